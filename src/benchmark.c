@@ -0,0 +1,1596 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Programa para medição de desempenho das diferentes formas de            *
+ * treinamento e inferência da rede.                                        *
+ *                                                                          *
+ * Uso: ./benchmark_perceptron <nome do benchmark>                          *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include "perceptron_multicamadas.h"
+#include "historico_treinamento.h"
+#include "quantizacao.h"
+#include "poda.h"
+#include "fatoracao.h"
+#include "fluxo_padroes.h"
+
+/**
+ * Método que retorna a hora atual em segundos.
+ */
+static double horaAtualSegs()
+{
+  struct timeval hora;
+  gettimeofday(&hora, NULL);
+  return hora.tv_sec + hora.tv_usec / 1000000.0;
+}
+
+/**
+ * Método que gera padrões de treinamento sintéticos (amostras aleatórias no
+ * intervalo 0..1 e alvos iguais à média da amostra) e os copia para a
+ * memória do dispositivo acelerador.
+ */
+static PadraoTreinamento * gerarPadroesSinteticos(int qtdItensAmostra,
+                                                  int qtdItensAlvo,
+                                                  int qtdPadroes)
+{
+  PadraoTreinamento * padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+  float * h_amostra = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_alvo = malloc(sizeof(float) * qtdItensAlvo);
+  int semente = 12345;
+
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    float media = 0;
+    for (int j = 0; j < qtdItensAmostra; j++)
+    {
+      h_amostra[j] = r4_uniform_01(&semente);
+      media += h_amostra[j] / qtdItensAmostra;
+    }
+
+    for (int j = 0; j < qtdItensAlvo; j++)
+    {
+      h_alvo[j] = media;
+    }
+
+    float * d_amostra;
+    float * d_alvo;
+    cudaMalloc((void **) &d_amostra, sizeof(float) * qtdItensAmostra);
+    cudaMalloc((void **) &d_alvo, sizeof(float) * qtdItensAlvo);
+    cudaMemcpy(d_amostra, h_amostra, sizeof(float) * qtdItensAmostra,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_alvo, h_alvo, sizeof(float) * qtdItensAlvo,
+               cudaMemcpyHostToDevice);
+
+    padroes[i].d_amostra = d_amostra;
+    padroes[i].d_alvo = d_alvo;
+    padroes[i].tipoAmostra = AmostraDensa;
+    padroes[i].d_indices = NULL;
+    padroes[i].qtdNaoNulos = 0;
+  }
+
+  free(h_amostra);
+  free(h_alvo);
+
+  return padroes;
+}
+
+/**
+ * Benchmark do modo "Hogwild": mede a vazão (amostras por segundo) de uma
+ * época de treinamento conforme a quantidade de threads aumenta. Os
+ * "kernels" das threads são serializados na fila padrão do dispositivo, de
+ * modo que a aceleração mede a sobreposição do trabalho do hospedeiro.
+ */
+static void benchmarkHogwild()
+{
+  const int qtdPadroes = 4096;
+  const int qtdEpocas = 3;
+  int qtdNeuroniosCamada[] = {256, 256, 10};
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(256, 10, qtdPadroes);
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializar(256, 3, qtdNeuroniosCamada, Sigmoide);
+
+  fprintf(stderr, "Aviso: os kernels de todas as threads são disparados de "
+          "forma síncrona na fila padrão do dispositivo e são serializados; "
+          "a aceleração mede apenas a sobreposição do trabalho do "
+          "hospedeiro.\n");
+  printf("threads;amostras_por_segundo;aceleracao\n");
+
+  double vazaoUmaThread = 0;
+  for (int qtdThreads = 1; qtdThreads <= 16; qtdThreads *= 2)
+  {
+    ContextoExecucao ** contextos;
+    contextos = malloc(sizeof(ContextoExecucao *) * qtdThreads);
+    for (int t = 0; t < qtdThreads; t++)
+    {
+      contextos[t] = ContextoExecucao_inicializar(pm);
+    }
+
+    double inicio = horaAtualSegs();
+    for (int e = 0; e < qtdEpocas; e++)
+    {
+      PerceptronMulticamadas_treinarEpocaHogwild(pm, contextos, padroes,
+                                                 NULL, qtdPadroes, 0.01,
+                                                 qtdThreads);
+    }
+    double vazao = (double) qtdPadroes * qtdEpocas /
+                   (horaAtualSegs() - inicio);
+
+    if (qtdThreads == 1)
+    {
+      vazaoUmaThread = vazao;
+    }
+
+    printf("%d;%.0f;%.2f\n", qtdThreads, vazao, vazao / vazaoUmaThread);
+
+    for (int t = 0; t < qtdThreads; t++)
+    {
+      ContextoExecucao_desalocar(contextos[t]);
+    }
+    free(contextos);
+  }
+}
+
+/**
+ * Benchmark da inferência em lote: mede a vazão (amostras por segundo) da
+ * inferência conforme o tamanho do lote aumenta.
+ */
+static void benchmarkInferenciaLote()
+{
+  const int qtdAmostras = 16384;
+  int qtdNeuroniosCamada[] = {512, 512, 10};
+
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializar(512, 3, qtdNeuroniosCamada, Sigmoide);
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+  float * h_entradas = malloc(sizeof(float) * qtdAmostras * 512);
+  float * h_saidas = malloc(sizeof(float) * qtdAmostras * 10);
+  int semente = 12345;
+  r4vec_uniform_01(qtdAmostras * 512, &semente, h_entradas);
+
+  printf("tamanho_lote;amostras_por_segundo\n");
+
+  for (int tamLote = 1; tamLote <= qtdAmostras; tamLote *= 4)
+  {
+    double inicio = horaAtualSegs();
+    for (int s = 0; s < qtdAmostras; s += tamLote)
+    {
+      int qtd = (qtdAmostras - s < tamLote) ? qtdAmostras - s : tamLote;
+      PerceptronMulticamadas_predizer(pm, contexto, &h_entradas[s * 512], qtd,
+                                      &h_saidas[s * 10]);
+    }
+    double vazao = qtdAmostras / (horaAtualSegs() - inicio);
+
+    printf("%d;%.0f\n", tamLote, vazao);
+  }
+
+  ContextoExecucao_desalocar(contexto);
+  free(h_entradas);
+  free(h_saidas);
+}
+
+/**
+ * Método utilizado pelo "qsort" para ordenar as latências.
+ */
+static int compararDouble(const void * a, const void * b)
+{
+  double da = *(const double *) a;
+  double db = *(const double *) b;
+  return (da > db) - (da < db);
+}
+
+/**
+ * Benchmark da inferência de baixa latência: mede a distribuição da
+ * latência (percentis 50, 99 e 99,9) da inferência de uma única amostra.
+ */
+static void benchmarkLatencia()
+{
+  const int qtdRepeticoes = 100000;
+  const int qtdAquecimento = 1000;
+  int qtdNeuroniosCamada[] = {256, 128, 10};
+
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializar(128, 3, qtdNeuroniosCamada, Sigmoide);
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+  float h_amostra[128];
+  float h_saida[10];
+  int semente = 12345;
+  r4vec_uniform_01(128, &semente, h_amostra);
+
+  double * latencias = malloc(sizeof(double) * qtdRepeticoes);
+
+  for (int r = 0; r < qtdAquecimento + qtdRepeticoes; r++)
+  {
+    struct timespec antes;
+    struct timespec depois;
+
+    clock_gettime(CLOCK_MONOTONIC, &antes);
+    PerceptronMulticamadas_predizerAmostra(pm, contexto, h_amostra, h_saida);
+    clock_gettime(CLOCK_MONOTONIC, &depois);
+
+    if (r >= qtdAquecimento)
+    {
+      latencias[r - qtdAquecimento] = (depois.tv_sec - antes.tv_sec) * 1e6 +
+                                      (depois.tv_nsec - antes.tv_nsec) / 1e3;
+    }
+  }
+
+  qsort(latencias, qtdRepeticoes, sizeof(double), compararDouble);
+
+  printf("p50_us;p99_us;p999_us;max_us\n");
+  printf("%.2f;%.2f;%.2f;%.2f\n",
+         latencias[(int) (qtdRepeticoes * 0.50)],
+         latencias[(int) (qtdRepeticoes * 0.99)],
+         latencias[(int) (qtdRepeticoes * 0.999)],
+         latencias[qtdRepeticoes - 1]);
+
+  free(latencias);
+  ContextoExecucao_desalocar(contexto);
+}
+
+/**
+ * Benchmark da quantização int8: compara o erro MSE (padrões sintéticos) e
+ * a vazão da inferência em lote da rede quantizada com a rede original.
+ */
+static void benchmarkQuantizacao()
+{
+  const int qtdPadroes = 2048;
+  const int qtdEpocas = 3;
+  const int qtdAmostras = 16384;
+  int qtdNeuroniosCamada[] = {512, 512, 10};
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(256, 10, qtdPadroes);
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializar(256, 3, qtdNeuroniosCamada, Sigmoide);
+
+  /* Treinando rapidamente a rede para que os pesos não sejam aleatórios. */
+  ContextoExecucao * contextoTreinamento = ContextoExecucao_inicializar(pm);
+  for (int e = 0; e < qtdEpocas; e++)
+  {
+    for (int p = 0; p < qtdPadroes; p++)
+    {
+      __treinarPadrao(pm, contextoTreinamento, &padroes[p], 0.01);
+    }
+  }
+  ContextoExecucao_desalocar(contextoTreinamento);
+
+  /* Calibrando com um quarto dos padrões. */
+  PerceptronQuantizado * pqCamada;
+  PerceptronQuantizado * pqNeuronio;
+  pqCamada = PerceptronQuantizado_quantizar(pm, padroes, qtdPadroes / 4,
+                                            QuantizacaoPorCamada);
+  pqNeuronio = PerceptronQuantizado_quantizar(pm, padroes, qtdPadroes / 4,
+                                              QuantizacaoPorNeuronio);
+
+  float * h_entradas = malloc(sizeof(float) * qtdAmostras * 256);
+  float * h_saidas = malloc(sizeof(float) * qtdAmostras * 10);
+  int semente = 12345;
+  r4vec_uniform_01(qtdAmostras * 256, &semente, h_entradas);
+
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+  ContextoQuantizado * contextoQuantizado;
+  contextoQuantizado = ContextoQuantizado_inicializar(pqNeuronio);
+
+  /* Vazão da rede original e da rede quantizada (mesmos lotes). */
+  double inicio = horaAtualSegs();
+  PerceptronMulticamadas_predizer(pm, contexto, h_entradas, qtdAmostras,
+                                  h_saidas);
+  double vazaoFloat = qtdAmostras / (horaAtualSegs() - inicio);
+
+  inicio = horaAtualSegs();
+  PerceptronQuantizado_predizer(pqNeuronio, contextoQuantizado, h_entradas,
+                                qtdAmostras, h_saidas);
+  double vazaoInt8 = qtdAmostras / (horaAtualSegs() - inicio);
+
+  /* Memória dos pesos (o bias e as escalas são desprezíveis). */
+  long qtdPesos = 256L * 512 + 512L * 512 + 512L * 10;
+
+  printf("modelo;erro_mse;amostras_por_segundo;bytes_pesos\n");
+  printf("float;%.6f;%.0f;%ld\n",
+         PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes, qtdPadroes),
+         vazaoFloat, qtdPesos * (long) sizeof(float));
+  printf("int8_por_camada;%.6f;-;%ld\n",
+         PerceptronQuantizado_calcularTaxaAcerto(pqCamada, padroes,
+                                                 qtdPadroes), qtdPesos);
+  printf("int8_por_neuronio;%.6f;%.0f;%ld\n",
+         PerceptronQuantizado_calcularTaxaAcerto(pqNeuronio, padroes,
+                                                 qtdPadroes),
+         vazaoInt8, qtdPesos);
+
+  ContextoExecucao_desalocar(contexto);
+  ContextoQuantizado_desalocar(contextoQuantizado);
+  PerceptronQuantizado_desalocar(pqCamada);
+  PerceptronQuantizado_desalocar(pqNeuronio);
+  free(h_entradas);
+  free(h_saidas);
+}
+
+/**
+ * Benchmark dos formatos de armazenamento dos pesos: treina (gradiente
+ * descendente estocástico) e realiza a inferência em lote de uma rede
+ * larga, limitada pela largura de banda da memória, partindo dos mesmos
+ * pesos em cada formato.
+ */
+static void benchmarkPrecisao()
+{
+  const int qtdPadroes = 1024;
+  const int qtdEpocas = 2;
+  const int qtdAmostras = 8192;
+  const int qtdCamadas = 3;
+  int qtdNeuroniosCamada[] = {2048, 2048, 10};
+
+  const char * nomes[] = {"fp32", "bf16_copia_fp32", "bf16", "fp16_copia_fp32"};
+  int formatos[] = {FormatoFP32, FormatoBF16, FormatoBF16, FormatoFP16};
+  bool copias[] = {true, true, false, true};
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(1024, 10, qtdPadroes);
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializar(1024, qtdCamadas, qtdNeuroniosCamada,
+                                          Sigmoide);
+
+  /* Guardando os pesos e os bias iniciais para que todos os formatos
+     partam dos mesmos valores. */
+  float * h_W[qtdCamadas];
+  float * h_bias[qtdCamadas];
+  long qtdPesos = 0;
+
+  for (int c = 0; c < qtdCamadas; c++)
+  {
+    int qtdPesosNeuronio = (c == 0) ? 1024 : qtdNeuroniosCamada[c - 1];
+    h_W[c] = malloc(sizeof(float) * qtdNeuroniosCamada[c] * qtdPesosNeuronio);
+    h_bias[c] = malloc(sizeof(float) * qtdNeuroniosCamada[c]);
+    Camada_copiarPesosHospedeiro(pm->camadas[c], qtdPesosNeuronio, h_W[c]);
+    cudaMemcpy(h_bias[c], pm->camadas[c]->d_bias,
+               sizeof(float) * qtdNeuroniosCamada[c], cudaMemcpyDeviceToHost);
+    qtdPesos += (long) qtdNeuroniosCamada[c] * qtdPesosNeuronio;
+  }
+
+  float * h_entradas = malloc(sizeof(float) * qtdAmostras * 1024);
+  float * h_saidas = malloc(sizeof(float) * qtdAmostras * 10);
+  int semente = 12345;
+  r4vec_uniform_01(qtdAmostras * 1024, &semente, h_entradas);
+
+  printf("formato;treino_padroes_por_segundo;erro_mse;"
+         "inferencia_amostras_por_segundo;bytes_pesos_lidos\n");
+
+  for (int f = 0; f < 4; f++)
+  {
+    /* Restaurando os pesos iniciais no formato. */
+    PerceptronMulticamadas_definirFormatoPesos(pm, formatos[f], copias[f]);
+    for (int c = 0; c < qtdCamadas; c++)
+    {
+      int qtdPesosNeuronio = (c == 0) ? 1024 : qtdNeuroniosCamada[c - 1];
+      Camada_definirPesosHospedeiro(pm->camadas[c], qtdPesosNeuronio, h_W[c]);
+      cudaMemcpy(pm->camadas[c]->d_bias, h_bias[c],
+                 sizeof(float) * qtdNeuroniosCamada[c],
+                 cudaMemcpyHostToDevice);
+    }
+
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+    double inicio = horaAtualSegs();
+    for (int e = 0; e < qtdEpocas; e++)
+    {
+      for (int p = 0; p < qtdPadroes; p++)
+      {
+        __treinarPadrao(pm, contexto, &padroes[p], 0.01);
+      }
+    }
+    double vazaoTreino = qtdEpocas * qtdPadroes /
+                         (horaAtualSegs() - inicio);
+
+    inicio = horaAtualSegs();
+    PerceptronMulticamadas_predizer(pm, contexto, h_entradas, qtdAmostras,
+                                    h_saidas);
+    double vazaoInferencia = qtdAmostras / (horaAtualSegs() - inicio);
+
+    printf("%s;%.0f;%.6f;%.0f;%ld\n", nomes[f], vazaoTreino,
+           PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes, qtdPadroes),
+           vazaoInferencia, qtdPesos * (long) ((formatos[f] == FormatoFP32) ?
+                                               sizeof(float) :
+                                               sizeof(uint16_t)));
+
+    ContextoExecucao_desalocar(contexto);
+  }
+
+  for (int c = 0; c < qtdCamadas; c++)
+  {
+    free(h_W[c]);
+    free(h_bias[c]);
+  }
+  free(h_entradas);
+  free(h_saidas);
+}
+
+/**
+ * Benchmark da poda por magnitude: treina rapidamente uma rede, poda 90%
+ * dos pesos de cada camada, realiza o ajuste fino e compara o erro, a vazão
+ * e a memória dos pesos da rede densa e da rede esparsa (CSR).
+ */
+static void benchmarkPoda()
+{
+  const int qtdPadroes = 2048;
+  const int qtdEpocas = 3;
+  const int qtdAmostras = 16384;
+  const float esparsidade = 0.9;
+  int qtdNeuroniosCamada[] = {1024, 1024, 10};
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(256, 10, qtdPadroes);
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializar(256, 3, qtdNeuroniosCamada, Sigmoide);
+
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+  for (int e = 0; e < qtdEpocas; e++)
+  {
+    for (int p = 0; p < qtdPadroes; p++)
+    {
+      __treinarPadrao(pm, contexto, &padroes[p], 0.01);
+    }
+  }
+
+  float * h_entradas = malloc(sizeof(float) * qtdAmostras * 256);
+  float * h_saidas = malloc(sizeof(float) * qtdAmostras * 10);
+  int semente = 12345;
+  r4vec_uniform_01(qtdAmostras * 256, &semente, h_entradas);
+
+  float erroDensa = PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                              qtdPadroes);
+  double inicio = horaAtualSegs();
+  PerceptronMulticamadas_predizer(pm, contexto, h_entradas, qtdAmostras,
+                                  h_saidas);
+  double vazaoDensa = qtdAmostras / (horaAtualSegs() - inicio);
+
+  /* Podando e medindo o erro antes e depois do ajuste fino. */
+  MascaraPoda * mascara = PerceptronMulticamadas_podar(pm, esparsidade);
+  float erroPodada = PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                               qtdPadroes);
+  PerceptronMulticamadas_ajustarPoda(pm, mascara, padroes, qtdPadroes, 0.01,
+                                     qtdEpocas);
+
+  PerceptronEsparso * pe = PerceptronEsparso_converter(pm);
+  ContextoEsparso * contextoEsparso = ContextoEsparso_inicializar(pe);
+
+  inicio = horaAtualSegs();
+  PerceptronEsparso_predizer(pe, contextoEsparso, h_entradas, qtdAmostras,
+                             h_saidas);
+  double vazaoEsparsa = qtdAmostras / (horaAtualSegs() - inicio);
+
+  long qtdPesos = 256L * 1024 + 1024L * 1024 + 1024L * 10;
+
+  printf("modelo;erro_mse;amostras_por_segundo;bytes_pesos\n");
+  printf("densa;%.6f;%.0f;%ld\n", erroDensa, vazaoDensa,
+         qtdPesos * (long) sizeof(float));
+  printf("podada_sem_ajuste;%.6f;-;-\n", erroPodada);
+  printf("esparsa_csr;%.6f;%.0f;%zu\n",
+         PerceptronEsparso_calcularTaxaAcerto(pe, padroes, qtdPadroes),
+         vazaoEsparsa, PerceptronEsparso_bytesPesos(pe));
+
+  ContextoExecucao_desalocar(contexto);
+  ContextoEsparso_desalocar(contextoEsparso);
+  PerceptronEsparso_desalocar(pe);
+  MascaraPoda_desalocar(mascara);
+  free(h_entradas);
+  free(h_saidas);
+}
+
+/**
+ * Benchmark da fatoração de posto baixo: treina rapidamente uma rede,
+ * fatora as camadas com um orçamento de erro e compara o erro, os postos
+ * escolhidos, a quantidade de multiplicações e a vazão da inferência da
+ * rede densa e da rede fatorada.
+ */
+static void benchmarkFatoracao()
+{
+  const int qtdPadroes = 2048;
+  const int qtdEpocas = 3;
+  const int qtdAmostras = 16384;
+  const float orcamentoErro = 0.01;
+  int qtdNeuroniosCamada[] = {1024, 1024, 10};
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(256, 10, qtdPadroes);
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializar(256, 3, qtdNeuroniosCamada, Sigmoide);
+
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+  for (int e = 0; e < qtdEpocas; e++)
+  {
+    for (int p = 0; p < qtdPadroes; p++)
+    {
+      __treinarPadrao(pm, contexto, &padroes[p], 0.01);
+    }
+  }
+
+  float * h_entradas = malloc(sizeof(float) * qtdAmostras * 256);
+  float * h_saidas = malloc(sizeof(float) * qtdAmostras * 10);
+  int semente = 12345;
+  r4vec_uniform_01(qtdAmostras * 256, &semente, h_entradas);
+
+  float erroDensa = PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                              qtdPadroes);
+  double inicio = horaAtualSegs();
+  PerceptronMulticamadas_predizer(pm, contexto, h_entradas, qtdAmostras,
+                                  h_saidas);
+  double vazaoDensa = qtdAmostras / (horaAtualSegs() - inicio);
+
+  PerceptronFatorado * pf = PerceptronFatorado_fatorar(pm, padroes, qtdPadroes,
+                                                       orcamentoErro);
+  ContextoFatorado * contextoFatorado = ContextoFatorado_inicializar(pf);
+
+  inicio = horaAtualSegs();
+  PerceptronFatorado_predizer(pf, contextoFatorado, h_entradas, qtdAmostras,
+                              h_saidas);
+  double vazaoFatorada = qtdAmostras / (horaAtualSegs() - inicio);
+
+  long qtdMultiplicacoesDensa = 256L * 1024 + 1024L * 1024 + 1024L * 10;
+
+  printf("modelo;erro_mse;postos;multiplicacoes;amostras_por_segundo\n");
+  printf("densa;%.6f;-;%ld;%.0f\n", erroDensa, qtdMultiplicacoesDensa,
+         vazaoDensa);
+  printf("fatorada;%.6f;%d/%d/%d;%ld;%.0f\n",
+         PerceptronFatorado_calcularTaxaAcerto(pf, padroes, qtdPadroes),
+         pf->camadas[0].posto, pf->camadas[1].posto, pf->camadas[2].posto,
+         PerceptronFatorado_qtdMultiplicacoes(pf), vazaoFatorada);
+
+  ContextoExecucao_desalocar(contexto);
+  ContextoFatorado_desalocar(contextoFatorado);
+  PerceptronFatorado_desalocar(pf);
+  free(h_entradas);
+  free(h_saidas);
+}
+
+/**
+ * Benchmark das amostras esparsas: treina a mesma rede (entrada de alta
+ * dimensão com poucos itens não nulos) com os padrões densos e com os
+ * mesmos padrões no formato esparso, comparando a vazão do treinamento.
+ */
+static void benchmarkEntradaEsparsa()
+{
+  const int qtdItensAmostra = 1 << 18;
+  const int qtdNaoNulos = 100;
+  const int qtdPadroes = 256;
+  const int qtdEpocas = 3;
+  int qtdNeuroniosCamada[] = {256, 10};
+
+  PadraoTreinamento * padroesDensos = malloc(sizeof(PadraoTreinamento) *
+                                             qtdPadroes);
+  PadraoTreinamento * padroesEsparsos = malloc(sizeof(PadraoTreinamento) *
+                                               qtdPadroes);
+  float * h_amostra = calloc(qtdItensAmostra, sizeof(float));
+  int * h_indices = malloc(sizeof(int) * qtdNaoNulos);
+  float * h_valores = malloc(sizeof(float) * qtdNaoNulos);
+  float h_alvo[10];
+  int semente = 12345;
+
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    float media = 0;
+    memset(h_amostra, 0, sizeof(float) * qtdItensAmostra);
+    for (int k = 0; k < qtdNaoNulos; k++)
+    {
+      h_indices[k] = i4_uniform_ab(0, qtdItensAmostra - 1, &semente);
+      h_valores[k] = r4_uniform_01(&semente);
+      h_amostra[h_indices[k]] += h_valores[k];
+      media += h_valores[k] / qtdNaoNulos;
+    }
+
+    for (int j = 0; j < 10; j++)
+    {
+      h_alvo[j] = media;
+    }
+
+    float * d_amostra;
+    float * d_valores;
+    int * d_indices;
+    float * d_alvo;
+    cudaMalloc((void **) &d_amostra, sizeof(float) * qtdItensAmostra);
+    cudaMalloc((void **) &d_valores, sizeof(float) * qtdNaoNulos);
+    cudaMalloc((void **) &d_indices, sizeof(int) * qtdNaoNulos);
+    cudaMalloc((void **) &d_alvo, sizeof(float) * 10);
+    cudaMemcpy(d_amostra, h_amostra, sizeof(float) * qtdItensAmostra,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_valores, h_valores, sizeof(float) * qtdNaoNulos,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_indices, h_indices, sizeof(int) * qtdNaoNulos,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_alvo, h_alvo, sizeof(float) * 10, cudaMemcpyHostToDevice);
+
+    padroesDensos[i].d_amostra = d_amostra;
+    padroesDensos[i].d_alvo = d_alvo;
+    padroesDensos[i].tipoAmostra = AmostraDensa;
+    padroesDensos[i].d_indices = NULL;
+    padroesDensos[i].qtdNaoNulos = 0;
+
+    padroesEsparsos[i].d_amostra = d_valores;
+    padroesEsparsos[i].d_alvo = d_alvo;
+    padroesEsparsos[i].tipoAmostra = AmostraEsparsa;
+    padroesEsparsos[i].d_indices = d_indices;
+    padroesEsparsos[i].qtdNaoNulos = qtdNaoNulos;
+  }
+
+  free(h_amostra);
+  free(h_indices);
+  free(h_valores);
+
+  printf("amostra;padroes_por_segundo;erro_mse\n");
+
+  for (int esparsa = 0; esparsa <= 1; esparsa++)
+  {
+    PadraoTreinamento * padroes = esparsa ? padroesEsparsos : padroesDensos;
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializar(qtdItensAmostra, 2,
+                                            qtdNeuroniosCamada, Sigmoide);
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+    double inicio = horaAtualSegs();
+    for (int e = 0; e < qtdEpocas; e++)
+    {
+      for (int p = 0; p < qtdPadroes; p++)
+      {
+        __treinarPadrao(pm, contexto, &padroes[p], 0.01);
+      }
+    }
+    double vazao = (double) qtdPadroes * qtdEpocas /
+                   (horaAtualSegs() - inicio);
+
+    printf("%s;%.0f;%.6f\n", esparsa ? "esparsa" : "densa", vazao,
+           PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes, qtdPadroes));
+
+    ContextoExecucao_desalocar(contexto);
+  }
+
+  free(padroesDensos);
+  free(padroesEsparsos);
+}
+
+/**
+ * Benchmark da camada de "embedding": treina a mesma tarefa com atributos
+ * categóricos codificados em "one-hot" (densos e esparsos) e com a camada
+ * de "embedding", comparando o tamanho da entrada da primeira camada, a
+ * vazão do treinamento e o erro.
+ */
+static void benchmarkEmbedding()
+{
+  const int qtdAtributos = 8;
+  const int qtdCategorias = 4096;
+  const int dimensao = 16;
+  const int qtdDensos = 16;
+  const int qtdPadroes = 512;
+  const int qtdEpocas = 3;
+  int qtdNeuroniosCamada[] = {256, 10};
+
+  int qtdItensOneHot = qtdAtributos * qtdCategorias + qtdDensos;
+  PadraoTreinamento * padroes[3];
+  for (int t = 0; t < 3; t++)
+  {
+    padroes[t] = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+  }
+
+  float * h_oneHot = malloc(sizeof(float) * qtdItensOneHot);
+  int h_ids[8];
+  int h_indices[8 + 16];
+  float h_valores[8 + 16];
+  float h_alvo[10];
+  int semente = 12345;
+
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    memset(h_oneHot, 0, sizeof(float) * qtdItensOneHot);
+
+    /* Cada atributo utiliza a sua própria faixa de identificadores. */
+    float media = 0;
+    for (int a = 0; a < qtdAtributos; a++)
+    {
+      int categoria = i4_uniform_ab(0, qtdCategorias / qtdAtributos - 1,
+                                    &semente);
+      h_ids[a] = a * (qtdCategorias / qtdAtributos) + categoria;
+      h_indices[a] = a * qtdCategorias + categoria;
+      h_valores[a] = 1;
+      h_oneHot[h_indices[a]] = 1;
+      media += (float) categoria / qtdCategorias;
+    }
+
+    for (int d = 0; d < qtdDensos; d++)
+    {
+      float valor = r4_uniform_01(&semente);
+      h_indices[qtdAtributos + d] = qtdAtributos * qtdCategorias + d;
+      h_valores[qtdAtributos + d] = valor;
+      h_oneHot[qtdAtributos * qtdCategorias + d] = valor;
+    }
+
+    for (int j = 0; j < 10; j++)
+    {
+      h_alvo[j] = media;
+    }
+
+    float * d_oneHot;
+    int * d_indices;
+    float * d_valores;
+    int * d_ids;
+    float * d_alvo;
+    cudaMalloc((void **) &d_oneHot, sizeof(float) * qtdItensOneHot);
+    cudaMalloc((void **) &d_indices, sizeof(int) * (qtdAtributos + qtdDensos));
+    cudaMalloc((void **) &d_valores, sizeof(float) * (qtdAtributos + qtdDensos));
+    cudaMalloc((void **) &d_ids, sizeof(int) * qtdAtributos);
+    cudaMalloc((void **) &d_alvo, sizeof(float) * 10);
+    cudaMemcpy(d_oneHot, h_oneHot, sizeof(float) * qtdItensOneHot,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_indices, h_indices, sizeof(int) * (qtdAtributos + qtdDensos),
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_valores, h_valores,
+               sizeof(float) * (qtdAtributos + qtdDensos),
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_ids, h_ids, sizeof(int) * qtdAtributos,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_alvo, h_alvo, sizeof(float) * 10, cudaMemcpyHostToDevice);
+
+    padroes[0][i].d_amostra = d_oneHot;
+    padroes[0][i].tipoAmostra = AmostraDensa;
+    padroes[0][i].d_indices = NULL;
+    padroes[0][i].qtdNaoNulos = 0;
+
+    padroes[1][i].d_amostra = d_valores;
+    padroes[1][i].tipoAmostra = AmostraEsparsa;
+    padroes[1][i].d_indices = d_indices;
+    padroes[1][i].qtdNaoNulos = qtdAtributos + qtdDensos;
+
+    /* Os atributos densos são os últimos valores da amostra esparsa. */
+    padroes[2][i].d_amostra = d_valores + qtdAtributos;
+    padroes[2][i].tipoAmostra = AmostraCategorica;
+    padroes[2][i].d_indices = d_ids;
+    padroes[2][i].qtdNaoNulos = qtdAtributos;
+
+    for (int t = 0; t < 3; t++)
+    {
+      padroes[t][i].d_alvo = d_alvo;
+    }
+  }
+
+  free(h_oneHot);
+
+  const char * nomes[] = {"onehot_densa", "onehot_esparsa", "embedding"};
+  int qtdEntradas[] = {qtdItensOneHot, qtdItensOneHot,
+                       qtdAtributos * dimensao + qtdDensos};
+
+  printf("entrada;qtd_entradas_primeira_camada;padroes_por_segundo;"
+         "erro_mse\n");
+
+  for (int t = 0; t < 3; t++)
+  {
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializar(qtdEntradas[t], 2,
+                                            qtdNeuroniosCamada, Sigmoide);
+    if (t == 2)
+    {
+      PerceptronMulticamadas_adicionarEmbedding(pm, qtdCategorias, dimensao,
+                                                qtdAtributos);
+    }
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+    double inicio = horaAtualSegs();
+    for (int e = 0; e < qtdEpocas; e++)
+    {
+      for (int p = 0; p < qtdPadroes; p++)
+      {
+        __treinarPadrao(pm, contexto, &padroes[t][p], 0.01);
+      }
+    }
+    double vazao = (double) qtdPadroes * qtdEpocas /
+                   (horaAtualSegs() - inicio);
+
+    printf("%s;%d;%.0f;%.6f\n", nomes[t], qtdEntradas[t], vazao,
+           PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes[t],
+                                                     qtdPadroes));
+
+    ContextoExecucao_desalocar(contexto);
+  }
+
+  for (int t = 0; t < 3; t++)
+  {
+    free(padroes[t]);
+  }
+}
+
+/**
+ * Benchmark das amostras brutas: treina a mesma rede com amostras de 8
+ * bits (tipo imagem) normalizadas e armazenadas em float, com as mesmas
+ * amostras mantidas em uint8 (normalizadas pela primeira camada com uma
+ * escala única ou com a escala de cada item) e em fp16, comparando a
+ * memória das amostras, a vazão do treinamento e o erro.
+ */
+static void benchmarkAmostraBruta()
+{
+  const int qtdItensAmostra = 784;
+  const int qtdPadroes = 4096;
+  const int qtdEpocas = 3;
+  const int qtdVariantes = 4;
+  int qtdNeuroniosCamada[] = {256, 10};
+  const char * nomesVariantes[] = {"float", "uint8", "uint8_por_item",
+                                   "fp16"};
+  int tiposVariantes[] = {AmostraDensa, AmostraUint8, AmostraUint8,
+                          AmostraFP16};
+
+  PadraoTreinamento * padroes[qtdVariantes];
+  for (int v = 0; v < qtdVariantes; v++)
+  {
+    padroes[v] = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+  }
+
+  uint8_t * h_amostrasBrutas = malloc(qtdItensAmostra * qtdPadroes);
+  uint16_t * h_amostrasFP16 = malloc(sizeof(uint16_t) * qtdItensAmostra *
+                                     qtdPadroes);
+  float * h_amostra = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_escalas = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_deslocamentos = malloc(sizeof(float) * qtdItensAmostra);
+  float h_alvo[10];
+  int semente = 12345;
+
+  /* Escalas de cada item equivalentes à escala única (para medir o custo
+     de converter cada item durante o produto escalar). */
+  for (int j = 0; j < qtdItensAmostra; j++)
+  {
+    h_escalas[j] = 1.0 / 255;
+    h_deslocamentos[j] = 0;
+  }
+
+  uint8_t * d_amostrasBrutas;
+  uint16_t * d_amostrasFP16;
+  float * d_escalas;
+  float * d_escalasFP16;
+  float * d_deslocamentos;
+  cudaMalloc((void **) &d_amostrasBrutas, qtdItensAmostra * qtdPadroes);
+  cudaMalloc((void **) &d_amostrasFP16,
+             sizeof(uint16_t) * qtdItensAmostra * qtdPadroes);
+  cudaMalloc((void **) &d_escalas, sizeof(float) * qtdItensAmostra);
+  cudaMalloc((void **) &d_escalasFP16, sizeof(float) * qtdItensAmostra);
+  cudaMalloc((void **) &d_deslocamentos, sizeof(float) * qtdItensAmostra);
+  cudaMemcpy(d_escalas, h_escalas, sizeof(float) * qtdItensAmostra,
+             cudaMemcpyHostToDevice);
+  cudaMemcpy(d_deslocamentos, h_deslocamentos,
+             sizeof(float) * qtdItensAmostra, cudaMemcpyHostToDevice);
+
+  /* Em fp16 as amostras são armazenadas já normalizadas (escala unitária). */
+  for (int j = 0; j < qtdItensAmostra; j++)
+  {
+    h_escalas[j] = 1.0;
+  }
+  cudaMemcpy(d_escalasFP16, h_escalas, sizeof(float) * qtdItensAmostra,
+             cudaMemcpyHostToDevice);
+
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    long deslocamentoAmostra = (long) qtdItensAmostra * i;
+    float media = 0;
+    for (int j = 0; j < qtdItensAmostra; j++)
+    {
+      uint8_t item = i4_uniform_ab(0, 255, &semente);
+      h_amostrasBrutas[deslocamentoAmostra + j] = item;
+      h_amostrasFP16[deslocamentoAmostra + j] = converterFloatFP16(item /
+                                                                   255.0);
+      h_amostra[j] = item;
+      media += item / 255.0 / qtdItensAmostra;
+    }
+
+    normalizacaoMinMax(h_amostra, qtdItensAmostra, 0, 255);
+
+    for (int j = 0; j < 10; j++)
+    {
+      h_alvo[j] = media;
+    }
+
+    float * d_amostra;
+    float * d_alvo;
+    cudaMalloc((void **) &d_amostra, sizeof(float) * qtdItensAmostra);
+    cudaMalloc((void **) &d_alvo, sizeof(float) * 10);
+    cudaMemcpy(d_amostra, h_amostra, sizeof(float) * qtdItensAmostra,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(d_alvo, h_alvo, sizeof(float) * 10, cudaMemcpyHostToDevice);
+
+    for (int v = 0; v < qtdVariantes; v++)
+    {
+      padroes[v][i].d_amostra = (v == 0) ? d_amostra : NULL;
+      padroes[v][i].d_alvo = d_alvo;
+      padroes[v][i].tipoAmostra = tiposVariantes[v];
+      padroes[v][i].d_indices = NULL;
+      padroes[v][i].qtdNaoNulos = 0;
+      padroes[v][i].d_amostraBruta = d_amostrasBrutas + deslocamentoAmostra;
+      padroes[v][i].escalaAmostra = 1.0 / 255;
+      padroes[v][i].deslocamentoAmostra = 0;
+      padroes[v][i].d_escalasAmostra = NULL;
+      padroes[v][i].d_deslocamentosAmostra = NULL;
+    }
+
+    padroes[2][i].d_escalasAmostra = d_escalas;
+    padroes[2][i].d_deslocamentosAmostra = d_deslocamentos;
+
+    padroes[3][i].d_amostraBruta = d_amostrasFP16 + deslocamentoAmostra;
+    padroes[3][i].d_escalasAmostra = d_escalasFP16;
+    padroes[3][i].d_deslocamentosAmostra = d_deslocamentos;
+  }
+
+  cudaMemcpy(d_amostrasBrutas, h_amostrasBrutas, qtdItensAmostra * qtdPadroes,
+             cudaMemcpyHostToDevice);
+  cudaMemcpy(d_amostrasFP16, h_amostrasFP16,
+             sizeof(uint16_t) * qtdItensAmostra * qtdPadroes,
+             cudaMemcpyHostToDevice);
+  free(h_amostrasBrutas);
+  free(h_amostrasFP16);
+  free(h_amostra);
+  free(h_escalas);
+  free(h_deslocamentos);
+
+  long bytesAmostras[] = {(long) sizeof(float) * qtdItensAmostra * qtdPadroes,
+                          (long) qtdItensAmostra * qtdPadroes,
+                          (long) qtdItensAmostra * qtdPadroes,
+                          (long) sizeof(uint16_t) * qtdItensAmostra *
+                          qtdPadroes};
+
+  printf("amostra;bytes_amostras;padroes_por_segundo;erro_mse\n");
+
+  for (int v = 0; v < qtdVariantes; v++)
+  {
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializar(qtdItensAmostra, 2,
+                                            qtdNeuroniosCamada, Sigmoide);
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+    double inicio = horaAtualSegs();
+    for (int e = 0; e < qtdEpocas; e++)
+    {
+      for (int p = 0; p < qtdPadroes; p++)
+      {
+        __treinarPadrao(pm, contexto, &padroes[v][p], 0.01);
+      }
+    }
+    double vazao = (double) qtdPadroes * qtdEpocas /
+                   (horaAtualSegs() - inicio);
+
+    printf("%s;%ld;%.0f;%.6f\n", nomesVariantes[v], bytesAmostras[v], vazao,
+           PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes[v],
+                                                     qtdPadroes));
+
+    ContextoExecucao_desalocar(contexto);
+  }
+
+  for (int v = 0; v < qtdVariantes; v++)
+  {
+    free(padroes[v]);
+  }
+}
+
+/**
+ * Benchmark do treinamento com os padrões lidos do disco: escreve os mesmos
+ * padrões de "gerarPadroesSinteticos" em arquivos binários e CSV e compara
+ * o treinamento com os padrões na memória do dispositivo acelerador e com
+ * os fluxos de cada formato (vazão, leitura do disco, memória ocupada pelos
+ * padrões e tempo aguardando a leitura).
+ */
+static void benchmarkFluxo()
+{
+  const int qtdItensAmostra = 784;
+  const int qtdItensAlvo = 10;
+  const int qtdPadroes = 16384;
+  const int qtdPadroesBloco = 1024;
+  const int qtdEpocas = 3;
+  int qtdNeuroniosCamada[] = {256, qtdItensAlvo};
+
+  /* Escrevendo os arquivos (mesma sequência de "gerarPadroesSinteticos"). */
+  FILE * arqAmostrasBin = fopen("fluxo_amostras.bin", "wb");
+  FILE * arqAlvosBin = fopen("fluxo_alvos.bin", "wb");
+  FILE * arqAmostrasCSV = fopen("fluxo_amostras.csv", "w");
+  FILE * arqAlvosCSV = fopen("fluxo_alvos.csv", "w");
+  float * h_amostra = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_alvo = malloc(sizeof(float) * qtdItensAlvo);
+  int semente = 12345;
+
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    float media = 0;
+    for (int j = 0; j < qtdItensAmostra; j++)
+    {
+      h_amostra[j] = r4_uniform_01(&semente);
+      media += h_amostra[j] / qtdItensAmostra;
+      fprintf(arqAmostrasCSV, (j == 0) ? "%.9g" : ";%.9g", h_amostra[j]);
+    }
+
+    for (int j = 0; j < qtdItensAlvo; j++)
+    {
+      h_alvo[j] = media;
+      fprintf(arqAlvosCSV, (j == 0) ? "%.9g" : ";%.9g", h_alvo[j]);
+    }
+
+    fwrite(h_amostra, sizeof(float), qtdItensAmostra, arqAmostrasBin);
+    fwrite(h_alvo, sizeof(float), qtdItensAlvo, arqAlvosBin);
+    fprintf(arqAmostrasCSV, "\n");
+    fprintf(arqAlvosCSV, "\n");
+  }
+
+  fclose(arqAmostrasBin);
+  fclose(arqAlvosBin);
+  fclose(arqAmostrasCSV);
+  fclose(arqAlvosCSV);
+  free(h_amostra);
+  free(h_alvo);
+
+  printf("fonte;bytes_padroes;padroes_por_segundo;mb_lidos_por_segundo;"
+         "segs_espera_leitura;erro_mse\n");
+
+  const char * nomesFontes[] = {"memoria", "fluxo_binario",
+                                "fluxo_binario_embaralhado", "fluxo_csv"};
+  ConfigEmbaralhamento embaralhamento = {EmbaralhamentoBlocos,
+                                         qtdPadroesBloco,
+                                         SEMENTE_EMBARALHAMENTO};
+
+  for (int fonte = 0; fonte < 4; fonte++)
+  {
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializar(qtdItensAmostra, 2,
+                                            qtdNeuroniosCamada, Sigmoide);
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+    long bytesPadroes = (long) sizeof(float) *
+                        (qtdItensAmostra + qtdItensAlvo);
+    float erro = 0;
+
+    double inicio = horaAtualSegs();
+
+    if (fonte == 0)
+    {
+      /* Padrões na memória (o tempo de geração não é contabilizado). */
+      PadraoTreinamento * padroes = gerarPadroesSinteticos(qtdItensAmostra,
+                                                           qtdItensAlvo,
+                                                           qtdPadroes);
+      inicio = horaAtualSegs();
+      for (int e = 0; e < qtdEpocas; e++)
+      {
+        erro = 0;
+        for (int p = 0; p < qtdPadroes; p++)
+        {
+          erro += __treinarPadrao(pm, contexto, &padroes[p], 0.01);
+        }
+        erro /= qtdPadroes;
+      }
+      double segs = horaAtualSegs() - inicio;
+
+      printf("%s;%ld;%.0f;0;0;%.6f\n", nomesFontes[fonte],
+             bytesPadroes * qtdPadroes,
+             (double) qtdPadroes * qtdEpocas / segs, erro);
+      free(padroes);
+    }
+    else
+    {
+      bool binario = (fonte != 3);
+      FluxoPadroes * fluxo;
+      fluxo = FluxoPadroes_abrir(binario ? "fluxo_amostras.bin" :
+                                           "fluxo_amostras.csv",
+                                 binario ? "fluxo_alvos.bin" :
+                                           "fluxo_alvos.csv",
+                                 binario ? FormatoFluxoBinario :
+                                           FormatoFluxoCSV,
+                                 0, 1, qtdItensAmostra, qtdItensAlvo,
+                                 qtdPadroesBloco,
+                                 (fonte == 2) ? &embaralhamento : NULL);
+
+      for (int e = 0; e < qtdEpocas; e++)
+      {
+        long qtdPadroesEpoca;
+        erro = FluxoPadroes_treinarEpoca(fluxo, pm, contexto, 0.01,
+                                         &qtdPadroesEpoca);
+      }
+      double segs = horaAtualSegs() - inicio;
+
+      /* Dois blocos no hospedeiro e um no dispositivo acelerador. */
+      printf("%s;%ld;%.0f;%.1f;%.2f;%.6f\n", nomesFontes[fonte],
+             3 * bytesPadroes * qtdPadroesBloco,
+             (double) qtdPadroes * qtdEpocas / segs,
+             fluxo->bytesLidos / segs / 1e6, fluxo->segsEsperaLeitura, erro);
+
+      FluxoPadroes_fechar(fluxo);
+    }
+
+    ContextoExecucao_desalocar(contexto);
+  }
+
+  remove("fluxo_amostras.bin");
+  remove("fluxo_alvos.bin");
+  remove("fluxo_amostras.csv");
+  remove("fluxo_alvos.csv");
+}
+
+/**
+ * Benchmark das janelas deslizantes sobre uma série temporal: compara os
+ * padrões materializados (uma cópia de cada janela e objetivo, como ao
+ * carregar as janelas de arquivos CSV) com os padrões que apontam para a
+ * série, medindo a memória, o tempo de criação e a vazão do treinamento.
+ */
+static void benchmarkJanelasSerie()
+{
+  const int tamJanela = 64;
+  const int horizonte = 1;
+  const int qtdPadroes = 16384;
+  const int qtdEpocas = 3;
+  const long tamSerie = qtdPadroes + tamJanela + horizonte - 1;
+  int qtdNeuroniosCamada[] = {32, horizonte};
+  int semente = 12345;
+
+  /* Série senoidal com ruído, normalizada entre 0 e 1. */
+  float * h_serie = malloc(sizeof(float) * tamSerie);
+  for (long t = 0; t < tamSerie; t++)
+  {
+    h_serie[t] = 0.5 + 0.4 * sinf(t * 0.05) +
+                 0.1 * (r4_uniform_01(&semente) - 0.5);
+  }
+
+  printf("padroes;bytes_padroes;segs_criacao;padroes_por_segundo;erro_mse\n");
+
+  for (int views = 0; views <= 1; views++)
+  {
+    PadraoTreinamento * padroes;
+    long bytesPadroes;
+    int qtdPadroesCriados = qtdPadroes;
+
+    double inicio = horaAtualSegs();
+    if (views)
+    {
+      padroes = PadraoTreinamento_criarJanelasSerie(h_serie, tamSerie,
+                                                    tamJanela, horizonte, 1,
+                                                    &qtdPadroesCriados);
+      bytesPadroes = (long) sizeof(float) * tamSerie;
+    }
+    else
+    {
+      padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+      for (int i = 0; i < qtdPadroes; i++)
+      {
+        float * d_amostra;
+        float * d_alvo;
+        cudaMalloc((void **) &d_amostra, sizeof(float) * tamJanela);
+        cudaMalloc((void **) &d_alvo, sizeof(float) * horizonte);
+        cudaMemcpy(d_amostra, h_serie + i, sizeof(float) * tamJanela,
+                   cudaMemcpyHostToDevice);
+        cudaMemcpy(d_alvo, h_serie + i + tamJanela, sizeof(float) * horizonte,
+                   cudaMemcpyHostToDevice);
+
+        padroes[i].d_amostra = d_amostra;
+        padroes[i].d_alvo = d_alvo;
+        padroes[i].tipoAmostra = AmostraDensa;
+        padroes[i].d_indices = NULL;
+        padroes[i].qtdNaoNulos = 0;
+      }
+      bytesPadroes = (long) sizeof(float) * (tamJanela + horizonte) *
+                     qtdPadroes;
+    }
+    double segsCriacao = horaAtualSegs() - inicio;
+
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializar(tamJanela, 2, qtdNeuroniosCamada,
+                                            Sigmoide);
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+    inicio = horaAtualSegs();
+    for (int e = 0; e < qtdEpocas; e++)
+    {
+      for (int p = 0; p < qtdPadroesCriados; p++)
+      {
+        __treinarPadrao(pm, contexto, &padroes[p], 0.1);
+      }
+    }
+    double vazao = (double) qtdPadroesCriados * qtdEpocas /
+                   (horaAtualSegs() - inicio);
+
+    printf("%s;%ld;%.3f;%.0f;%.6f\n", views ? "janelas" : "materializados",
+           bytesPadroes, segsCriacao, vazao,
+           PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                     qtdPadroesCriados));
+
+    ContextoExecucao_desalocar(contexto);
+
+    if (views)
+    {
+      PadraoTreinamento_desalocarJanelasSerie(padroes);
+    }
+    else
+    {
+      for (int i = 0; i < qtdPadroes; i++)
+      {
+        cudaFree((void *) padroes[i].d_amostra);
+        cudaFree((void *) padroes[i].d_alvo);
+      }
+      free(padroes);
+    }
+  }
+
+  free(h_serie);
+}
+
+/**
+ * Benchmark da ordem dos padrões em cada época: compara a ordem do vetor
+ * com os embaralhamentos completo e em blocos (tempo para gerar a ordem,
+ * vazão do treinamento e erro ao final das épocas).
+ */
+static void benchmarkEmbaralhamento()
+{
+  const int qtdItensAmostra = 784;
+  const int qtdItensAlvo = 10;
+  const int qtdPadroes = 16384;
+  const int qtdEpocas = 5;
+  int qtdNeuroniosCamada[] = {64, qtdItensAlvo};
+  const char * nomesModos[] = {"desativado", "completo", "blocos"};
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(qtdItensAmostra,
+                                                       qtdItensAlvo,
+                                                       qtdPadroes);
+  int * ordem = malloc(sizeof(int) * qtdPadroes);
+
+  printf("modo;segs_ordem_epoca;padroes_por_segundo;erro_mse\n");
+
+  for (int modo = EmbaralhamentoDesativado; modo <= EmbaralhamentoBlocos;
+       modo++)
+  {
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializar(qtdItensAmostra, 2,
+                                            qtdNeuroniosCamada, Sigmoide);
+    PerceptronMulticamadas_definirEmbaralhamento(pm, modo, 1024,
+                                                 SEMENTE_EMBARALHAMENTO);
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+    double segsOrdem = 0;
+    double inicio = horaAtualSegs();
+    for (int e = 0; e < qtdEpocas; e++)
+    {
+      double inicioOrdem = horaAtualSegs();
+      ConfigEmbaralhamento_ordenarEpoca(&pm->embaralhamento, ordem,
+                                        qtdPadroes, e);
+      segsOrdem += horaAtualSegs() - inicioOrdem;
+
+      for (int p = 0; p < qtdPadroes; p++)
+      {
+        __treinarPadrao(pm, contexto, &padroes[ordem[p]], 0.01);
+      }
+    }
+    double vazao = (double) qtdPadroes * qtdEpocas /
+                   (horaAtualSegs() - inicio);
+
+    printf("%s;%.6f;%.0f;%.6f\n", nomesModos[modo], segsOrdem / qtdEpocas,
+           vazao, PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                            qtdPadroes));
+
+    ContextoExecucao_desalocar(contexto);
+  }
+
+  free(ordem);
+  free(padroes);
+}
+
+/**
+ * Método que desaloca as camadas de uma rede de uma única camada (os
+ * benchmarks de inicialização alocam redes grandes repetidas vezes).
+ */
+static void desalocarRedeCamadaUnica(PerceptronMulticamadas * pm)
+{
+  Camada * camada = (Camada *) pm->camadas[0];
+  cudaFree(camada->d_W);
+  cudaFree(camada->d_bias);
+  free(camada);
+  free(pm->camadas);
+  free(pm);
+}
+
+/**
+ * Benchmark da inicialização dos pesos: mede o tempo para gerar os pesos de
+ * camadas cada vez maiores e verifica se duas inicializações com a mesma
+ * semente resultam nos mesmos pesos.
+ */
+static void benchmarkInicializacao()
+{
+  const int tamanhos[] = {1024, 4096, 16384};
+  const long qtdPesosComparados = 1 << 20;
+  float * h_pesosA = malloc(sizeof(float) * qtdPesosComparados);
+  float * h_pesosB = malloc(sizeof(float) * qtdPesosComparados);
+
+  printf("qtd_pesos;segs_inicializacao;pesos_por_segundo;reproduzivel\n");
+
+  for (int t = 0; t < 3; t++)
+  {
+    int qtdNeuroniosCamada[] = {tamanhos[t]};
+    long qtdPesos = (long) tamanhos[t] * tamanhos[t];
+    long qtdComparar = qtdPesos < qtdPesosComparados ? qtdPesos :
+                       qtdPesosComparados;
+
+    double inicio = horaAtualSegs();
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializarSemente(tamanhos[t], 1,
+                                                   qtdNeuroniosCamada,
+                                                   Sigmoide, SEMENTE_PESOS);
+    double segs = horaAtualSegs() - inicio;
+
+    cudaMemcpy(h_pesosA, pm->camadas[0]->d_W, sizeof(float) * qtdComparar,
+               cudaMemcpyDeviceToHost);
+    desalocarRedeCamadaUnica(pm);
+
+    pm = PerceptronMulticamadas_inicializarSemente(tamanhos[t], 1,
+                                                   qtdNeuroniosCamada,
+                                                   Sigmoide, SEMENTE_PESOS);
+    cudaMemcpy(h_pesosB, pm->camadas[0]->d_W, sizeof(float) * qtdComparar,
+               cudaMemcpyDeviceToHost);
+    desalocarRedeCamadaUnica(pm);
+
+    bool reproduzivel = memcmp(h_pesosA, h_pesosB,
+                               sizeof(float) * qtdComparar) == 0;
+
+    printf("%ld;%.6f;%.0f;%s\n", qtdPesos, segs, qtdPesos / segs,
+           reproduzivel ? "sim" : "nao");
+  }
+
+  free(h_pesosA);
+  free(h_pesosB);
+}
+
+/**
+ * Benchmark dos esquemas de inicialização: mede a quantidade de épocas (e o
+ * tempo) até que uma rede larga atinja o erro desejado com cada esquema.
+ */
+static void benchmarkEsquemasInicializacao()
+{
+  const int qtdItensAmostra = 784;
+  const int qtdItensAlvo = 10;
+  const int qtdPadroes = 2048;
+  const int qtdMaxEpocas = 200;
+  const float erroDesejado = 0.001;
+  int qtdNeuroniosCamada[] = {512, 512, qtdItensAlvo};
+  const char * nomesEsquemas[] = {"padrao", "xavier_uniforme",
+                                  "xavier_normal", "he_uniforme",
+                                  "he_normal"};
+  ConfigInicializacao configs[5][3];
+
+  for (int c = 0; c < 3; c++)
+  {
+    configs[0][c] = ConfigInicializacao_padrao();
+    configs[1][c] = ConfigInicializacao_recomendada(Sigmoide);
+    configs[2][c] = configs[1][c];
+    configs[2][c].esquema = InicializacaoXavierNormal;
+    configs[3][c] = configs[1][c];
+    configs[3][c].esquema = InicializacaoHeUniforme;
+    configs[4][c] = configs[1][c];
+    configs[4][c].esquema = InicializacaoHeNormal;
+  }
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(qtdItensAmostra,
+                                                       qtdItensAlvo,
+                                                       qtdPadroes);
+
+  printf("esquema;epocas;segs;erro_mse\n");
+
+  for (int e = 0; e < 5; e++)
+  {
+    PerceptronMulticamadas * pm;
+    pm = PerceptronMulticamadas_inicializarConfig(qtdItensAmostra, 3,
+                                                  qtdNeuroniosCamada,
+                                                  Sigmoide, configs[e],
+                                                  SEMENTE_PESOS);
+    ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+    int epocas = 0;
+    float erro = PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                           qtdPadroes);
+    double inicio = horaAtualSegs();
+    while (erro > erroDesejado && epocas < qtdMaxEpocas)
+    {
+      for (int p = 0; p < qtdPadroes; p++)
+      {
+        __treinarPadrao(pm, contexto, &padroes[p], 0.1);
+      }
+
+      erro = PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                       qtdPadroes);
+      epocas++;
+    }
+
+    printf("%s;%d;%.3f;%.6f\n", nomesEsquemas[e], epocas,
+           horaAtualSegs() - inicio, erro);
+
+    ContextoExecucao_desalocar(contexto);
+  }
+
+  free(padroes);
+}
+
+/**
+ * Método que treina uma rede com um otimizador até que a mesma atinja o
+ * erro desejado (ou a quantidade máxima de épocas) e imprime a quantidade
+ * de épocas e o tempo de treinamento.
+ */
+static void medirOtimizador(const char * nomeProblema,
+                            const char * nomeOtimizador,
+                            PadraoTreinamento * padroes,
+                            int qtdPadroes,
+                            int qtdNeuroniosEntrada,
+                            int qtdCamadas,
+                            int * qtdNeuroniosCamada,
+                            const ConfigInicializacao * configs,
+                            int tipoOtimizador,
+                            float taxaAprendizagem,
+                            float erroDesejado,
+                            int qtdMaxEpocas)
+{
+  PerceptronMulticamadas * pm;
+  pm = PerceptronMulticamadas_inicializarConfig(qtdNeuroniosEntrada,
+                                                qtdCamadas,
+                                                qtdNeuroniosCamada,
+                                                Sigmoide, configs,
+                                                SEMENTE_PESOS);
+  ParametrosOtimizador otimizador = ParametrosOtimizador_padrao(
+                                      tipoOtimizador);
+  PerceptronMulticamadas_definirOtimizador(pm, &otimizador);
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+  int epocas = 0;
+  float erro = PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                         qtdPadroes);
+  double inicio = horaAtualSegs();
+  while (erro > erroDesejado && epocas < qtdMaxEpocas)
+  {
+    for (int p = 0; p < qtdPadroes; p++)
+    {
+      __treinarPadrao(pm, contexto, &padroes[p], taxaAprendizagem);
+    }
+
+    erro = PerceptronMulticamadas_calcularTaxaAcerto(pm, padroes,
+                                                     qtdPadroes);
+    epocas++;
+  }
+
+  printf("%s;%s;%g;%d;%.3f;%.6f\n", nomeProblema, nomeOtimizador,
+         taxaAprendizagem, epocas, horaAtualSegs() - inicio, erro);
+
+  ContextoExecucao_desalocar(contexto);
+}
+
+/**
+ * Benchmark dos otimizadores: mede a quantidade de épocas e o tempo até
+ * que a rede atinja o erro desejado com cada otimizador (partindo dos
+ * mesmos pesos iniciais), no conjunto XOR e em um problema sintético
+ * maior. Cada otimizador utiliza uma taxa de aprendizagem adequada ao
+ * mesmo.
+ */
+static void benchmarkOtimizadores()
+{
+  const char * nomesOtimizadores[] = {"sgd", "momento", "nesterov", "adam",
+                                      "adamw"};
+  const float taxasXOR[] = {1.0, 0.1, 0.1, 0.1, 0.1};
+  const float taxasSintetico[] = {0.005, 0.005, 0.005, 0.0003, 0.0003};
+
+  printf("problema;otimizador;taxa;epocas;segs;erro_mse\n");
+
+  /* Conjunto XOR (executar a partir do diretório do projeto). */
+  PadraoTreinamento * padroesXOR =
+    PadraoTreinamento_carregarPadroesArquivo("./arquivo-amostras-xor.csv",
+                                             "./arquivo-objetivos-xor.csv",
+                                             0, 1, 2, 1, 4);
+  int qtdNeuroniosXOR[] = {2, 1};
+
+  for (int o = OtimizadorSGD; o <= OtimizadorAdamW; o++)
+  {
+    medirOtimizador("xor", nomesOtimizadores[o], padroesXOR, 4, 2, 2,
+                    qtdNeuroniosXOR, NULL, o, taxasXOR[o], 0.001, 20000);
+  }
+
+  /* Problema sintético com uma rede larga. */
+  const int qtdItensAmostra = 256;
+  const int qtdItensAlvo = 10;
+  const int qtdPadroes = 2048;
+  int qtdNeuroniosCamada[] = {256, 256, qtdItensAlvo};
+  ConfigInicializacao configs[3];
+
+  for (int c = 0; c < 3; c++)
+  {
+    configs[c] = ConfigInicializacao_recomendada(Sigmoide);
+  }
+
+  PadraoTreinamento * padroes = gerarPadroesSinteticos(qtdItensAmostra,
+                                                       qtdItensAlvo,
+                                                       qtdPadroes);
+
+  for (int o = OtimizadorSGD; o <= OtimizadorAdamW; o++)
+  {
+    medirOtimizador("sintetico", nomesOtimizadores[o], padroes, qtdPadroes,
+                    qtdItensAmostra, 3, qtdNeuroniosCamada, configs, o,
+                    taxasSintetico[o], 0.0005, 200);
+  }
+
+  free(padroesXOR);
+  free(padroes);
+}
+
+int main(int argc, char ** argv)
+{
+  if (argc < 2)
+  {
+    printf("Uso: %s <hogwild|lote|latencia|quantizacao|precisao|poda|"
+           "fatoracao|esparsa|embedding|bruta|fluxo|janelas|"
+           "embaralhamento|inicializacao|esquemas_inicializacao|"
+           "otimizadores>\n",
+           argv[0]);
+    return 1;
+  }
+
+  if (strcmp(argv[1], "hogwild") == 0)
+  {
+    benchmarkHogwild();
+  }
+  else if (strcmp(argv[1], "lote") == 0)
+  {
+    benchmarkInferenciaLote();
+  }
+  else if (strcmp(argv[1], "latencia") == 0)
+  {
+    benchmarkLatencia();
+  }
+  else if (strcmp(argv[1], "quantizacao") == 0)
+  {
+    benchmarkQuantizacao();
+  }
+  else if (strcmp(argv[1], "precisao") == 0)
+  {
+    benchmarkPrecisao();
+  }
+  else if (strcmp(argv[1], "poda") == 0)
+  {
+    benchmarkPoda();
+  }
+  else if (strcmp(argv[1], "fatoracao") == 0)
+  {
+    benchmarkFatoracao();
+  }
+  else if (strcmp(argv[1], "esparsa") == 0)
+  {
+    benchmarkEntradaEsparsa();
+  }
+  else if (strcmp(argv[1], "embedding") == 0)
+  {
+    benchmarkEmbedding();
+  }
+  else if (strcmp(argv[1], "bruta") == 0)
+  {
+    benchmarkAmostraBruta();
+  }
+  else if (strcmp(argv[1], "fluxo") == 0)
+  {
+    benchmarkFluxo();
+  }
+  else if (strcmp(argv[1], "janelas") == 0)
+  {
+    benchmarkJanelasSerie();
+  }
+  else if (strcmp(argv[1], "embaralhamento") == 0)
+  {
+    benchmarkEmbaralhamento();
+  }
+  else if (strcmp(argv[1], "inicializacao") == 0)
+  {
+    benchmarkInicializacao();
+  }
+  else if (strcmp(argv[1], "esquemas_inicializacao") == 0)
+  {
+    benchmarkEsquemasInicializacao();
+  }
+  else if (strcmp(argv[1], "otimizadores") == 0)
+  {
+    benchmarkOtimizadores();
+  }
+  else
+  {
+    printf("Benchmark desconhecido: %s\n", argv[1]);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,600 @@
+#include <sys/mman.h>
+#include "checkpoint_treinamento.h"
+#include "historico_treinamento.h"
+
+/**
+ * Método que retorna a hora atual em segundos.
+ */
+static double __horaAtualSegs()
+{
+  struct timeval hora;
+  gettimeofday(&hora, NULL);
+  return hora.tv_sec + hora.tv_usec / 1000000.0;
+}
+
+/**
+ * Método que retorna a quantidade de pesos de uma camada da rede.
+ */
+static size_t __qtdPesosCamada(const PerceptronMulticamadas * pm, int c)
+{
+  int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                    pm->camadas[c - 1]->qtdNeuronios;
+  return (size_t) pm->camadas[c]->qtdNeuronios * qtdPesosNeuronio;
+}
+
+/**
+ * Método que retorna a quantidade de grupos de vetores de estado do
+ * otimizador: um por camada e, caso exista, um da tabela de "embedding".
+ */
+static int __qtdGruposOtimizador(const PerceptronMulticamadas * pm)
+{
+  return pm->qtdCamadas + ((pm->embedding != NULL) ? 1 : 0);
+}
+
+/**
+ * Método que preenche os vetores de estado do otimizador de um grupo (na
+ * ordem do arquivo, NULO caso não seja utilizado) e as suas quantidades de
+ * itens. O grupo da tabela de "embedding" (após as camadas) utiliza apenas
+ * as posições dos pesos.
+ */
+static void __vetoresOtimizador(const PerceptronMulticamadas * pm, int c,
+                                float ** d_vetores, size_t * qtdItens)
+{
+  if (c == pm->qtdCamadas)
+  {
+    const CamadaEmbedding * embedding = pm->embedding;
+
+    d_vetores[0] = embedding->d_velocidadeTabela;
+    d_vetores[1] = NULL;
+    d_vetores[2] = embedding->d_segundoMomentoTabela;
+    d_vetores[3] = NULL;
+
+    qtdItens[0] = (size_t) embedding->qtdCategorias * embedding->dimensao;
+    qtdItens[1] = 0;
+    qtdItens[2] = qtdItens[0];
+    qtdItens[3] = 0;
+    return;
+  }
+
+  const Camada * camada = pm->camadas[c];
+
+  d_vetores[0] = camada->d_velocidadeW;
+  d_vetores[1] = camada->d_velocidadeBias;
+  d_vetores[2] = camada->d_segundoMomentoW;
+  d_vetores[3] = camada->d_segundoMomentoBias;
+
+  qtdItens[0] = __qtdPesosCamada(pm, c);
+  qtdItens[1] = camada->qtdNeuronios;
+  qtdItens[2] = qtdItens[0];
+  qtdItens[3] = qtdItens[1];
+}
+
+/**
+ * Método que retorna o tamanho (em bytes) do estado do otimizador da rede.
+ */
+static uint64_t __tamEstadoOtimizador(const PerceptronMulticamadas * pm)
+{
+  uint64_t tam = 0;
+
+  for (int c = 0; c < __qtdGruposOtimizador(pm); c++)
+  {
+    float * d_vetores[QTD_MAX_VETORES_OTIMIZADOR];
+    size_t qtdItens[QTD_MAX_VETORES_OTIMIZADOR];
+    __vetoresOtimizador(pm, c, d_vetores, qtdItens);
+
+    for (int v = 0; v < QTD_MAX_VETORES_OTIMIZADOR; v++)
+    {
+      tam += (d_vetores[v] != NULL) ? sizeof(float) * qtdItens[v] : 0;
+    }
+  }
+
+  return tam;
+}
+
+/**
+ * Método que retorna o deslocamento alinhado a ALINHAMENTO_BLOCOS_MODELO
+ * bytes.
+ */
+static uint64_t __alinhar(uint64_t deslocamento)
+{
+  return (deslocamento + ALINHAMENTO_BLOCOS_MODELO - 1)
+         / ALINHAMENTO_BLOCOS_MODELO * ALINHAMENTO_BLOCOS_MODELO;
+}
+
+/**
+ * Método que escreve uma captura no arquivo de "checkpoint" (através de um
+ * arquivo temporário que substitui o anterior somente após ter sido
+ * escrito e sincronizado com o disco).
+ */
+static bool __escreverCaptura(CheckpointTreinamento * checkpoint,
+                              const CapturaCheckpoint * captura)
+{
+  char * nomeArquivoTmp = malloc(strlen(checkpoint->nomeArquivo) + 5);
+  sprintf(nomeArquivoTmp, "%s.tmp", checkpoint->nomeArquivo);
+
+  FILE * arquivo = fopen(nomeArquivoTmp, "wb");
+  if (arquivo == NULL)
+  {
+    free(nomeArquivoTmp);
+    return false;
+  }
+
+  CabecalhoCheckpoint cabecalho;
+  memset(&cabecalho, 0, sizeof(CabecalhoCheckpoint));
+  memcpy(cabecalho.assinatura, ASSINATURA_CHECKPOINT,
+         sizeof(cabecalho.assinatura));
+  cabecalho.versao = VERSAO_CHECKPOINT;
+  cabecalho.epoca = captura->epoca;
+  cabecalho.qtdEpocasHistorico = captura->qtdEpocasHistorico;
+  cabecalho.tipoOtimizador = captura->otimizador.tipo;
+  cabecalho.momento = captura->otimizador.momento;
+  cabecalho.beta1 = captura->otimizador.beta1;
+  cabecalho.beta2 = captura->otimizador.beta2;
+  cabecalho.epsilon = captura->otimizador.epsilon;
+  cabecalho.decaimentoPesos = captura->otimizador.decaimentoPesos;
+  cabecalho.passoOtimizador = captura->otimizador.passo;
+
+  /* A imagem do modelo inicia alinhada, para que os blocos da mesma
+     também fiquem alinhados no arquivo. */
+  cabecalho.deslocamentoModelo = __alinhar(sizeof(CabecalhoCheckpoint) +
+                                           sizeof(InfoEpocaTreinamento) *
+                                           captura->qtdEpocasHistorico);
+
+  /* O cabeçalho é escrito novamente ao final, com o tamanho da imagem. */
+  bool sucesso = fwrite(&cabecalho, sizeof(CabecalhoCheckpoint), 1,
+                        arquivo) == 1
+                 && fwrite(captura->historico, sizeof(InfoEpocaTreinamento),
+                           captura->qtdEpocasHistorico, arquivo) ==
+                    (size_t) captura->qtdEpocasHistorico
+                 && fseek(arquivo, cabecalho.deslocamentoModelo,
+                          SEEK_SET) == 0
+                 && ModeloArquivo_escreverImagem(arquivo, checkpoint->pm,
+                                                 captura->h_W,
+                                                 captura->h_bias,
+                                                 captura->h_tabelaEmbedding);
+
+  /* Escrevendo o estado do otimizador após a imagem do modelo. */
+  if (sucesso)
+  {
+    cabecalho.tamModelo = ftell(arquivo) - cabecalho.deslocamentoModelo;
+    cabecalho.tamOtimizador = __tamEstadoOtimizador(checkpoint->pm);
+
+    /* Sem estado (SGD), o bloco vazio fica no final do arquivo, já que o
+       "fseek" não estende o arquivo. */
+    cabecalho.deslocamentoOtimizador = cabecalho.deslocamentoModelo +
+                                       cabecalho.tamModelo;
+    if (cabecalho.tamOtimizador > 0)
+    {
+      cabecalho.deslocamentoOtimizador =
+        __alinhar(cabecalho.deslocamentoOtimizador);
+    }
+    sucesso = fseek(arquivo, cabecalho.deslocamentoOtimizador,
+                    SEEK_SET) == 0;
+  }
+
+  for (int c = 0; sucesso && c < __qtdGruposOtimizador(checkpoint->pm); c++)
+  {
+    float * d_vetores[QTD_MAX_VETORES_OTIMIZADOR];
+    size_t qtdItens[QTD_MAX_VETORES_OTIMIZADOR];
+    __vetoresOtimizador(checkpoint->pm, c, d_vetores, qtdItens);
+
+    for (int v = 0; sucesso && v < QTD_MAX_VETORES_OTIMIZADOR; v++)
+    {
+      const float * h_vetor;
+      h_vetor = captura->h_estadoOtimizador[c * QTD_MAX_VETORES_OTIMIZADOR
+                                            + v];
+      sucesso = h_vetor == NULL
+                || fwrite(h_vetor, sizeof(float), qtdItens[v], arquivo) ==
+                   qtdItens[v];
+    }
+  }
+
+  if (sucesso)
+  {
+    sucesso = fseek(arquivo, 0, SEEK_SET) == 0
+              && fwrite(&cabecalho, sizeof(CabecalhoCheckpoint), 1,
+                        arquivo) == 1
+              && fflush(arquivo) == 0
+              && fsync(fileno(arquivo)) == 0;
+  }
+
+  sucesso = (fclose(arquivo) == 0) && sucesso;
+  sucesso = sucesso && rename(nomeArquivoTmp, checkpoint->nomeArquivo) == 0;
+
+  if (!sucesso)
+  {
+    remove(nomeArquivoTmp);
+  }
+
+  free(nomeArquivoTmp);
+
+  return sucesso;
+}
+
+/**
+ * Método executado pela thread que escreve as capturas pendentes.
+ */
+static void * __executarThreadEscrita(void * args)
+{
+  CheckpointTreinamento * checkpoint = (CheckpointTreinamento *) args;
+
+  pthread_mutex_lock(&checkpoint->mutex);
+
+  while (true)
+  {
+    while (checkpoint->capturaPendente < 0 && !checkpoint->encerrar)
+    {
+      pthread_cond_wait(&checkpoint->cond, &checkpoint->mutex);
+    }
+
+    /* Só encerra após escrever a última captura pendente. */
+    if (checkpoint->capturaPendente < 0)
+    {
+      break;
+    }
+
+    int c = checkpoint->capturaPendente;
+    checkpoint->capturaPendente = -1;
+    checkpoint->capturaEscrita = c;
+    pthread_mutex_unlock(&checkpoint->mutex);
+
+    bool sucesso = __escreverCaptura(checkpoint, &checkpoint->capturas[c]);
+
+    pthread_mutex_lock(&checkpoint->mutex);
+    checkpoint->capturaEscrita = -1;
+    if (sucesso)
+    {
+      checkpoint->qtdCheckpointsEscritos++;
+    }
+    else
+    {
+      fprintf(stderr, "Não foi possível escrever o checkpoint %s.\n",
+              checkpoint->nomeArquivo);
+    }
+  }
+
+  pthread_mutex_unlock(&checkpoint->mutex);
+
+  return NULL;
+}
+
+CheckpointTreinamento *
+CheckpointTreinamento_iniciar(const PerceptronMulticamadas * pm,
+                              const ConfigCheckpoint * config,
+                              int epocaInicial)
+{
+  CheckpointTreinamento * checkpoint = malloc(sizeof(CheckpointTreinamento));
+
+  checkpoint->pm = pm;
+  checkpoint->config = *config;
+  checkpoint->nomeArquivo = strdup(config->nomeArquivo);
+  checkpoint->config.nomeArquivo = checkpoint->nomeArquivo;
+
+  /* Alocando os "buffers" duplos (na "pinned memory"). */
+  for (int b = 0; b < 2; b++)
+  {
+    CapturaCheckpoint * captura = &checkpoint->capturas[b];
+    captura->h_W = malloc(sizeof(float *) * pm->qtdCamadas);
+    captura->h_bias = malloc(sizeof(float *) * pm->qtdCamadas);
+
+    for (int c = 0; c < pm->qtdCamadas; c++)
+    {
+      cudaMallocHost((void **) &captura->h_W[c],
+                     sizeof(float) * __qtdPesosCamada(pm, c));
+      cudaMallocHost((void **) &captura->h_bias[c],
+                     sizeof(float) * pm->camadas[c]->qtdNeuronios);
+    }
+
+    captura->h_tabelaEmbedding = NULL;
+    if (pm->embedding != NULL)
+    {
+      cudaMallocHost((void **) &captura->h_tabelaEmbedding,
+                     sizeof(float) * pm->embedding->qtdCategorias *
+                     pm->embedding->dimensao);
+    }
+
+    /* Apenas os vetores utilizados pelo otimizador da rede. */
+    captura->h_estadoOtimizador = malloc(sizeof(float *) *
+                                         __qtdGruposOtimizador(pm) *
+                                         QTD_MAX_VETORES_OTIMIZADOR);
+
+    for (int c = 0; c < __qtdGruposOtimizador(pm); c++)
+    {
+      float * d_vetores[QTD_MAX_VETORES_OTIMIZADOR];
+      size_t qtdItens[QTD_MAX_VETORES_OTIMIZADOR];
+      __vetoresOtimizador(pm, c, d_vetores, qtdItens);
+
+      for (int v = 0; v < QTD_MAX_VETORES_OTIMIZADOR; v++)
+      {
+        float ** h_vetor;
+        h_vetor = &captura->h_estadoOtimizador[c * QTD_MAX_VETORES_OTIMIZADOR
+                                               + v];
+        *h_vetor = NULL;
+        if (d_vetores[v] != NULL)
+        {
+          cudaMallocHost((void **) h_vetor, sizeof(float) * qtdItens[v]);
+        }
+      }
+    }
+
+    captura->epoca = 0;
+    captura->historico = NULL;
+    captura->qtdEpocasHistorico = 0;
+    captura->capacidadeHistorico = 0;
+  }
+
+  checkpoint->capturaEscrita = -1;
+  checkpoint->capturaPendente = -1;
+  checkpoint->epocaUltimaCaptura = epocaInicial;
+  checkpoint->horaUltimaCaptura = __horaAtualSegs();
+  checkpoint->qtdCheckpointsEscritos = 0;
+  checkpoint->qtdCapturasDescartadas = 0;
+  checkpoint->encerrar = false;
+
+  pthread_mutex_init(&checkpoint->mutex, NULL);
+  pthread_cond_init(&checkpoint->cond, NULL);
+  pthread_create(&checkpoint->threadEscrita, NULL, __executarThreadEscrita,
+                 checkpoint);
+
+  return checkpoint;
+}
+
+void CheckpointTreinamento_verificar(CheckpointTreinamento * checkpoint,
+                                     int epoca,
+                                     const HistoricoTreinamento * historico)
+{
+  bool intervaloEpocasAtingido = checkpoint->config.intervaloEpocas > 0
+    && epoca - checkpoint->epocaUltimaCaptura >=
+       checkpoint->config.intervaloEpocas;
+
+  bool intervaloTempoAtingido = checkpoint->config.intervaloSegs > 0
+    && __horaAtualSegs() - checkpoint->horaUltimaCaptura >=
+       checkpoint->config.intervaloSegs;
+
+  if (intervaloEpocasAtingido || intervaloTempoAtingido)
+  {
+    CheckpointTreinamento_capturar(checkpoint, epoca, historico);
+  }
+}
+
+void CheckpointTreinamento_capturar(CheckpointTreinamento * checkpoint,
+                                    int epoca,
+                                    const HistoricoTreinamento * historico)
+{
+  const PerceptronMulticamadas * pm = checkpoint->pm;
+
+  /* Escolhendo o "buffer" que não está sendo escrito. Caso o mesmo ainda
+     esteja pendente (a escrita anterior ainda não terminou), a captura
+     pendente é descartada, pois esta será mais recente. */
+  pthread_mutex_lock(&checkpoint->mutex);
+  int b = (checkpoint->capturaEscrita == 0) ? 1 : 0;
+  if (checkpoint->capturaPendente == b)
+  {
+    checkpoint->capturaPendente = -1;
+    checkpoint->qtdCapturasDescartadas++;
+  }
+  pthread_mutex_unlock(&checkpoint->mutex);
+
+  CapturaCheckpoint * captura = &checkpoint->capturas[b];
+
+  /* Copiando os pesos e os bias do dispositivo acelerador (única parte da
+     captura que ocupa a thread do treinamento). */
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+    Camada_copiarPesosHospedeiro(pm->camadas[c], qtdPesosNeuronio,
+                                 captura->h_W[c]);
+    cudaMemcpy(captura->h_bias[c], pm->camadas[c]->d_bias,
+               sizeof(float) * pm->camadas[c]->qtdNeuronios,
+               cudaMemcpyDeviceToHost);
+  }
+
+  if (pm->embedding != NULL)
+  {
+    cudaMemcpy(captura->h_tabelaEmbedding, pm->embedding->d_tabela,
+               sizeof(float) * pm->embedding->qtdCategorias *
+               pm->embedding->dimensao, cudaMemcpyDeviceToHost);
+  }
+
+  /* Copiando os vetores de estado do otimizador. */
+  for (int c = 0; c < __qtdGruposOtimizador(pm); c++)
+  {
+    float * d_vetores[QTD_MAX_VETORES_OTIMIZADOR];
+    size_t qtdItens[QTD_MAX_VETORES_OTIMIZADOR];
+    __vetoresOtimizador(pm, c, d_vetores, qtdItens);
+
+    for (int v = 0; v < QTD_MAX_VETORES_OTIMIZADOR; v++)
+    {
+      float * h_vetor;
+      h_vetor = captura->h_estadoOtimizador[c * QTD_MAX_VETORES_OTIMIZADOR
+                                            + v];
+      if (h_vetor != NULL)
+      {
+        cudaMemcpy(h_vetor, d_vetores[v], sizeof(float) * qtdItens[v],
+                   cudaMemcpyDeviceToHost);
+      }
+    }
+  }
+
+  /* O passo é lido junto com os vetores, ao final da época. */
+  captura->otimizador = pm->otimizador;
+
+  /* Copiando o histórico (a lista continua sendo alterada pelo
+     treinamento enquanto a captura é escrita). */
+  captura->epoca = epoca;
+  captura->qtdEpocasHistorico = 0;
+
+  struct ListaNo * no = (historico != NULL) ? historico->listaEpocas : NULL;
+  for (; no != NULL; no = no->proxNo)
+  {
+    if (captura->qtdEpocasHistorico == captura->capacidadeHistorico)
+    {
+      captura->capacidadeHistorico = (captura->capacidadeHistorico == 0) ?
+                                     64 : captura->capacidadeHistorico * 2;
+      captura->historico = realloc(captura->historico,
+                                   sizeof(InfoEpocaTreinamento) *
+                                   captura->capacidadeHistorico);
+    }
+
+    captura->historico[captura->qtdEpocasHistorico++] = no->dado;
+  }
+
+  checkpoint->epocaUltimaCaptura = epoca;
+  checkpoint->horaUltimaCaptura = __horaAtualSegs();
+
+  /* Entregando a captura para a thread de escrita. */
+  pthread_mutex_lock(&checkpoint->mutex);
+  checkpoint->capturaPendente = b;
+  pthread_cond_signal(&checkpoint->cond);
+  pthread_mutex_unlock(&checkpoint->mutex);
+}
+
+void CheckpointTreinamento_encerrar(CheckpointTreinamento * checkpoint)
+{
+  pthread_mutex_lock(&checkpoint->mutex);
+  checkpoint->encerrar = true;
+  pthread_cond_signal(&checkpoint->cond);
+  pthread_mutex_unlock(&checkpoint->mutex);
+
+  pthread_join(checkpoint->threadEscrita, NULL);
+
+  if (INFO_ESTATISTICAS)
+  {
+    printf("Checkpoints escritos: %d (capturas descartadas: %d)\n",
+           checkpoint->qtdCheckpointsEscritos,
+           checkpoint->qtdCapturasDescartadas);
+  }
+
+  for (int b = 0; b < 2; b++)
+  {
+    CapturaCheckpoint * captura = &checkpoint->capturas[b];
+    for (int c = 0; c < checkpoint->pm->qtdCamadas; c++)
+    {
+      cudaFreeHost(captura->h_W[c]);
+      cudaFreeHost(captura->h_bias[c]);
+    }
+    for (int v = 0; v < __qtdGruposOtimizador(checkpoint->pm) *
+                        QTD_MAX_VETORES_OTIMIZADOR; v++)
+    {
+      cudaFreeHost(captura->h_estadoOtimizador[v]);
+    }
+    cudaFreeHost(captura->h_tabelaEmbedding);
+    free(captura->h_W);
+    free(captura->h_bias);
+    free(captura->h_estadoOtimizador);
+    free(captura->historico);
+  }
+
+  pthread_mutex_destroy(&checkpoint->mutex);
+  pthread_cond_destroy(&checkpoint->cond);
+  free(checkpoint->nomeArquivo);
+  free(checkpoint);
+}
+
+bool CheckpointTreinamento_retomar(const char * nomeArquivo,
+                                   PerceptronMulticamadas * pm,
+                                   int * epoca,
+                                   HistoricoTreinamento * historico)
+{
+  uint64_t tamArquivo;
+  const char * h_checkpoint = ModeloArquivo_mapear(nomeArquivo, &tamArquivo);
+  if (h_checkpoint == NULL)
+  {
+    return false;
+  }
+
+  const CabecalhoCheckpoint * cabecalho;
+  cabecalho = (const CabecalhoCheckpoint *) h_checkpoint;
+
+  bool cabecalhoValido = tamArquivo >= sizeof(CabecalhoCheckpoint)
+    && memcmp(cabecalho->assinatura, ASSINATURA_CHECKPOINT,
+              sizeof(cabecalho->assinatura)) == 0;
+
+  /* Os "checkpoints" de outras versões não possuem o mesmo layout (os da
+     versão 1 não possuem o estado do otimizador). */
+  if (cabecalhoValido && cabecalho->versao != VERSAO_CHECKPOINT)
+  {
+    fprintf(stderr, "O checkpoint %s é da versão %u (esperada: %u).\n",
+            nomeArquivo, cabecalho->versao, VERSAO_CHECKPOINT);
+    cabecalhoValido = false;
+  }
+
+  /* O estado do otimizador só pode ser restaurado no mesmo otimizador. */
+  if (cabecalhoValido && cabecalho->tipoOtimizador != pm->otimizador.tipo)
+  {
+    fprintf(stderr, "O checkpoint %s é de outro otimizador.\n", nomeArquivo);
+    cabecalhoValido = false;
+  }
+
+  /* Verificando se o histórico, a imagem do modelo e o estado do
+     otimizador estão contidos no arquivo (os vetores de estado já foram
+     alocados por "PerceptronMulticamadas_definirOtimizador") e copiando os
+     parâmetros (a imagem é verificada e comparada com a topologia da
+     rede). */
+  bool sucesso = cabecalhoValido
+    && cabecalho->qtdEpocasHistorico <= (tamArquivo -
+                                         sizeof(CabecalhoCheckpoint)) /
+                                        sizeof(InfoEpocaTreinamento)
+    && cabecalho->deslocamentoModelo <= tamArquivo
+    && cabecalho->tamModelo <= tamArquivo - cabecalho->deslocamentoModelo
+    && cabecalho->deslocamentoOtimizador >= cabecalho->deslocamentoModelo +
+                                            cabecalho->tamModelo
+    && cabecalho->deslocamentoOtimizador <= tamArquivo
+    && cabecalho->tamOtimizador == tamArquivo -
+                                   cabecalho->deslocamentoOtimizador
+    && cabecalho->tamOtimizador == __tamEstadoOtimizador(pm)
+    && ModeloArquivo_copiarParametros(pm, h_checkpoint +
+                                      cabecalho->deslocamentoModelo,
+                                      cabecalho->tamModelo);
+
+  if (sucesso)
+  {
+    /* Copiando os vetores de estado e o passo do otimizador. */
+    const char * h_estado = h_checkpoint + cabecalho->deslocamentoOtimizador;
+
+    for (int c = 0; c < __qtdGruposOtimizador(pm); c++)
+    {
+      float * d_vetores[QTD_MAX_VETORES_OTIMIZADOR];
+      size_t qtdItens[QTD_MAX_VETORES_OTIMIZADOR];
+      __vetoresOtimizador(pm, c, d_vetores, qtdItens);
+
+      for (int v = 0; v < QTD_MAX_VETORES_OTIMIZADOR; v++)
+      {
+        if (d_vetores[v] != NULL)
+        {
+          cudaMemcpy(d_vetores[v], h_estado, sizeof(float) * qtdItens[v],
+                     cudaMemcpyHostToDevice);
+          h_estado += sizeof(float) * qtdItens[v];
+        }
+      }
+    }
+
+    pm->otimizador.momento = cabecalho->momento;
+    pm->otimizador.beta1 = cabecalho->beta1;
+    pm->otimizador.beta2 = cabecalho->beta2;
+    pm->otimizador.epsilon = cabecalho->epsilon;
+    pm->otimizador.decaimentoPesos = cabecalho->decaimentoPesos;
+    pm->otimizador.passo = cabecalho->passoOtimizador;
+
+    *epoca = cabecalho->epoca;
+
+    if (historico != NULL)
+    {
+      const InfoEpocaTreinamento * epocas;
+      epocas = (const InfoEpocaTreinamento *) (h_checkpoint +
+                                               sizeof(CabecalhoCheckpoint));
+
+      for (uint32_t e = 0; e < cabecalho->qtdEpocasHistorico; e++)
+      {
+        HistoricoTreinamento_adicionarInfoEpoca(historico,
+                                                epocas[e].duracaoSegs,
+                                                epocas[e].erroGlobal);
+      }
+    }
+  }
+
+  munmap((void *) h_checkpoint, tamArquivo);
+
+  return sucesso;
+}
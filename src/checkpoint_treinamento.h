@@ -0,0 +1,239 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * "Checkpoints" periódicos do treinamento, escritos no disco por uma       *
+ * thread em segundo plano a partir de "buffers" duplos do hospedeiro.      *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef CHECKPOINT_TREINAMENTO_H
+#define CHECKPOINT_TREINAMENTO_H
+
+#include <stdint.h>
+#include "perceptron_multicamadas.h"
+#include "modelo_arquivo.h"
+
+/***************************************************************************
+ * Layout do arquivo de "checkpoint":                                      *
+ *                                                                         *
+ *   CabecalhoCheckpoint                                                   *
+ *   InfoEpocaTreinamento historico[qtdEpocasHistorico]                    *
+ *   (alinhada a ALINHAMENTO_BLOCOS_MODELO bytes)                          *
+ *   imagem do modelo (mesmo formato de "modelo_arquivo.h")                *
+ *   (alinhado a ALINHAMENTO_BLOCOS_MODELO bytes)                          *
+ *   estado do otimizador: para cada camada, os vetores utilizados pelo    *
+ *   otimizador do cabeçalho, na ordem velocidadeW, velocidadeBias,        *
+ *   segundoMomentoW e segundoMomentoBias, seguidos de velocidadeTabela e  *
+ *   segundoMomentoTabela da camada de "embedding" (vazio no SGD)          *
+ ***************************************************************************/
+
+/* Assinatura ("magic") do arquivo de "checkpoint". */
+#define ASSINATURA_CHECKPOINT "PMCCHKPT"
+
+/* Quantidade máxima de vetores de estado do otimizador por camada. */
+#define QTD_MAX_VETORES_OTIMIZADOR 4
+
+/* Versão atual do formato do "checkpoint". */
+#define VERSAO_CHECKPOINT 2
+
+/**
+ * Estrutura do cabeçalho do arquivo de "checkpoint".
+ */
+typedef struct
+{
+  /** Assinatura do arquivo (ASSINATURA_CHECKPOINT, sem o '\0'). */
+  char assinatura[8];
+
+  /** Versão do formato (VERSAO_CHECKPOINT). */
+  uint32_t versao;
+
+  /** Quantidade de épocas já treinadas. */
+  uint32_t epoca;
+
+  /** Quantidade de épocas salvas no histórico (0 caso o treinamento não
+  esteja gerando o histórico). */
+  uint32_t qtdEpocasHistorico;
+
+  /** Reservado (mantém o alinhamento dos deslocamentos). */
+  uint32_t reservado;
+
+  /** Deslocamento (em bytes) da imagem do modelo. */
+  uint64_t deslocamentoModelo;
+
+  /** Tamanho (em bytes) da imagem do modelo. */
+  uint64_t tamModelo;
+
+  /** Otimizador do treinamento (usar a enumeração "OtimizadoresEnum") e os
+  seus parâmetros. */
+  int32_t tipoOtimizador;
+  float momento;
+  float beta1;
+  float beta2;
+  float epsilon;
+  float decaimentoPesos;
+
+  /** Quantidade de atualizações já realizadas pelo otimizador. */
+  uint64_t passoOtimizador;
+
+  /** Deslocamento e tamanho (em bytes) do estado do otimizador. */
+  uint64_t deslocamentoOtimizador;
+  uint64_t tamOtimizador;
+
+} CabecalhoCheckpoint;
+
+/**
+ * Estrutura com uma cópia (no hospedeiro) do estado do treinamento.
+ */
+typedef struct
+{
+  /** Pesos e bias de cada camada ("pinned memory", para que a cópia do
+  dispositivo acelerador seja feita por DMA). */
+  float ** h_W;
+  float ** h_bias;
+
+  /** Tabela da camada de "embedding" (NULO caso a rede não possua a
+  camada). */
+  float * h_tabelaEmbedding;
+
+  /** Parâmetros do otimizador e os seus vetores de estado de cada camada e
+  da tabela de "embedding" (QTD_MAX_VETORES_OTIMIZADOR por grupo, NULO caso
+  o otimizador não utilize o vetor). */
+  ParametrosOtimizador otimizador;
+  float ** h_estadoOtimizador;
+
+  /** Quantidade de épocas já treinadas. */
+  int epoca;
+
+  /** Cópia do histórico das épocas. */
+  InfoEpocaTreinamento * historico;
+  int qtdEpocasHistorico;
+  int capacidadeHistorico;
+
+} CapturaCheckpoint;
+
+/**
+ * Estrutura que controla os "checkpoints" de um treinamento.
+ *
+ * A thread do treinamento copia o estado para a captura que não está sendo
+ * escrita (substituindo uma captura ainda pendente, que ficou desatualizada)
+ * e a thread de escrita grava a captura pendente no disco.
+ */
+typedef struct
+{
+  /** Rede sendo treinada. */
+  const PerceptronMulticamadas * pm;
+
+  /** Configuração dos "checkpoints" e cópia do nome do arquivo. */
+  ConfigCheckpoint config;
+  char * nomeArquivo;
+
+  /** "Buffers" duplos com as capturas. */
+  CapturaCheckpoint capturas[2];
+
+  /** Captura sendo escrita e captura aguardando a escrita (-1 caso não
+  haja nenhuma), protegidas por "mutex". */
+  int capturaEscrita;
+  int capturaPendente;
+
+  /** Época e hora (em segundos) da última captura. */
+  int epocaUltimaCaptura;
+  double horaUltimaCaptura;
+
+  /** Quantidade de "checkpoints" escritos e de capturas substituídas antes
+  de serem escritas (o disco está mais lento que o intervalo). */
+  int qtdCheckpointsEscritos;
+  int qtdCapturasDescartadas;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_t threadEscrita;
+
+  /** Se a thread de escrita deve ser encerrada (após escrever a captura
+  pendente). */
+  bool encerrar;
+
+} CheckpointTreinamento;
+
+/**
+ * Método que aloca os "buffers" duplos e inicia a thread de escrita dos
+ * "checkpoints".
+ *
+ * @param pm Rede sendo treinada.
+ *
+ * @param config Configuração dos "checkpoints".
+ *
+ * @param epocaInicial Época a partir da qual o treinamento inicia (maior
+ *                     que 0 quando o treinamento é retomado).
+ *
+ * @return Referência para a estrutura alocada.
+ */
+CheckpointTreinamento *
+CheckpointTreinamento_iniciar(const PerceptronMulticamadas * pm,
+                              const ConfigCheckpoint * config,
+                              int epocaInicial);
+
+/**
+ * Método que realiza uma captura caso o intervalo de épocas ou de tempo da
+ * configuração tenha sido atingido (chamado ao final de cada época).
+ *
+ * @param checkpoint Estrutura dos "checkpoints".
+ *
+ * @param epoca Quantidade de épocas já treinadas.
+ *
+ * @param historico Histórico do treinamento (pode ser NULO).
+ */
+void CheckpointTreinamento_verificar(CheckpointTreinamento * checkpoint,
+                                     int epoca,
+                                     const HistoricoTreinamento * historico);
+
+/**
+ * Método que copia o estado atual do treinamento para um dos "buffers" e
+ * o entrega à thread de escrita (retorna sem aguardar a escrita).
+ *
+ * @param checkpoint Estrutura dos "checkpoints".
+ *
+ * @param epoca Quantidade de épocas já treinadas.
+ *
+ * @param historico Histórico do treinamento (pode ser NULO).
+ */
+void CheckpointTreinamento_capturar(CheckpointTreinamento * checkpoint,
+                                    int epoca,
+                                    const HistoricoTreinamento * historico);
+
+/**
+ * Método que aguarda a escrita da captura pendente, encerra a thread de
+ * escrita e desaloca a estrutura.
+ *
+ * @param checkpoint Estrutura dos "checkpoints".
+ */
+void CheckpointTreinamento_encerrar(CheckpointTreinamento * checkpoint);
+
+/**
+ * Método que restaura o estado de um treinamento a partir de um arquivo de
+ * "checkpoint": pesos, bias e tabela de "embedding" (a rede deve possuir a
+ * mesma topologia),
+ * parâmetros, passo e vetores de estado do otimizador (o otimizador da
+ * rede deve ser do mesmo tipo), contador de épocas e histórico.
+ *
+ * @param nomeArquivo Nome do arquivo de "checkpoint".
+ *
+ * @param pm Rede que irá receber os pesos e os bias.
+ *
+ * @param epoca Variável onde será armazenada a quantidade de épocas já
+ *              treinadas.
+ *
+ * @param historico Histórico que irá receber as épocas salvas (pode ser
+ *                  NULO).
+ *
+ * @return Verdadeiro caso o treinamento tenha sido restaurado, ou falso
+ *         caso o arquivo não exista, seja inválido, de outra versão, de
+ *         outra topologia ou de outro otimizador.
+ */
+bool CheckpointTreinamento_retomar(const char * nomeArquivo,
+                                   PerceptronMulticamadas * pm,
+                                   int * epoca,
+                                   HistoricoTreinamento * historico);
+
+#endif
@@ -0,0 +1,304 @@
+#include <ctype.h>
+#include "exportacao_c.h"
+
+/* Quantidade de valores por linha nos vetores gerados. */
+#define QTD_VALORES_LINHA 6
+
+/**
+ * Método que verifica se o prefixo é um identificador C válido.
+ */
+static bool __identificadorValido(const char * prefixo)
+{
+  if (prefixo[0] == '\0' || !(isalpha((unsigned char) prefixo[0]) ||
+                              prefixo[0] == '_'))
+  {
+    return false;
+  }
+
+  for (const char * c = prefixo; *c != '\0'; c++)
+  {
+    if (!(isalnum((unsigned char) *c) || *c == '_'))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Método que escreve um float como literal C que reproduz exatamente o
+ * valor (9 dígitos significativos).
+ */
+static void __escreverLiteralFloat(FILE * arquivo, float valor)
+{
+  if (isnan(valor))
+  {
+    fprintf(arquivo, "NAN");
+    return;
+  }
+
+  if (isinf(valor))
+  {
+    fprintf(arquivo, (valor > 0) ? "INFINITY" : "-INFINITY");
+    return;
+  }
+
+  char literal[32];
+  snprintf(literal, sizeof(literal), "%.9g", valor);
+
+  /* Garantindo que o literal seja de ponto flutuante (ex: "1" -> "1.0f"). */
+  if (strpbrk(literal, ".e") == NULL)
+  {
+    strcat(literal, ".0");
+  }
+
+  fprintf(arquivo, "%sf", literal);
+}
+
+/**
+ * Método que escreve um vetor "static const" com os valores informados
+ * (uma matriz "qtdLinhas x qtdColunas" caso "matriz" seja verdadeiro, ou um
+ * vetor simples com todos os valores caso contrário).
+ */
+static void __escreverVetor(FILE * arquivo, const char * prefixo,
+                            const char * nome, int c, const float * valores,
+                            int qtdLinhas, int qtdColunas, bool matriz)
+{
+  if (matriz)
+  {
+    fprintf(arquivo, "static const float %s_%s%d[%d][%d] =\n{\n",
+            prefixo, nome, c, qtdLinhas, qtdColunas);
+  }
+  else
+  {
+    fprintf(arquivo, "static const float %s_%s%d[%d] =\n{",
+            prefixo, nome, c, qtdLinhas * qtdColunas);
+  }
+
+  for (int l = 0; l < qtdLinhas; l++)
+  {
+    if (matriz)
+    {
+      fprintf(arquivo, "  {");
+    }
+
+    for (int i = 0; i < qtdColunas; i++)
+    {
+      if (i % QTD_VALORES_LINHA == 0)
+      {
+        fprintf(arquivo, "\n    ");
+      }
+
+      __escreverLiteralFloat(arquivo, valores[(size_t) l * qtdColunas + i]);
+      fprintf(arquivo, (i + 1 < qtdColunas) ? ", " : "");
+    }
+
+    if (matriz)
+    {
+      fprintf(arquivo, "\n  }");
+    }
+    fprintf(arquivo, (l + 1 < qtdLinhas) ? ",\n" : "\n");
+  }
+
+  fprintf(arquivo, "};\n\n");
+}
+
+/**
+ * Método que retorna a expressão C da função de ativação aplicada à
+ * variável "z".
+ */
+static const char * __expressaoFuncaoAtivacao(int funcaoAtivacao)
+{
+  switch (funcaoAtivacao)
+  {
+  case Degrau:
+    return "(z >= 0.0f) ? 1.0f : 0.0f";
+  case Sigmoide:
+    return "1.0f / (1.0f + expf(-z))";
+  case TangHiperbolica:
+    return "tanhf(z)";
+  default:
+    return "z";
+  }
+}
+
+/**
+ * Método que retorna o nome da função de ativação (comentários do código
+ * gerado).
+ */
+static const char * __nomeFuncaoAtivacao(int funcaoAtivacao)
+{
+  switch (funcaoAtivacao)
+  {
+  case Degrau:
+    return "degrau";
+  case Sigmoide:
+    return "sigmóide";
+  case TangHiperbolica:
+    return "tangente hiperbólica";
+  default:
+    return "identidade";
+  }
+}
+
+bool PerceptronMulticamadas_exportarC(const PerceptronMulticamadas * pm,
+                                      const char * nomeBase,
+                                      const char * prefixo)
+{
+  if (!__identificadorValido(prefixo) || pm->embedding != NULL)
+  {
+    return false;
+  }
+
+  char * nomeArquivo = malloc(strlen(nomeBase) + 3);
+
+  sprintf(nomeArquivo, "%s.h", nomeBase);
+  FILE * arquivoH = fopen(nomeArquivo, "w");
+
+  sprintf(nomeArquivo, "%s.c", nomeBase);
+  FILE * arquivoC = fopen(nomeArquivo, "w");
+
+  free(nomeArquivo);
+
+  if (arquivoH == NULL || arquivoC == NULL)
+  {
+    if (arquivoH != NULL)
+    {
+      fclose(arquivoH);
+    }
+    if (arquivoC != NULL)
+    {
+      fclose(arquivoC);
+    }
+    return false;
+  }
+
+  /* Nome do cabeçalho (sem o diretório) para o "include" do código, e o
+     prefixo em maiúsculas para as macros. */
+  const char * nomeCabecalho = strrchr(nomeBase, '/');
+  nomeCabecalho = (nomeCabecalho != NULL) ? nomeCabecalho + 1 : nomeBase;
+
+  char * prefixoMacro = strdup(prefixo);
+  for (char * c = prefixoMacro; *c != '\0'; c++)
+  {
+    *c = toupper((unsigned char) *c);
+  }
+
+  /* Topologia no formato "entrada-camada1-...-camadaN". */
+  fprintf(arquivoH, "/* Gerado por PerceptronMulticamadas_exportarC "
+          "(topologia %d", pm->qtdNeuroniosEntrada);
+  fprintf(arquivoC, "/* Gerado por PerceptronMulticamadas_exportarC "
+          "(topologia %d", pm->qtdNeuroniosEntrada);
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    fprintf(arquivoH, "-%d", pm->camadas[c]->qtdNeuronios);
+    fprintf(arquivoC, "-%d", pm->camadas[c]->qtdNeuronios);
+  }
+  fprintf(arquivoH, "). */\n\n");
+  fprintf(arquivoC, "). */\n\n");
+
+  /* Cabeçalho. */
+  int qtdSaidas = pm->camadas[pm->qtdCamadas - 1]->qtdNeuronios;
+
+  fprintf(arquivoH, "#ifndef %s_H\n#define %s_H\n\n", prefixoMacro,
+          prefixoMacro);
+  fprintf(arquivoH, "#define %s_QTD_ENTRADAS %d\n", prefixoMacro,
+          pm->qtdNeuroniosEntrada);
+  fprintf(arquivoH, "#define %s_QTD_SAIDAS %d\n\n", prefixoMacro, qtdSaidas);
+  fprintf(arquivoH, "/**\n * Calcula a saída da rede para uma amostra.\n"
+          " *\n * @param entrada Amostra (%s_QTD_ENTRADAS itens).\n *\n"
+          " * @param saida Vetor onde será armazenada a saída da rede\n"
+          " *              (%s_QTD_SAIDAS itens).\n */\n",
+          prefixoMacro, prefixoMacro);
+  fprintf(arquivoH, "void %s_predizer(const float * entrada, float * saida);"
+          "\n\n#endif\n", prefixo);
+
+  /* Pesos e bias de cada camada. */
+  fprintf(arquivoC, "#include <math.h>\n#include \"%s.h\"\n\n",
+          nomeCabecalho);
+
+  int maiorQtdNeuronios = 0;
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+    size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+    float * h_W = malloc(sizeof(float) * qtdPesos);
+    float * h_bias = malloc(sizeof(float) * camada->qtdNeuronios);
+    Camada_copiarPesosHospedeiro(camada, qtdPesosNeuronio, h_W);
+    cudaMemcpy(h_bias, camada->d_bias, sizeof(float) * camada->qtdNeuronios,
+               cudaMemcpyDeviceToHost);
+
+    /* Os pesos são gerados como matriz mesmo quando há um único peso por
+       neurônio, para que o acesso no laço seja sempre "W[n][i]". */
+    __escreverVetor(arquivoC, prefixo, "W", c, h_W, camada->qtdNeuronios,
+                    qtdPesosNeuronio, true);
+    __escreverVetor(arquivoC, prefixo, "bias", c, h_bias, 1,
+                    camada->qtdNeuronios, false);
+
+    free(h_W);
+    free(h_bias);
+
+    if (camada->qtdNeuronios > maiorQtdNeuronios)
+    {
+      maiorQtdNeuronios = camada->qtdNeuronios;
+    }
+  }
+
+  /* Função de inferência, com um laço por camada (quantidades e função de
+     ativação fixas). As camadas ocultas utilizam dois vetores locais
+     alternadamente e a última camada escreve diretamente na saída. */
+  fprintf(arquivoC, "void %s_predizer(const float * entrada, float * saida)\n"
+          "{\n", prefixo);
+  if (pm->qtdCamadas > 1)
+  {
+    fprintf(arquivoC, "  float ativacaoA[%d];\n", maiorQtdNeuronios);
+  }
+  if (pm->qtdCamadas > 2)
+  {
+    fprintf(arquivoC, "  float ativacaoB[%d];\n", maiorQtdNeuronios);
+  }
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+
+    const char * entrada = (c == 0) ? "entrada" :
+                           ((c - 1) % 2 == 0) ? "ativacaoA" : "ativacaoB";
+    const char * saida = (c == pm->qtdCamadas - 1) ? "saida" :
+                         (c % 2 == 0) ? "ativacaoA" : "ativacaoB";
+
+    fprintf(arquivoC, "\n  /* Camada %d: %d -> %d (%s). */\n", c,
+            qtdPesosNeuronio, camada->qtdNeuronios,
+            __nomeFuncaoAtivacao(camada->funcaoAtivacao));
+    fprintf(arquivoC,
+            "  for (int n = 0; n < %d; n++)\n"
+            "  {\n"
+            "    float soma = 0.0f;\n"
+            "    for (int i = 0; i < %d; i++)\n"
+            "    {\n"
+            "      soma += %s_W%d[n][i] * %s[i];\n"
+            "    }\n"
+            "    float z = soma + %s_bias%d[n];\n"
+            "    %s[n] = %s;\n"
+            "  }\n",
+            camada->qtdNeuronios, qtdPesosNeuronio, prefixo, c, entrada,
+            prefixo, c, saida,
+            __expressaoFuncaoAtivacao(camada->funcaoAtivacao));
+  }
+
+  fprintf(arquivoC, "}\n");
+
+  free(prefixoMacro);
+
+  bool sucesso = !ferror(arquivoH) && !ferror(arquivoC);
+  sucesso = (fclose(arquivoH) == 0) && sucesso;
+  sucesso = (fclose(arquivoC) == 0) && sucesso;
+
+  return sucesso;
+}
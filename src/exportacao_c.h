@@ -0,0 +1,49 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Exportação de uma rede treinada como código C independente (pesos        *
+ * embutidos), para alvos embarcados sem CUDA/OpenACC.                      *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef EXPORTACAO_C_H
+#define EXPORTACAO_C_H
+
+#include "perceptron_multicamadas.h"
+
+/**
+ * Método que gera os arquivos "<nomeBase>.h" e "<nomeBase>.c" com a
+ * inferência (feedfoward) da rede em C99 puro, sem dependência de CUDA,
+ * OpenACC ou "uniform.c" (apenas da biblioteca matemática padrão).
+ *
+ * Os pesos e os bias são gerados como vetores "static const" (com todos os
+ * dígitos necessários para reproduzir exatamente os valores) e cada camada
+ * possui o seu próprio laço, com as quantidades de neurônios e a função de
+ * ativação fixas no código, permitindo que o compilador do alvo desenrole
+ * e vetorize os laços para a topologia exata.
+ *
+ * O arquivo de cabeçalho gerado declara:
+ *   <PREFIXO>_QTD_ENTRADAS e <PREFIXO>_QTD_SAIDAS;
+ *   void <prefixo>_predizer(const float * entrada, float * saida);
+ *
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param nomeBase Caminho dos arquivos gerados, sem a extensão.
+ *
+ * @param prefixo Prefixo (identificador C válido) dos símbolos gerados.
+ *
+ * A camada de "embedding" não é exportada (a função gerada recebe apenas a
+ * entrada densa da primeira camada), portanto redes com a camada não são
+ * exportadas.
+ *
+ * @return Verdadeiro caso os arquivos tenham sido gerados, ou falso caso o
+ *         prefixo seja inválido, a rede possua a camada de "embedding" ou
+ *         não seja possível criar os arquivos.
+ */
+bool PerceptronMulticamadas_exportarC(const PerceptronMulticamadas * pm,
+                                      const char * nomeBase,
+                                      const char * prefixo);
+
+#endif
@@ -0,0 +1,42 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Programa que exporta um arquivo de modelo como código C independente.    *
+ *                                                                          *
+ * Uso: ./exportar_modelo <arquivo de modelo> <nome base dos arquivos>      *
+ *                        <prefixo dos símbolos>                            *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#include "modelo_arquivo.h"
+#include "exportacao_c.h"
+
+int main(int argc, char ** argv)
+{
+  if (argc < 4)
+  {
+    printf("Uso: %s <modelo> <nomeBase> <prefixo>\n", argv[0]);
+    return 1;
+  }
+
+  PerceptronMulticamadas * pm = PerceptronMulticamadas_carregar(argv[1]);
+  if (pm == NULL)
+  {
+    printf("Arquivo de modelo inválido: %s\n", argv[1]);
+    return 1;
+  }
+
+  if (!PerceptronMulticamadas_exportarC(pm, argv[2], argv[3]))
+  {
+    printf("Não foi possível gerar %s.c/%s.h (o prefixo deve ser um "
+           "identificador C válido e a rede não pode possuir a camada de "
+           "embedding).\n", argv[2], argv[2]);
+    return 1;
+  }
+
+  printf("Gerados %s.h e %s.c.\n", argv[2], argv[2]);
+
+  return 0;
+}
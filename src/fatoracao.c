@@ -0,0 +1,781 @@
+#include "fatoracao.h"
+
+/* Quantidade máxima de varreduras do método de Jacobi. */
+#define QTD_MAX_VARREDURAS_JACOBI 50
+
+/**
+ * Estrutura (no hospedeiro) com a decomposição aleatorizada dos pesos de
+ * uma camada, a partir da qual é obtida a fatoração de qualquer posto até
+ * "qtdColunas": W ~ Q.B, onde as colunas de Q são ortonormais e
+ * B.B^T = E.diag(autovalores).E^T, com os autovetores (colunas de E)
+ * ordenados pelos autovalores decrescentes.
+ */
+typedef struct
+{
+  /** Base ortonormal do subespaço dominante (linhas x qtdColunas). */
+  double * Q;
+
+  /** Projeção dos pesos no subespaço (qtdColunas x colunas). */
+  double * B;
+
+  /** Autovetores de B.B^T (qtdColunas x qtdColunas). */
+  double * E;
+
+  /** Dimensões dos pesos e quantidade de colunas amostradas. */
+  int linhas;
+  int colunas;
+  int qtdColunas;
+
+} DecomposicaoCamada;
+
+/**
+ * Método que ortonormaliza as colunas de uma matriz "row-major" através do
+ * Gram-Schmidt modificado (com reortogonalização). Colunas linearmente
+ * dependentes das anteriores são zeradas.
+ */
+static void __ortonormalizarColunas(double * A, int linhas, int colunas)
+{
+  for (int j = 0; j < colunas; j++)
+  {
+    for (int passo = 0; passo < 2; passo++)
+    {
+      for (int k = 0; k < j; k++)
+      {
+        double produto = 0;
+        for (int i = 0; i < linhas; i++)
+        {
+          produto += A[(long) i * colunas + k] * A[(long) i * colunas + j];
+        }
+        for (int i = 0; i < linhas; i++)
+        {
+          A[(long) i * colunas + j] -= produto * A[(long) i * colunas + k];
+        }
+      }
+    }
+
+    double norma = 0;
+    for (int i = 0; i < linhas; i++)
+    {
+      norma += A[(long) i * colunas + j] * A[(long) i * colunas + j];
+    }
+    norma = sqrt(norma);
+
+    for (int i = 0; i < linhas; i++)
+    {
+      A[(long) i * colunas + j] = (norma > 1e-12) ?
+                                  A[(long) i * colunas + j] / norma : 0;
+    }
+  }
+}
+
+/**
+ * Método que calcula os autovalores e autovetores de uma matriz simétrica
+ * "n x n" pelo método de Jacobi cíclico (a matriz é destruída). Os
+ * autovetores (colunas de "E") são ordenados pelos autovalores
+ * decrescentes.
+ */
+static void __autovetoresJacobi(double * C, int n, double * E)
+{
+  double * V = calloc((size_t) n * n, sizeof(double));
+  for (int i = 0; i < n; i++)
+  {
+    V[(long) i * n + i] = 1;
+  }
+
+  for (int varredura = 0; varredura < QTD_MAX_VARREDURAS_JACOBI; varredura++)
+  {
+    /* Verificando a convergência pela norma fora da diagonal. */
+    double foraDiagonal = 0;
+    double diagonal = 0;
+    for (int p = 0; p < n; p++)
+    {
+      diagonal += C[(long) p * n + p] * C[(long) p * n + p];
+      for (int q = p + 1; q < n; q++)
+      {
+        foraDiagonal += C[(long) p * n + q] * C[(long) p * n + q];
+      }
+    }
+
+    if (foraDiagonal <= 1e-24 * diagonal)
+    {
+      break;
+    }
+
+    for (int p = 0; p < n; p++)
+    {
+      for (int q = p + 1; q < n; q++)
+      {
+        double apq = C[(long) p * n + q];
+        if (fabs(apq) < 1e-300)
+        {
+          continue;
+        }
+
+        /* Rotação que zera o item (p, q). */
+        double theta = (C[(long) q * n + q] - C[(long) p * n + p]) / (2 * apq);
+        double t = ((theta >= 0) ? 1 : -1) /
+                   (fabs(theta) + sqrt(theta * theta + 1));
+        double c = 1 / sqrt(t * t + 1);
+        double s = t * c;
+
+        for (int k = 0; k < n; k++)
+        {
+          double ckp = C[(long) k * n + p];
+          double ckq = C[(long) k * n + q];
+          C[(long) k * n + p] = c * ckp - s * ckq;
+          C[(long) k * n + q] = s * ckp + c * ckq;
+        }
+
+        for (int k = 0; k < n; k++)
+        {
+          double cpk = C[(long) p * n + k];
+          double cqk = C[(long) q * n + k];
+          C[(long) p * n + k] = c * cpk - s * cqk;
+          C[(long) q * n + k] = s * cpk + c * cqk;
+        }
+
+        for (int k = 0; k < n; k++)
+        {
+          double vkp = V[(long) k * n + p];
+          double vkq = V[(long) k * n + q];
+          V[(long) k * n + p] = c * vkp - s * vkq;
+          V[(long) k * n + q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+
+  /* Ordenando os autovetores pelos autovalores (diagonal) decrescentes. */
+  int * ordem = malloc(sizeof(int) * n);
+  for (int i = 0; i < n; i++)
+  {
+    ordem[i] = i;
+  }
+
+  for (int i = 0; i < n; i++)
+  {
+    int maior = i;
+    for (int j = i + 1; j < n; j++)
+    {
+      if (C[(long) ordem[j] * n + ordem[j]] >
+          C[(long) ordem[maior] * n + ordem[maior]])
+      {
+        maior = j;
+      }
+    }
+
+    int aux = ordem[i];
+    ordem[i] = ordem[maior];
+    ordem[maior] = aux;
+  }
+
+  for (int i = 0; i < n; i++)
+  {
+    for (int j = 0; j < n; j++)
+    {
+      E[(long) i * n + j] = V[(long) i * n + ordem[j]];
+    }
+  }
+
+  free(ordem);
+  free(V);
+}
+
+/**
+ * Método que calcula a decomposição aleatorizada dos pesos (linhas x
+ * colunas) de uma camada amostrando "qtdColunas" colunas.
+ */
+static DecomposicaoCamada * __decomporCamada(const float * h_W, int linhas,
+                                             int colunas, int qtdColunas)
+{
+  DecomposicaoCamada * d = malloc(sizeof(DecomposicaoCamada));
+  d->linhas = linhas;
+  d->colunas = colunas;
+  d->qtdColunas = qtdColunas;
+
+  int l = qtdColunas;
+  double * Y = calloc((size_t) linhas * l, sizeof(double));
+  double * Z = calloc((size_t) colunas * l, sizeof(double));
+
+  /* Matriz aleatória (colunas x l) e a amostragem Y = W.Z. */
+  int semente = 12345;
+  for (long i = 0; i < (long) colunas * l; i++)
+  {
+    Z[i] = r8_uniform_ab(-1, 1, &semente);
+  }
+
+  for (int iteracao = 0; iteracao <= QTD_ITERACOES_POTENCIA_FATORACAO;
+       iteracao++)
+  {
+    /* Y = W.Z */
+    memset(Y, 0, sizeof(double) * linhas * l);
+    for (int i = 0; i < linhas; i++)
+    {
+      for (int k = 0; k < colunas; k++)
+      {
+        double w = h_W[(long) i * colunas + k];
+        for (int j = 0; j < l; j++)
+        {
+          Y[(long) i * l + j] += w * Z[(long) k * l + j];
+        }
+      }
+    }
+    __ortonormalizarColunas(Y, linhas, l);
+
+    if (iteracao == QTD_ITERACOES_POTENCIA_FATORACAO)
+    {
+      break;
+    }
+
+    /* Iteração de potência: Z = W^T.Y */
+    memset(Z, 0, sizeof(double) * colunas * l);
+    for (int i = 0; i < linhas; i++)
+    {
+      for (int k = 0; k < colunas; k++)
+      {
+        double w = h_W[(long) i * colunas + k];
+        for (int j = 0; j < l; j++)
+        {
+          Z[(long) k * l + j] += w * Y[(long) i * l + j];
+        }
+      }
+    }
+    __ortonormalizarColunas(Z, colunas, l);
+  }
+
+  free(Z);
+  d->Q = Y;
+
+  /* B = Q^T.W */
+  d->B = calloc((size_t) l * colunas, sizeof(double));
+  for (int i = 0; i < linhas; i++)
+  {
+    for (int j = 0; j < l; j++)
+    {
+      double q = d->Q[(long) i * l + j];
+      for (int k = 0; k < colunas; k++)
+      {
+        d->B[(long) j * colunas + k] += q * h_W[(long) i * colunas + k];
+      }
+    }
+  }
+
+  /* C = B.B^T e os seus autovetores. */
+  double * C = malloc(sizeof(double) * l * l);
+  for (int a = 0; a < l; a++)
+  {
+    for (int b = a; b < l; b++)
+    {
+      double soma = 0;
+      for (int k = 0; k < colunas; k++)
+      {
+        soma += d->B[(long) a * colunas + k] * d->B[(long) b * colunas + k];
+      }
+      C[(long) a * l + b] = soma;
+      C[(long) b * l + a] = soma;
+    }
+  }
+
+  d->E = malloc(sizeof(double) * l * l);
+  __autovetoresJacobi(C, l, d->E);
+  free(C);
+
+  return d;
+}
+
+/**
+ * Método que desaloca uma decomposição.
+ */
+static void __desalocarDecomposicao(DecomposicaoCamada * d)
+{
+  free(d->Q);
+  free(d->B);
+  free(d->E);
+  free(d);
+}
+
+/**
+ * Método que retorna o maior posto cuja fatoração realiza menos
+ * multiplicações que a camada densa.
+ */
+static int __postoMaximoVantajoso(int linhas, int colunas)
+{
+  return (int) (((long) linhas * colunas - 1) / (linhas + colunas));
+}
+
+/**
+ * Método que substitui os pesos de uma camada fatorada pela fatoração de
+ * posto "posto" da decomposição, ou pelos pesos densos caso o posto seja
+ * nulo.
+ */
+static void __definirPostoCamada(CamadaFatorada * camada,
+                                 const DecomposicaoCamada * d, int posto,
+                                 const float * h_W)
+{
+  int linhas = camada->qtdNeuronios;
+  int colunas = camada->qtdPesosNeuronio;
+
+  cudaFree(camada->d_U);
+  cudaFree(camada->d_V);
+  camada->d_U = NULL;
+  camada->posto = posto;
+
+  if (posto == 0)
+  {
+    cudaMalloc((void **) &camada->d_V, sizeof(float) * linhas * colunas);
+    cudaMemcpy(camada->d_V, h_W, sizeof(float) * linhas * colunas,
+               cudaMemcpyHostToDevice);
+    return;
+  }
+
+  /* U = Q.E[:, :posto] e V = E[:, :posto]^T.B */
+  int l = d->qtdColunas;
+  float * h_U = malloc(sizeof(float) * linhas * posto);
+  float * h_V = malloc(sizeof(float) * posto * colunas);
+
+  for (int i = 0; i < linhas; i++)
+  {
+    for (int r = 0; r < posto; r++)
+    {
+      double soma = 0;
+      for (int j = 0; j < l; j++)
+      {
+        soma += d->Q[(long) i * l + j] * d->E[(long) j * l + r];
+      }
+      h_U[(long) i * posto + r] = soma;
+    }
+  }
+
+  for (int r = 0; r < posto; r++)
+  {
+    for (int k = 0; k < colunas; k++)
+    {
+      double soma = 0;
+      for (int j = 0; j < l; j++)
+      {
+        soma += d->E[(long) j * l + r] * d->B[(long) j * colunas + k];
+      }
+      h_V[(long) r * colunas + k] = soma;
+    }
+  }
+
+  cudaMalloc((void **) &camada->d_U, sizeof(float) * linhas * posto);
+  cudaMalloc((void **) &camada->d_V, sizeof(float) * posto * colunas);
+  cudaMemcpy(camada->d_U, h_U, sizeof(float) * linhas * posto,
+             cudaMemcpyHostToDevice);
+  cudaMemcpy(camada->d_V, h_V, sizeof(float) * posto * colunas,
+             cudaMemcpyHostToDevice);
+
+  free(h_U);
+  free(h_V);
+}
+
+/**
+ * Método que aloca a rede fatorada com todas as camadas densas (cópias da
+ * rede original) e retorna os pesos de cada camada no hospedeiro.
+ */
+static PerceptronFatorado * __alocarPerceptronFatorado(PerceptronMulticamadas
+                                                       * pm, float ** h_W)
+{
+  PerceptronFatorado * pf = malloc(sizeof(PerceptronFatorado));
+  pf->camadas = malloc(sizeof(CamadaFatorada) * pm->qtdCamadas);
+  pf->qtdCamadas = pm->qtdCamadas;
+  pf->qtdNeuroniosEntrada = pm->qtdNeuroniosEntrada;
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    CamadaFatorada * camadaFatorada = &pf->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+
+    camadaFatorada->qtdNeuronios = camada->qtdNeuronios;
+    camadaFatorada->qtdPesosNeuronio = qtdPesosNeuronio;
+    camadaFatorada->funcaoAtivacao = camada->funcaoAtivacao;
+    camadaFatorada->d_U = NULL;
+    camadaFatorada->d_V = NULL;
+
+    cudaMalloc((void **) &camadaFatorada->d_bias,
+               sizeof(float) * camada->qtdNeuronios);
+    cudaMemcpy(camadaFatorada->d_bias, camada->d_bias,
+               sizeof(float) * camada->qtdNeuronios,
+               cudaMemcpyDeviceToDevice);
+
+    h_W[c] = malloc(sizeof(float) * camada->qtdNeuronios * qtdPesosNeuronio);
+    Camada_copiarPesosHospedeiro(camada, qtdPesosNeuronio, h_W[c]);
+
+    __definirPostoCamada(camadaFatorada, NULL, 0, h_W[c]);
+  }
+
+  return pf;
+}
+
+PerceptronFatorado *
+PerceptronFatorado_fatorarPostos(PerceptronMulticamadas * pm,
+                                 const int * postos)
+{
+  /* A rede fatorada não possui a camada de "embedding" (a primeira camada
+     espera a entrada montada pela mesma). */
+  if (pm->embedding != NULL)
+  {
+    return NULL;
+  }
+
+  float ** h_W = malloc(sizeof(float *) * pm->qtdCamadas);
+  PerceptronFatorado * pf = __alocarPerceptronFatorado(pm, h_W);
+
+  for (int c = 0; c < pf->qtdCamadas; c++)
+  {
+    CamadaFatorada * camada = &pf->camadas[c];
+    int menorDimensao = (camada->qtdNeuronios < camada->qtdPesosNeuronio) ?
+                        camada->qtdNeuronios : camada->qtdPesosNeuronio;
+    int posto = (postos[c] < menorDimensao) ? postos[c] : menorDimensao;
+
+    if (posto > 0)
+    {
+      int qtdColunas = posto + QTD_COLUNAS_EXTRAS_FATORACAO;
+      qtdColunas = (qtdColunas < menorDimensao) ? qtdColunas : menorDimensao;
+
+      DecomposicaoCamada * d = __decomporCamada(h_W[c], camada->qtdNeuronios,
+                                                camada->qtdPesosNeuronio,
+                                                qtdColunas);
+      __definirPostoCamada(camada, d, posto, h_W[c]);
+      __desalocarDecomposicao(d);
+    }
+
+    free(h_W[c]);
+  }
+
+  free(h_W);
+
+  return pf;
+}
+
+PerceptronFatorado *
+PerceptronFatorado_fatorar(PerceptronMulticamadas * pm,
+                           PadraoTreinamento * padroesValidacao,
+                           int qtdPadroesValidacao,
+                           float orcamentoErro)
+{
+  if (pm->embedding != NULL)
+  {
+    return NULL;
+  }
+
+  float ** h_W = malloc(sizeof(float *) * pm->qtdCamadas);
+  PerceptronFatorado * pf = __alocarPerceptronFatorado(pm, h_W);
+
+  float erroOriginal = PerceptronFatorado_calcularTaxaAcerto
+    (pf, padroesValidacao, qtdPadroesValidacao);
+
+  for (int c = 0; c < pf->qtdCamadas; c++)
+  {
+    CamadaFatorada * camada = &pf->camadas[c];
+    int postoMaximo = __postoMaximoVantajoso(camada->qtdNeuronios,
+                                             camada->qtdPesosNeuronio);
+    float erroLimite = erroOriginal + orcamentoErro * (c + 1) / pf->qtdCamadas;
+
+    /* Sem o erro da rede original (padrões de validação que não são
+       densos) nenhum posto pode ser avaliado e a camada é mantida densa. */
+    if (postoMaximo < 1 || isnan(erroOriginal))
+    {
+      free(h_W[c]);
+      continue;
+    }
+
+    int menorDimensao = (camada->qtdNeuronios < camada->qtdPesosNeuronio) ?
+                        camada->qtdNeuronios : camada->qtdPesosNeuronio;
+    int qtdColunas = postoMaximo + QTD_COLUNAS_EXTRAS_FATORACAO;
+    qtdColunas = (qtdColunas < menorDimensao) ? qtdColunas : menorDimensao;
+
+    DecomposicaoCamada * d = __decomporCamada(h_W[c], camada->qtdNeuronios,
+                                              camada->qtdPesosNeuronio,
+                                              qtdColunas);
+
+    /* Busca binária pelo menor posto que atende o limite (0 caso nem o
+       maior posto vantajoso atenda). */
+    int menor = 1;
+    int maior = postoMaximo;
+    int postoEscolhido = 0;
+
+    while (menor <= maior)
+    {
+      int posto = (menor + maior) / 2;
+      __definirPostoCamada(camada, d, posto, h_W[c]);
+
+      if (PerceptronFatorado_calcularTaxaAcerto(pf, padroesValidacao,
+                                                qtdPadroesValidacao) <=
+          erroLimite)
+      {
+        postoEscolhido = posto;
+        maior = posto - 1;
+      }
+      else
+      {
+        menor = posto + 1;
+      }
+    }
+
+    __definirPostoCamada(camada, d, postoEscolhido, h_W[c]);
+    __desalocarDecomposicao(d);
+    free(h_W[c]);
+  }
+
+  free(h_W);
+
+  return pf;
+}
+
+void PerceptronFatorado_desalocar(PerceptronFatorado * pf)
+{
+  for (int c = 0; c < pf->qtdCamadas; c++)
+  {
+    cudaFree(pf->camadas[c].d_U);
+    cudaFree(pf->camadas[c].d_V);
+    cudaFree(pf->camadas[c].d_bias);
+  }
+
+  free(pf->camadas);
+  free(pf);
+}
+
+long PerceptronFatorado_qtdMultiplicacoes(const PerceptronFatorado * pf)
+{
+  long qtdMultiplicacoes = 0;
+
+  for (int c = 0; c < pf->qtdCamadas; c++)
+  {
+    const CamadaFatorada * camada = &pf->camadas[c];
+
+    if (camada->posto == 0)
+    {
+      qtdMultiplicacoes += (long) camada->qtdNeuronios *
+                           camada->qtdPesosNeuronio;
+    }
+    else
+    {
+      qtdMultiplicacoes += (long) camada->posto *
+                           (camada->qtdNeuronios + camada->qtdPesosNeuronio);
+    }
+  }
+
+  return qtdMultiplicacoes;
+}
+
+ContextoFatorado * ContextoFatorado_inicializar(const PerceptronFatorado * pf)
+{
+  ContextoFatorado * contexto = malloc(sizeof(ContextoFatorado));
+
+  int maiorCamada = 0;
+  int maiorPosto = 1;
+  for (int c = 0; c < pf->qtdCamadas; c++)
+  {
+    if (pf->camadas[c].qtdNeuronios > maiorCamada)
+    {
+      maiorCamada = pf->camadas[c].qtdNeuronios;
+    }
+    if (pf->camadas[c].posto > maiorPosto)
+    {
+      maiorPosto = pf->camadas[c].posto;
+    }
+  }
+
+  int qtdNeuroniosSaida = pf->camadas[pf->qtdCamadas - 1].qtdNeuronios;
+
+  cudaMalloc((void **) &contexto->d_ativacaoA, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_ativacaoB, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_intermediario, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * maiorPosto);
+  cudaMalloc((void **) &contexto->d_loteEntrada, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * pf->qtdNeuroniosEntrada);
+  cudaMalloc((void **) &contexto->d_loteSaida, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * qtdNeuroniosSaida);
+
+  return contexto;
+}
+
+void ContextoFatorado_desalocar(ContextoFatorado * contexto)
+{
+  cudaFree(contexto->d_ativacaoA);
+  cudaFree(contexto->d_ativacaoB);
+  cudaFree(contexto->d_intermediario);
+  cudaFree(contexto->d_loteEntrada);
+  cudaFree(contexto->d_loteSaida);
+  free(contexto);
+}
+
+/**
+ * Método que calcula "f(M.x + bias)" para um lote de amostras ("gangs" nas
+ * amostras e "vector lanes" nas linhas de M), onde o bias pode ser NULO.
+ */
+static void __multiplicarLote(const float * d_M, int qtdLinhas,
+                              int qtdColunas, const float * d_entradaLote,
+                              int qtdAmostras, const float * d_bias,
+                              int funcaoAtivacao, float * d_saidaLote)
+{
+  bool possuiBias = (d_bias != NULL);
+
+  #pragma acc parallel loop gang vector_length(TAM_VECTOR) \
+  deviceptr(d_M, d_entradaLote, d_bias, d_saidaLote)
+  for (int s = 0; s < qtdAmostras; s++)
+  {
+    const float * entrada = &d_entradaLote[(long) qtdColunas * s];
+
+    #pragma acc loop vector
+    for (int n = 0; n < qtdLinhas; n++)
+    {
+      const float * m = &d_M[(long) qtdColunas * n];
+      float soma = 0.0;
+
+      #pragma acc loop seq reduction(+:soma)
+      for (int i = 0; i < qtdColunas; i++)
+      {
+        soma += m[i] * entrada[i];
+      }
+
+      if (possuiBias)
+      {
+        soma += d_bias[n];
+      }
+
+      d_saidaLote[(long) qtdLinhas * s + n] =
+        aplicarFuncaoAtivacao(soma, funcaoAtivacao);
+    }
+  }
+}
+
+void CamadaFatorada_calcularAtivacaoNeuroniosLote(const CamadaFatorada camada,
+                                                  const float * d_entradaLote,
+                                                  int qtdAmostras,
+                                                  float * d_intermediario,
+                                                  float * d_saidaLote)
+{
+  if (camada.posto == 0)
+  {
+    __multiplicarLote(camada.d_V, camada.qtdNeuronios,
+                      camada.qtdPesosNeuronio, d_entradaLote, qtdAmostras,
+                      camada.d_bias, camada.funcaoAtivacao, d_saidaLote);
+    return;
+  }
+
+  /* t = V.x (sem bias e sem função de ativação) e f(U.t + bias). */
+  __multiplicarLote(camada.d_V, camada.posto, camada.qtdPesosNeuronio,
+                    d_entradaLote, qtdAmostras, NULL, Identidade,
+                    d_intermediario);
+  __multiplicarLote(camada.d_U, camada.qtdNeuronios, camada.posto,
+                    d_intermediario, qtdAmostras, camada.d_bias,
+                    camada.funcaoAtivacao, d_saidaLote);
+}
+
+void PerceptronFatorado_predizerLote(PerceptronFatorado * pf,
+                                     ContextoFatorado * contexto,
+                                     const float * d_entradas,
+                                     int qtdAmostras,
+                                     float * d_saidas)
+{
+  int qtdNeuroniosSaida = pf->camadas[pf->qtdCamadas - 1].qtdNeuronios;
+
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
+    {
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    /* A primeira camada lê as amostras e a última escreve na saída, as
+       demais alternam entre as matrizes de ativação do contexto. */
+    const float * d_entradaCamada = &d_entradas[(long) inicio *
+                                                pf->qtdNeuroniosEntrada];
+
+    for (int c = 0; c < pf->qtdCamadas; c++)
+    {
+      float * d_saidaCamada;
+      if (c == pf->qtdCamadas - 1)
+      {
+        d_saidaCamada = &d_saidas[(long) inicio * qtdNeuroniosSaida];
+      }
+      else
+      {
+        d_saidaCamada = (c % 2 == 0) ? contexto->d_ativacaoA :
+                                       contexto->d_ativacaoB;
+      }
+
+      CamadaFatorada_calcularAtivacaoNeuroniosLote(pf->camadas[c],
+                                                   d_entradaCamada,
+                                                   qtdAmostrasLote,
+                                                   contexto->d_intermediario,
+                                                   d_saidaCamada);
+
+      d_entradaCamada = d_saidaCamada;
+    }
+  }
+}
+
+void PerceptronFatorado_predizer(PerceptronFatorado * pf,
+                                 ContextoFatorado * contexto,
+                                 const float * h_entradas,
+                                 int qtdAmostras,
+                                 float * h_saidas)
+{
+  int qtdNeuroniosSaida = pf->camadas[pf->qtdCamadas - 1].qtdNeuronios;
+
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
+    {
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    cudaMemcpy(contexto->d_loteEntrada,
+               &h_entradas[(long) inicio * pf->qtdNeuroniosEntrada],
+               sizeof(float) * qtdAmostrasLote * pf->qtdNeuroniosEntrada,
+               cudaMemcpyHostToDevice);
+
+    PerceptronFatorado_predizerLote(pf, contexto, contexto->d_loteEntrada,
+                                    qtdAmostrasLote, contexto->d_loteSaida);
+
+    cudaMemcpy(&h_saidas[(long) inicio * qtdNeuroniosSaida],
+               contexto->d_loteSaida,
+               sizeof(float) * qtdAmostrasLote * qtdNeuroniosSaida,
+               cudaMemcpyDeviceToHost);
+  }
+}
+
+float PerceptronFatorado_calcularTaxaAcerto(PerceptronFatorado * pf,
+                                            PadraoTreinamento * padroesTeste,
+                                            int qtdPadroesTeste)
+{
+  /* A rede fatorada recebe apenas amostras densas (float). */
+  for (int i = 0; i < qtdPadroesTeste; i++)
+  {
+    if (padroesTeste[i].tipoAmostra != AmostraDensa)
+    {
+      fprintf(stderr, "PerceptronFatorado_calcularTaxaAcerto: o padrão %d "
+              "não possui uma amostra densa.\n", i);
+      return NAN;
+    }
+  }
+
+  ContextoFatorado * contexto = ContextoFatorado_inicializar(pf);
+  int qtdNeuroniosSaida = pf->camadas[pf->qtdCamadas - 1].qtdNeuronios;
+
+  float h_erroGlobal = 0;
+
+  for (int i = 0; i < qtdPadroesTeste; i++)
+  {
+    PerceptronFatorado_predizerLote(pf, contexto, padroesTeste[i].d_amostra,
+                                    1, contexto->d_loteSaida);
+
+    h_erroGlobal += calcularErroSaida(contexto->d_loteSaida,
+                                      padroesTeste[i].d_alvo,
+                                      qtdNeuroniosSaida);
+  }
+
+  ContextoFatorado_desalocar(contexto);
+
+  return h_erroGlobal / qtdPadroesTeste;
+}
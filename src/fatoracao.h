@@ -0,0 +1,257 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Fatoração de posto baixo (W ~ U.V) das camadas de uma rede treinada para *
+ * inferência, com o posto escolhido por um orçamento de erro.              *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef FATORACAO_H
+#define FATORACAO_H
+
+#include "perceptron_multicamadas.h"
+
+/* Colunas adicionais (além do posto) amostradas pelo "randomized range
+finder", melhorando a aproximação do subespaço dominante. */
+#define QTD_COLUNAS_EXTRAS_FATORACAO 10
+
+/* Quantidade de iterações de potência do "randomized range finder" (para
+matrizes cujos valores singulares decaem lentamente). */
+#define QTD_ITERACOES_POTENCIA_FATORACAO 2
+
+/**
+ * Estrutura que representa uma camada fatorada, onde os pesos são
+ * aproximados por "W = U.V" (U com "qtdNeuronios x posto" e V com
+ * "posto x qtdPesosNeuronio"), ou uma camada mantida densa (posto nulo),
+ * quando a fatoração não reduz a quantidade de operações.
+ */
+typedef struct
+{
+  /** Matriz U ("row-major"), ou NULO caso a camada seja densa. */
+  float * d_U;
+
+  /** Matriz V ("row-major"), ou os pesos W caso a camada seja densa. */
+  float * d_V;
+
+  /** Bias de cada neurônio. */
+  float * d_bias;
+
+  /** Quantidade de neurônios e de pesos por neurônio. */
+  int qtdNeuronios;
+  int qtdPesosNeuronio;
+
+  /** Posto da fatoração (0 para uma camada densa). */
+  int posto;
+
+  /** Função de ativação (enumeração "FuncoesAtivacaoEnum"). */
+  int funcaoAtivacao;
+
+} CamadaFatorada;
+
+/**
+ * Estrutura que irá armazenar as camadas da rede fatorada.
+ */
+typedef struct
+{
+  /** Vetor de camadas. */
+  CamadaFatorada * camadas;
+
+  /** Quantidade de camadas. */
+  int qtdCamadas;
+
+  /** Tamanho da entrada (quantidade de "neurônios"). */
+  int qtdNeuroniosEntrada;
+
+} PerceptronFatorado;
+
+/**
+ * Estrutura com as matrizes (no dispositivo acelerador) utilizadas pela
+ * inferência em lote da rede fatorada (uma por thread).
+ */
+typedef struct
+{
+  /** Matrizes (amostra x neurônio) utilizadas alternadamente para as
+  ativações das camadas. */
+  float * d_ativacaoA;
+  float * d_ativacaoB;
+
+  /** Matriz (amostra x posto) com o produto intermediário "V.x". */
+  float * d_intermediario;
+
+  /** Matrizes utilizadas para transferir as entradas e as saídas entre
+  o hospedeiro e o dispositivo acelerador. */
+  float * d_loteEntrada;
+  float * d_loteSaida;
+
+} ContextoFatorado;
+
+/**
+ * Método que fatora as camadas de uma rede treinada com os postos
+ * informados. A fatoração é calculada no hospedeiro por uma SVD truncada
+ * aleatorizada ("randomized range finder" seguido da decomposição da
+ * projeção no subespaço encontrado).
+ *
+ * @param pm Rede treinada (não é alterada).
+ *
+ * @param postos Posto de cada camada (0 para manter a camada densa).
+ *
+ * @return Referência para a rede fatorada, ou NULO caso a rede possua a
+ *         camada de "embedding" (que não é fatorada).
+ */
+PerceptronFatorado *
+PerceptronFatorado_fatorarPostos(PerceptronMulticamadas * pm,
+                                 const int * postos);
+
+/**
+ * Método que fatora as camadas de uma rede treinada escolhendo o menor
+ * posto de cada camada cujo erro (MSE) nos padrões de validação não
+ * ultrapasse o erro da rede original somado ao orçamento de erro.
+ *
+ * O orçamento é dividido igualmente entre as camadas, que são fatoradas em
+ * ordem (o erro de cada camada é medido com as camadas anteriores já
+ * fatoradas). O posto de cada camada é procurado por busca binária,
+ * considerando que o erro diminui conforme o posto aumenta. Camadas em que
+ * nenhum posto vantajoso (com menos operações que a camada densa) atende o
+ * orçamento são mantidas densas.
+ *
+ * @param pm Rede treinada (não é alterada).
+ *
+ * @param padroesValidacao Padrões de validação (apenas com amostras densas,
+ *                         "AmostraDensa"; caso contrário todas as camadas
+ *                         são mantidas densas).
+ *
+ * @param qtdPadroesValidacao Quantidade de padrões de validação.
+ *
+ * @param orcamentoErro Aumento máximo do erro MSE em relação à rede
+ *                      original.
+ *
+ * @return Referência para a rede fatorada, ou NULO caso a rede possua a
+ *         camada de "embedding" (que não é fatorada).
+ */
+PerceptronFatorado *
+PerceptronFatorado_fatorar(PerceptronMulticamadas * pm,
+                           PadraoTreinamento * padroesValidacao,
+                           int qtdPadroesValidacao,
+                           float orcamentoErro);
+
+/**
+ * Método que desaloca uma rede fatorada.
+ *
+ * @param pf Rede fatorada.
+ */
+void PerceptronFatorado_desalocar(PerceptronFatorado * pf);
+
+/**
+ * Método que retorna a quantidade de multiplicações realizadas pela rede
+ * fatorada para cada amostra.
+ *
+ * @param pf Rede fatorada.
+ *
+ * @return Quantidade de multiplicações por amostra.
+ */
+long PerceptronFatorado_qtdMultiplicacoes(const PerceptronFatorado * pf);
+
+/**
+ * Método que aloca as matrizes da inferência em lote da rede fatorada.
+ *
+ * @param pf Rede fatorada.
+ *
+ * @return Referência para o contexto alocado.
+ */
+ContextoFatorado * ContextoFatorado_inicializar(const PerceptronFatorado * pf);
+
+/**
+ * Método que desaloca um contexto da rede fatorada.
+ *
+ * @param contexto Contexto a ser desalocado.
+ */
+void ContextoFatorado_desalocar(ContextoFatorado * contexto);
+
+/**
+ * Método que calcula a ativação dos neurônios de uma camada fatorada para
+ * um lote de amostras, com dois produtos encadeados: "t = V.x" e
+ * "f(U.t + bias)" (apenas o segundo caso a camada seja densa).
+ *
+ * @param camada Camada fatorada.
+ *
+ * @param d_entradaLote Entradas (amostra x qtdPesosNeuronio).
+ *
+ * @param qtdAmostras Quantidade de amostras do lote.
+ *
+ * @param d_intermediario Matriz (amostra x posto) para o produto
+ *                        intermediário.
+ *
+ * @param d_saidaLote Matriz (amostra x neurônio) onde serão armazenadas as
+ *                    ativações.
+ */
+void CamadaFatorada_calcularAtivacaoNeuroniosLote(const CamadaFatorada camada,
+                                                  const float * d_entradaLote,
+                                                  int qtdAmostras,
+                                                  float * d_intermediario,
+                                                  float * d_saidaLote);
+
+/**
+ * Método que realiza a inferência da rede fatorada para um lote de
+ * amostras que já estão no dispositivo acelerador.
+ *
+ * @param pf Rede fatorada.
+ *
+ * @param contexto Contexto da rede fatorada.
+ *
+ * @param d_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) com as
+ *                   amostras.
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param d_saidas Matriz (qtdAmostras x neurônios da última camada) onde
+ *                 serão armazenadas as saídas da rede.
+ */
+void PerceptronFatorado_predizerLote(PerceptronFatorado * pf,
+                                     ContextoFatorado * contexto,
+                                     const float * d_entradas,
+                                     int qtdAmostras,
+                                     float * d_saidas);
+
+/**
+ * Método que realiza a inferência da rede fatorada para um lote de
+ * amostras que estão na memória do hospedeiro.
+ *
+ * @param pf Rede fatorada.
+ *
+ * @param contexto Contexto da rede fatorada.
+ *
+ * @param h_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) com as
+ *                   amostras.
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param h_saidas Matriz (qtdAmostras x neurônios da última camada) onde
+ *                 serão armazenadas as saídas da rede.
+ */
+void PerceptronFatorado_predizer(PerceptronFatorado * pf,
+                                 ContextoFatorado * contexto,
+                                 const float * h_entradas,
+                                 int qtdAmostras,
+                                 float * h_saidas);
+
+/**
+ * Método que calcula a taxa de acerto (erro MSE, da mesma forma que
+ * "PerceptronMulticamadas_calcularTaxaAcerto") da rede fatorada.
+ *
+ * @param pf Rede fatorada.
+ *
+ * @param padroesTeste Padrões de teste (apenas com amostras densas,
+ *                     "AmostraDensa").
+ *
+ * @param qtdPadroesTeste Quantidade de padrões de teste.
+ *
+ * @return Taxa de acerto da rede (erro MSE), ou NAN caso algum padrão não
+ *         possua uma amostra densa.
+ */
+float PerceptronFatorado_calcularTaxaAcerto(PerceptronFatorado * pf,
+                                            PadraoTreinamento * padroesTeste,
+                                            int qtdPadroesTeste);
+
+#endif
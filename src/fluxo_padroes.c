@@ -0,0 +1,509 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "fluxo_padroes.h"
+#include "historico_treinamento.h"
+
+/**
+ * Método que retorna a hora atual em segundos.
+ */
+static double __horaAtualSegs()
+{
+  struct timeval hora;
+  gettimeofday(&hora, NULL);
+  return hora.tv_sec + hora.tv_usec / 1000000.0;
+}
+
+/**
+ * Método que extrai os itens de uma linha CSV (itens ausentes na linha são
+ * considerados nulos).
+ */
+static void __extrairItensLinha(char * linha, float * v, int qtdItens)
+{
+  memset(v, 0, sizeof(float) * qtdItens);
+
+  char * item = strtok(linha, ";\r\n");
+  for (int j = 0; j < qtdItens && item != NULL; j++)
+  {
+    v[j] = atof(item);
+    item = strtok(NULL, ";\r\n");
+  }
+}
+
+/**
+ * Método que lê até "qtdPadroesBloco" padrões dos arquivos CSV para um
+ * bloco, retornando a quantidade de bytes lidos.
+ */
+static uint64_t __lerBlocoCSV(FluxoPadroes * fluxo, BlocoFluxo * bloco)
+{
+  uint64_t bytesLidos = 0;
+
+  bloco->qtdPadroes = 0;
+  while (bloco->qtdPadroes < fluxo->qtdPadroesBloco)
+  {
+    ssize_t tamAmostra = getline(&fluxo->linhaAmostra,
+                                 &fluxo->tamLinhaAmostra, fluxo->arqAmostras);
+    ssize_t tamAlvo = (tamAmostra == -1) ? -1 :
+                      getline(&fluxo->linhaAlvo, &fluxo->tamLinhaAlvo,
+                              fluxo->arqAlvos);
+    if (tamAlvo == -1)
+    {
+      break;
+    }
+
+    float * h_amostra = bloco->h_amostras + (long) fluxo->qtdItensAmostra *
+                                            bloco->qtdPadroes;
+    float * h_alvo = bloco->h_alvos + (long) fluxo->qtdItensAlvo *
+                                      bloco->qtdPadroes;
+
+    __extrairItensLinha(fluxo->linhaAmostra, h_amostra,
+                        fluxo->qtdItensAmostra);
+    __extrairItensLinha(fluxo->linhaAlvo, h_alvo, fluxo->qtdItensAlvo);
+    normalizacaoMinMax(h_amostra, fluxo->qtdItensAmostra,
+                       fluxo->menorValAmostra, fluxo->maiorValAmostra);
+
+    bytesLidos += tamAmostra + tamAlvo;
+    bloco->qtdPadroes++;
+  }
+
+  return bytesLidos;
+}
+
+/**
+ * Método que lê o próximo bloco dos arquivos binários (na ordem dos blocos
+ * da época) diretamente nos "buffers", retornando a quantidade de bytes
+ * lidos. As amostras binárias já estão normalizadas (não são convertidas).
+ */
+static uint64_t __lerBlocoBinario(FluxoPadroes * fluxo, BlocoFluxo * bloco)
+{
+  size_t tamAmostra = sizeof(float) * fluxo->qtdItensAmostra;
+  size_t tamAlvo = sizeof(float) * fluxo->qtdItensAlvo;
+
+  bloco->qtdPadroes = 0;
+  bloco->fimEpoca = true;
+
+  if (fluxo->qtdBlocosArquivo == 0)
+  {
+    return 0;
+  }
+
+  /* Gerando a ordem dos blocos no início de cada época. */
+  if (fluxo->posicaoBlocoArquivo == 0)
+  {
+    ConfigEmbaralhamento_ordenarEpoca(&fluxo->embaralhamento,
+                                      fluxo->ordemBlocosArquivo,
+                                      fluxo->qtdBlocosArquivo,
+                                      fluxo->epocaLeitura);
+  }
+
+  long primeiroPadrao = (long) fluxo->qtdPadroesBloco *
+                        fluxo->ordemBlocosArquivo[fluxo->posicaoBlocoArquivo];
+  long qtdPadroes = fluxo->qtdPadroesArquivo - primeiroPadrao;
+  if (qtdPadroes > fluxo->qtdPadroesBloco)
+  {
+    qtdPadroes = fluxo->qtdPadroesBloco;
+  }
+
+  /* Na ordem dos arquivos a leitura continua de onde parou. */
+  if (fluxo->embaralhamento.modo != EmbaralhamentoDesativado)
+  {
+    fseeko(fluxo->arqAmostras, (off_t) primeiroPadrao * tamAmostra,
+           SEEK_SET);
+    fseeko(fluxo->arqAlvos, (off_t) primeiroPadrao * tamAlvo, SEEK_SET);
+  }
+
+  size_t qtdAmostras = fread(bloco->h_amostras, tamAmostra, qtdPadroes,
+                             fluxo->arqAmostras);
+  size_t qtdAlvos = fread(bloco->h_alvos, tamAlvo, qtdAmostras,
+                          fluxo->arqAlvos);
+
+  bloco->qtdPadroes = (int) qtdAlvos;
+
+  fluxo->posicaoBlocoArquivo++;
+  bloco->fimEpoca = fluxo->posicaoBlocoArquivo == fluxo->qtdBlocosArquivo;
+
+  return qtdAmostras * tamAmostra + qtdAlvos * tamAlvo;
+}
+
+/**
+ * Método executado pela thread que lê os blocos do fluxo.
+ */
+static void * __executarThreadLeitura(void * args)
+{
+  FluxoPadroes * fluxo = (FluxoPadroes *) args;
+  int b = 0;
+
+  while (true)
+  {
+    /* Aguardando o consumo do bloco (ou o encerramento do fluxo). */
+    pthread_mutex_lock(&fluxo->mutex);
+    while (fluxo->blocos[b].cheio && !fluxo->encerrar)
+    {
+      pthread_cond_wait(&fluxo->condLivre, &fluxo->mutex);
+    }
+
+    if (fluxo->encerrar)
+    {
+      pthread_mutex_unlock(&fluxo->mutex);
+      break;
+    }
+    pthread_mutex_unlock(&fluxo->mutex);
+
+    /* Lendo o bloco fora do "mutex" (o treinamento não acessa um bloco
+       que não está cheio). */
+    BlocoFluxo * bloco = &fluxo->blocos[b];
+    uint64_t bytesLidos;
+
+    if (fluxo->formato == FormatoFluxoBinario)
+    {
+      bytesLidos = __lerBlocoBinario(fluxo, bloco);
+    }
+    else
+    {
+      /* No CSV, um bloco incompleto encerra a época. */
+      bytesLidos = __lerBlocoCSV(fluxo, bloco);
+      bloco->fimEpoca = bloco->qtdPadroes < fluxo->qtdPadroesBloco;
+    }
+
+    /* Retornando ao início dos arquivos para antecipar a leitura da
+       próxima época. */
+    if (bloco->fimEpoca)
+    {
+      rewind(fluxo->arqAmostras);
+      rewind(fluxo->arqAlvos);
+      fluxo->posicaoBlocoArquivo = 0;
+      fluxo->epocaLeitura++;
+    }
+
+    /* Entregando o bloco para o treinamento. */
+    pthread_mutex_lock(&fluxo->mutex);
+    bloco->cheio = true;
+    fluxo->bytesLidos += bytesLidos;
+    pthread_cond_signal(&fluxo->condCheio);
+    pthread_mutex_unlock(&fluxo->mutex);
+
+    b = 1 - b;
+  }
+
+  return NULL;
+}
+
+FluxoPadroes * FluxoPadroes_abrir(char * nomeArquivoAmostras,
+                                  char * nomeArquivoAlvos,
+                                  int formato,
+                                  float menorValAmostra,
+                                  float maiorValAmostra,
+                                  int qtdItensAmostra,
+                                  int qtdItensAlvo,
+                                  int qtdPadroesBloco,
+                                  const ConfigEmbaralhamento *
+                                  embaralhamento)
+{
+  /* Tentando abrir os arquivos para leitura. */
+  const char * modo = (formato == FormatoFluxoBinario) ? "rb" : "r";
+  FILE * arqAmostras = fopen(nomeArquivoAmostras, modo);
+  FILE * arqAlvos = fopen(nomeArquivoAlvos, modo);
+
+  if (arqAmostras == NULL || arqAlvos == NULL)
+  {
+    if (arqAmostras != NULL) fclose(arqAmostras);
+    if (arqAlvos != NULL) fclose(arqAlvos);
+    return NULL;
+  }
+
+  /* Os arquivos são lidos sequencialmente (o sistema pode antecipar a
+     leitura de trechos maiores). */
+  posix_fadvise(fileno(arqAmostras), 0, 0, POSIX_FADV_SEQUENTIAL);
+  posix_fadvise(fileno(arqAlvos), 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  FluxoPadroes * fluxo = malloc(sizeof(FluxoPadroes));
+
+  fluxo->arqAmostras = arqAmostras;
+  fluxo->arqAlvos = arqAlvos;
+  fluxo->formato = formato;
+  fluxo->qtdItensAmostra = qtdItensAmostra;
+  fluxo->qtdItensAlvo = qtdItensAlvo;
+  fluxo->menorValAmostra = menorValAmostra;
+  fluxo->maiorValAmostra = maiorValAmostra;
+  fluxo->qtdPadroesBloco = qtdPadroesBloco;
+
+  if (embaralhamento != NULL)
+  {
+    fluxo->embaralhamento = *embaralhamento;
+  }
+  else
+  {
+    fluxo->embaralhamento.modo = EmbaralhamentoDesativado;
+    fluxo->embaralhamento.semente = SEMENTE_EMBARALHAMENTO;
+  }
+
+  /* Os blocos do fluxo são as unidades do embaralhamento: a ordem dos
+     blocos de cada época é uma permutação completa. */
+  if (fluxo->embaralhamento.modo != EmbaralhamentoDesativado)
+  {
+    fluxo->embaralhamento.modo = EmbaralhamentoCompleto;
+  }
+  fluxo->embaralhamento.tamBloco = qtdPadroesBloco;
+
+  /* A quantidade de padrões dos arquivos binários é obtida pelo tamanho
+     dos mesmos (padrões incompletos no fim dos arquivos são ignorados). */
+  fluxo->qtdPadroesArquivo = 0;
+  if (formato == FormatoFluxoBinario)
+  {
+    struct stat infoAmostras;
+    struct stat infoAlvos;
+    fstat(fileno(arqAmostras), &infoAmostras);
+    fstat(fileno(arqAlvos), &infoAlvos);
+
+    long qtdAmostras = infoAmostras.st_size /
+                       (sizeof(float) * qtdItensAmostra);
+    long qtdAlvos = infoAlvos.st_size / (sizeof(float) * qtdItensAlvo);
+    fluxo->qtdPadroesArquivo = (qtdAmostras < qtdAlvos) ? qtdAmostras :
+                                                          qtdAlvos;
+  }
+
+  fluxo->qtdBlocosArquivo = (int) ((fluxo->qtdPadroesArquivo +
+                                    qtdPadroesBloco - 1) / qtdPadroesBloco);
+  fluxo->ordemBlocosArquivo = malloc(sizeof(int) *
+                                     (fluxo->qtdBlocosArquivo + 1));
+  fluxo->posicaoBlocoArquivo = 0;
+  fluxo->epocaLeitura = 0;
+  fluxo->epocaConsumo = 0;
+  fluxo->ordemPadroesBloco = malloc(sizeof(int) * qtdPadroesBloco);
+
+  size_t tamAmostras = sizeof(float) * qtdItensAmostra * qtdPadroesBloco;
+  size_t tamAlvos = sizeof(float) * qtdItensAlvo * qtdPadroesBloco;
+
+  /* Alocando os "buffers" duplos (na "pinned memory"). */
+  for (int b = 0; b < 2; b++)
+  {
+    cudaMallocHost((void **) &fluxo->blocos[b].h_amostras, tamAmostras);
+    cudaMallocHost((void **) &fluxo->blocos[b].h_alvos, tamAlvos);
+    fluxo->blocos[b].qtdPadroes = 0;
+    fluxo->blocos[b].fimEpoca = false;
+    fluxo->blocos[b].cheio = false;
+  }
+  fluxo->blocoConsumo = 0;
+
+  /* Alocando o bloco do dispositivo acelerador e os padrões (fixos) que
+     apontam para cada amostra e objetivo do mesmo. */
+  cudaMalloc((void **) &fluxo->d_amostras, tamAmostras);
+  cudaMalloc((void **) &fluxo->d_alvos, tamAlvos);
+
+  fluxo->padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroesBloco);
+  for (int i = 0; i < qtdPadroesBloco; i++)
+  {
+    fluxo->padroes[i].d_amostra = fluxo->d_amostras +
+                                  (long) qtdItensAmostra * i;
+    fluxo->padroes[i].d_alvo = fluxo->d_alvos + (long) qtdItensAlvo * i;
+    fluxo->padroes[i].tipoAmostra = AmostraDensa;
+    fluxo->padroes[i].d_indices = NULL;
+    fluxo->padroes[i].qtdNaoNulos = 0;
+  }
+
+  fluxo->linhaAmostra = NULL;
+  fluxo->tamLinhaAmostra = 0;
+  fluxo->linhaAlvo = NULL;
+  fluxo->tamLinhaAlvo = 0;
+  fluxo->bytesLidos = 0;
+  fluxo->segsEsperaLeitura = 0;
+  fluxo->encerrar = false;
+
+  pthread_mutex_init(&fluxo->mutex, NULL);
+  pthread_cond_init(&fluxo->condCheio, NULL);
+  pthread_cond_init(&fluxo->condLivre, NULL);
+  pthread_create(&fluxo->threadLeitura, NULL, __executarThreadLeitura,
+                 fluxo);
+
+  return fluxo;
+}
+
+PadraoTreinamento * FluxoPadroes_proximoBloco(FluxoPadroes * fluxo,
+                                              int * qtdPadroes,
+                                              bool * fimEpoca)
+{
+  BlocoFluxo * bloco = &fluxo->blocos[fluxo->blocoConsumo];
+
+  /* Aguardando a leitura do bloco. */
+  double inicioEspera = __horaAtualSegs();
+
+  pthread_mutex_lock(&fluxo->mutex);
+  while (!bloco->cheio)
+  {
+    pthread_cond_wait(&fluxo->condCheio, &fluxo->mutex);
+  }
+  pthread_mutex_unlock(&fluxo->mutex);
+
+  fluxo->segsEsperaLeitura += __horaAtualSegs() - inicioEspera;
+
+  /* Copiando o bloco para o dispositivo acelerador (o bloco anterior já
+     foi consumido pelo treinamento). */
+  *qtdPadroes = bloco->qtdPadroes;
+  *fimEpoca = bloco->fimEpoca;
+
+  if (bloco->qtdPadroes > 0)
+  {
+    cudaMemcpy(fluxo->d_amostras, bloco->h_amostras,
+               sizeof(float) * fluxo->qtdItensAmostra * bloco->qtdPadroes,
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(fluxo->d_alvos, bloco->h_alvos,
+               sizeof(float) * fluxo->qtdItensAlvo * bloco->qtdPadroes,
+               cudaMemcpyHostToDevice);
+  }
+
+  /* Liberando o "buffer" para a leitura do bloco seguinte, que ocorre
+     enquanto este bloco é apresentado à rede. */
+  pthread_mutex_lock(&fluxo->mutex);
+  bloco->cheio = false;
+  pthread_cond_signal(&fluxo->condLivre);
+  pthread_mutex_unlock(&fluxo->mutex);
+
+  fluxo->blocoConsumo = 1 - fluxo->blocoConsumo;
+
+  return fluxo->padroes;
+}
+
+void FluxoPadroes_fechar(FluxoPadroes * fluxo)
+{
+  pthread_mutex_lock(&fluxo->mutex);
+  fluxo->encerrar = true;
+  pthread_cond_signal(&fluxo->condLivre);
+  pthread_mutex_unlock(&fluxo->mutex);
+
+  pthread_join(fluxo->threadLeitura, NULL);
+
+  for (int b = 0; b < 2; b++)
+  {
+    cudaFreeHost(fluxo->blocos[b].h_amostras);
+    cudaFreeHost(fluxo->blocos[b].h_alvos);
+  }
+
+  cudaFree(fluxo->d_amostras);
+  cudaFree(fluxo->d_alvos);
+  free(fluxo->padroes);
+  free(fluxo->ordemBlocosArquivo);
+  free(fluxo->ordemPadroesBloco);
+  free(fluxo->linhaAmostra);
+  free(fluxo->linhaAlvo);
+
+  fclose(fluxo->arqAmostras);
+  fclose(fluxo->arqAlvos);
+
+  pthread_mutex_destroy(&fluxo->mutex);
+  pthread_cond_destroy(&fluxo->condCheio);
+  pthread_cond_destroy(&fluxo->condLivre);
+  free(fluxo);
+}
+
+float FluxoPadroes_treinarEpoca(FluxoPadroes * fluxo,
+                                PerceptronMulticamadas * pm,
+                                ContextoExecucao * contexto,
+                                float taxaAprendizagem,
+                                long * qtdPadroesEpoca)
+{
+  float erroGlobal = 0;
+  bool fimEpoca = false;
+
+  *qtdPadroesEpoca = 0;
+
+  /* Gerador da ordem dos padrões dentro dos blocos desta época (a ordem
+     dos blocos é gerada pela thread de leitura com a mesma semente). */
+  uint64_t sementeEpoca = GeradorAleatorio_contador(
+                            ~fluxo->embaralhamento.semente,
+                            fluxo->epocaConsumo);
+  GeradorAleatorio gerador;
+  GeradorAleatorio_inicializar(&gerador, sementeEpoca);
+
+  while (!fimEpoca)
+  {
+    int qtdPadroes;
+    PadraoTreinamento * padroes = FluxoPadroes_proximoBloco(fluxo,
+                                                            &qtdPadroes,
+                                                            &fimEpoca);
+
+    for (int i = 0; i < qtdPadroes; i++)
+    {
+      fluxo->ordemPadroesBloco[i] = i;
+    }
+
+    if (fluxo->embaralhamento.modo != EmbaralhamentoDesativado)
+    {
+      embaralhamentoFisherYates(fluxo->ordemPadroesBloco, qtdPadroes,
+                                &gerador);
+    }
+
+    for (int i = 0; i < qtdPadroes; i++)
+    {
+      erroGlobal += __treinarPadrao(pm, contexto,
+                                    &padroes[fluxo->ordemPadroesBloco[i]],
+                                    taxaAprendizagem);
+    }
+
+    *qtdPadroesEpoca += qtdPadroes;
+  }
+
+  fluxo->epocaConsumo++;
+
+  /* Retornando o erro MSE. */
+  return (*qtdPadroesEpoca > 0) ? erroGlobal / *qtdPadroesEpoca : 0;
+}
+
+HistoricoTreinamento *
+PerceptronMulticamadas_backpropagationFluxo(PerceptronMulticamadas * pm,
+                                            FluxoPadroes * fluxo,
+                                            float taxaAprendizagem,
+                                            float erroDesejado,
+                                            bool gerarHistorico)
+{
+  HistoricoTreinamento * historicoTreinamento = NULL;
+  if (gerarHistorico)
+  {
+    historicoTreinamento = HistoricoTreinamento_inicializar(pm,
+                                                            taxaAprendizagem,
+                                                            erroDesejado);
+  }
+
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+  float h_erroGlobal;
+  int epocas = 0;
+
+  do
+  {
+    double inicio = __horaAtualSegs();
+    double segsEsperaAnterior = fluxo->segsEsperaLeitura;
+
+    long qtdPadroesEpoca;
+    h_erroGlobal = FluxoPadroes_treinarEpoca(fluxo, pm, contexto,
+                                             taxaAprendizagem,
+                                             &qtdPadroesEpoca);
+
+    float segs = __horaAtualSegs() - inicio;
+
+    /* Arquivos sem nenhum padrão. */
+    if (qtdPadroesEpoca == 0)
+    {
+      break;
+    }
+
+    epocas++;
+
+    if (gerarHistorico)
+    {
+      HistoricoTreinamento_adicionarInfoEpoca(historicoTreinamento, segs,
+                                              h_erroGlobal);
+    }
+
+    if (INFO_ESTATISTICAS)
+    {
+      printf("Época: %d\nErro MSE: %.4f\n", epocas, h_erroGlobal);
+      printf("Tempo total de execução da época: %.2f segundo(s)\n", segs);
+      printf("Tempo aguardando a leitura do disco: %.2f segundo(s)\n\n",
+             fluxo->segsEsperaLeitura - segsEsperaAnterior);
+    }
+
+  } while (h_erroGlobal > erroDesejado && epocas < QTD_MAX_EPOCAS);
+
+  ContextoExecucao_desalocar(contexto);
+
+  return historicoTreinamento;
+}
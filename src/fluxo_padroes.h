@@ -0,0 +1,271 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Fluxo de padrões lidos do disco em blocos por uma thread em segundo      *
+ * plano ("buffers" duplos), para o treinamento com conjuntos maiores que   *
+ * a memória.                                                               *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef FLUXO_PADROES_H
+#define FLUXO_PADROES_H
+
+#include "perceptron_multicamadas.h"
+
+/***************************************************************************
+ * Formatos dos arquivos (um arquivo de amostras e um de objetivos):       *
+ *                                                                         *
+ *   FormatoFluxoCSV: o mesmo de "PadraoTreinamento_carregarPadroesArquivo"*
+ *   (uma linha por padrão, itens separados por ';'), com as amostras      *
+ *   normalizadas ("min-max") durante a leitura.                           *
+ *                                                                         *
+ *   FormatoFluxoBinario: floats (fp32, "little-endian") sem separadores,  *
+ *   "qtdItensAmostra" por amostra e "qtdItensAlvo" por objetivo, que      *
+ *   DEVEM estar normalizados: os blocos são lidos diretamente nos         *
+ *   "buffers", sem conversão (o menor e o maior valor informados são      *
+ *   ignorados), e podem ser lidos em ordem aleatória (embaralhamento).    *
+ ***************************************************************************/
+
+/* Quantidade padrão de padrões por bloco. */
+#define QTD_PADROES_BLOCO_FLUXO 4096
+
+/**
+ * Enumeração dos formatos dos arquivos do fluxo.
+ */
+enum FormatosFluxoEnum
+{
+  FormatoFluxoCSV,
+  FormatoFluxoBinario
+};
+
+/**
+ * Estrutura com um bloco de padrões lido do disco (no hospedeiro).
+ */
+typedef struct
+{
+  /** Amostras e objetivos do bloco ("pinned memory", para que a cópia
+  para o dispositivo acelerador seja feita por DMA). */
+  float * h_amostras;
+  float * h_alvos;
+
+  /** Quantidade de padrões lidos (menor que o tamanho do bloco apenas no
+  bloco do fim do arquivo). */
+  int qtdPadroes;
+
+  /** Se o bloco é o último da época (todo o arquivo foi lido). */
+  bool fimEpoca;
+
+  /** Se o bloco foi lido e aguarda o consumo pelo treinamento (protegido
+  por "mutex"). */
+  bool cheio;
+
+} BlocoFluxo;
+
+/**
+ * Estrutura que controla o fluxo de padrões de um par de arquivos.
+ *
+ * A thread de leitura preenche o bloco livre enquanto o treinamento
+ * consome o outro bloco, retornando ao início dos arquivos ao final de
+ * cada época (de modo que a leitura da época seguinte também é antecipada).
+ * A memória utilizada é limitada a dois blocos no hospedeiro e um bloco no
+ * dispositivo acelerador, independente do tamanho dos arquivos.
+ *
+ * Com o embaralhamento, os padrões de cada bloco são apresentados em ordem
+ * aleatória e, no formato binário, os blocos também são lidos em ordem
+ * aleatória (cada bloco continua sendo uma leitura sequencial), como no
+ * modo "EmbaralhamentoBlocos" com blocos de "qtdPadroesBloco" padrões.
+ */
+typedef struct
+{
+  /** Arquivos de amostras e de objetivos. */
+  FILE * arqAmostras;
+  FILE * arqAlvos;
+
+  /** Formato dos arquivos (enumeração "FormatosFluxoEnum"). */
+  int formato;
+
+  /** Quantidade de itens por amostra e por objetivo. */
+  int qtdItensAmostra;
+  int qtdItensAlvo;
+
+  /** Normalização das amostras CSV. */
+  float menorValAmostra;
+  float maiorValAmostra;
+
+  /** Quantidade de padrões por bloco. */
+  int qtdPadroesBloco;
+
+  /** Configuração do embaralhamento (modo "EmbaralhamentoDesativado"
+  para a ordem dos arquivos). */
+  ConfigEmbaralhamento embaralhamento;
+
+  /** Quantidade de padrões e de blocos dos arquivos binários, ordem de
+  leitura dos blocos na época atual e posição da leitura nesta ordem. */
+  long qtdPadroesArquivo;
+  int qtdBlocosArquivo;
+  int * ordemBlocosArquivo;
+  int posicaoBlocoArquivo;
+
+  /** Épocas lidas pela thread de leitura e consumidas pelo treinamento. */
+  int epocaLeitura;
+  int epocaConsumo;
+
+  /** Ordem em que os padrões do bloco atual são apresentados à rede. */
+  int * ordemPadroesBloco;
+
+  /** "Buffers" duplos com os blocos e índice do próximo bloco a ser
+  consumido pelo treinamento. */
+  BlocoFluxo blocos[2];
+  int blocoConsumo;
+
+  /** Bloco atual no dispositivo acelerador e os padrões que apontam para
+  o mesmo. */
+  float * d_amostras;
+  float * d_alvos;
+  PadraoTreinamento * padroes;
+
+  /** Linhas utilizadas pela leitura dos arquivos CSV. */
+  char * linhaAmostra;
+  size_t tamLinhaAmostra;
+  char * linhaAlvo;
+  size_t tamLinhaAlvo;
+
+  /** Bytes lidos dos arquivos e tempo (em segundos) em que o treinamento
+  aguardou a leitura de um bloco (o disco está mais lento que o
+  treinamento). */
+  uint64_t bytesLidos;
+  double segsEsperaLeitura;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t condCheio;
+  pthread_cond_t condLivre;
+  pthread_t threadLeitura;
+
+  /** Se a thread de leitura deve ser encerrada. */
+  bool encerrar;
+
+} FluxoPadroes;
+
+/**
+ * Método que abre os arquivos, aloca os blocos e inicia a thread de
+ * leitura do fluxo.
+ *
+ * @param nomeArquivoAmostras Nome do arquivo com as amostras.
+ *
+ * @param nomeArquivoAlvos Nome do arquivo com os objetivos.
+ *
+ * @param formato Formato dos arquivos (enumeração "FormatosFluxoEnum").
+ *
+ * @param menorValAmostra Menor valor presente nas amostras (para a
+ *                        normalização das amostras CSV; ignorado no
+ *                        formato binário, cujas amostras já devem estar
+ *                        normalizadas).
+ *
+ * @param maiorValAmostra Maior valor presente nas amostras (para a
+ *                        normalização das amostras CSV; ignorado no
+ *                        formato binário).
+ *
+ * @param qtdItensAmostra Quantidade de itens por amostra.
+ *
+ * @param qtdItensAlvo Quantidade de itens por vetor de objetivo.
+ *
+ * @param qtdPadroesBloco Quantidade de padrões por bloco.
+ *
+ * @param embaralhamento Configuração do embaralhamento (NULO para a ordem
+ *                       dos arquivos). Os modos "EmbaralhamentoCompleto" e
+ *                       "EmbaralhamentoBlocos" são equivalentes no fluxo
+ *                       (o tamanho do bloco é "qtdPadroesBloco").
+ *
+ * @return Referência para o fluxo ou NULO caso não seja possível abrir os
+ *         arquivos para leitura.
+ */
+FluxoPadroes * FluxoPadroes_abrir(char * nomeArquivoAmostras,
+                                  char * nomeArquivoAlvos,
+                                  int formato,
+                                  float menorValAmostra,
+                                  float maiorValAmostra,
+                                  int qtdItensAmostra,
+                                  int qtdItensAlvo,
+                                  int qtdPadroesBloco,
+                                  const ConfigEmbaralhamento *
+                                  embaralhamento);
+
+/**
+ * Método que aguarda o próximo bloco do fluxo, copia o mesmo para o
+ * dispositivo acelerador e libera o "buffer" do hospedeiro para a leitura
+ * do bloco seguinte. Os padrões retornados permanecem válidos até a
+ * próxima chamada.
+ *
+ * @param fluxo Fluxo de padrões.
+ *
+ * @param qtdPadroes Variável onde será armazenada a quantidade de padrões
+ *                   do bloco (pode ser 0 no último bloco da época).
+ *
+ * @param fimEpoca Variável onde será armazenado se o bloco é o último da
+ *                 época.
+ *
+ * @return Vetor com os padrões do bloco (no dispositivo acelerador).
+ */
+PadraoTreinamento * FluxoPadroes_proximoBloco(FluxoPadroes * fluxo,
+                                              int * qtdPadroes,
+                                              bool * fimEpoca);
+
+/**
+ * Método que encerra a thread de leitura, fecha os arquivos e desaloca o
+ * fluxo.
+ *
+ * @param fluxo Fluxo de padrões.
+ */
+void FluxoPadroes_fechar(FluxoPadroes * fluxo);
+
+/**
+ * Método que apresenta todos os padrões de uma época do fluxo à rede
+ * (na ordem dos arquivos ou embaralhados), realizando o treinamento da
+ * mesma.
+ *
+ * @param fluxo Fluxo de padrões.
+ *
+ * @param pm Rede a ser treinada.
+ *
+ * @param contexto Contexto de execução do treinamento.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param qtdPadroesEpoca Variável onde será armazenada a quantidade de
+ *                        padrões da época.
+ *
+ * @return Erro MSE da época (0 caso a época não possua padrões).
+ */
+float FluxoPadroes_treinarEpoca(FluxoPadroes * fluxo,
+                                PerceptronMulticamadas * pm,
+                                ContextoExecucao * contexto,
+                                float taxaAprendizagem,
+                                long * qtdPadroesEpoca);
+
+/**
+ * Método que treina a rede com os padrões de um fluxo (da mesma forma que
+ * "PerceptronMulticamadas_backpropagation") até que o erro seja menor ou
+ * igual ao desejado ou a quantidade máxima de épocas seja atingida.
+ *
+ * @param pm Rede a ser treinada.
+ *
+ * @param fluxo Fluxo de padrões.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param erroDesejado Erro MSE desejado.
+ *
+ * @param gerarHistorico Se o histórico do treinamento deve ser gerado.
+ *
+ * @return Histórico do treinamento (NULO caso não tenha sido gerado).
+ */
+HistoricoTreinamento *
+PerceptronMulticamadas_backpropagationFluxo(PerceptronMulticamadas * pm,
+                                            FluxoPadroes * fluxo,
+                                            float taxaAprendizagem,
+                                            float erroDesejado,
+                                            bool gerarHistorico);
+
+#endif
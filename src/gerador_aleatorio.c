@@ -0,0 +1,84 @@
+#include "gerador_aleatorio.h"
+
+/**
+ * Método que rotaciona os bits de um número para a esquerda.
+ */
+static inline uint64_t __rotacionar(uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+void GeradorAleatorio_inicializar(GeradorAleatorio * gerador,
+                                  uint64_t semente)
+{
+  /* Preenchendo o estado com a sequência "splitmix64" da semente (o
+     estado nunca é inteiramente nulo). */
+  for (int i = 0; i < 4; i++)
+  {
+    gerador->estado[i] = GeradorAleatorio_contador(semente, i);
+  }
+}
+
+uint64_t GeradorAleatorio_proximo(GeradorAleatorio * gerador)
+{
+  uint64_t * s = gerador->estado;
+  uint64_t resultado = __rotacionar(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = __rotacionar(s[3], 45);
+
+  return resultado;
+}
+
+uint32_t GeradorAleatorio_inteiro(GeradorAleatorio * gerador,
+                                  uint32_t limite)
+{
+  /* Método de Lemire: os 32 bits mais significativos do produto de um
+     número de 32 bits pelo limite, rejeitando os poucos valores que
+     causariam viés. */
+  uint64_t produto = (GeradorAleatorio_proximo(gerador) >> 32) * limite;
+  uint32_t resto = (uint32_t) produto;
+
+  if (resto < limite)
+  {
+    uint32_t limiar = -limite % limite;
+    while (resto < limiar)
+    {
+      produto = (GeradorAleatorio_proximo(gerador) >> 32) * limite;
+      resto = (uint32_t) produto;
+    }
+  }
+
+  return (uint32_t) (produto >> 32);
+}
+
+#pragma acc routine seq
+uint64_t GeradorAleatorio_contador(uint64_t semente, uint64_t contador)
+{
+  uint64_t z = semente + (contador + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+#pragma acc routine seq
+float GeradorAleatorio_uniformeContador(uint64_t semente, uint64_t contador)
+{
+  /* Os 24 bits mais significativos (a precisão do float). */
+  return (GeradorAleatorio_contador(semente, contador) >> 40) *
+         (1.0f / 16777216.0f);
+}
+
+#pragma acc routine seq
+float GeradorAleatorio_normalContador(uint64_t semente, uint64_t contador)
+{
+  /* "1 - u" está em (0, 1], evitando o logaritmo de 0. */
+  float u1 = 1.0f - GeradorAleatorio_uniformeContador(semente, 2 * contador);
+  float u2 = GeradorAleatorio_uniformeContador(semente, 2 * contador + 1);
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.28318530718f * u2);
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Geradores de números pseudoaleatórios com semente explícita, para        *
+ * resultados reproduzíveis: sequencial ("xoshiro256**", inicializado pelo  *
+ * "splitmix64") e baseado em contador (o número "i-ésimo" de uma sequência *
+ * é calculado diretamente, permitindo o preenchimento em paralelo).        *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef GERADOR_ALEATORIO_H
+#define GERADOR_ALEATORIO_H
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Estrutura com o estado do gerador (cada thread deve utilizar o seu
+ * próprio estado).
+ */
+typedef struct
+{
+  uint64_t estado[4];
+
+} GeradorAleatorio;
+
+/**
+ * Método que inicializa o estado do gerador a partir de uma semente
+ * (sementes próximas resultam em sequências independentes).
+ *
+ * @param gerador Gerador a ser inicializado.
+ *
+ * @param semente Semente do gerador.
+ */
+void GeradorAleatorio_inicializar(GeradorAleatorio * gerador,
+                                  uint64_t semente);
+
+/**
+ * Método que retorna o próximo número (64 bits) da sequência.
+ *
+ * @param gerador Gerador.
+ *
+ * @return Número pseudoaleatório.
+ */
+uint64_t GeradorAleatorio_proximo(GeradorAleatorio * gerador);
+
+/**
+ * Método que retorna um inteiro uniformemente distribuído entre 0 e
+ * "limite - 1" (sem o viés de "rand() % limite").
+ *
+ * @param gerador Gerador.
+ *
+ * @param limite Limite (exclusivo) do intervalo, maior que 0.
+ *
+ * @return Inteiro entre 0 e "limite - 1".
+ */
+uint32_t GeradorAleatorio_inteiro(GeradorAleatorio * gerador,
+                                  uint32_t limite);
+
+/**
+ * Método que retorna o número (64 bits) de posição "contador" da sequência
+ * de uma semente ("splitmix64" da posição). O resultado depende apenas da
+ * semente e do contador, de modo que os números podem ser calculados em
+ * qualquer ordem e por qualquer quantidade de threads.
+ *
+ * @param semente Semente da sequência.
+ *
+ * @param contador Posição do número na sequência.
+ *
+ * @return Número pseudoaleatório.
+ */
+#pragma acc routine seq
+uint64_t GeradorAleatorio_contador(uint64_t semente, uint64_t contador);
+
+/**
+ * Método que retorna o número de posição "contador" da sequência de uma
+ * semente como um float uniformemente distribuído no intervalo [0, 1).
+ *
+ * @param semente Semente da sequência.
+ *
+ * @param contador Posição do número na sequência.
+ *
+ * @return Número pseudoaleatório entre 0 (inclusive) e 1 (exclusive).
+ */
+#pragma acc routine seq
+float GeradorAleatorio_uniformeContador(uint64_t semente, uint64_t contador);
+
+/**
+ * Método que retorna um número com distribuição normal padrão (média 0 e
+ * desvio padrão 1) calculado a partir da posição "contador" da sequência de
+ * uma semente (Box-Muller com as posições "2 * contador" e
+ * "2 * contador + 1").
+ *
+ * @param semente Semente da sequência.
+ *
+ * @param contador Posição do número.
+ *
+ * @return Número pseudoaleatório com distribuição normal padrão.
+ */
+#pragma acc routine seq
+float GeradorAleatorio_normalContador(uint64_t semente, uint64_t contador);
+
+#endif
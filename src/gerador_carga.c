@@ -0,0 +1,239 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Gerador de carga para o servidor de inferência local: para cada         *
+ * quantidade de clientes concorrentes (1, 2, 4, ...), cada cliente envia   *
+ * requisições em sequência durante um período, e são reportadas a vazão   *
+ * e a latência (curva vazão x latência), permitindo ajustar a janela dos   *
+ * micro-lotes.                                                             *
+ *                                                                          *
+ * Uso: ./gerador_carga <socket> <qtdNeuroniosEntrada> <qtdNeuroniosSaida>  *
+ *                      [duração de cada nível em segundos]                 *
+ *                      [quantidade máxima de clientes]                     *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+ * Estrutura com os argumentos e os resultados de cada cliente.
+ */
+typedef struct
+{
+  const char * caminhoSocket;
+  int qtdNeuroniosEntrada;
+  int qtdNeuroniosSaida;
+  double prazo;
+
+  /** Semente da amostra aleatória do cliente ("rand_r", pois "rand" não é
+  seguro entre threads). */
+  unsigned int semente;
+
+  /** Latências (em microssegundos) das requisições realizadas. */
+  double * latencias;
+  int qtdLatencias;
+  int capacidadeLatencias;
+
+  bool falhou;
+} Cliente;
+
+static double horaAtualSegs()
+{
+  struct timespec hora;
+  clock_gettime(CLOCK_MONOTONIC, &hora);
+  return hora.tv_sec + hora.tv_nsec / 1e9;
+}
+
+static bool lerSocket(int socketConexao, void * buffer, size_t qtdBytes)
+{
+  char * posicao = (char *) buffer;
+  while (qtdBytes > 0)
+  {
+    ssize_t qtdLidos = recv(socketConexao, posicao, qtdBytes, 0);
+    if (qtdLidos <= 0)
+    {
+      return false;
+    }
+    posicao += qtdLidos;
+    qtdBytes -= qtdLidos;
+  }
+  return true;
+}
+
+static bool escreverSocket(int socketConexao, const void * buffer,
+                           size_t qtdBytes)
+{
+  const char * posicao = (const char *) buffer;
+  while (qtdBytes > 0)
+  {
+    ssize_t qtdEscritos = send(socketConexao, posicao, qtdBytes, MSG_NOSIGNAL);
+    if (qtdEscritos <= 0)
+    {
+      return false;
+    }
+    posicao += qtdEscritos;
+    qtdBytes -= qtdEscritos;
+  }
+  return true;
+}
+
+/**
+ * Thread de um cliente: envia requisições (e aguarda as respostas) até o
+ * prazo, registrando a latência de cada uma.
+ */
+static void * executarCliente(void * args)
+{
+  Cliente * cliente = (Cliente *) args;
+
+  struct sockaddr_un endereco;
+  memset(&endereco, 0, sizeof(endereco));
+  endereco.sun_family = AF_UNIX;
+  strncpy(endereco.sun_path, cliente->caminhoSocket,
+          sizeof(endereco.sun_path) - 1);
+
+  int socketConexao = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socketConexao < 0 ||
+      connect(socketConexao, (struct sockaddr *) &endereco,
+              sizeof(endereco)) != 0)
+  {
+    cliente->falhou = true;
+    return NULL;
+  }
+
+  /* Montando a requisição (prefixo de tamanho + amostra aleatória). */
+  uint32_t qtdBytesAmostra = sizeof(float) * cliente->qtdNeuroniosEntrada;
+  char * requisicao = malloc(sizeof(uint32_t) + qtdBytesAmostra);
+  float * amostra = (float *) (requisicao + sizeof(uint32_t));
+  memcpy(requisicao, &qtdBytesAmostra, sizeof(uint32_t));
+  for (int i = 0; i < cliente->qtdNeuroniosEntrada; i++)
+  {
+    amostra[i] = (float) rand_r(&cliente->semente) / RAND_MAX;
+  }
+
+  float * saida = malloc(sizeof(float) * cliente->qtdNeuroniosSaida);
+
+  while (horaAtualSegs() < cliente->prazo)
+  {
+    double antes = horaAtualSegs();
+
+    uint32_t qtdBytesResposta;
+    if (!escreverSocket(socketConexao, requisicao,
+                        sizeof(uint32_t) + qtdBytesAmostra) ||
+        !lerSocket(socketConexao, &qtdBytesResposta, sizeof(uint32_t)) ||
+        qtdBytesResposta != sizeof(float) * cliente->qtdNeuroniosSaida ||
+        !lerSocket(socketConexao, saida, qtdBytesResposta))
+    {
+      cliente->falhou = true;
+      break;
+    }
+
+    /* Registrando a latência. */
+    if (cliente->qtdLatencias == cliente->capacidadeLatencias)
+    {
+      cliente->capacidadeLatencias *= 2;
+      cliente->latencias = realloc(cliente->latencias, sizeof(double) *
+                                   cliente->capacidadeLatencias);
+    }
+    cliente->latencias[cliente->qtdLatencias++] =
+      (horaAtualSegs() - antes) * 1e6;
+  }
+
+  close(socketConexao);
+  free(requisicao);
+  free(saida);
+
+  return NULL;
+}
+
+static int compararDouble(const void * a, const void * b)
+{
+  double da = *(const double *) a;
+  double db = *(const double *) b;
+  return (da > db) - (da < db);
+}
+
+int main(int argc, char ** argv)
+{
+  if (argc < 4)
+  {
+    printf("Uso: %s <socket> <qtdNeuroniosEntrada> <qtdNeuroniosSaida> "
+           "[duracaoSegs] [qtdMaxClientes]\n", argv[0]);
+    return 1;
+  }
+
+  int qtdNeuroniosEntrada = atoi(argv[2]);
+  int qtdNeuroniosSaida = atoi(argv[3]);
+  double duracaoSegs = (argc > 4) ? atof(argv[4]) : 5;
+  int qtdMaxClientes = (argc > 5) ? atoi(argv[5]) : 64;
+
+  printf("clientes;requisicoes_por_segundo;p50_us;p99_us;p999_us\n");
+
+  for (int qtdClientes = 1; qtdClientes <= qtdMaxClientes; qtdClientes *= 2)
+  {
+    Cliente * clientes = calloc(qtdClientes, sizeof(Cliente));
+    pthread_t * threads = malloc(sizeof(pthread_t) * qtdClientes);
+    double inicio = horaAtualSegs();
+
+    for (int c = 0; c < qtdClientes; c++)
+    {
+      clientes[c].caminhoSocket = argv[1];
+      clientes[c].qtdNeuroniosEntrada = qtdNeuroniosEntrada;
+      clientes[c].qtdNeuroniosSaida = qtdNeuroniosSaida;
+      clientes[c].prazo = inicio + duracaoSegs;
+      clientes[c].semente = c + 1;
+      clientes[c].capacidadeLatencias = 1024;
+      clientes[c].latencias = malloc(sizeof(double) * 1024);
+      pthread_create(&threads[c], NULL, executarCliente, &clientes[c]);
+    }
+
+    /* Juntando as latências de todos os clientes. */
+    int qtdTotal = 0;
+    bool falhou = false;
+    for (int c = 0; c < qtdClientes; c++)
+    {
+      pthread_join(threads[c], NULL);
+      qtdTotal += clientes[c].qtdLatencias;
+      falhou = falhou || clientes[c].falhou;
+    }
+    double duracaoReal = horaAtualSegs() - inicio;
+
+    if (falhou || qtdTotal == 0)
+    {
+      printf("Falha ao comunicar com o servidor em %s.\n", argv[1]);
+      return 1;
+    }
+
+    double * latencias = malloc(sizeof(double) * qtdTotal);
+    int posicao = 0;
+    for (int c = 0; c < qtdClientes; c++)
+    {
+      memcpy(&latencias[posicao], clientes[c].latencias,
+             sizeof(double) * clientes[c].qtdLatencias);
+      posicao += clientes[c].qtdLatencias;
+      free(clientes[c].latencias);
+    }
+    qsort(latencias, qtdTotal, sizeof(double), compararDouble);
+
+    printf("%d;%.0f;%.1f;%.1f;%.1f\n", qtdClientes, qtdTotal / duracaoReal,
+           latencias[(int) (qtdTotal * 0.50)],
+           latencias[(int) (qtdTotal * 0.99)],
+           latencias[(int) (qtdTotal * 0.999)]);
+
+    free(latencias);
+    free(clientes);
+    free(threads);
+  }
+
+  return 0;
+}
@@ -3,6 +3,7 @@
 #include <time.h>
 #include "perceptron_multicamadas.h"
 #include "historico_treinamento.h"
+#include "modelo_arquivo.h"
 
 int main()
 {
@@ -28,5 +29,9 @@ int main()
   char nomeArquivoHistorico[] = "historico_treinamento_XOR_NVIDIA.csv";
   HistoricoTreinamento_gerarArquivoCSV(historicoTreinamento, nomeArquivoHistorico);
 
+  /* Salvando a rede treinada (pode ser carregada, por exemplo, pelo
+     servidor de inferência). */
+  PerceptronMulticamadas_salvar(pm, "modelo_XOR.pmc");
+
   return 0;
 }
@@ -0,0 +1,444 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "modelo_arquivo.h"
+
+/**
+ * Método que arredonda um deslocamento para o próximo múltiplo de
+ * ALINHAMENTO_BLOCOS_MODELO.
+ */
+static uint64_t __alinharDeslocamento(uint64_t deslocamento)
+{
+  return (deslocamento + ALINHAMENTO_BLOCOS_MODELO - 1) /
+         ALINHAMENTO_BLOCOS_MODELO * ALINHAMENTO_BLOCOS_MODELO;
+}
+
+/**
+ * Método que escreve zeros no arquivo até que o mesmo atinja o
+ * deslocamento desejado (relativo ao início da imagem do modelo).
+ */
+static bool __escreverPreenchimento(FILE * arquivo, long inicioImagem,
+                                    uint64_t deslocamento)
+{
+  static const char zeros[ALINHAMENTO_BLOCOS_MODELO] = {0};
+
+  long posAtual = ftell(arquivo) - inicioImagem;
+  if (posAtual < 0 || (uint64_t) posAtual > deslocamento)
+  {
+    return false;
+  }
+
+  size_t qtdBytes = (size_t) (deslocamento - (uint64_t) posAtual);
+  return fwrite(zeros, 1, qtdBytes, arquivo) == qtdBytes;
+}
+
+/**
+ * Método que retorna a quantidade de itens da tabela de "embedding" da
+ * rede (0 caso a rede não possua a camada).
+ */
+static size_t __qtdItensTabelaEmbedding(const PerceptronMulticamadas * pm)
+{
+  return (pm->embedding == NULL) ? 0 :
+         (size_t) pm->embedding->qtdCategorias * pm->embedding->dimensao;
+}
+
+bool ModeloArquivo_escreverImagem(FILE * arquivo,
+                                  const PerceptronMulticamadas * pm,
+                                  float * const * h_W,
+                                  float * const * h_bias,
+                                  const float * h_tabelaEmbedding)
+{
+  long inicioImagem = ftell(arquivo);
+  if (inicioImagem < 0)
+  {
+    return false;
+  }
+
+  /* Montando o cabeçalho e os descritores das camadas, com os blocos de
+     pesos e bias posicionados logo após os descritores (alinhados). */
+  CabecalhoModelo cabecalho;
+  memset(&cabecalho, 0, sizeof(CabecalhoModelo));
+  memcpy(cabecalho.assinatura, ASSINATURA_MODELO, sizeof(cabecalho.assinatura));
+  cabecalho.versao = VERSAO_MODELO;
+  cabecalho.tamFloat = sizeof(float);
+  cabecalho.qtdNeuroniosEntrada = pm->qtdNeuroniosEntrada;
+  cabecalho.qtdCamadas = pm->qtdCamadas;
+
+  DescritorCamadaModelo * descritores;
+  descritores = calloc(pm->qtdCamadas, sizeof(DescritorCamadaModelo));
+
+  uint64_t deslocamento = sizeof(CabecalhoModelo) +
+                          sizeof(DescritorCamadaModelo) * pm->qtdCamadas;
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+
+    descritores[c].qtdNeuronios = camada->qtdNeuronios;
+    descritores[c].qtdPesosNeuronio = qtdPesosNeuronio;
+    descritores[c].funcaoAtivacao = camada->funcaoAtivacao;
+
+    descritores[c].deslocamentoW = __alinharDeslocamento(deslocamento);
+    deslocamento = descritores[c].deslocamentoW + sizeof(float) *
+                   ((uint64_t) camada->qtdNeuronios * qtdPesosNeuronio);
+
+    descritores[c].deslocamentoBias = __alinharDeslocamento(deslocamento);
+    deslocamento = descritores[c].deslocamentoBias +
+                   sizeof(float) * camada->qtdNeuronios;
+  }
+
+  /* A tabela de "embedding" fica após os blocos das camadas. */
+  size_t qtdItensTabela = __qtdItensTabelaEmbedding(pm);
+  if (pm->embedding != NULL)
+  {
+    cabecalho.qtdCategoriasEmbedding = pm->embedding->qtdCategorias;
+    cabecalho.dimensaoEmbedding = pm->embedding->dimensao;
+    cabecalho.qtdAtributosEmbedding = pm->embedding->qtdAtributos;
+    cabecalho.deslocamentoEmbedding = __alinharDeslocamento(deslocamento);
+    deslocamento = cabecalho.deslocamentoEmbedding +
+                   sizeof(float) * qtdItensTabela;
+  }
+
+  cabecalho.tamArquivo = deslocamento;
+
+  bool sucesso = fwrite(&cabecalho, sizeof(CabecalhoModelo), 1, arquivo) == 1
+                 && fwrite(descritores, sizeof(DescritorCamadaModelo),
+                           pm->qtdCamadas, arquivo) == (size_t) pm->qtdCamadas;
+
+  for (int c = 0; c < pm->qtdCamadas && sucesso; c++)
+  {
+    size_t qtdPesos = (size_t) descritores[c].qtdNeuronios *
+                      descritores[c].qtdPesosNeuronio;
+    size_t qtdNeuronios = descritores[c].qtdNeuronios;
+
+    sucesso = __escreverPreenchimento(arquivo, inicioImagem,
+                                      descritores[c].deslocamentoW)
+              && fwrite(h_W[c], sizeof(float), qtdPesos, arquivo) == qtdPesos
+              && __escreverPreenchimento(arquivo, inicioImagem,
+                                         descritores[c].deslocamentoBias)
+              && fwrite(h_bias[c], sizeof(float), qtdNeuronios,
+                        arquivo) == qtdNeuronios;
+  }
+
+  if (sucesso && pm->embedding != NULL)
+  {
+    sucesso = __escreverPreenchimento(arquivo, inicioImagem,
+                                      cabecalho.deslocamentoEmbedding)
+              && fwrite(h_tabelaEmbedding, sizeof(float), qtdItensTabela,
+                        arquivo) == qtdItensTabela;
+  }
+
+  free(descritores);
+
+  return sucesso;
+}
+
+bool PerceptronMulticamadas_salvar(const PerceptronMulticamadas * pm,
+                                   const char * nomeArquivo)
+{
+  /* Copiando os pesos e os bias de cada camada do dispositivo acelerador
+     para o hospedeiro. */
+  float ** h_W = malloc(sizeof(float *) * pm->qtdCamadas);
+  float ** h_bias = malloc(sizeof(float *) * pm->qtdCamadas);
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+    size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+    h_W[c] = malloc(sizeof(float) * qtdPesos);
+    h_bias[c] = malloc(sizeof(float) * camada->qtdNeuronios);
+
+    Camada_copiarPesosHospedeiro(camada, qtdPesosNeuronio, h_W[c]);
+    cudaMemcpy(h_bias[c], camada->d_bias,
+               sizeof(float) * camada->qtdNeuronios, cudaMemcpyDeviceToHost);
+  }
+
+  float * h_tabelaEmbedding = NULL;
+  if (pm->embedding != NULL)
+  {
+    size_t qtdItensTabela = __qtdItensTabelaEmbedding(pm);
+    h_tabelaEmbedding = malloc(sizeof(float) * qtdItensTabela);
+    cudaMemcpy(h_tabelaEmbedding, pm->embedding->d_tabela,
+               sizeof(float) * qtdItensTabela, cudaMemcpyDeviceToHost);
+  }
+
+  /* Escrevendo em um arquivo temporário, que só substitui o arquivo de
+     modelo após ter sido escrito por completo. */
+  char * nomeArquivoTmp = malloc(strlen(nomeArquivo) + 5);
+  sprintf(nomeArquivoTmp, "%s.tmp", nomeArquivo);
+
+  bool sucesso = false;
+  FILE * arquivo = fopen(nomeArquivoTmp, "wb");
+  if (arquivo != NULL)
+  {
+    sucesso = ModeloArquivo_escreverImagem(arquivo, pm, h_W, h_bias,
+                                           h_tabelaEmbedding);
+    sucesso = (fclose(arquivo) == 0) && sucesso;
+    sucesso = sucesso && rename(nomeArquivoTmp, nomeArquivo) == 0;
+
+    if (!sucesso)
+    {
+      remove(nomeArquivoTmp);
+    }
+  }
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    free(h_W[c]);
+    free(h_bias[c]);
+  }
+  free(h_W);
+  free(h_bias);
+  free(h_tabelaEmbedding);
+  free(nomeArquivoTmp);
+
+  return sucesso;
+}
+
+/**
+ * Método que verifica se um bloco de "qtdFloats" floats, iniciado no
+ * deslocamento informado, está contido na imagem e alinhado a um float.
+ */
+static bool __blocoValido(uint64_t deslocamento, uint64_t qtdFloats,
+                          uint64_t tamImagem)
+{
+  return deslocamento % sizeof(float) == 0
+         && deslocamento <= tamImagem
+         && qtdFloats <= (tamImagem - deslocamento) / sizeof(float);
+}
+
+bool ModeloArquivo_validarImagem(const char * h_modelo, uint64_t tamImagem)
+{
+  if (tamImagem < sizeof(CabecalhoModelo))
+  {
+    return false;
+  }
+
+  const CabecalhoModelo * cabecalho = (const CabecalhoModelo *) h_modelo;
+
+  if (memcmp(cabecalho->assinatura, ASSINATURA_MODELO,
+             sizeof(cabecalho->assinatura)) != 0
+      || cabecalho->versao != VERSAO_MODELO
+      || cabecalho->tamFloat != sizeof(float)
+      || cabecalho->tamArquivo != tamImagem
+      || cabecalho->qtdCamadas == 0
+      || cabecalho->qtdCamadas > (tamImagem - sizeof(CabecalhoModelo)) /
+                                 sizeof(DescritorCamadaModelo))
+  {
+    return false;
+  }
+
+  const DescritorCamadaModelo * descritores;
+  descritores = (const DescritorCamadaModelo *) (h_modelo +
+                                                 sizeof(CabecalhoModelo));
+
+  uint32_t qtdPesosNeuronioEsperada = cabecalho->qtdNeuroniosEntrada;
+
+  for (uint32_t c = 0; c < cabecalho->qtdCamadas; c++)
+  {
+    const DescritorCamadaModelo * descritor = &descritores[c];
+
+    /* A quantidade de pesos de cada neurônio deve corresponder à saída da
+       camada anterior (ou à entrada, na primeira camada). */
+    if (descritor->qtdNeuronios == 0
+        || descritor->qtdPesosNeuronio != qtdPesosNeuronioEsperada
+        || descritor->funcaoAtivacao < Identidade
+        || descritor->funcaoAtivacao > TangHiperbolica
+        || !__blocoValido(descritor->deslocamentoW,
+                          (uint64_t) descritor->qtdNeuronios *
+                          descritor->qtdPesosNeuronio, tamImagem)
+        || !__blocoValido(descritor->deslocamentoBias,
+                          descritor->qtdNeuronios, tamImagem))
+    {
+      return false;
+    }
+
+    qtdPesosNeuronioEsperada = descritor->qtdNeuronios;
+  }
+
+  /* Os vetores da camada de "embedding" (caso exista) devem caber na
+     entrada da primeira camada. */
+  if (cabecalho->qtdCategoriasEmbedding == 0)
+  {
+    return cabecalho->dimensaoEmbedding == 0
+           && cabecalho->qtdAtributosEmbedding == 0;
+  }
+
+  return cabecalho->dimensaoEmbedding > 0
+         && cabecalho->qtdAtributosEmbedding > 0
+         && (uint64_t) cabecalho->qtdAtributosEmbedding *
+            cabecalho->dimensaoEmbedding <= cabecalho->qtdNeuroniosEntrada
+         && __blocoValido(cabecalho->deslocamentoEmbedding,
+                          (uint64_t) cabecalho->qtdCategoriasEmbedding *
+                          cabecalho->dimensaoEmbedding, tamImagem);
+}
+
+bool ModeloArquivo_copiarParametros(PerceptronMulticamadas * pm,
+                                    const char * h_modelo,
+                                    uint64_t tamImagem)
+{
+  if (!ModeloArquivo_validarImagem(h_modelo, tamImagem))
+  {
+    return false;
+  }
+
+  const CabecalhoModelo * cabecalho = (const CabecalhoModelo *) h_modelo;
+  const DescritorCamadaModelo * descritores;
+  descritores = (const DescritorCamadaModelo *) (h_modelo +
+                                                 sizeof(CabecalhoModelo));
+
+  /* Verificando se a topologia da imagem é a mesma da rede (incluindo a
+     camada de "embedding"). */
+  const CamadaEmbedding * embedding = pm->embedding;
+  if (cabecalho->qtdNeuroniosEntrada != (uint32_t) pm->qtdNeuroniosEntrada
+      || cabecalho->qtdCamadas != (uint32_t) pm->qtdCamadas
+      || cabecalho->qtdCategoriasEmbedding !=
+         (uint32_t) ((embedding != NULL) ? embedding->qtdCategorias : 0)
+      || cabecalho->dimensaoEmbedding !=
+         (uint32_t) ((embedding != NULL) ? embedding->dimensao : 0)
+      || cabecalho->qtdAtributosEmbedding !=
+         (uint32_t) ((embedding != NULL) ? embedding->qtdAtributos : 0))
+  {
+    return false;
+  }
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    if (descritores[c].qtdNeuronios != (uint32_t) pm->camadas[c]->qtdNeuronios
+        || descritores[c].funcaoAtivacao != pm->camadas[c]->funcaoAtivacao)
+    {
+      return false;
+    }
+  }
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    const float * h_W = (const float *) (h_modelo +
+                                         descritores[c].deslocamentoW);
+
+    /* Os pesos são convertidos caso a camada utilize um formato reduzido. */
+    Camada_definirPesosHospedeiro(camada, descritores[c].qtdPesosNeuronio,
+                                  h_W);
+    cudaMemcpy(camada->d_bias, h_modelo + descritores[c].deslocamentoBias,
+               sizeof(float) * camada->qtdNeuronios, cudaMemcpyHostToDevice);
+  }
+
+  if (embedding != NULL)
+  {
+    cudaMemcpy(embedding->d_tabela, h_modelo +
+               cabecalho->deslocamentoEmbedding,
+               sizeof(float) * __qtdItensTabelaEmbedding(pm),
+               cudaMemcpyHostToDevice);
+  }
+
+  return true;
+}
+
+const char * ModeloArquivo_mapear(const char * nomeArquivo,
+                                  uint64_t * tamArquivo)
+{
+  int descritorArquivo = open(nomeArquivo, O_RDONLY);
+  if (descritorArquivo < 0)
+  {
+    return NULL;
+  }
+
+  struct stat infoArquivo;
+  if (fstat(descritorArquivo, &infoArquivo) != 0 || infoArquivo.st_size <= 0)
+  {
+    close(descritorArquivo);
+    return NULL;
+  }
+
+  /* Mapeando o arquivo apenas para leitura, para que os blocos sejam
+     copiados das páginas do arquivo sem "buffers" intermediários. */
+  *tamArquivo = (uint64_t) infoArquivo.st_size;
+  const char * h_arquivo = mmap(NULL, *tamArquivo, PROT_READ, MAP_SHARED,
+                                descritorArquivo, 0);
+  close(descritorArquivo);
+
+  if (h_arquivo == MAP_FAILED)
+  {
+    return NULL;
+  }
+
+  /* Antecipando a leitura das páginas que ainda não estão no "page
+     cache", já que os blocos serão copiados em seguida. */
+  madvise((void *) h_arquivo, *tamArquivo, MADV_WILLNEED);
+
+  return h_arquivo;
+}
+
+PerceptronMulticamadas * PerceptronMulticamadas_carregar(const char *
+                                                         nomeArquivo)
+{
+  uint64_t tamArquivo;
+  const char * h_modelo = ModeloArquivo_mapear(nomeArquivo, &tamArquivo);
+  if (h_modelo == NULL)
+  {
+    return NULL;
+  }
+
+  if (!ModeloArquivo_validarImagem(h_modelo, tamArquivo))
+  {
+    munmap((void *) h_modelo, tamArquivo);
+    return NULL;
+  }
+
+  const CabecalhoModelo * cabecalho = (const CabecalhoModelo *) h_modelo;
+  const DescritorCamadaModelo * descritores;
+  descritores = (const DescritorCamadaModelo *) (h_modelo +
+                                                 sizeof(CabecalhoModelo));
+
+  /* Alocando as camadas com os pesos e bias copiados diretamente das
+     páginas mapeadas. */
+  Camada ** camadas = malloc(sizeof(Camada *) * cabecalho->qtdCamadas);
+
+  for (uint32_t c = 0; c < cabecalho->qtdCamadas; c++)
+  {
+    camadas[c] = __alocarCamadaPesos(descritores[c].qtdNeuronios,
+                                     descritores[c].qtdPesosNeuronio,
+                                     descritores[c].funcaoAtivacao,
+                                     (const float *) (h_modelo +
+                                       descritores[c].deslocamentoW),
+                                     (const float *) (h_modelo +
+                                       descritores[c].deslocamentoBias));
+  }
+
+  PerceptronMulticamadas * pm = malloc(sizeof(PerceptronMulticamadas));
+  pm->camadas = (const Camada **) camadas;
+  pm->qtdCamadas = cabecalho->qtdCamadas;
+  pm->qtdNeuroniosEntrada = cabecalho->qtdNeuroniosEntrada;
+  pm->embedding = NULL;
+  pm->sementePesos = SEMENTE_PESOS;
+  pm->otimizador = ParametrosOtimizador_padrao(OtimizadorSGD);
+  PerceptronMulticamadas_definirEmbaralhamento(pm, EmbaralhamentoCompleto,
+                                               TAM_BLOCO_EMBARALHAMENTO,
+                                               SEMENTE_EMBARALHAMENTO);
+
+  /* Recriando a camada de "embedding" (as dimensões já foram validadas) e
+     substituindo a tabela aleatória pela do arquivo. */
+  if (cabecalho->qtdCategoriasEmbedding > 0)
+  {
+    PerceptronMulticamadas_adicionarEmbedding(pm,
+                                              cabecalho->qtdCategoriasEmbedding,
+                                              cabecalho->dimensaoEmbedding,
+                                              cabecalho->qtdAtributosEmbedding);
+    cudaMemcpy(pm->embedding->d_tabela,
+               h_modelo + cabecalho->deslocamentoEmbedding,
+               sizeof(float) * __qtdItensTabelaEmbedding(pm),
+               cudaMemcpyHostToDevice);
+  }
+
+  /* Os parâmetros já foram copiados para o dispositivo acelerador (cada
+     processo possui a sua própria cópia). */
+  munmap((void *) h_modelo, tamArquivo);
+
+  return pm;
+}
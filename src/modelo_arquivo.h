@@ -0,0 +1,221 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Formato binário (versionado) para salvar e carregar a rede treinada,     *
+ * carregado através de "mmap".                                             *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef MODELO_ARQUIVO_H
+#define MODELO_ARQUIVO_H
+
+#include <stdint.h>
+#include "perceptron_multicamadas.h"
+
+/***************************************************************************
+ * Layout do arquivo (na ordem de bytes do hospedeiro que o gerou):        *
+ *                                                                         *
+ *   CabecalhoModelo                                                       *
+ *   DescritorCamadaModelo[qtdCamadas]                                     *
+ *   (para cada camada, alinhados a ALINHAMENTO_BLOCOS_MODELO bytes)       *
+ *     float W[qtdNeuronios * qtdPesosNeuronio]   ("row-major")            *
+ *     float bias[qtdNeuronios]                                            *
+ *   (caso a rede possua a camada de "embedding", alinhada)                *
+ *     float tabela[qtdCategoriasEmbedding * dimensaoEmbedding]            *
+ *                                                                         *
+ * Como os blocos estão alinhados e no mesmo formato utilizado na memória, *
+ * o carregamento apenas mapeia o arquivo e copia os blocos diretamente    *
+ * das páginas mapeadas para o dispositivo acelerador (sem "parsing" nem   *
+ * "buffers" intermediários no hospedeiro).                                *
+ *                                                                         *
+ * Limitação: cada processo mantém a sua própria cópia dos parâmetros no   *
+ * dispositivo acelerador (os pesos podem ser treinados e convertidos para *
+ * outros formatos) e o mapeamento é desfeito ao final do carregamento,    *
+ * portanto o tempo de carregamento é proporcional ao tamanho do modelo e  *
+ * as páginas do arquivo não são compartilhadas durante a inferência.      *
+ ***************************************************************************/
+
+/* Assinatura ("magic") do arquivo de modelo. */
+#define ASSINATURA_MODELO "PMCMODEL"
+
+/* Versão atual do formato (incrementar a cada mudança no layout). */
+#define VERSAO_MODELO 2
+
+/* Alinhamento (em bytes) dos blocos de pesos e bias no arquivo. */
+#define ALINHAMENTO_BLOCOS_MODELO 64
+
+/**
+ * Estrutura do cabeçalho do arquivo de modelo.
+ */
+typedef struct
+{
+  /** Assinatura do arquivo (ASSINATURA_MODELO, sem o '\0'). */
+  char assinatura[8];
+
+  /** Versão do formato (VERSAO_MODELO). */
+  uint32_t versao;
+
+  /** Tamanho (em bytes) de um "float" no hospedeiro que gerou o arquivo,
+  utilizado também para detectar uma ordem de bytes diferente. */
+  uint32_t tamFloat;
+
+  /** Tamanho da entrada (quantidade de "neurônios"). */
+  uint32_t qtdNeuroniosEntrada;
+
+  /** Quantidade de camadas. */
+  uint32_t qtdCamadas;
+
+  /** Tamanho total do arquivo em bytes. */
+  uint64_t tamArquivo;
+
+  /** Dimensões da camada de "embedding" (todas 0 caso a rede não possua a
+  camada). */
+  uint32_t qtdCategoriasEmbedding;
+  uint32_t dimensaoEmbedding;
+  uint32_t qtdAtributosEmbedding;
+
+  /** Reservado (mantém o alinhamento dos deslocamentos). */
+  uint32_t reservado;
+
+  /** Deslocamento (em bytes, a partir do início do arquivo) da tabela de
+  "embedding". */
+  uint64_t deslocamentoEmbedding;
+
+} CabecalhoModelo;
+
+/**
+ * Estrutura que descreve uma camada no arquivo de modelo.
+ */
+typedef struct
+{
+  /** Quantidade de neurônios da camada. */
+  uint32_t qtdNeuronios;
+
+  /** Quantidade de pesos de cada neurônio. */
+  uint32_t qtdPesosNeuronio;
+
+  /** Função de ativação (enumeração "FuncoesAtivacaoEnum"). */
+  int32_t funcaoAtivacao;
+
+  /** Reservado (mantém o alinhamento dos deslocamentos). */
+  uint32_t reservado;
+
+  /** Deslocamento (em bytes, a partir do início do arquivo) dos pesos. */
+  uint64_t deslocamentoW;
+
+  /** Deslocamento (em bytes, a partir do início do arquivo) dos bias. */
+  uint64_t deslocamentoBias;
+
+} DescritorCamadaModelo;
+
+/**
+ * Método que salva os parâmetros (topologia, função de ativação de cada
+ * camada, pesos, bias e a tabela de "embedding", caso exista) da rede em um
+ * arquivo de modelo.
+ *
+ * O arquivo é escrito em um arquivo temporário ("<nomeArquivo>.tmp") e
+ * renomeado ao final, portanto um processo que esteja carregando o modelo
+ * nunca verá um arquivo parcialmente escrito.
+ *
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param nomeArquivo Nome do arquivo de modelo.
+ *
+ * @return Verdadeiro caso o modelo tenha sido salvo com sucesso.
+ */
+bool PerceptronMulticamadas_salvar(const PerceptronMulticamadas * pm,
+                                   const char * nomeArquivo);
+
+/**
+ * Método que carrega uma rede de um arquivo de modelo, mapeando o mesmo
+ * na memória e copiando os pesos e bias diretamente das páginas mapeadas
+ * para memória própria do dispositivo acelerador (o mapeamento é desfeito
+ * antes do retorno).
+ *
+ * @param nomeArquivo Nome do arquivo de modelo.
+ *
+ * @return Referência para a rede carregada ou NULO caso não seja possível
+ *         abrir o arquivo ou o mesmo seja inválido (assinatura, versão ou
+ *         blocos fora do arquivo).
+ */
+PerceptronMulticamadas * PerceptronMulticamadas_carregar(const char *
+                                                         nomeArquivo);
+
+/**
+ * Método que escreve a imagem de um modelo (cabeçalho, descritores e
+ * blocos) na posição atual de um arquivo, a partir de pesos e bias que já
+ * estão na memória do hospedeiro (utilizado também pelos "checkpoints" do
+ * treinamento, que embutem a imagem do modelo).
+ *
+ * Os deslocamentos são relativos ao início da imagem, portanto os blocos só
+ * ficarão alinhados no arquivo caso a imagem inicie em uma posição múltipla
+ * de ALINHAMENTO_BLOCOS_MODELO.
+ *
+ * @param arquivo Arquivo aberto para escrita.
+ *
+ * @param pm Rede da qual serão utilizadas a topologia e as funções de
+ *           ativação.
+ *
+ * @param h_W Vetor com os pesos (no hospedeiro) de cada camada.
+ *
+ * @param h_bias Vetor com os bias (no hospedeiro) de cada camada.
+ *
+ * @param h_tabelaEmbedding Tabela de "embedding" (no hospedeiro), ou NULO
+ *                          caso a rede não possua a camada.
+ *
+ * @return Verdadeiro caso a imagem tenha sido escrita com sucesso.
+ */
+bool ModeloArquivo_escreverImagem(FILE * arquivo,
+                                  const PerceptronMulticamadas * pm,
+                                  float * const * h_W,
+                                  float * const * h_bias,
+                                  const float * h_tabelaEmbedding);
+
+/**
+ * Método que verifica se a imagem de um modelo (mapeada na memória) é
+ * válida: assinatura, versão, tamanho, encadeamento da topologia e blocos
+ * contidos na imagem.
+ *
+ * @param h_modelo Início da imagem.
+ *
+ * @param tamImagem Tamanho da imagem em bytes.
+ *
+ * @return Verdadeiro caso a imagem seja válida.
+ */
+bool ModeloArquivo_validarImagem(const char * h_modelo, uint64_t tamImagem);
+
+/**
+ * Método que copia os pesos, os bias e a tabela de "embedding" da imagem de
+ * um modelo para uma rede já alocada, desde que a topologia, as funções de
+ * ativação e as dimensões da camada de "embedding" sejam as mesmas.
+ *
+ * @param pm Rede que irá receber os parâmetros.
+ *
+ * @param h_modelo Início da imagem.
+ *
+ * @param tamImagem Tamanho da imagem em bytes.
+ *
+ * @return Verdadeiro caso os parâmetros tenham sido copiados, ou falso caso
+ *         a imagem seja inválida ou de uma topologia diferente.
+ */
+bool ModeloArquivo_copiarParametros(PerceptronMulticamadas * pm,
+                                    const char * h_modelo,
+                                    uint64_t tamImagem);
+
+/**
+ * Método que mapeia um arquivo na memória apenas para leitura (de forma
+ * compartilhada). O mapeamento deve ser desfeito com "munmap".
+ *
+ * @param nomeArquivo Nome do arquivo.
+ *
+ * @param tamArquivo Variável onde será armazenado o tamanho do arquivo.
+ *
+ * @return Início do arquivo mapeado ou NULO caso não seja possível abrir ou
+ *         mapear o mesmo.
+ */
+const char * ModeloArquivo_mapear(const char * nomeArquivo,
+                                  uint64_t * tamArquivo);
+
+#endif
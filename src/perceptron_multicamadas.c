@@ -1,24 +1,59 @@
 // Esse include abaixo já possui o include do cabeçalho
 // "perceptron_multicamadas.h" 
 #include "historico_treinamento.h"
+#include "checkpoint_treinamento.h"
 
 PerceptronMulticamadas *
 PerceptronMulticamadas_inicializar(int qtdNeuroniosEntrada,
                                    int qtdCamadas,
                                    int * qtdNeuroniosCamada,
                                    int funcaoAtivacaoRede)
+{
+  return PerceptronMulticamadas_inicializarSemente(qtdNeuroniosEntrada,
+                                                   qtdCamadas,
+                                                   qtdNeuroniosCamada,
+                                                   funcaoAtivacaoRede,
+                                                   SEMENTE_PESOS);
+}
+
+PerceptronMulticamadas *
+PerceptronMulticamadas_inicializarSemente(int qtdNeuroniosEntrada,
+                                          int qtdCamadas,
+                                          int * qtdNeuroniosCamada,
+                                          int funcaoAtivacaoRede,
+                                          uint64_t semente)
+{
+  return PerceptronMulticamadas_inicializarConfig(qtdNeuroniosEntrada,
+                                                  qtdCamadas,
+                                                  qtdNeuroniosCamada,
+                                                  funcaoAtivacaoRede, NULL,
+                                                  semente);
+}
+
+PerceptronMulticamadas *
+PerceptronMulticamadas_inicializarConfig(int qtdNeuroniosEntrada,
+                                         int qtdCamadas,
+                                         int * qtdNeuroniosCamada,
+                                         int funcaoAtivacaoRede,
+                                         const ConfigInicializacao *
+                                         configCamadas,
+                                         uint64_t semente)
 {
   /* Criando o vetor de referências que irá armazenar as camadas. */
   Camada ** camadas = malloc(sizeof(Camada *) * qtdCamadas);
+  ConfigInicializacao configPadrao = ConfigInicializacao_padrao();
 
-  /* Alocando as camadas. */
-  camadas[0] = __alocarCamada(qtdNeuroniosCamada[0], qtdNeuroniosEntrada,
-                              funcaoAtivacaoRede);
-
-  for (int i = 1; i < qtdCamadas; i++)
+  /* Alocando as camadas (cada camada utiliza uma sequência derivada da
+     semente da rede e do índice da camada). */
+  for (int i = 0; i < qtdCamadas; i++)
   {
-    camadas[i] = __alocarCamada(qtdNeuroniosCamada[i],qtdNeuroniosCamada[i - 1],
-                                funcaoAtivacaoRede);
+    int qtdPesosNeuronio = i == 0 ? qtdNeuroniosEntrada :
+                           qtdNeuroniosCamada[i - 1];
+    camadas[i] = __alocarCamada(qtdNeuroniosCamada[i], qtdPesosNeuronio,
+                                funcaoAtivacaoRede,
+                                configCamadas != NULL ? &configCamadas[i] :
+                                &configPadrao,
+                                GeradorAleatorio_contador(semente, i));
   }
 
   /* Alocando a estrutura que irá abrigar as camadas. */
@@ -28,93 +63,784 @@ PerceptronMulticamadas_inicializar(int qtdNeuroniosEntrada,
   pm->camadas = camadas;
   pm->qtdCamadas = qtdCamadas;
   pm->qtdNeuroniosEntrada = qtdNeuroniosEntrada;
+  pm->embedding = NULL;
+  pm->sementePesos = semente;
+  pm->otimizador = ParametrosOtimizador_padrao(OtimizadorSGD);
+  PerceptronMulticamadas_definirEmbaralhamento(pm, EmbaralhamentoCompleto,
+                                               TAM_BLOCO_EMBARALHAMENTO,
+                                               SEMENTE_EMBARALHAMENTO);
 
   /* Retornando a estrutura alocada. */
   return pm;
 }
 
-Camada * __alocarCamada(int qtdNeuronios,
-			int qtdPesosNeuronio,
-                        int funcaoAtivacao)
+ConfigInicializacao ConfigInicializacao_padrao()
 {
-  /* Alocando a camada. */
-  Camada * camada = malloc(sizeof(Camada));
+  ConfigInicializacao config = {InicializacaoUniforme, RAND_LIM_MAX, BIAS};
+  return config;
+}
 
-  /* Gerando o vetor de pesos aleatórios dos neurônios no
-     hospedeiro. */
-  float * h_vetorPesos = __alocarVetorPesosRandomicos(qtdPesosNeuronio
-						      *	qtdNeuronios);
+ConfigInicializacao ConfigInicializacao_recomendada(int funcaoAtivacao)
+{
+  ConfigInicializacao config = {InicializacaoXavierUniforme, 1, 0};
 
-  /* Copiando o vetor de pesos aleatórios gerados no hospedeiro para
-     o dispositivo acelerador. */
-  cudaMalloc((void **) &camada->d_W, sizeof(float) *
-	     (qtdPesosNeuronio * qtdNeuronios));
-  cudaMemcpy(camada->d_W, h_vetorPesos, sizeof(float) *
-	     (qtdPesosNeuronio * qtdNeuronios), cudaMemcpyHostToDevice);
-  
-  /* Alocando o vetor que irá armazenar a ativação dos neurônios
-     no dispositivo acelerador. */
-  cudaMalloc((void **) &camada->d_neuronioAtivacao, sizeof(float) * qtdNeuronios);
+  if (funcaoAtivacao != Sigmoide && funcaoAtivacao != TangHiperbolica &&
+      funcaoAtivacao != Identidade)
+  {
+    config.esquema = InicializacaoHeUniforme;
+  }
+
+  return config;
+}
+
+/**
+ * Método que gera os pesos iniciais de uma camada (já alocados no
+ * dispositivo acelerador) conforme o esquema da configuração.
+ */
+static void __gerarPesosIniciais(float * d_W,
+                                 int qtdNeuronios,
+                                 int qtdPesosNeuronio,
+                                 const ConfigInicializacao * config,
+                                 uint64_t semente)
+{
+  long qtdPesos = (long) qtdPesosNeuronio * qtdNeuronios;
+  float fanIn = qtdPesosNeuronio;
+  float fanOut = qtdNeuronios;
+  float limite = config->escala;
+  bool normal = false;
+
+  /* Limite da distribuição uniforme ou desvio padrão da normal. */
+  switch (config->esquema)
+  {
+    case InicializacaoNormal:
+      normal = true;
+      break;
+
+    case InicializacaoXavierUniforme:
+      limite *= sqrtf(6.0f / (fanIn + fanOut));
+      break;
+
+    case InicializacaoXavierNormal:
+      limite *= sqrtf(2.0f / (fanIn + fanOut));
+      normal = true;
+      break;
+
+    case InicializacaoHeUniforme:
+      limite *= sqrtf(6.0f / fanIn);
+      break;
 
-  /* Alocando o vetor que irá armazenar as derivadas dos neurônios no
-     dispositivo acelerador. */
-  cudaMalloc((void **) &camada->d_neuronioDerivada, sizeof(float) * qtdNeuronios);
+    case InicializacaoHeNormal:
+      limite *= sqrtf(2.0f / fanIn);
+      normal = true;
+      break;
+  }
 
-  /* Alocando o vetor que irá armazenar o erro retropropagado calculado para
-     cada neurônio no dispositivo acelerador. */
-  cudaMalloc((void **) &camada->d_neuronioErroRprop, sizeof(float) * qtdNeuronios);
+  if (normal)
+  {
+    gerarVetorNormalAleatorio(d_W, qtdPesos, limite, semente);
+  }
+  else
+  {
+    gerarVetorUniformeAleatorio(d_W, qtdPesos, -limite, limite, semente);
+  }
+}
 
+Camada * __alocarCamada(int qtdNeuronios,
+			int qtdPesosNeuronio,
+                        int funcaoAtivacao,
+                        const ConfigInicializacao * config,
+                        uint64_t semente)
+{
   /* Alocando vetor de bias no hospedeiro. */
   float * h_bias = malloc(sizeof(float) * qtdNeuronios);
 
-  /* Inicializando os valores do vetor de bias através da macro
-     definida no arquivo de cabeçalho (BIAS). */
+  /* Inicializando os valores do vetor de bias com o valor da
+     configuração. */
   for (int i = 0; i < qtdNeuronios; i++)
   {
-    h_bias[i] = BIAS;
+    h_bias[i] = config->bias;
   }
 
-  /* Desalocando os vetores do hospedeiro que já foram copiados
-     para o dispositivo acelerador. */
-  free(h_vetorPesos);
+  /* Alocando a camada. */
+  Camada * camada = malloc(sizeof(Camada));
+
+  /* Gerando os pesos aleatórios dos neurônios diretamente no dispositivo
+     acelerador (sem vetor no hospedeiro nem cópia). */
+  cudaMalloc((void **) &camada->d_W,
+             sizeof(float) * ((long) qtdPesosNeuronio * qtdNeuronios));
+  __gerarPesosIniciais(camada->d_W, qtdNeuronios, qtdPesosNeuronio, config,
+                       semente);
+
+  /* Copiando o vetor de bias para o dispositivo acelerador. */
+  cudaMalloc((void **) &camada->d_bias, sizeof(float) * qtdNeuronios);
+  cudaMemcpy(camada->d_bias, h_bias, sizeof(float) * qtdNeuronios,
+	     cudaMemcpyHostToDevice);
   free(h_bias);
 
+  /* Preenchendo os demais atributos (as camadas são sempre criadas no
+     formato fp32). */
+  camada->d_Wreduzido = NULL;
+  camada->qtdNeuronios = qtdNeuronios;
+  camada->funcaoAtivacao = funcaoAtivacao;
+  camada->formatoPesos = FormatoFP32;
+  camada->d_velocidadeW = NULL;
+  camada->d_velocidadeBias = NULL;
+  camada->d_segundoMomentoW = NULL;
+  camada->d_segundoMomentoBias = NULL;
+
+  /* Retornando a referência para a camada alocada. */
+  return camada;
+}
+
+Camada * __alocarCamadaPesos(int qtdNeuronios,
+                             int qtdPesosNeuronio,
+                             int funcaoAtivacao,
+                             const float * h_W,
+                             const float * h_bias)
+{
+  /* Alocando a camada. */
+  Camada * camada = malloc(sizeof(Camada));
+
+  /* Copiando o vetor de pesos do hospedeiro para o dispositivo
+     acelerador. */
+  cudaMalloc((void **) &camada->d_W, sizeof(float) *
+	     ((long) qtdPesosNeuronio * qtdNeuronios));
+  cudaMemcpy(camada->d_W, h_W, sizeof(float) *
+	     ((long) qtdPesosNeuronio * qtdNeuronios), cudaMemcpyHostToDevice);
+
   /* Alocando o espaço para o vetor de bias no adaptador gráfico
    * e copiando o vetor de bias do hospedeiro para o mesmo.
    */
   cudaMalloc((void **) &camada->d_bias, sizeof(float) * qtdNeuronios);
   cudaMemcpy(camada->d_bias, h_bias, sizeof(float) * qtdNeuronios,
 	     cudaMemcpyHostToDevice);
-  
-  /* Preenchendo os demais atributos. */
+
+  /* Preenchendo os demais atributos (as camadas são sempre criadas no
+     formato fp32). */
+  camada->d_Wreduzido = NULL;
   camada->qtdNeuronios = qtdNeuronios;
   camada->funcaoAtivacao = funcaoAtivacao;
+  camada->formatoPesos = FormatoFP32;
+  camada->d_velocidadeW = NULL;
+  camada->d_velocidadeBias = NULL;
+  camada->d_segundoMomentoW = NULL;
+  camada->d_segundoMomentoBias = NULL;
 
   /* Retornando a referência para a camada alocada. */
   return camada;
 }
 
-float * __alocarVetorPesosRandomicos(int qtdPesos)
+void gerarVetorUniformeAleatorio(float * d_vetor,
+                                 long qtdItens,
+                                 float limiteMin,
+                                 float limiteMax,
+                                 uint64_t semente)
+{
+  float amplitude = limiteMax - limiteMin;
+
+  /* Cada item depende apenas da semente e do seu índice, de modo que o
+     resultado não depende da divisão do laço entre as threads. */
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  deviceptr(d_vetor)
+  for (long i = 0; i < qtdItens; i++)
+  {
+    d_vetor[i] = limiteMin + amplitude *
+                 GeradorAleatorio_uniformeContador(semente, i);
+  }
+}
+
+void gerarVetorNormalAleatorio(float * d_vetor,
+                               long qtdItens,
+                               float desvioPadrao,
+                               uint64_t semente)
+{
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  deviceptr(d_vetor)
+  for (long i = 0; i < qtdItens; i++)
+  {
+    d_vetor[i] = desvioPadrao * GeradorAleatorio_normalContador(semente, i);
+  }
+}
+
+void PerceptronMulticamadas_definirFormatoPesos(PerceptronMulticamadas * pm,
+                                                int formato,
+                                                bool manterCopiaFP32)
+{
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    Camada * camada = (Camada *) pm->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+    size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+    /* Obtendo os pesos atuais (no formato atual) antes de substituir os
+       vetores da camada. */
+    float * h_W = malloc(sizeof(float) * qtdPesos);
+    Camada_copiarPesosHospedeiro(camada, qtdPesosNeuronio, h_W);
+
+    cudaFree(camada->d_W);
+    cudaFree(camada->d_Wreduzido);
+    camada->d_W = NULL;
+    camada->d_Wreduzido = NULL;
+    camada->formatoPesos = formato;
+
+    /* O vetor em fp32 é necessário no formato fp32 ou como cópia mestre. */
+    if (formato == FormatoFP32 || manterCopiaFP32)
+    {
+      cudaMalloc((void **) &camada->d_W, sizeof(float) * qtdPesos);
+    }
+
+    if (formato != FormatoFP32)
+    {
+      cudaMalloc((void **) &camada->d_Wreduzido, sizeof(uint16_t) * qtdPesos);
+    }
+
+    Camada_definirPesosHospedeiro(camada, qtdPesosNeuronio, h_W);
+    free(h_W);
+  }
+}
+
+void PerceptronMulticamadas_definirEmbaralhamento(PerceptronMulticamadas * pm,
+                                                  int modo,
+                                                  int tamBloco,
+                                                  uint64_t semente)
+{
+  pm->embaralhamento.modo = modo;
+  pm->embaralhamento.tamBloco = (tamBloco > 0) ? tamBloco :
+                                                 TAM_BLOCO_EMBARALHAMENTO;
+  pm->embaralhamento.semente = semente;
+}
+
+ParametrosOtimizador ParametrosOtimizador_padrao(int tipo)
+{
+  ParametrosOtimizador parametros;
+  parametros.tipo = tipo;
+  parametros.momento = MOMENTO_PADRAO;
+  parametros.beta1 = BETA1_PADRAO;
+  parametros.beta2 = BETA2_PADRAO;
+  parametros.epsilon = EPSILON_PADRAO;
+  parametros.decaimentoPesos = (tipo == OtimizadorAdamW) ?
+                               DECAIMENTO_PESOS_PADRAO : 0;
+  parametros.passo = 0;
+  parametros.correcaoPrimeiroMomento = 1;
+  parametros.correcaoSegundoMomento = 1;
+
+  return parametros;
+}
+
+/**
+ * Método que realoca (zerado) um vetor de estado do otimizador, ou apenas o
+ * desaloca caso o otimizador não o utilize.
+ */
+static void __realocarEstadoOtimizador(float ** d_vetor, size_t qtdItens,
+                                       bool utilizado)
+{
+  cudaFree(*d_vetor);
+  *d_vetor = NULL;
+
+  if (utilizado)
+  {
+    cudaMalloc((void **) d_vetor, sizeof(float) * qtdItens);
+    cudaMemset(*d_vetor, 0, sizeof(float) * qtdItens);
+  }
+}
+
+/**
+ * Método que realoca os vetores de estado da tabela de "embedding" para o
+ * otimizador da rede.
+ */
+static void __realocarEstadoEmbedding(CamadaEmbedding * embedding,
+                                      int tipoOtimizador)
+{
+  bool utilizaAdam = tipoOtimizador == OtimizadorAdam ||
+                     tipoOtimizador == OtimizadorAdamW;
+  bool utilizaMomento = utilizaAdam ||
+                        tipoOtimizador == OtimizadorMomento ||
+                        tipoOtimizador == OtimizadorNesterov;
+  size_t qtdItensTabela = (size_t) embedding->qtdCategorias *
+                          embedding->dimensao;
+
+  __realocarEstadoOtimizador(&embedding->d_velocidadeTabela, qtdItensTabela,
+                             utilizaMomento);
+  __realocarEstadoOtimizador(&embedding->d_segundoMomentoTabela,
+                             qtdItensTabela, utilizaAdam);
+}
+
+void PerceptronMulticamadas_definirOtimizador(PerceptronMulticamadas * pm,
+                                              const ParametrosOtimizador *
+                                              parametros)
+{
+  bool utilizaAdam = parametros->tipo == OtimizadorAdam ||
+                     parametros->tipo == OtimizadorAdamW;
+  bool utilizaMomento = utilizaAdam ||
+                        parametros->tipo == OtimizadorMomento ||
+                        parametros->tipo == OtimizadorNesterov;
+
+  /* As velocidades e os momentos sempre recomeçam zerados. */
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    Camada * camada = (Camada *) pm->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+    size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+    __realocarEstadoOtimizador(&camada->d_velocidadeW, qtdPesos,
+                               utilizaMomento);
+    __realocarEstadoOtimizador(&camada->d_velocidadeBias,
+                               camada->qtdNeuronios, utilizaMomento);
+    __realocarEstadoOtimizador(&camada->d_segundoMomentoW, qtdPesos,
+                               utilizaAdam);
+    __realocarEstadoOtimizador(&camada->d_segundoMomentoBias,
+                               camada->qtdNeuronios, utilizaAdam);
+  }
+
+  if (pm->embedding != NULL)
+  {
+    __realocarEstadoEmbedding(pm->embedding, parametros->tipo);
+  }
+
+  pm->otimizador = *parametros;
+  pm->otimizador.passo = 0;
+}
+
+void Camada_copiarPesosHospedeiro(const Camada * camada,
+                                  int qtdPesosNeuronio,
+                                  float * h_W)
+{
+  size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+  /* A cópia em fp32, quando existe, é sempre a mais precisa. */
+  if (camada->d_W != NULL)
+  {
+    cudaMemcpy(h_W, camada->d_W, sizeof(float) * qtdPesos,
+               cudaMemcpyDeviceToHost);
+    return;
+  }
+
+  uint16_t * h_Wreduzido = malloc(sizeof(uint16_t) * qtdPesos);
+  cudaMemcpy(h_Wreduzido, camada->d_Wreduzido, sizeof(uint16_t) * qtdPesos,
+             cudaMemcpyDeviceToHost);
+
+  for (size_t i = 0; i < qtdPesos; i++)
+  {
+    h_W[i] = lerValorFormato(NULL, h_Wreduzido, camada->formatoPesos, i);
+  }
+
+  free(h_Wreduzido);
+}
+
+void Camada_definirPesosHospedeiro(const Camada * camada,
+                                   int qtdPesosNeuronio,
+                                   const float * h_W)
+{
+  size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+  if (camada->d_W != NULL)
+  {
+    cudaMemcpy(camada->d_W, h_W, sizeof(float) * qtdPesos,
+               cudaMemcpyHostToDevice);
+  }
+
+  if (camada->formatoPesos != FormatoFP32)
+  {
+    /* Arredondando os pesos no hospedeiro e copiando os mesmos. */
+    uint16_t * h_Wreduzido = malloc(sizeof(uint16_t) * qtdPesos);
+
+    for (size_t i = 0; i < qtdPesos; i++)
+    {
+      escreverValorFormato(NULL, h_Wreduzido, camada->formatoPesos, i,
+                           h_W[i]);
+    }
+
+    cudaMemcpy(camada->d_Wreduzido, h_Wreduzido, sizeof(uint16_t) * qtdPesos,
+               cudaMemcpyHostToDevice);
+    free(h_Wreduzido);
+  }
+}
+
+ContextoExecucao *
+ContextoExecucao_inicializar(const PerceptronMulticamadas * pm)
+{
+  /* Alocando o contexto e o vetor com os estados das camadas. */
+  ContextoExecucao * contexto = malloc(sizeof(ContextoExecucao));
+  contexto->estados = malloc(sizeof(EstadoCamada) * pm->qtdCamadas);
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    int qtdNeuronios = pm->camadas[c]->qtdNeuronios;
+
+    /* Alocando o vetor que irá armazenar a ativação dos neurônios
+       no dispositivo acelerador. */
+    cudaMalloc((void **) &contexto->estados[c].d_neuronioAtivacao,
+               sizeof(float) * qtdNeuronios);
+
+    /* Alocando o vetor que irá armazenar as derivadas dos neurônios no
+       dispositivo acelerador. */
+    cudaMalloc((void **) &contexto->estados[c].d_neuronioDerivada,
+               sizeof(float) * qtdNeuronios);
+
+    /* Alocando o vetor que irá armazenar o erro retropropagado calculado para
+       cada neurônio no dispositivo acelerador. */
+    cudaMalloc((void **) &contexto->estados[c].d_neuronioErroRprop,
+               sizeof(float) * qtdNeuronios);
+  }
+
+  /* Alocando na memória do dispositivo acelerador a variável que
+     irá armazenar o erro para os padrões apresentados à rede. */
+  cudaMalloc((void **) &contexto->d_erroPadrao, sizeof(float));
+
+  /* As matrizes da inferência em lote só serão alocadas quando forem
+     utilizadas. */
+  contexto->d_loteAtivacaoA = NULL;
+  contexto->d_loteAtivacaoB = NULL;
+  contexto->d_loteEntrada = NULL;
+  contexto->d_loteSaida = NULL;
+
+  /* Alocando a entrada montada pela camada de "embedding". */
+  contexto->d_entradaEmbedding = NULL;
+  if (pm->embedding != NULL)
+  {
+    cudaMalloc((void **) &contexto->d_entradaEmbedding,
+               sizeof(float) * pm->qtdNeuroniosEntrada);
+  }
+
+  /* Alocando a soma dos pesos de cada neurônio da primeira camada
+     (calculada apenas na primeira ativação com amostras brutas). */
+  cudaMalloc((void **) &contexto->d_somaPesosPrimeiraCamada,
+             sizeof(float) * pm->camadas[0]->qtdNeuronios);
+  contexto->somaPesosValida = false;
+
+  /* Alocando o espaço de trabalho da inferência de baixa latência junto
+     com o contexto, para que nenhuma inferência realize alocações. */
+  contexto->d_latenciaTabelaW = NULL;
+  contexto->d_latenciaTabelaWreduzido = NULL;
+  contexto->d_latenciaTabelaFormatoPesos = NULL;
+  contexto->d_latenciaTabelaBias = NULL;
+  contexto->d_latenciaTabelaQtdNeuronios = NULL;
+  contexto->d_latenciaTabelaFuncaoAtivacao = NULL;
+  contexto->d_latenciaAtivacaoA = NULL;
+  contexto->d_latenciaAtivacaoB = NULL;
+  contexto->h_latenciaEntrada = NULL;
+  contexto->h_latenciaSaida = NULL;
+  contexto->h_latenciaTabelaW = NULL;
+  contexto->h_latenciaTabelaWreduzido = NULL;
+  contexto->h_latenciaTabelaFormatoPesos = NULL;
+  contexto->h_latenciaTabelaBias = NULL;
+  PerceptronMulticamadas_prepararLatencia(pm, contexto);
+
+  contexto->qtdCamadas = pm->qtdCamadas;
+
+  return contexto;
+}
+
+void ContextoExecucao_desalocar(ContextoExecucao * contexto)
+{
+  for (int c = 0; c < contexto->qtdCamadas; c++)
+  {
+    cudaFree(contexto->estados[c].d_neuronioAtivacao);
+    cudaFree(contexto->estados[c].d_neuronioDerivada);
+    cudaFree(contexto->estados[c].d_neuronioErroRprop);
+  }
+
+  cudaFree(contexto->d_erroPadrao);
+  cudaFree(contexto->d_loteAtivacaoA);
+  cudaFree(contexto->d_loteAtivacaoB);
+  cudaFree(contexto->d_loteEntrada);
+  cudaFree(contexto->d_loteSaida);
+  cudaFree(contexto->d_entradaEmbedding);
+  cudaFree(contexto->d_somaPesosPrimeiraCamada);
+  cudaFree(contexto->d_latenciaTabelaW);
+  cudaFree(contexto->d_latenciaTabelaWreduzido);
+  cudaFree(contexto->d_latenciaTabelaFormatoPesos);
+  cudaFree(contexto->d_latenciaTabelaBias);
+  cudaFree(contexto->d_latenciaTabelaQtdNeuronios);
+  cudaFree(contexto->d_latenciaTabelaFuncaoAtivacao);
+  cudaFree(contexto->d_latenciaAtivacaoA);
+  cudaFree(contexto->d_latenciaAtivacaoB);
+  cudaFreeHost(contexto->h_latenciaEntrada);
+  cudaFreeHost(contexto->h_latenciaSaida);
+  free(contexto->h_latenciaTabelaW);
+  free(contexto->h_latenciaTabelaWreduzido);
+  free(contexto->h_latenciaTabelaFormatoPesos);
+  free(contexto->h_latenciaTabelaBias);
+  free(contexto->estados);
+  free(contexto);
+}
+
+void ContextoExecucao_invalidarSomaPesos(ContextoExecucao * contexto)
+{
+  contexto->somaPesosValida = false;
+}
+
+bool PerceptronMulticamadas_adicionarEmbedding(PerceptronMulticamadas * pm,
+                                               int qtdCategorias,
+                                               int dimensao,
+                                               int qtdAtributos)
+{
+  /* Os vetores concatenados devem caber na entrada da primeira camada. */
+  if (pm->embedding != NULL || qtdCategorias <= 0 || dimensao <= 0 ||
+      qtdAtributos <= 0 || (long) qtdAtributos * dimensao >
+      pm->qtdNeuroniosEntrada)
+  {
+    return false;
+  }
+
+  CamadaEmbedding * embedding = malloc(sizeof(CamadaEmbedding));
+  embedding->qtdCategorias = qtdCategorias;
+  embedding->dimensao = dimensao;
+  embedding->qtdAtributos = qtdAtributos;
+
+  /* Vetores de estado para o otimizador já definido na rede. */
+  embedding->d_velocidadeTabela = NULL;
+  embedding->d_segundoMomentoTabela = NULL;
+  __realocarEstadoEmbedding(embedding, pm->otimizador.tipo);
+
+  /* Inicializando a tabela da mesma forma que os pesos das camadas (com
+     a sequência seguinte às das camadas). */
+  long qtdItensTabela = (long) qtdCategorias * dimensao;
+  cudaMalloc((void **) &embedding->d_tabela, sizeof(float) * qtdItensTabela);
+  gerarVetorUniformeAleatorio(embedding->d_tabela, qtdItensTabela,
+                              RAND_LIM_MIN, RAND_LIM_MAX,
+                              GeradorAleatorio_contador(pm->sementePesos,
+                                                        pm->qtdCamadas));
+
+  pm->embedding = embedding;
+
+  return true;
+}
+
+void CamadaEmbedding_montarEntrada(const CamadaEmbedding camada,
+                                   const int * d_ids,
+                                   const float * d_densos,
+                                   int qtdNeuroniosEntrada,
+                                   float * d_entrada)
+{
+  float * camada_d_tabela = camada.d_tabela;
+  int dimensao = camada.dimensao;
+  int tamVetores = camada.qtdAtributos * camada.dimensao;
+
+  /* Cada item da entrada é copiado da linha da tabela do seu atributo ou
+     dos atributos densos. */
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  deviceptr(camada_d_tabela, d_ids, d_densos, d_entrada)
+  for (int i = 0; i < qtdNeuroniosEntrada; i++)
+  {
+    if (i < tamVetores)
+    {
+      d_entrada[i] = camada_d_tabela[(long) d_ids[i / dimensao] * dimensao +
+                                     i % dimensao];
+    }
+    else
+    {
+      d_entrada[i] = d_densos[i - tamVetores];
+    }
+  }
+}
+
+/**
+ * Método que soma "delta" ao peso "i-ésimo" de uma camada: com a cópia
+ * mestre (ou no formato fp32) a soma é feita em fp32 e o peso reduzido é
+ * arredondado a partir da mesma, caso contrário a soma é feita diretamente
+ * sobre o peso reduzido.
+ */
+#pragma acc routine seq
+static inline void __atualizarPeso(float * d_W, uint16_t * d_Wreduzido,
+                                   int formatoPesos, long i, float delta)
+{
+  if (d_W != NULL)
+  {
+    d_W[i] += delta;
+
+    if (formatoPesos != FormatoFP32)
+    {
+      escreverValorFormato(NULL, d_Wreduzido, formatoPesos, i, d_W[i]);
+    }
+  }
+  else
+  {
+    escreverValorFormato(NULL, d_Wreduzido, formatoPesos, i,
+                         lerValorFormato(NULL, d_Wreduzido, formatoPesos, i)
+                         + delta);
+  }
+}
+
+/**
+ * Método que retorna o passo a ser somado ao parâmetro "i-ésimo" (peso ou
+ * bias, cujo valor atual é "valor") para o seu gradiente, atualizando a
+ * velocidade ou os momentos do mesmo na mesma passagem. Os bias são
+ * atualizados com "valor" igual a 0 (sem decaimento).
+ */
+#pragma acc routine seq
+static inline float __passoOtimizador(const ParametrosOtimizador otimizador,
+                                      float * d_velocidade,
+                                      float * d_segundoMomento,
+                                      long i, float gradiente, float valor,
+                                      float taxaAprendizagem)
 {
-  /* Alocando o vetor de pesos. */
-  float * vetorPesos;
-  vetorPesos = malloc(sizeof(float) * qtdPesos);
+  /* Regularização L2 (no AdamW o decaimento é desacoplado). */
+  if (otimizador.tipo != OtimizadorAdamW)
+  {
+    gradiente += otimizador.decaimentoPesos * valor;
+  }
 
-  /* Gerando a semente (número entre 0 a 99 999)... */
-  srand(time(NULL));
-  int semente = rand() % 100000;
+  float passo = -taxaAprendizagem * gradiente;
 
-  for (int i = 0; i < qtdPesos; i++)
+  switch (otimizador.tipo)
   {
-    /* Gerando o peso no intervalo de RAND_LIM_MIN..RAND_LIM_MAX. */
-    vetorPesos[i] = r4_uniform_ab(RAND_LIM_MIN, RAND_LIM_MAX, &semente);
+  case OtimizadorMomento:
+  case OtimizadorNesterov:
+  {
+    float velocidade = otimizador.momento * d_velocidade[i] + passo;
+    d_velocidade[i] = velocidade;
+    passo = (otimizador.tipo == OtimizadorNesterov) ?
+            otimizador.momento * velocidade + passo : velocidade;
+    break;
+  }
+  case OtimizadorAdam:
+  case OtimizadorAdamW:
+  {
+    float m = otimizador.beta1 * d_velocidade[i] +
+              (1 - otimizador.beta1) * gradiente;
+    float v = otimizador.beta2 * d_segundoMomento[i] +
+              (1 - otimizador.beta2) * gradiente * gradiente;
+    d_velocidade[i] = m;
+    d_segundoMomento[i] = v;
+
+    passo = -taxaAprendizagem * (m / otimizador.correcaoPrimeiroMomento) /
+            (sqrtf(v / otimizador.correcaoSegundoMomento) +
+             otimizador.epsilon);
+
+    if (otimizador.tipo == OtimizadorAdamW)
+    {
+      passo -= taxaAprendizagem * otimizador.decaimentoPesos * valor;
+    }
+    break;
+  }
+  }
+
+  return passo;
+}
+
+/**
+ * Método que soma ao peso "i-ésimo" de uma camada o passo do otimizador
+ * para o seu gradiente (o peso e o seu estado são lidos e escritos uma
+ * única vez).
+ */
+#pragma acc routine seq
+static inline void __atualizarPesoOtimizador(float * d_W,
+                                             uint16_t * d_Wreduzido,
+                                             int formatoPesos,
+                                             float * d_velocidade,
+                                             float * d_segundoMomento,
+                                             long i, float gradiente,
+                                             float taxaAprendizagem,
+                                             const ParametrosOtimizador
+                                             otimizador)
+{
+  /* O valor do peso só é necessário para o decaimento. */
+  float peso = 0;
+  if (otimizador.decaimentoPesos != 0)
+  {
+    peso = (d_W != NULL) ? d_W[i] :
+           lerValorFormato(NULL, d_Wreduzido, formatoPesos, i);
   }
 
-  /* Retornando a referência para o vetor alocado. */
-  return vetorPesos;
+  __atualizarPeso(d_W, d_Wreduzido, formatoPesos, i,
+                  __passoOtimizador(otimizador, d_velocidade,
+                                    d_segundoMomento, i, gradiente, peso,
+                                    taxaAprendizagem));
+}
+
+void CamadaEmbedding_atualizarLinhas(const CamadaEmbedding camada,
+                                     const Camada primeiraCamada,
+                                     const EstadoCamada estado,
+                                     const int * d_ids,
+                                     int qtdNeuroniosEntrada,
+                                     float taxaAprendizagem,
+                                     const ParametrosOtimizador otimizador)
+{
+  /* Convertendo as estruturas para variáveis de tipos primitivos para que
+   * o OpenACC não tente copiar os vetores para a memória do dispositivo. */
+  float * camada_d_tabela = camada.d_tabela;
+  float * camada_d_velocidadeTabela = camada.d_velocidadeTabela;
+  float * camada_d_segundoMomentoTabela = camada.d_segundoMomentoTabela;
+  int dimensao = camada.dimensao;
+  int qtdAtributos = camada.qtdAtributos;
+  int tamVetores = camada.qtdAtributos * camada.dimensao;
+
+  float * primeiraCamada_d_W = primeiraCamada.d_W;
+  uint16_t * primeiraCamada_d_Wreduzido = primeiraCamada.d_Wreduzido;
+  int formatoPesos = primeiraCamada.formatoPesos;
+  int qtdNeuronios = primeiraCamada.qtdNeuronios;
+  float * estado_d_neuronioErroRprop = estado.d_neuronioErroRprop;
+
+  /* Percorrendo (de forma paralela) apenas os itens da entrada que vieram
+     da tabela, ou seja, apenas as linhas selecionadas pela amostra. */
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  deviceptr(camada_d_tabela, camada_d_velocidadeTabela, \
+            camada_d_segundoMomentoTabela, d_ids, primeiraCamada_d_W, \
+            primeiraCamada_d_Wreduzido, estado_d_neuronioErroRprop) \
+  copyin(otimizador)
+  for (int i = 0; i < tamVetores; i++)
+  {
+    int atributo = i / dimensao;
+    int coluna = i % dimensao;
+    int id = d_ids[atributo];
+
+    /* A linha repetida é atualizada apenas pelo primeiro atributo que a
+       seleciona (com o gradiente de todos), para que o passo e o estado do
+       otimizador sejam aplicados uma única vez. */
+    bool repetida = false;
+
+    #pragma acc loop seq
+    for (int a = 0; a < atributo; a++)
+    {
+      repetida = repetida || d_ids[a] == id;
+    }
+
+    if (repetida)
+    {
+      continue;
+    }
+
+    /* Gradiente do erro em relação ao item da linha (a coluna de cada
+       atributo que seleciona a linha nos pesos, multiplicada pelo erro
+       retropropagado). */
+    float gradiente = 0.0;
+
+    #pragma acc loop seq
+    for (int a = atributo; a < qtdAtributos; a++)
+    {
+      if (d_ids[a] != id)
+      {
+        continue;
+      }
+
+      long entrada = (long) a * dimensao + coluna;
+
+      #pragma acc loop seq reduction(+:gradiente)
+      for (int n = 0; n < qtdNeuronios; n++)
+      {
+        gradiente += lerValorFormato(primeiraCamada_d_W,
+                                     primeiraCamada_d_Wreduzido, formatoPesos,
+                                     (long) qtdNeuroniosEntrada * n + entrada)
+                     * estado_d_neuronioErroRprop[n];
+      }
+    }
+
+    long posicao = (long) id * dimensao + coluna;
+
+    camada_d_tabela[posicao] += __passoOtimizador(otimizador,
+                                                  camada_d_velocidadeTabela,
+                                                  camada_d_segundoMomentoTabela,
+                                                  posicao, gradiente,
+                                                  camada_d_tabela[posicao],
+                                                  taxaAprendizagem);
+  }
 }
 
 void Camada_calcularAtivacaoNeuroniosPrimeiraCamada(const Camada camada,
+                                                    const EstadoCamada estado,
                                                     const float * d_amostra,
                                                     int qtdNeuroniosEntrada)
 {
@@ -123,25 +849,25 @@ void Camada_calcularAtivacaoNeuroniosPrimeiraCamada(const Camada camada,
    * para a memória do dispositivo, pois os mesmos já estão
    * na memória do dispositivo acelerador. */
   float * camada_d_W = camada.d_W;
-  float * camada_d_neuronioAtivacao = camada.d_neuronioAtivacao;
-  float * camada_d_neuronioDerivada = camada.d_neuronioDerivada;
-  float * camada_d_neuronioErroRprop = camada.d_neuronioErroRprop;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
   float * camada_d_bias = camada.d_bias;
+  float * estado_d_neuronioAtivacao = estado.d_neuronioAtivacao;
+  float * estado_d_neuronioDerivada = estado.d_neuronioDerivada;
   
   /* Percorrendo todos os neurônios da camada de forma paralela
    * no dispositivo acelerador. */
   #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
   copyin(camada, qtdNeuroniosEntrada) \
-  deviceptr(camada_d_W, camada_d_neuronioAtivacao, \
-            camada_d_neuronioDerivada, camada_d_neuronioErroRprop, \
-	    camada_d_bias, d_amostra)
+  deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_bias, \
+            estado_d_neuronioAtivacao, estado_d_neuronioDerivada, d_amostra)
   for (int n = 0; n < camada.qtdNeuronios; n++)
   {  
-    /* Variável que irá referênciar os pesos do neurônio "n-ésimo".
-    Os pesos serão obtidos utilizando o deslocamento "row-major". */
-    float * w = &camada_d_W[qtdNeuroniosEntrada * n];
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) qtdNeuroniosEntrada * n;
     
-    /* Calculando o valor da função de integração o neurônio. */
+    /* Calculando o valor da função de integração o neurônio (sempre
+    acumulado em fp32, mesmo com os pesos em um formato reduzido). */
     float valFuncIntegracao = 0.0;
 
     #pragma acc loop seq reduction(+:valFuncIntegracao)
@@ -149,7 +875,9 @@ void Camada_calcularAtivacaoNeuroniosPrimeiraCamada(const Camada camada,
     {      
       /* Somando o item "i-ésimo" da amostra pelo peso "i-ésimo" do
       neurônio "n-ésimo". */
-      valFuncIntegracao += w[i] * d_amostra[i];
+      valFuncIntegracao += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                           formatoPesos, w + i) *
+                           d_amostra[i];
     }
     
     /* Por fim calculando a ativação do neurônio (usando o bias) junto com
@@ -159,70 +887,69 @@ void Camada_calcularAtivacaoNeuroniosPrimeiraCamada(const Camada camada,
     switch (camada.funcaoAtivacao)
     {
     case Identidade:
-       camada_d_neuronioAtivacao[n] = valFuncIntegracao + camada_d_bias[n];
-       camada_d_neuronioDerivada[n] = 1;
+       estado_d_neuronioAtivacao[n] = valFuncIntegracao + camada_d_bias[n];
+       estado_d_neuronioDerivada[n] = 1;
        break;
     case Degrau:
       ativacaoNeuronio = funcaoDegrau(valFuncIntegracao + camada_d_bias[n]);
-      camada_d_neuronioAtivacao[n] = ativacaoNeuronio;
-      camada_d_neuronioDerivada[n] = derivadaFuncaoDegrau(ativacaoNeuronio);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoDegrau(ativacaoNeuronio);
       break;
     case Sigmoide:
       ativacaoNeuronio = funcaoSigmoide(valFuncIntegracao + camada_d_bias[n]);
-      camada_d_neuronioAtivacao[n] = ativacaoNeuronio;
-      camada_d_neuronioDerivada[n] = derivadaFuncaoSigmoide(ativacaoNeuronio);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoSigmoide(ativacaoNeuronio);
       break;
     case TangHiperbolica:
       ativacaoNeuronio = funcaoTangHiperbolica(valFuncIntegracao + camada_d_bias[n]);
-      camada_d_neuronioAtivacao[n] = ativacaoNeuronio;
-      camada_d_neuronioDerivada[n] = derivadaFuncaoTangHiperbolica(ativacaoNeuronio);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoTangHiperbolica(ativacaoNeuronio);
     }
   }
 }
 
-void Camada_calcularAtivacaoNeuroniosCamada(const Camada camadaAnterior,
-                                            const Camada camada)
+void Camada_calcularAtivacaoPrimeiraCamadaEsparsa(const Camada camada,
+                                                  const EstadoCamada estado,
+                                                  const int * d_indices,
+                                                  const float * d_valores,
+                                                  int qtdNaoNulos,
+                                                  int qtdNeuroniosEntrada)
 {
   /* Convertendo a estrutura da camada para variáveis de tipos
    * primitivos para que o OpenACC não tente copiar os vetores
    * para a memória do dispositivo, pois os mesmos já estão
    * na memória do dispositivo acelerador. */
-  float * camadaAnterior_d_W = camadaAnterior.d_W;
-  float * camadaAnterior_d_neuronioAtivacao = camadaAnterior.d_neuronioAtivacao;
-  float * camadaAnterior_d_neuronioDerivada = camadaAnterior.d_neuronioDerivada;
-  float * camadaAnterior_d_neuronioErroRprop = camadaAnterior.d_neuronioErroRprop;
-  float * camadaAnterior_d_bias = camadaAnterior.d_bias;
-
   float * camada_d_W = camada.d_W;
-  float * camada_d_neuronioAtivacao = camada.d_neuronioAtivacao;
-  float * camada_d_neuronioDerivada = camada.d_neuronioDerivada;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
   float * camada_d_bias = camada.d_bias;
+  float * estado_d_neuronioAtivacao = estado.d_neuronioAtivacao;
+  float * estado_d_neuronioDerivada = estado.d_neuronioDerivada;
 
   /* Percorrendo todos os neurônios da camada de forma paralela
-     no dispositivo acelerador. */
+   * no dispositivo acelerador. */
   #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
-  deviceptr(camadaAnterior_d_W, camadaAnterior_d_neuronioAtivacao, \
-            camadaAnterior_d_neuronioDerivada, camadaAnterior_d_bias, \
-            camadaAnterior_d_neuronioErroRprop, \
-            camada_d_neuronioAtivacao, camada_d_neuronioDerivada, \
-	    camada_d_bias)
+  copyin(camada, qtdNaoNulos, qtdNeuroniosEntrada) \
+  deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_bias, \
+            estado_d_neuronioAtivacao, estado_d_neuronioDerivada, \
+            d_indices, d_valores)
   for (int n = 0; n < camada.qtdNeuronios; n++)
   {
-    /* Variável que irá referênciar os pesos do neurônio "n-ésimo".
-    Os pesos serão obtidos utilizando o deslocamento "row-major". */
-    float * w = &camada_d_W[camadaAnterior.qtdNeuronios * n];
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) qtdNeuroniosEntrada * n;
 
-    /* Calculando o valor da função de integração o neurônio. */
+    /* Calculando o valor da função de integração do neurônio apenas com
+    os itens não nulos da amostra (os demais não contribuem para a soma). */
     float valFuncIntegracao = 0.0;
 
     #pragma acc loop seq reduction(+:valFuncIntegracao)
-    for (int i = 0; i < camadaAnterior.qtdNeuronios; i++)
+    for (int k = 0; k < qtdNaoNulos; k++)
     {
-      /* Somando a ativação do neurônio "i-ésimo" pelo peso "i-ésimo" do
-      neurônio "n-ésimo". */
-      valFuncIntegracao += w[i] * camadaAnterior_d_neuronioAtivacao[i];
+      valFuncIntegracao += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                           formatoPesos, w + d_indices[k]) *
+                           d_valores[k];
     }
-    
+
     /* Por fim calculando a ativação do neurônio (usando o bias) junto com
     sua derivada. */
     float ativacaoNeuronio;
@@ -230,76 +957,270 @@ void Camada_calcularAtivacaoNeuroniosCamada(const Camada camadaAnterior,
     switch (camada.funcaoAtivacao)
     {
     case Identidade:
-       camada_d_neuronioAtivacao[n] = valFuncIntegracao + camada_d_bias[n];
-       camada_d_neuronioDerivada[n] = 1;
-       break;
+      estado_d_neuronioAtivacao[n] = valFuncIntegracao + camada_d_bias[n];
+      estado_d_neuronioDerivada[n] = 1;
+      break;
     case Degrau:
       ativacaoNeuronio = funcaoDegrau(valFuncIntegracao + camada_d_bias[n]);
-      camada_d_neuronioAtivacao[n] = ativacaoNeuronio;
-      camada_d_neuronioDerivada[n] = derivadaFuncaoDegrau(ativacaoNeuronio);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoDegrau(ativacaoNeuronio);
       break;
     case Sigmoide:
       ativacaoNeuronio = funcaoSigmoide(valFuncIntegracao + camada_d_bias[n]);
-      camada_d_neuronioAtivacao[n] = ativacaoNeuronio;
-      camada_d_neuronioDerivada[n] = derivadaFuncaoSigmoide(ativacaoNeuronio);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoSigmoide(ativacaoNeuronio);
       break;
     case TangHiperbolica:
       ativacaoNeuronio = funcaoTangHiperbolica(valFuncIntegracao + camada_d_bias[n]);
-      camada_d_neuronioAtivacao[n] = ativacaoNeuronio;
-      camada_d_neuronioDerivada[n] = derivadaFuncaoTangHiperbolica(ativacaoNeuronio);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoTangHiperbolica(ativacaoNeuronio);
     }
   }
 }
 
-void Camada_calcularErroRpropNeuroniosCamada(const Camada camada,
-                                             const Camada camadaPosterior)
+void Camada_calcularAtivacaoPrimeiraCamadaBruta(const Camada camada,
+                                                const EstadoCamada estado,
+                                                const void * d_amostraBruta,
+                                                int tipoAmostra,
+                                                float escala,
+                                                float deslocamento,
+                                                const float * d_escalas,
+                                                const float * d_deslocamentos,
+                                                const float * d_somaPesos,
+                                                int qtdNeuroniosEntrada)
 {
   /* Convertendo a estrutura da camada para variáveis de tipos
    * primitivos para que o OpenACC não tente copiar os vetores
    * para a memória do dispositivo, pois os mesmos já estão
    * na memória do dispositivo acelerador. */
-  float * camada_d_neuronioDerivada = camada.d_neuronioDerivada;
-  float * camada_d_neuronioErroRprop = camada.d_neuronioErroRprop;
+  float * camada_d_W = camada.d_W;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
+  float * camada_d_bias = camada.d_bias;
+  float * estado_d_neuronioAtivacao = estado.d_neuronioAtivacao;
+  float * estado_d_neuronioDerivada = estado.d_neuronioDerivada;
 
-  float * camadaPosterior_d_W = camadaPosterior.d_W;
-  float * camadaPosterior_d_neuronioErroRprop = camadaPosterior.d_neuronioErroRprop;
-  float * camadaPosterior_d_bias = camadaPosterior.d_bias;
-  
   /* Percorrendo todos os neurônios da camada de forma paralela
-     no dispositivo acelerador. */
+   * no dispositivo acelerador. */
   #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
-  copyin(camada, camadaPosterior) \
-  deviceptr(camada_d_neuronioDerivada, camada_d_neuronioErroRprop, \
-            camadaPosterior_d_W, camadaPosterior_d_neuronioErroRprop, \
-            camadaPosterior_d_bias)
+  copyin(camada, tipoAmostra, escala, deslocamento, qtdNeuroniosEntrada) \
+  deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_bias, \
+            estado_d_neuronioAtivacao, estado_d_neuronioDerivada, \
+            d_amostraBruta, d_escalas, d_deslocamentos, d_somaPesos)
   for (int n = 0; n < camada.qtdNeuronios; n++)
   {
-    /* Calculando a soma dos erros da camada posterior multiplicados
-    pelo respectivos pesos. */
-    float somaErroCamadaPosterior = 0.0;
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) qtdNeuroniosEntrada * n;
 
-    #pragma acc loop seq reduction(+:somaErroCamadaPosterior)
-    for (int i = 0; i < camadaPosterior.qtdNeuronios; i++)
+    float valFuncIntegracao = 0.0;
+
+    if (d_escalas != NULL)
+    {
+      /* Com a escala de cada item, convertendo os itens durante o produto
+         escalar. */
+      #pragma acc loop seq reduction(+:valFuncIntegracao)
+      for (int i = 0; i < qtdNeuroniosEntrada; i++)
+      {
+        float item = lerItemAmostraBruta(d_amostraBruta, tipoAmostra, i) *
+                     d_escalas[i] + d_deslocamentos[i];
+
+        valFuncIntegracao += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                             formatoPesos, w + i) * item;
+      }
+    }
+    else if (d_somaPesos != NULL)
+    {
+      /* Com a soma dos pesos já calculada, apenas o produto escalar com os
+         itens brutos é realizado, aplicando a normalização uma única vez
+         por neurônio. */
+      float somaBruta = 0.0;
+
+      #pragma acc loop seq reduction(+:somaBruta)
+      for (int i = 0; i < qtdNeuroniosEntrada; i++)
+      {
+        somaBruta += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                     formatoPesos, w + i) *
+                     lerItemAmostraBruta(d_amostraBruta, tipoAmostra, i);
+      }
+
+      valFuncIntegracao = escala * somaBruta + deslocamento * d_somaPesos[n];
+    }
+    else
+    {
+      /* Somando os pesos multiplicados pelos itens brutos e os próprios
+         pesos, para aplicar a normalização apenas uma vez por neurônio. */
+      float somaBruta = 0.0;
+      float somaPesos = 0.0;
+
+      #pragma acc loop seq reduction(+:somaBruta, somaPesos)
+      for (int i = 0; i < qtdNeuroniosEntrada; i++)
+      {
+        float peso = lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                     formatoPesos, w + i);
+        somaBruta += peso * lerItemAmostraBruta(d_amostraBruta, tipoAmostra,
+                                                i);
+        somaPesos += peso;
+      }
+
+      valFuncIntegracao = escala * somaBruta + deslocamento * somaPesos;
+    }
+
+    /* Por fim calculando a ativação do neurônio (usando o bias) junto com
+    sua derivada. */
+    float ativacaoNeuronio;
+
+    switch (camada.funcaoAtivacao)
+    {
+    case Identidade:
+      estado_d_neuronioAtivacao[n] = valFuncIntegracao + camada_d_bias[n];
+      estado_d_neuronioDerivada[n] = 1;
+      break;
+    case Degrau:
+      ativacaoNeuronio = funcaoDegrau(valFuncIntegracao + camada_d_bias[n]);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoDegrau(ativacaoNeuronio);
+      break;
+    case Sigmoide:
+      ativacaoNeuronio = funcaoSigmoide(valFuncIntegracao + camada_d_bias[n]);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoSigmoide(ativacaoNeuronio);
+      break;
+    case TangHiperbolica:
+      ativacaoNeuronio = funcaoTangHiperbolica(valFuncIntegracao + camada_d_bias[n]);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoTangHiperbolica(ativacaoNeuronio);
+    }
+  }
+}
+
+void Camada_calcularAtivacaoNeuroniosCamada(const Camada camadaAnterior,
+                                            const EstadoCamada estadoAnterior,
+                                            const Camada camada,
+                                            const EstadoCamada estado)
+{
+  /* Convertendo a estrutura da camada para variáveis de tipos
+   * primitivos para que o OpenACC não tente copiar os vetores
+   * para a memória do dispositivo, pois os mesmos já estão
+   * na memória do dispositivo acelerador. */
+  float * estadoAnterior_d_neuronioAtivacao = estadoAnterior.d_neuronioAtivacao;
+
+  float * camada_d_W = camada.d_W;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
+  float * camada_d_bias = camada.d_bias;
+  float * estado_d_neuronioAtivacao = estado.d_neuronioAtivacao;
+  float * estado_d_neuronioDerivada = estado.d_neuronioDerivada;
+
+  /* Percorrendo todos os neurônios da camada de forma paralela
+     no dispositivo acelerador. */
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  copyin(camadaAnterior, camada) \
+  deviceptr(estadoAnterior_d_neuronioAtivacao, camada_d_W, \
+            camada_d_Wreduzido, camada_d_bias, estado_d_neuronioAtivacao, \
+            estado_d_neuronioDerivada)
+  for (int n = 0; n < camada.qtdNeuronios; n++)
+  {
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) camadaAnterior.qtdNeuronios * n;
+
+    /* Calculando o valor da função de integração o neurônio (sempre
+    acumulado em fp32). */
+    float valFuncIntegracao = 0.0;
+
+    #pragma acc loop seq reduction(+:valFuncIntegracao)
+    for (int i = 0; i < camadaAnterior.qtdNeuronios; i++)
+    {
+      /* Somando a ativação do neurônio "i-ésimo" pelo peso "i-ésimo" do
+      neurônio "n-ésimo". */
+      valFuncIntegracao += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                           formatoPesos, w + i) *
+                           estadoAnterior_d_neuronioAtivacao[i];
+    }
+    
+    /* Por fim calculando a ativação do neurônio (usando o bias) junto com
+    sua derivada. */
+    float ativacaoNeuronio;
+
+    switch (camada.funcaoAtivacao)
+    {
+    case Identidade:
+       estado_d_neuronioAtivacao[n] = valFuncIntegracao + camada_d_bias[n];
+       estado_d_neuronioDerivada[n] = 1;
+       break;
+    case Degrau:
+      ativacaoNeuronio = funcaoDegrau(valFuncIntegracao + camada_d_bias[n]);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoDegrau(ativacaoNeuronio);
+      break;
+    case Sigmoide:
+      ativacaoNeuronio = funcaoSigmoide(valFuncIntegracao + camada_d_bias[n]);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoSigmoide(ativacaoNeuronio);
+      break;
+    case TangHiperbolica:
+      ativacaoNeuronio = funcaoTangHiperbolica(valFuncIntegracao + camada_d_bias[n]);
+      estado_d_neuronioAtivacao[n] = ativacaoNeuronio;
+      estado_d_neuronioDerivada[n] = derivadaFuncaoTangHiperbolica(ativacaoNeuronio);
+    }
+  }
+}
+
+void Camada_calcularErroRpropNeuroniosCamada(const Camada camada,
+                                             const EstadoCamada estado,
+                                             const Camada camadaPosterior,
+                                             const EstadoCamada estadoPosterior)
+{
+  /* Convertendo a estrutura da camada para variáveis de tipos
+   * primitivos para que o OpenACC não tente copiar os vetores
+   * para a memória do dispositivo, pois os mesmos já estão
+   * na memória do dispositivo acelerador. */
+  float * estado_d_neuronioDerivada = estado.d_neuronioDerivada;
+  float * estado_d_neuronioErroRprop = estado.d_neuronioErroRprop;
+
+  float * camadaPosterior_d_W = camadaPosterior.d_W;
+  uint16_t * camadaPosterior_d_Wreduzido = camadaPosterior.d_Wreduzido;
+  int formatoPesosPosterior = camadaPosterior.formatoPesos;
+  float * estadoPosterior_d_neuronioErroRprop = estadoPosterior.d_neuronioErroRprop;
+  
+  /* Percorrendo todos os neurônios da camada de forma paralela
+     no dispositivo acelerador. */
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  copyin(camada, camadaPosterior) \
+  deviceptr(estado_d_neuronioDerivada, estado_d_neuronioErroRprop, \
+            camadaPosterior_d_W, camadaPosterior_d_Wreduzido, \
+            estadoPosterior_d_neuronioErroRprop)
+  for (int n = 0; n < camada.qtdNeuronios; n++)
+  {
+    /* Calculando a soma dos erros da camada posterior multiplicados
+    pelo respectivos pesos. */
+    float somaErroCamadaPosterior = 0.0;
+
+    #pragma acc loop seq reduction(+:somaErroCamadaPosterior)
+    for (int i = 0; i < camadaPosterior.qtdNeuronios; i++)
     {
       /* Coletando o peso do neurônio "i-ésimo" da camada posterior
       que se conecta ao respectivo neurônio "n-ésimo" que está tendo seu
       erro calculado. */
-      float w = camadaPosterior_d_W[camada.qtdNeuronios * i + n];
+      float w = lerValorFormato(camadaPosterior_d_W,
+                                camadaPosterior_d_Wreduzido,
+                                formatoPesosPosterior,
+                                (long) camada.qtdNeuronios * i + n);
 
       /* Calculando o erro do neurônio "i-ésimo" da camada posterior
       multiplicado pelo respectivo peso da camada posterior que se
       conecta ao respectivo neurônio "n-ésimo" que está tendo seu erro
       calculado, e somando... */
-      somaErroCamadaPosterior += w * camadaPosterior_d_neuronioErroRprop[i];
+      somaErroCamadaPosterior += w * estadoPosterior_d_neuronioErroRprop[i];
     }
 
     /* Por fim, calculando o erro retropropagado do neurônio. */
-    camada_d_neuronioErroRprop[n] = camada_d_neuronioDerivada[n] *
+    estado_d_neuronioErroRprop[n] = estado_d_neuronioDerivada[n] *
       somaErroCamadaPosterior;
   }
 }
 
 void Camada_calcularErroRpropNeuroniosUltimaCamada(const Camada camada,
+                                                   const EstadoCamada estado,
 						   const float * d_alvo,
 						   float * d_erroPadrao)
 {
@@ -307,17 +1228,15 @@ void Camada_calcularErroRpropNeuroniosUltimaCamada(const Camada camada,
    * primitivos para que o OpenACC não tente copiar os vetores
    * para a memória do dispositivo, pois os mesmos já estão
    * na memória do dispositivo acelerador. */
-  float * camada_d_neuronioAtivacao = camada.d_neuronioAtivacao;
-  float * camada_d_neuronioDerivada = camada.d_neuronioDerivada;
-  float * camada_d_neuronioErroRprop = camada.d_neuronioErroRprop;
-  float * camada_d_bias = camada.d_bias;
+  float * estado_d_neuronioAtivacao = estado.d_neuronioAtivacao;
+  float * estado_d_neuronioDerivada = estado.d_neuronioDerivada;
+  float * estado_d_neuronioErroRprop = estado.d_neuronioErroRprop;
   
   /* Calculando o erro retropropagado da última camada no próprio dispositivo
      acelerador de forma sequencial para manter a localidade dos dados. */
   #pragma acc parallel copyin(camada) \
-  deviceptr(camada_d_neuronioAtivacao, camada_d_neuronioDerivada, \
-            camada_d_neuronioErroRprop, camada_d_bias, \
-            d_alvo, d_erroPadrao)
+  deviceptr(estado_d_neuronioAtivacao, estado_d_neuronioDerivada, \
+            estado_d_neuronioErroRprop, d_alvo, d_erroPadrao)
   {
     /* Variável que irá armazenar o erro para o padrão apresentado à rede. */
     float erroPadrao = 0.0;
@@ -327,11 +1246,11 @@ void Camada_calcularErroRpropNeuroniosUltimaCamada(const Camada camada,
     for (int n = 0; n < camada.qtdNeuronios; n++)
     {
       /* Calculando o erro da saída do neurônio "n-ésimo". */
-      float erroSaidaNeuronio = camada_d_neuronioAtivacao[n] - d_alvo[n];
+      float erroSaidaNeuronio = estado_d_neuronioAtivacao[n] - d_alvo[n];
 	
       /* Calculando o erro retropropagado. */
-      camada_d_neuronioErroRprop[n] = erroSaidaNeuronio *
-	camada_d_neuronioDerivada[n];
+      estado_d_neuronioErroRprop[n] = erroSaidaNeuronio *
+	estado_d_neuronioDerivada[n];
 
       /* Calculando o erro para o padrão... */
       erroPadrao += 0.5 * powf(erroSaidaNeuronio, 2);
@@ -343,425 +1262,2497 @@ void Camada_calcularErroRpropNeuroniosUltimaCamada(const Camada camada,
 }
 
 void Camada_atualizarPesosNeuroniosPrimeiraCamada(const Camada camada,
+                                                  const EstadoCamada estado,
                                                   const float * d_amostra,
                                                   int qtdNeuroniosEntrada,
-                                                  float taxaAprendizagem)
+                                                  float taxaAprendizagem,
+                                                  const ParametrosOtimizador
+                                                  otimizador)
 {
   /* Convertendo a estrutura da camada para variáveis de tipos
    * primitivos para que o OpenACC não tente copiar os vetores
    * para a memória do dispositivo, pois os mesmos já estão
    * na memória do dispositivo acelerador. */
   float * camada_d_W = camada.d_W;
-  float * camada_d_neuronioErroRprop = camada.d_neuronioErroRprop;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
   float * camada_d_bias = camada.d_bias;
+  float * camada_d_velocidadeW = camada.d_velocidadeW;
+  float * camada_d_velocidadeBias = camada.d_velocidadeBias;
+  float * camada_d_segundoMomentoW = camada.d_segundoMomentoW;
+  float * camada_d_segundoMomentoBias = camada.d_segundoMomentoBias;
+  float * estado_d_neuronioErroRprop = estado.d_neuronioErroRprop;
   
   /* Percorrendo todos os neurônios da camada de forma paralela
      no dispositivo acelerador. */
   #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
-  copyin(camada, qtdNeuroniosEntrada, taxaAprendizagem) \
-  deviceptr(camada_d_W, camada_d_neuronioErroRprop, \
-            camada_d_bias, d_amostra)
+  copyin(camada, qtdNeuroniosEntrada, taxaAprendizagem, \
+         otimizador) \
+  deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_bias, \
+            camada_d_velocidadeW, camada_d_velocidadeBias, \
+            camada_d_segundoMomentoW, camada_d_segundoMomentoBias, \
+            estado_d_neuronioErroRprop, d_amostra)
   for (int n = 0; n < camada.qtdNeuronios; n++)
   {
-    /* Variável que irá referênciar os pesos do neurônio "n-ésimo".
-    Os pesos serão obtidos utilizando o deslocamento "row-major". */
-    float * w = &camada_d_W[qtdNeuroniosEntrada * n];
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) qtdNeuroniosEntrada * n;
 
     /* Percorrendo todos os pesos do neurônio. */
     #pragma acc loop seq
     for (int i = 0; i < qtdNeuroniosEntrada; i++)
     {
       /* Atualizando o peso "i-ésimo" do neurônio "n-ésimo". */
-      w[i] += -taxaAprendizagem * d_amostra[i] * camada_d_neuronioErroRprop[n];
+      __atualizarPesoOtimizador(camada_d_W, camada_d_Wreduzido, formatoPesos,
+                                camada_d_velocidadeW,
+                                camada_d_segundoMomentoW, w + i,
+                                d_amostra[i] * estado_d_neuronioErroRprop[n],
+                                taxaAprendizagem, otimizador);
+    }
+
+    /* Atualizando o bias do neurônio "n-ésimo"... */
+    camada_d_bias[n] += __passoOtimizador(otimizador,
+                                          camada_d_velocidadeBias,
+                                          camada_d_segundoMomentoBias, n,
+                                          estado_d_neuronioErroRprop[n], 0,
+                                          taxaAprendizagem);
+  }
+}
+
+void Camada_atualizarPesosPrimeiraCamadaEsparsa(const Camada camada,
+                                                const EstadoCamada estado,
+                                                const int * d_indices,
+                                                const float * d_valores,
+                                                int qtdNaoNulos,
+                                                int qtdNeuroniosEntrada,
+                                                float taxaAprendizagem,
+                                                const ParametrosOtimizador
+                                                otimizador)
+{
+  /* Convertendo a estrutura da camada para variáveis de tipos
+   * primitivos para que o OpenACC não tente copiar os vetores
+   * para a memória do dispositivo, pois os mesmos já estão
+   * na memória do dispositivo acelerador. */
+  float * camada_d_W = camada.d_W;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
+  float * camada_d_bias = camada.d_bias;
+  float * camada_d_velocidadeW = camada.d_velocidadeW;
+  float * camada_d_velocidadeBias = camada.d_velocidadeBias;
+  float * camada_d_segundoMomentoW = camada.d_segundoMomentoW;
+  float * camada_d_segundoMomentoBias = camada.d_segundoMomentoBias;
+  float * estado_d_neuronioErroRprop = estado.d_neuronioErroRprop;
+
+  /* Percorrendo todos os neurônios da camada de forma paralela
+     no dispositivo acelerador. */
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  copyin(camada, qtdNaoNulos, qtdNeuroniosEntrada, taxaAprendizagem, \
+         otimizador) \
+  deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_bias, \
+            camada_d_velocidadeW, camada_d_velocidadeBias, \
+            camada_d_segundoMomentoW, camada_d_segundoMomentoBias, \
+            estado_d_neuronioErroRprop, d_indices, d_valores)
+  for (int n = 0; n < camada.qtdNeuronios; n++)
+  {
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) qtdNeuroniosEntrada * n;
+
+    /* Percorrendo apenas os pesos das entradas não nulas (o gradiente dos
+    demais pesos é nulo). */
+    #pragma acc loop seq
+    for (int k = 0; k < qtdNaoNulos; k++)
+    {
+      __atualizarPesoOtimizador(camada_d_W, camada_d_Wreduzido, formatoPesos,
+                                camada_d_velocidadeW,
+                                camada_d_segundoMomentoW, w + d_indices[k],
+                                d_valores[k] * estado_d_neuronioErroRprop[n],
+                                taxaAprendizagem, otimizador);
+    }
+
+    /* Atualizando o bias do neurônio "n-ésimo"... */
+    camada_d_bias[n] += __passoOtimizador(otimizador,
+                                          camada_d_velocidadeBias,
+                                          camada_d_segundoMomentoBias, n,
+                                          estado_d_neuronioErroRprop[n], 0,
+                                          taxaAprendizagem);
+  }
+}
+
+void Camada_atualizarPesosPrimeiraCamadaBruta(const Camada camada,
+                                              const EstadoCamada estado,
+                                              const void * d_amostraBruta,
+                                              int tipoAmostra,
+                                              float escala,
+                                              float deslocamento,
+                                              const float * d_escalas,
+                                              const float * d_deslocamentos,
+                                              int qtdNeuroniosEntrada,
+                                              float taxaAprendizagem,
+                                              const ParametrosOtimizador
+                                              otimizador,
+                                              float * d_somaPesos)
+{
+  /* Convertendo a estrutura da camada para variáveis de tipos
+   * primitivos para que o OpenACC não tente copiar os vetores
+   * para a memória do dispositivo, pois os mesmos já estão
+   * na memória do dispositivo acelerador. */
+  float * camada_d_W = camada.d_W;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
+  float * camada_d_bias = camada.d_bias;
+  float * camada_d_velocidadeW = camada.d_velocidadeW;
+  float * camada_d_velocidadeBias = camada.d_velocidadeBias;
+  float * camada_d_segundoMomentoW = camada.d_segundoMomentoW;
+  float * camada_d_segundoMomentoBias = camada.d_segundoMomentoBias;
+  float * estado_d_neuronioErroRprop = estado.d_neuronioErroRprop;
+
+  /* Percorrendo todos os neurônios da camada de forma paralela
+     no dispositivo acelerador. */
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  copyin(camada, tipoAmostra, escala, deslocamento, qtdNeuroniosEntrada, \
+         taxaAprendizagem, otimizador) \
+  deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_bias, \
+            camada_d_velocidadeW, camada_d_velocidadeBias, \
+            camada_d_segundoMomentoW, camada_d_segundoMomentoBias, \
+            estado_d_neuronioErroRprop, d_amostraBruta, d_escalas, \
+            d_deslocamentos, d_somaPesos)
+  for (int n = 0; n < camada.qtdNeuronios; n++)
+  {
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) qtdNeuroniosEntrada * n;
+
+    /* Soma dos pesos já atualizados do neurônio (utilizada pela próxima
+       ativação com amostras brutas). */
+    float somaPesos = 0.0;
+
+    /* Percorrendo todos os pesos do neurônio, normalizando o item da
+       amostra correspondente. */
+    #pragma acc loop seq reduction(+:somaPesos)
+    for (int i = 0; i < qtdNeuroniosEntrada; i++)
+    {
+      float escalaItem = (d_escalas != NULL) ? d_escalas[i] : escala;
+      float deslocamentoItem = (d_deslocamentos != NULL) ?
+                               d_deslocamentos[i] : deslocamento;
+      float item = lerItemAmostraBruta(d_amostraBruta, tipoAmostra, i) *
+                   escalaItem + deslocamentoItem;
+
+      __atualizarPesoOtimizador(camada_d_W, camada_d_Wreduzido, formatoPesos,
+                                camada_d_velocidadeW,
+                                camada_d_segundoMomentoW, w + i,
+                                item * estado_d_neuronioErroRprop[n],
+                                taxaAprendizagem, otimizador);
+
+      /* Relendo o peso no formato da camada, igual ao lido pela ativação. */
+      somaPesos += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                   formatoPesos, w + i);
+    }
+
+    if (d_somaPesos != NULL)
+    {
+      d_somaPesos[n] = somaPesos;
     }
 
     /* Atualizando o bias do neurônio "n-ésimo"... */
-    camada_d_bias[n] += -taxaAprendizagem * camada_d_neuronioErroRprop[n];
+    camada_d_bias[n] += __passoOtimizador(otimizador,
+                                          camada_d_velocidadeBias,
+                                          camada_d_segundoMomentoBias, n,
+                                          estado_d_neuronioErroRprop[n], 0,
+                                          taxaAprendizagem);
   }
 }
 
 void Camada_atualizarPesosNeuroniosCamada(const Camada camadaAnterior,
+                                          const EstadoCamada estadoAnterior,
                                           const Camada camada,
-                                          float taxaAprendizagem)
+                                          const EstadoCamada estado,
+                                          float taxaAprendizagem,
+                                          const ParametrosOtimizador
+                                          otimizador)
 {
   /* Convertendo a estrutura da camada para variáveis de tipos
    * primitivos para que o OpenACC não tente copiar os vetores
    * para a memória do dispositivo, pois os mesmos já estão
    * na memória do dispositivo acelerador. */
-  float * camadaAnterior_d_W = camadaAnterior.d_W;
-  float * camadaAnterior_d_neuronioAtivacao = camadaAnterior.d_neuronioAtivacao;
-  float * camadaAnterior_d_neuronioDerivada = camadaAnterior.d_neuronioDerivada;
-  float * camadaAnterior_d_neuronioErroRprop = camadaAnterior.d_neuronioErroRprop;
-  float * camadaAnterior_d_bias = camadaAnterior.d_bias;
+  float * estadoAnterior_d_neuronioAtivacao = estadoAnterior.d_neuronioAtivacao;
   
   float * camada_d_W = camada.d_W;
-  float * camada_d_neuronioAtivacao = camada.d_neuronioAtivacao;
-  float * camada_d_neuronioDerivada = camada.d_neuronioDerivada;
-  float * camada_d_neuronioErroRprop = camada.d_neuronioErroRprop;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
   float * camada_d_bias = camada.d_bias;
+  float * camada_d_velocidadeW = camada.d_velocidadeW;
+  float * camada_d_velocidadeBias = camada.d_velocidadeBias;
+  float * camada_d_segundoMomentoW = camada.d_segundoMomentoW;
+  float * camada_d_segundoMomentoBias = camada.d_segundoMomentoBias;
+  float * estado_d_neuronioErroRprop = estado.d_neuronioErroRprop;
   
   /* Percorrendo todos os neurônios da camada de forma paralela
      no dispositivo acelerador. */
   #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
-  copyin(camadaAnterior, camada, taxaAprendizagem) \
-  deviceptr(camadaAnterior_d_neuronioAtivacao,	\
-            camada_d_W, camada_d_neuronioAtivacao, \
-            camada_d_neuronioErroRprop, \
-            camada_d_bias)
+  copyin(camadaAnterior, camada, taxaAprendizagem, otimizador) \
+  deviceptr(estadoAnterior_d_neuronioAtivacao, camada_d_W, \
+            camada_d_Wreduzido, camada_d_bias, camada_d_velocidadeW, \
+            camada_d_velocidadeBias, camada_d_segundoMomentoW, \
+            camada_d_segundoMomentoBias, estado_d_neuronioErroRprop)
   for (int n = 0; n < camada.qtdNeuronios; n++)
   {
-    /* Variável que irá referênciar os pesos do neurônio "n-ésimo".
-    Os pesos serão obtidos utilizando o deslocamento "row-major". */
-    float * w = &camada_d_W[camadaAnterior.qtdNeuronios * n];
+    /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+    long w = (long) camadaAnterior.qtdNeuronios * n;
 
     /* Percorrendo todos os pesos do neurônio. */
     #pragma acc loop seq
     for (int i = 0; i < camadaAnterior.qtdNeuronios; i++)
     {
       /* Atualizando o peso "i-ésimo" do neurônio "n-ésimo". */
-      w[i] += -taxaAprendizagem * camadaAnterior_d_neuronioAtivacao[i] *
-              camada_d_neuronioErroRprop[n];
+      __atualizarPesoOtimizador(camada_d_W, camada_d_Wreduzido, formatoPesos,
+                                camada_d_velocidadeW,
+                                camada_d_segundoMomentoW, w + i,
+                                estadoAnterior_d_neuronioAtivacao[i] *
+                                estado_d_neuronioErroRprop[n],
+                                taxaAprendizagem, otimizador);
     }
 
     /* Atualizando o bias do neurônio "n-ésimo"... */
-    camada_d_bias[n] += -taxaAprendizagem * camada_d_neuronioErroRprop[n];
+    camada_d_bias[n] += __passoOtimizador(otimizador,
+                                          camada_d_velocidadeBias,
+                                          camada_d_segundoMomentoBias, n,
+                                          estado_d_neuronioErroRprop[n], 0,
+                                          taxaAprendizagem);
   }
 }
 
 void PerceptronMulticamadas_feedfoward(PerceptronMulticamadas * pm,
+                                       ContextoExecucao * contexto,
                                        const float * d_amostra)
 {
   /* Calculando a ativação dos neurônios da primeira camada. */
-  Camada_calcularAtivacaoNeuroniosPrimeiraCamada(*pm->camadas[0], d_amostra,
+  Camada_calcularAtivacaoNeuroniosPrimeiraCamada(*pm->camadas[0],
+                                                 contexto->estados[0],
+                                                 d_amostra,
                                                  pm->qtdNeuroniosEntrada);
 
   /* Calculando a ativação dos neurônios das demais camadas. */
   for (int c = 1; c < pm->qtdCamadas; c++)
   {
     Camada_calcularAtivacaoNeuroniosCamada(*pm->camadas[c - 1],
-					   *pm->camadas[c]);
+                                           contexto->estados[c - 1],
+					   *pm->camadas[c],
+                                           contexto->estados[c]);
   }
 }
 
-HistoricoTreinamento *
-PerceptronMulticamadas_backpropagation(PerceptronMulticamadas * pm,
-				       PadraoTreinamento * padroes,
-				       int qtdPadroesTreinamento,
-				       float taxaAprendizagem,
-				       float erroDesejado,
-				       bool gerarHistorico)
+/**
+ * Método que calcula a soma dos pesos de cada neurônio da primeira camada
+ * (no formato da camada), utilizada pela ativação com amostras brutas.
+ */
+static void __calcularSomaPesosPrimeiraCamada(const Camada camada,
+                                              int qtdNeuroniosEntrada,
+                                              float * d_somaPesos)
 {
-  /* Inicializando a estrutura. */
-  HistoricoTreinamento * historicoTreinamento; 
-  if (gerarHistorico)
+  float * camada_d_W = camada.d_W;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
+
+  #pragma acc parallel loop vector_length(TAM_VECTOR) gang, vector \
+  copyin(camada, qtdNeuroniosEntrada) \
+  deviceptr(camada_d_W, camada_d_Wreduzido, d_somaPesos)
+  for (int n = 0; n < camada.qtdNeuronios; n++)
   {
-    historicoTreinamento = HistoricoTreinamento_inicializar(pm,
-							    taxaAprendizagem,
-							    erroDesejado);
+    long w = (long) qtdNeuroniosEntrada * n;
+    float somaPesos = 0.0;
+
+    #pragma acc loop seq reduction(+:somaPesos)
+    for (int i = 0; i < qtdNeuroniosEntrada; i++)
+    {
+      somaPesos += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                   formatoPesos, w + i);
+    }
+
+    d_somaPesos[n] = somaPesos;
   }
-  
-  /* Variável que irá armazenar o erro global calculado para cada iteração.
-     A mesma será populada após a execução de uma iteração, onde será copiado
-     o erro global que está na memória do dispositivo acelerador para o
-     hospedeiro. */
-  float h_erroGlobal;
+}
 
-  /* Alocando na memória do dispositivo acelerador  a variável que 
-     irá armazenar o erro para os padrões apresentados à rede. */
-  float * d_erroPadrao;
-  cudaMalloc((void **) &d_erroPadrao, sizeof(float));
+void PerceptronMulticamadas_feedfowardPadrao(PerceptronMulticamadas * pm,
+                                             ContextoExecucao * contexto,
+                                             const PadraoTreinamento * padrao)
+{
+  switch (padrao->tipoAmostra)
+  {
+  case AmostraEsparsa:
+    /* Calculando a ativação da primeira camada apenas com os itens não
+       nulos da amostra. */
+    Camada_calcularAtivacaoPrimeiraCamadaEsparsa(*pm->camadas[0],
+                                                 contexto->estados[0],
+                                                 padrao->d_indices,
+                                                 padrao->d_amostra,
+                                                 padrao->qtdNaoNulos,
+                                                 pm->qtdNeuroniosEntrada);
+    break;
+  case AmostraUint8:
+  case AmostraUint16:
+  case AmostraFP16:
+    /* Calculando a ativação da primeira camada com a amostra bruta,
+       normalizada durante o cálculo. Com a mesma normalização para todos
+       os itens, a soma dos pesos de cada neurônio é calculada apenas
+       quando os pesos foram modificados fora do treinamento com amostras
+       brutas (que a mantém atualizada). */
+    if (padrao->d_escalasAmostra == NULL && !contexto->somaPesosValida)
+    {
+      __calcularSomaPesosPrimeiraCamada(*pm->camadas[0],
+                                        pm->qtdNeuroniosEntrada,
+                                        contexto->d_somaPesosPrimeiraCamada);
+      contexto->somaPesosValida = true;
+    }
 
-  /* O treinamento irá ocorrer enquanto o erro da rede estiver acima
-     do desejado OU a quantidade de épocas não tenha atingido o limite. */
-  int epocas = 0;
+    Camada_calcularAtivacaoPrimeiraCamadaBruta(*pm->camadas[0],
+                                               contexto->estados[0],
+                                               padrao->d_amostraBruta,
+                                               padrao->tipoAmostra,
+                                               padrao->escalaAmostra,
+                                               padrao->deslocamentoAmostra,
+                                               padrao->d_escalasAmostra,
+                                               padrao->d_deslocamentosAmostra,
+                                               contexto->d_somaPesosPrimeiraCamada,
+                                               pm->qtdNeuroniosEntrada);
+    break;
+  case AmostraCategorica:
+    /* Montando a entrada da primeira camada com a camada de "embedding". */
+    CamadaEmbedding_montarEntrada(*pm->embedding, padrao->d_indices,
+                                  padrao->d_amostra, pm->qtdNeuroniosEntrada,
+                                  contexto->d_entradaEmbedding);
+    PerceptronMulticamadas_feedfoward(pm, contexto,
+                                      contexto->d_entradaEmbedding);
+    return;
+  default:
+    PerceptronMulticamadas_feedfoward(pm, contexto, padrao->d_amostra);
+    return;
+  }
 
-  do
+  /* Calculando a ativação dos neurônios das demais camadas. */
+  for (int c = 1; c < pm->qtdCamadas; c++)
   {
-    /* Inicializando com 0 o erro global no para
-       a época atual. */
-    h_erroGlobal = 0;
+    Camada_calcularAtivacaoNeuroniosCamada(*pm->camadas[c - 1],
+                                           contexto->estados[c - 1],
+                                           *pm->camadas[c],
+                                           contexto->estados[c]);
+  }
+}
 
-    /* Variáveis que serão utilizadas para armazenar a hora que foi iniciada
-       e finalizada o treinamento da rede para a época atual. */
-    struct timeval horaAntesTreinamento;
-    struct timeval horaDepoisTreinamento;
+void Camada_calcularAtivacaoNeuroniosLote(const Camada camada,
+                                          const float * d_entradaLote,
+                                          int qtdNeuroniosEntrada,
+                                          int passoEntrada,
+                                          float * d_saidaLote,
+                                          int passoSaida,
+                                          int qtdAmostras)
+{
+  Camada_calcularAtivacaoNeuroniosLoteFormato(camada, d_entradaLote,
+                                              FormatoFP32,
+                                              qtdNeuroniosEntrada,
+                                              passoEntrada, d_saidaLote,
+                                              FormatoFP32, passoSaida,
+                                              qtdAmostras);
+}
 
-    /* Coletando a hora antes do treinamento. */
-    gettimeofday(&horaAntesTreinamento, NULL);
+void Camada_calcularAtivacaoNeuroniosLoteFormato(const Camada camada,
+                                                 const void * d_entradaLote,
+                                                 int formatoEntrada,
+                                                 int qtdNeuroniosEntrada,
+                                                 int passoEntrada,
+                                                 void * d_saidaLote,
+                                                 int formatoSaida,
+                                                 int passoSaida,
+                                                 int qtdAmostras)
+{
+  /* Convertendo a estrutura da camada para variáveis de tipos
+   * primitivos para que o OpenACC não tente copiar os vetores
+   * para a memória do dispositivo, pois os mesmos já estão
+   * na memória do dispositivo acelerador. */
+  float * camada_d_W = camada.d_W;
+  uint16_t * camada_d_Wreduzido = camada.d_Wreduzido;
+  int formatoPesos = camada.formatoPesos;
+  float * camada_d_bias = camada.d_bias;
+  int qtdNeuronios = camada.qtdNeuronios;
+  int funcaoAtivacao = camada.funcaoAtivacao;
+
+  /* As matrizes são acessadas através do ponteiro do seu formato. */
+  const float * entradaFP32 = (const float *) d_entradaLote;
+  const uint16_t * entradaReduzida = (const uint16_t *) d_entradaLote;
+  float * saidaFP32 = (float *) d_saidaLote;
+  uint16_t * saidaReduzida = (uint16_t *) d_saidaLote;
+
+  /* Percorrendo as amostras do lote ("gangs") e os neurônios da camada
+     ("vector lanes") de forma paralela no dispositivo acelerador. */
+  #pragma acc parallel loop gang vector_length(TAM_VECTOR) \
+  deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_bias, entradaFP32, \
+            entradaReduzida, saidaFP32, saidaReduzida)
+  for (int s = 0; s < qtdAmostras; s++)
+  {
+    /* Deslocamentos da entrada e da saída da amostra "s-ésima". */
+    long entrada = (long) passoEntrada * s;
+    long saida = (long) passoSaida * s;
 
-    /* Apresentando os padrões de treinamento para rede e realizando o
-       treinamento da mesma. */
-    for (int i = 0; i < qtdPadroesTreinamento; i++)
+    #pragma acc loop vector
+    for (int n = 0; n < qtdNeuronios; n++)
     {
-      
-      /* Alimentando a rede com o padrão "i-ésimo". */
-      PerceptronMulticamadas_feedfoward(pm, padroes[i].d_amostra);
+      /* Deslocamento dos pesos do neurônio "n-ésimo" ("row-major"). */
+      long w = (long) qtdNeuroniosEntrada * n;
 
-      /* Calculando o erro dos neurônios da última camada e já calculando
-	 o erro global para o padrão apresentado à rede. */
-      Camada_calcularErroRpropNeuroniosUltimaCamada
-	(*pm->camadas[pm->qtdCamadas - 1], padroes[i].d_alvo, d_erroPadrao);
+      /* Calculando o valor da função de integração o neurônio (sempre
+      acumulado em fp32). */
+      float valFuncIntegracao = 0.0;
 
-      /* Copiando o erro do padrão armazenado no adaptador gráfico para o hospedeiro. */
-      float h_erroPadrao;
-      cudaMemcpy(&h_erroPadrao, d_erroPadrao, sizeof(float),
-		 cudaMemcpyDeviceToHost);
-      
-      /* Somando o erro calculado para o padrão no erro global. */
-      h_erroGlobal += h_erroPadrao;
-       
-      /* Realizando a retropropagação do erro para as demais camadas. */
-      for (int c = pm->qtdCamadas - 2; c >= 0; c--)
+      #pragma acc loop seq reduction(+:valFuncIntegracao)
+      for (int i = 0; i < qtdNeuroniosEntrada; i++)
       {
-        Camada_calcularErroRpropNeuroniosCamada(*pm->camadas[c],
-                                                *pm->camadas[c + 1]);
+        valFuncIntegracao += lerValorFormato(camada_d_W, camada_d_Wreduzido,
+                                             formatoPesos, w + i) *
+                             lerValorFormato(entradaFP32, entradaReduzida,
+                                             formatoEntrada, entrada + i);
       }
 
-      /* Atualizando os pesos dos neurônios da primeira camada. */
-      Camada_atualizarPesosNeuroniosPrimeiraCamada(*pm->camadas[0],
-                                                   padroes[i].d_amostra,
-                                                   pm->qtdNeuroniosEntrada,
-                                                   taxaAprendizagem);
-
-      /* Atualizando os pesos dos neurônios das demais camadas. */
-      for (int c = 1; c < pm->qtdCamadas; c++)
-      {
-        Camada_atualizarPesosNeuroniosCamada(*pm->camadas[c - 1],
-                                             *pm->camadas[c],
-                                             taxaAprendizagem);
-      }
+      /* Por fim calculando a ativação do neurônio (usando o bias). */
+      escreverValorFormato(saidaFP32, saidaReduzida, formatoSaida, saida + n,
+                           aplicarFuncaoAtivacao(valFuncIntegracao +
+                                                 camada_d_bias[n],
+                                                 funcaoAtivacao));
     }
+  }
+}
 
-    /* Coletando a hora depois do treinamento. */
-    gettimeofday(&horaDepoisTreinamento, NULL);
+/**
+ * Método que aloca (caso ainda não tenham sido alocadas) as matrizes da
+ * inferência em lote do contexto.
+ */
+static void __alocarMatrizesLoteContexto(PerceptronMulticamadas * pm,
+                                         ContextoExecucao * contexto)
+{
+  if (contexto->d_loteAtivacaoA != NULL)
+  {
+    return;
+  }
 
-    /* Realizando o cálculo do MSE. */
-    h_erroGlobal = h_erroGlobal/ qtdPadroesTreinamento;
+  /* Localizando a maior camada da rede. */
+  int maiorCamada = 0;
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    if (pm->camadas[c]->qtdNeuronios > maiorCamada)
+    {
+      maiorCamada = pm->camadas[c]->qtdNeuronios;
+    }
+  }
 
-    /* Atualizando a quantidade de épocas. */
-    epocas++;
+  int qtdNeuroniosSaida = pm->camadas[pm->qtdCamadas - 1]->qtdNeuronios;
 
-    /* Calculando o tempo de treinamento. */
-    float segs =  (horaDepoisTreinamento.tv_sec +
-		   horaDepoisTreinamento.tv_usec / 1000000.0) -
-                  (horaAntesTreinamento.tv_sec +
-                   horaAntesTreinamento.tv_usec / 1000000.0);
+  cudaMalloc((void **) &contexto->d_loteAtivacaoA, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_loteAtivacaoB, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_loteEntrada, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * pm->qtdNeuroniosEntrada);
+  cudaMalloc((void **) &contexto->d_loteSaida, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * qtdNeuroniosSaida);
+}
 
-    /* Adicionando as informações desta época no histórico de
-    treinamento. */
-    if (gerarHistorico)
+void PerceptronMulticamadas_predizerLoteEspacado(PerceptronMulticamadas * pm,
+                                                 ContextoExecucao * contexto,
+                                                 const float * d_entradas,
+                                                 int passoEntrada,
+                                                 int qtdAmostras,
+                                                 float * d_saidas,
+                                                 int passoSaida)
+{
+  __alocarMatrizesLoteContexto(pm, contexto);
+
+  /* Processando as amostras em lotes de no máximo TAM_MAX_LOTE_INFERENCIA
+     amostras (limitando a memória das matrizes de ativação). */
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
     {
-      HistoricoTreinamento_adicionarInfoEpoca(historicoTreinamento,
-					      segs,
-					      h_erroGlobal);
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    /* A primeira camada lê diretamente as amostras de entrada e a última
+       escreve diretamente na matriz de saída (ambas em fp32), as demais
+       alternam entre as matrizes de ativação do contexto, armazenando as
+       ativações no formato dos pesos da camada que as produziu. */
+    const void * d_entradaCamada = &d_entradas[(long) inicio * passoEntrada];
+    int formatoEntradaCamada = FormatoFP32;
+    int qtdNeuroniosEntradaCamada = pm->qtdNeuroniosEntrada;
+    int passoEntradaCamada = passoEntrada;
+
+    for (int c = 0; c < pm->qtdCamadas; c++)
+    {
+      void * d_saidaCamada;
+      int formatoSaidaCamada;
+      int passoSaidaCamada;
+      if (c == pm->qtdCamadas - 1)
+      {
+        d_saidaCamada = &d_saidas[(long) inicio * passoSaida];
+        formatoSaidaCamada = FormatoFP32;
+        passoSaidaCamada = passoSaida;
+      }
+      else
+      {
+        d_saidaCamada = (c % 2 == 0) ? contexto->d_loteAtivacaoA :
+                                       contexto->d_loteAtivacaoB;
+        formatoSaidaCamada = pm->camadas[c]->formatoPesos;
+        passoSaidaCamada = pm->camadas[c]->qtdNeuronios;
+      }
+
+      Camada_calcularAtivacaoNeuroniosLoteFormato(*pm->camadas[c],
+                                                  d_entradaCamada,
+                                                  formatoEntradaCamada,
+                                                  qtdNeuroniosEntradaCamada,
+                                                  passoEntradaCamada,
+                                                  d_saidaCamada,
+                                                  formatoSaidaCamada,
+                                                  passoSaidaCamada,
+                                                  qtdAmostrasLote);
+
+      d_entradaCamada = d_saidaCamada;
+      formatoEntradaCamada = formatoSaidaCamada;
+      qtdNeuroniosEntradaCamada = pm->camadas[c]->qtdNeuronios;
+      passoEntradaCamada = passoSaidaCamada;
+    }
+  }
+}
+
+void PerceptronMulticamadas_predizerLote(PerceptronMulticamadas * pm,
+                                         ContextoExecucao * contexto,
+                                         const float * d_entradas,
+                                         int qtdAmostras,
+                                         float * d_saidas)
+{
+  /* As amostras e as saídas estão contíguas. */
+  PerceptronMulticamadas_predizerLoteEspacado
+    (pm, contexto, d_entradas, pm->qtdNeuroniosEntrada, qtdAmostras,
+     d_saidas, pm->camadas[pm->qtdCamadas - 1]->qtdNeuronios);
+}
+
+bool PerceptronMulticamadas_registrarMemoria(void * h_memoria,
+                                             size_t qtdBytes)
+{
+  return cudaHostRegister(h_memoria, qtdBytes, cudaHostRegisterMapped |
+                          cudaHostRegisterPortable) == cudaSuccess;
+}
+
+void PerceptronMulticamadas_desregistrarMemoria(void * h_memoria)
+{
+  cudaHostUnregister(h_memoria);
+}
+
+bool PerceptronMulticamadas_predizerSemCopia(PerceptronMulticamadas * pm,
+                                             ContextoExecucao * contexto,
+                                             const float * h_entradas,
+                                             int passoEntrada,
+                                             int qtdAmostras,
+                                             float * h_saidas,
+                                             int passoSaida)
+{
+  /* Obtendo os endereços das regiões do chamador no espaço de
+     endereçamento do dispositivo acelerador (as mesmas não são
+     copiadas, os "kernels" acessam as mesmas pelo barramento). */
+  float * d_entradas;
+  float * d_saidas;
+
+  if (cudaHostGetDevicePointer((void **) &d_entradas, (void *) h_entradas,
+                               0) != cudaSuccess ||
+      cudaHostGetDevicePointer((void **) &d_saidas, h_saidas, 0) !=
+      cudaSuccess)
+  {
+    return false; // Regiões não registradas.
+  }
+
+  PerceptronMulticamadas_predizerLoteEspacado(pm, contexto, d_entradas,
+                                              passoEntrada, qtdAmostras,
+                                              d_saidas, passoSaida);
+
+  /* Aguardando a escrita das saídas na memória do chamador. */
+  cudaDeviceSynchronize();
+
+  return true;
+}
+
+void PerceptronMulticamadas_predizer(PerceptronMulticamadas * pm,
+                                     ContextoExecucao * contexto,
+                                     const float * h_entradas,
+                                     int qtdAmostras,
+                                     float * h_saidas)
+{
+  /* Uma única amostra: utilizando a inferência de baixa latência. */
+  if (qtdAmostras == 1)
+  {
+    PerceptronMulticamadas_predizerAmostra(pm, contexto, h_entradas,
+                                           h_saidas);
+    return;
+  }
+
+  __alocarMatrizesLoteContexto(pm, contexto);
+
+  int qtdNeuroniosSaida = pm->camadas[pm->qtdCamadas - 1]->qtdNeuronios;
+
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
+    {
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    /* Copiando o lote de amostras para o dispositivo acelerador,
+       calculando as saídas e copiando as mesmas de volta. */
+    cudaMemcpy(contexto->d_loteEntrada,
+               &h_entradas[(long) inicio * pm->qtdNeuroniosEntrada],
+               sizeof(float) * qtdAmostrasLote * pm->qtdNeuroniosEntrada,
+               cudaMemcpyHostToDevice);
+
+    PerceptronMulticamadas_predizerLote(pm, contexto, contexto->d_loteEntrada,
+                                        qtdAmostrasLote, contexto->d_loteSaida);
+
+    cudaMemcpy(&h_saidas[(long) inicio * qtdNeuroniosSaida],
+               contexto->d_loteSaida,
+               sizeof(float) * qtdAmostrasLote * qtdNeuroniosSaida,
+               cudaMemcpyDeviceToHost);
+  }
+}
+
+/**
+ * Método que reenvia ao dispositivo acelerador as tabelas de pesos, formatos
+ * e bias da inferência de baixa latência caso algum vetor das camadas tenha
+ * sido realocado ou convertido desde o último envio (sem alocações).
+ */
+static void __atualizarTabelasLatencia(const PerceptronMulticamadas * pm,
+                                       ContextoExecucao * contexto)
+{
+  bool alterada = false;
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+
+    alterada = alterada
+               || contexto->h_latenciaTabelaW[c] != camada->d_W
+               || contexto->h_latenciaTabelaWreduzido[c] != camada->d_Wreduzido
+               || contexto->h_latenciaTabelaFormatoPesos[c] !=
+                  camada->formatoPesos
+               || contexto->h_latenciaTabelaBias[c] != camada->d_bias;
+
+    contexto->h_latenciaTabelaW[c] = camada->d_W;
+    contexto->h_latenciaTabelaWreduzido[c] = camada->d_Wreduzido;
+    contexto->h_latenciaTabelaFormatoPesos[c] = camada->formatoPesos;
+    contexto->h_latenciaTabelaBias[c] = camada->d_bias;
+  }
+
+  if (!alterada)
+  {
+    return;
+  }
+
+  cudaMemcpy(contexto->d_latenciaTabelaW, contexto->h_latenciaTabelaW,
+             sizeof(float *) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaWreduzido,
+             contexto->h_latenciaTabelaWreduzido,
+             sizeof(uint16_t *) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaFormatoPesos,
+             contexto->h_latenciaTabelaFormatoPesos,
+             sizeof(int) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaBias, contexto->h_latenciaTabelaBias,
+             sizeof(float *) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+}
+
+void PerceptronMulticamadas_prepararLatencia(const PerceptronMulticamadas * pm,
+                                             ContextoExecucao * contexto)
+{
+  if (contexto->d_latenciaTabelaW != NULL)
+  {
+    __atualizarTabelasLatencia(pm, contexto);
+    return;
+  }
+
+  /* Montando no hospedeiro as tabelas com os atributos das camadas (as
+     tabelas de pesos, formatos e bias são mantidas no contexto). */
+  contexto->h_latenciaTabelaW = malloc(sizeof(float *) * pm->qtdCamadas);
+  contexto->h_latenciaTabelaWreduzido = malloc(sizeof(uint16_t *) *
+                                               pm->qtdCamadas);
+  contexto->h_latenciaTabelaFormatoPesos = malloc(sizeof(int) *
+                                                  pm->qtdCamadas);
+  contexto->h_latenciaTabelaBias = malloc(sizeof(float *) * pm->qtdCamadas);
+  float ** h_tabelaW = contexto->h_latenciaTabelaW;
+  uint16_t ** h_tabelaWreduzido = contexto->h_latenciaTabelaWreduzido;
+  int * h_tabelaFormatoPesos = contexto->h_latenciaTabelaFormatoPesos;
+  float ** h_tabelaBias = contexto->h_latenciaTabelaBias;
+  int * h_tabelaQtdNeuronios = malloc(sizeof(int) * pm->qtdCamadas);
+  int * h_tabelaFuncaoAtivacao = malloc(sizeof(int) * pm->qtdCamadas);
+  int maiorCamada = 0;
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    h_tabelaW[c] = pm->camadas[c]->d_W;
+    h_tabelaWreduzido[c] = pm->camadas[c]->d_Wreduzido;
+    h_tabelaFormatoPesos[c] = pm->camadas[c]->formatoPesos;
+    h_tabelaBias[c] = pm->camadas[c]->d_bias;
+    h_tabelaQtdNeuronios[c] = pm->camadas[c]->qtdNeuronios;
+    h_tabelaFuncaoAtivacao[c] = pm->camadas[c]->funcaoAtivacao;
+
+    if (pm->camadas[c]->qtdNeuronios > maiorCamada)
+    {
+      maiorCamada = pm->camadas[c]->qtdNeuronios;
+    }
+  }
+
+  /* Copiando as tabelas para o dispositivo acelerador. */
+  cudaMalloc((void **) &contexto->d_latenciaTabelaW,
+             sizeof(float *) * pm->qtdCamadas);
+  cudaMalloc((void **) &contexto->d_latenciaTabelaWreduzido,
+             sizeof(uint16_t *) * pm->qtdCamadas);
+  cudaMalloc((void **) &contexto->d_latenciaTabelaFormatoPesos,
+             sizeof(int) * pm->qtdCamadas);
+  cudaMalloc((void **) &contexto->d_latenciaTabelaBias,
+             sizeof(float *) * pm->qtdCamadas);
+  cudaMalloc((void **) &contexto->d_latenciaTabelaQtdNeuronios,
+             sizeof(int) * pm->qtdCamadas);
+  cudaMalloc((void **) &contexto->d_latenciaTabelaFuncaoAtivacao,
+             sizeof(int) * pm->qtdCamadas);
+  cudaMemcpy(contexto->d_latenciaTabelaW, h_tabelaW,
+             sizeof(float *) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaWreduzido, h_tabelaWreduzido,
+             sizeof(uint16_t *) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaFormatoPesos, h_tabelaFormatoPesos,
+             sizeof(int) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaBias, h_tabelaBias,
+             sizeof(float *) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaQtdNeuronios, h_tabelaQtdNeuronios,
+             sizeof(int) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+  cudaMemcpy(contexto->d_latenciaTabelaFuncaoAtivacao, h_tabelaFuncaoAtivacao,
+             sizeof(int) * pm->qtdCamadas, cudaMemcpyHostToDevice);
+
+  free(h_tabelaQtdNeuronios);
+  free(h_tabelaFuncaoAtivacao);
+
+  /* Alocando os vetores de ativação (o segundo também recebe a cópia da
+     amostra, lida da região mapeada uma única vez) e as regiões mapeadas do
+     hospedeiro para a amostra e a saída. */
+  int tamAtivacaoB = (pm->qtdNeuroniosEntrada > maiorCamada) ?
+                     pm->qtdNeuroniosEntrada : maiorCamada;
+  cudaMalloc((void **) &contexto->d_latenciaAtivacaoA,
+             sizeof(float) * maiorCamada);
+  cudaMalloc((void **) &contexto->d_latenciaAtivacaoB,
+             sizeof(float) * tamAtivacaoB);
+  cudaHostAlloc((void **) &contexto->h_latenciaEntrada,
+                sizeof(float) * pm->qtdNeuroniosEntrada, cudaHostAllocMapped);
+  cudaHostAlloc((void **) &contexto->h_latenciaSaida, sizeof(float) *
+                pm->camadas[pm->qtdCamadas - 1]->qtdNeuronios,
+                cudaHostAllocMapped);
+}
+
+void PerceptronMulticamadas_predizerAmostra(PerceptronMulticamadas * pm,
+                                            ContextoExecucao * contexto,
+                                            const float * h_amostra,
+                                            float * h_saida)
+{
+  PerceptronMulticamadas_prepararLatencia(pm, contexto);
+
+  /* Convertendo as estruturas para variáveis de tipos primitivos para que
+     o OpenACC não tente copiar os vetores para a memória do
+     dispositivo. */
+  float ** tabelaW = contexto->d_latenciaTabelaW;
+  uint16_t ** tabelaWreduzido = contexto->d_latenciaTabelaWreduzido;
+  int * tabelaFormatoPesos = contexto->d_latenciaTabelaFormatoPesos;
+  float ** tabelaBias = contexto->d_latenciaTabelaBias;
+  int * tabelaQtdNeuronios = contexto->d_latenciaTabelaQtdNeuronios;
+  int * tabelaFuncaoAtivacao = contexto->d_latenciaTabelaFuncaoAtivacao;
+  float * ativacaoA = contexto->d_latenciaAtivacaoA;
+  float * ativacaoB = contexto->d_latenciaAtivacaoB;
+  int qtdCamadas = pm->qtdCamadas;
+  int qtdNeuroniosEntrada = pm->qtdNeuroniosEntrada;
+  int qtdNeuroniosSaida = pm->camadas[qtdCamadas - 1]->qtdNeuronios;
+
+  /* Obtendo os endereços das regiões mapeadas no dispositivo e colocando a
+     amostra na região de entrada. */
+  float * d_entrada;
+  float * d_saida;
+  cudaHostGetDevicePointer((void **) &d_entrada, contexto->h_latenciaEntrada,
+                           0);
+  cudaHostGetDevicePointer((void **) &d_saida, contexto->h_latenciaSaida, 0);
+  memcpy(contexto->h_latenciaEntrada, h_amostra,
+         sizeof(float) * qtdNeuroniosEntrada);
+
+  /* Calculando todas as camadas em um único "kernel" com uma única "gang",
+     evitando o custo de disparar um "kernel" por camada. */
+  #pragma acc parallel num_gangs(1) vector_length(TAM_VECTOR_LATENCIA) \
+  deviceptr(tabelaW, tabelaWreduzido, tabelaFormatoPesos, tabelaBias, \
+            tabelaQtdNeuronios, tabelaFuncaoAtivacao, ativacaoA, ativacaoB, \
+            d_entrada, d_saida)
+  {
+    /* Copiando a amostra da região mapeada para o dispositivo uma única vez
+       (cada neurônio da primeira camada lê todos os itens da mesma). A
+       primeira camada escreve em "ativacaoA", portanto a cópia pode ficar
+       em "ativacaoB". */
+    #pragma acc loop vector
+    for (int i = 0; i < qtdNeuroniosEntrada; i++)
+    {
+      ativacaoB[i] = d_entrada[i];
+    }
+
+    #pragma acc loop seq
+    for (int c = 0; c < qtdCamadas; c++)
+    {
+      /* A primeira camada lê a cópia da amostra, a última escreve na saída
+         e as demais alternam entre os vetores de ativação. */
+      const float * entrada = (c % 2 == 1) ? ativacaoA : ativacaoB;
+      float * saida = (c == qtdCamadas - 1) ? d_saida :
+                      ((c % 2 == 0) ? ativacaoA : ativacaoB);
+      int qtdEntradas = (c == 0) ? qtdNeuroniosEntrada :
+                        tabelaQtdNeuronios[c - 1];
+      float * W = tabelaW[c];
+      uint16_t * Wreduzido = tabelaWreduzido[c];
+      int formatoPesos = tabelaFormatoPesos[c];
+      float * bias = tabelaBias[c];
+      int funcaoAtivacao = tabelaFuncaoAtivacao[c];
+
+      #pragma acc loop vector
+      for (int n = 0; n < tabelaQtdNeuronios[c]; n++)
+      {
+        long w = (long) qtdEntradas * n;
+        float valFuncIntegracao = 0.0;
+
+        #pragma acc loop seq reduction(+:valFuncIntegracao)
+        for (int i = 0; i < qtdEntradas; i++)
+        {
+          valFuncIntegracao += lerValorFormato(W, Wreduzido, formatoPesos,
+                                               w + i) * entrada[i];
+        }
+
+        saida[n] = aplicarFuncaoAtivacao(valFuncIntegracao + bias[n],
+                                         funcaoAtivacao);
+      }
+    }
+  }
+
+  /* A saída já foi escrita na região mapeada. */
+  memcpy(h_saida, contexto->h_latenciaSaida, sizeof(float) * qtdNeuroniosSaida);
+}
+
+float __treinarPadrao(PerceptronMulticamadas * pm,
+                      ContextoExecucao * contexto,
+                      const PadraoTreinamento * padrao,
+                      float taxaAprendizagem)
+{
+  int ultimaCamada = pm->qtdCamadas - 1;
+
+  /* Alimentando a rede com o padrão. */
+  PerceptronMulticamadas_feedfowardPadrao(pm, contexto, padrao);
+
+  /* Calculando o erro dos neurônios da última camada e já calculando
+     o erro global para o padrão apresentado à rede. */
+  Camada_calcularErroRpropNeuroniosUltimaCamada
+    (*pm->camadas[ultimaCamada], contexto->estados[ultimaCamada],
+     padrao->d_alvo, contexto->d_erroPadrao);
+
+  /* Copiando o erro do padrão armazenado no adaptador gráfico para o hospedeiro. */
+  float h_erroPadrao;
+  cudaMemcpy(&h_erroPadrao, contexto->d_erroPadrao, sizeof(float),
+             cudaMemcpyDeviceToHost);
+
+  /* Realizando a retropropagação do erro para as demais camadas. */
+  for (int c = pm->qtdCamadas - 2; c >= 0; c--)
+  {
+    Camada_calcularErroRpropNeuroniosCamada(*pm->camadas[c],
+                                            contexto->estados[c],
+                                            *pm->camadas[c + 1],
+                                            contexto->estados[c + 1]);
+  }
+
+  /* Contando a atualização de forma atômica (as threads "hogwild"
+     compartilham o contador) e calculando as correções dos momentos do
+     Adam com o passo obtido por esta thread. */
+  ParametrosOtimizador otimizador = pm->otimizador;
+  otimizador.passo = __atomic_add_fetch(&pm->otimizador.passo, 1,
+                                        __ATOMIC_RELAXED);
+  otimizador.correcaoPrimeiroMomento = 1 - powf(otimizador.beta1,
+                                                otimizador.passo);
+  otimizador.correcaoSegundoMomento = 1 - powf(otimizador.beta2,
+                                               otimizador.passo);
+
+  /* Atualizando os pesos dos neurônios da primeira camada de acordo com o
+     tipo da amostra (apenas a atualização com amostras brutas mantém a
+     soma dos pesos de cada neurônio do contexto). */
+  contexto->somaPesosValida = false;
+
+  switch (padrao->tipoAmostra)
+  {
+  case AmostraEsparsa:
+    /* Apenas os pesos das entradas não nulas. */
+    Camada_atualizarPesosPrimeiraCamadaEsparsa(*pm->camadas[0],
+                                               contexto->estados[0],
+                                               padrao->d_indices,
+                                               padrao->d_amostra,
+                                               padrao->qtdNaoNulos,
+                                               pm->qtdNeuroniosEntrada,
+                                               taxaAprendizagem,
+                                               otimizador);
+    break;
+  case AmostraUint8:
+  case AmostraUint16:
+  case AmostraFP16:
+    Camada_atualizarPesosPrimeiraCamadaBruta(*pm->camadas[0],
+                                             contexto->estados[0],
+                                             padrao->d_amostraBruta,
+                                             padrao->tipoAmostra,
+                                             padrao->escalaAmostra,
+                                             padrao->deslocamentoAmostra,
+                                             padrao->d_escalasAmostra,
+                                             padrao->d_deslocamentosAmostra,
+                                             pm->qtdNeuroniosEntrada,
+                                             taxaAprendizagem,
+                                             otimizador,
+                                             contexto->d_somaPesosPrimeiraCamada);
+    contexto->somaPesosValida = true;
+    break;
+  case AmostraCategorica:
+    /* Atualizando as linhas da tabela selecionadas pela amostra (com os
+       pesos da primeira camada ainda não atualizados) e depois os pesos
+       da primeira camada com a entrada montada. */
+    CamadaEmbedding_atualizarLinhas(*pm->embedding, *pm->camadas[0],
+                                    contexto->estados[0], padrao->d_indices,
+                                    pm->qtdNeuroniosEntrada,
+                                    taxaAprendizagem, otimizador);
+
+    Camada_atualizarPesosNeuroniosPrimeiraCamada(*pm->camadas[0],
+                                                 contexto->estados[0],
+                                                 contexto->d_entradaEmbedding,
+                                                 pm->qtdNeuroniosEntrada,
+                                                 taxaAprendizagem,
+                                                 otimizador);
+    break;
+  default:
+    Camada_atualizarPesosNeuroniosPrimeiraCamada(*pm->camadas[0],
+                                                 contexto->estados[0],
+                                                 padrao->d_amostra,
+                                                 pm->qtdNeuroniosEntrada,
+                                                 taxaAprendizagem,
+                                                 otimizador);
+  }
+
+  /* Atualizando os pesos dos neurônios das demais camadas. */
+  for (int c = 1; c < pm->qtdCamadas; c++)
+  {
+    Camada_atualizarPesosNeuroniosCamada(*pm->camadas[c - 1],
+                                         contexto->estados[c - 1],
+                                         *pm->camadas[c],
+                                         contexto->estados[c],
+                                         taxaAprendizagem,
+                                         otimizador);
+  }
+
+  return h_erroPadrao;
+}
+
+HistoricoTreinamento *
+PerceptronMulticamadas_backpropagation(PerceptronMulticamadas * pm,
+				       PadraoTreinamento * padroes,
+				       int qtdPadroesTreinamento,
+				       float taxaAprendizagem,
+				       float erroDesejado,
+				       bool gerarHistorico)
+{
+  return PerceptronMulticamadas_backpropagationCheckpoint(pm, padroes,
+                                                          qtdPadroesTreinamento,
+                                                          taxaAprendizagem,
+                                                          erroDesejado,
+                                                          gerarHistorico,
+                                                          NULL);
+}
+
+HistoricoTreinamento *
+PerceptronMulticamadas_backpropagationCheckpoint(PerceptronMulticamadas * pm,
+                                                 PadraoTreinamento * padroes,
+                                                 int qtdPadroesTreinamento,
+                                                 float taxaAprendizagem,
+                                                 float erroDesejado,
+                                                 bool gerarHistorico,
+                                                 const ConfigCheckpoint *
+                                                 config)
+{
+  /* Inicializando a estrutura. */
+  HistoricoTreinamento * historicoTreinamento = NULL;
+  if (gerarHistorico)
+  {
+    historicoTreinamento = HistoricoTreinamento_inicializar(pm,
+							    taxaAprendizagem,
+							    erroDesejado);
+  }
+  
+  /* Variável que irá armazenar o erro global calculado para cada iteração.
+     A mesma será populada após a execução de uma iteração, onde será copiado
+     o erro global que está na memória do dispositivo acelerador para o
+     hospedeiro. */
+  float h_erroGlobal;
+
+  /* Alocando o contexto de execução (ativações, derivadas e erros dos
+     neurônios) utilizado durante o treinamento. */
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+  /* Ordem em que os padrões são apresentados à rede (gerada a cada
+     época). */
+  int * ordemPadroes = malloc(sizeof(int) * qtdPadroesTreinamento);
+
+  /* O treinamento irá ocorrer enquanto o erro da rede estiver acima
+     do desejado OU a quantidade de épocas não tenha atingido o limite. */
+  int epocas = 0;
+
+  /* Retomando o treinamento do último "checkpoint" (caso exista) e
+     iniciando a thread que irá escrever os próximos. */
+  CheckpointTreinamento * checkpoint = NULL;
+  if (config != NULL)
+  {
+    if (config->retomar
+        && CheckpointTreinamento_retomar(config->nomeArquivo, pm, &epocas,
+                                         historicoTreinamento)
+        && INFO_ESTATISTICAS)
+    {
+      printf("Treinamento retomado a partir da época %d.\n\n", epocas);
+    }
+
+    checkpoint = CheckpointTreinamento_iniciar(pm, config, epocas);
+  }
+
+  do
+  {
+    /* Inicializando com 0 o erro global no para
+       a época atual. */
+    h_erroGlobal = 0;
+
+    /* Variáveis que serão utilizadas para armazenar a hora que foi iniciada
+       e finalizada o treinamento da rede para a época atual. */
+    struct timeval horaAntesTreinamento;
+    struct timeval horaDepoisTreinamento;
+
+    /* Coletando a hora antes do treinamento. */
+    gettimeofday(&horaAntesTreinamento, NULL);
+
+    /* Embaralhando a ordem dos padrões para esta época. */
+    ConfigEmbaralhamento_ordenarEpoca(&pm->embaralhamento, ordemPadroes,
+                                      qtdPadroesTreinamento, epocas);
+
+    /* Apresentando os padrões de treinamento para rede e realizando o
+       treinamento da mesma. */
+    for (int i = 0; i < qtdPadroesTreinamento; i++)
+    {
+      /* Somando o erro calculado para o padrão no erro global. */
+      h_erroGlobal += __treinarPadrao(pm, contexto,
+                                      &padroes[ordemPadroes[i]],
+                                      taxaAprendizagem);
+    }
+
+    /* Coletando a hora depois do treinamento. */
+    gettimeofday(&horaDepoisTreinamento, NULL);
+
+    /* Realizando o cálculo do MSE. */
+    h_erroGlobal = h_erroGlobal/ qtdPadroesTreinamento;
+
+    /* Atualizando a quantidade de épocas. */
+    epocas++;
+
+    /* Calculando o tempo de treinamento. */
+    float segs =  (horaDepoisTreinamento.tv_sec +
+		   horaDepoisTreinamento.tv_usec / 1000000.0) -
+                  (horaAntesTreinamento.tv_sec +
+                   horaAntesTreinamento.tv_usec / 1000000.0);
+
+    /* Adicionando as informações desta época no histórico de
+    treinamento. */
+    if (gerarHistorico)
+    {
+      HistoricoTreinamento_adicionarInfoEpoca(historicoTreinamento,
+					      segs,
+					      h_erroGlobal);
     }
  
     
      /* Mostrando a época e o erro MSE para a mesma (caso tenha que ser feito). */
     if (INFO_ESTATISTICAS)
     {
-      printf("Época: %d\nErro MSE: %.4f\n", epocas, h_erroGlobal);
-      printf("Tempo total de execução da época: %.2f segundo(s)\n\n", segs);
+      printf("Época: %d\nErro MSE: %.4f\n", epocas, h_erroGlobal);
+      printf("Tempo total de execução da época: %.2f segundo(s)\n\n", segs);
+    }
+
+    /* Capturando o estado do treinamento caso o intervalo entre os
+       "checkpoints" tenha sido atingido (a escrita é feita em segundo
+       plano). */
+    if (checkpoint != NULL)
+    {
+      CheckpointTreinamento_verificar(checkpoint, epocas,
+                                      historicoTreinamento);
+    }
+    
+  } while (h_erroGlobal > erroDesejado && epocas < QTD_MAX_EPOCAS);
+
+  /* Salvando o estado final do treinamento e aguardando a escrita do
+     mesmo. */
+  if (checkpoint != NULL)
+  {
+    if (checkpoint->epocaUltimaCaptura != epocas)
+    {
+      CheckpointTreinamento_capturar(checkpoint, epocas, historicoTreinamento);
+    }
+    CheckpointTreinamento_encerrar(checkpoint);
+  }
+
+  /* Desalocando as variáveis que estão no dispositivo acelerador 
+     que não serão mais necessárias. */
+  ContextoExecucao_desalocar(contexto);
+  free(ordemPadroes);
+  
+  return historicoTreinamento;
+}
+
+/**
+ * Estrutura com os argumentos de cada thread do modo "Hogwild".
+ */
+typedef struct
+{
+  PerceptronMulticamadas * pm;
+  ContextoExecucao * contexto;
+  PadraoTreinamento * padroes;
+  const int * ordemPadroes;
+  int inicio;
+  int fim;
+  float taxaAprendizagem;
+  float erroAcumulado;
+} ArgsThreadHogwild;
+
+static void * __executarThreadHogwild(void * args)
+{
+  ArgsThreadHogwild * argsThread = (ArgsThreadHogwild *) args;
+
+  /* Apresentando a faixa de padrões desta thread à rede. */
+  argsThread->erroAcumulado = 0;
+  for (int i = argsThread->inicio; i < argsThread->fim; i++)
+  {
+    int p = (argsThread->ordemPadroes != NULL) ?
+            argsThread->ordemPadroes[i] : i;
+
+    argsThread->erroAcumulado += __treinarPadrao(argsThread->pm,
+                                                 argsThread->contexto,
+                                                 &argsThread->padroes[p],
+                                                 argsThread->taxaAprendizagem);
+  }
+
+  return NULL;
+}
+
+float PerceptronMulticamadas_treinarEpocaHogwild(PerceptronMulticamadas * pm,
+                                                 ContextoExecucao ** contextos,
+                                                 PadraoTreinamento * padroes,
+                                                 const int * ordemPadroes,
+                                                 int qtdPadroesTreinamento,
+                                                 float taxaAprendizagem,
+                                                 int qtdThreads)
+{
+  pthread_t * threads = malloc(sizeof(pthread_t) * qtdThreads);
+  ArgsThreadHogwild * argsThreads = malloc(sizeof(ArgsThreadHogwild) *
+                                           qtdThreads);
+
+  /* Dividindo a ordem dos padrões em faixas disjuntas (uma por thread) e
+     disparando as threads. As somas dos pesos mantidas pelos contextos são
+     descartadas, pois os pesos podem ter sido modificados pelas demais
+     threads (ou pelo chamador) desde a época anterior. */
+  for (int t = 0; t < qtdThreads; t++)
+  {
+    ContextoExecucao_invalidarSomaPesos(contextos[t]);
+
+    argsThreads[t].pm = pm;
+    argsThreads[t].contexto = contextos[t];
+    argsThreads[t].padroes = padroes;
+    argsThreads[t].ordemPadroes = ordemPadroes;
+    argsThreads[t].inicio = (int) ((long) qtdPadroesTreinamento * t /
+                                   qtdThreads);
+    argsThreads[t].fim = (int) ((long) qtdPadroesTreinamento * (t + 1) /
+                                qtdThreads);
+    argsThreads[t].taxaAprendizagem = taxaAprendizagem;
+
+    pthread_create(&threads[t], NULL, __executarThreadHogwild,
+                   &argsThreads[t]);
+  }
+
+  /* Aguardando as threads e somando os erros calculados por cada uma. */
+  float erroGlobal = 0;
+  for (int t = 0; t < qtdThreads; t++)
+  {
+    pthread_join(threads[t], NULL);
+    erroGlobal += argsThreads[t].erroAcumulado;
+  }
+
+  free(threads);
+  free(argsThreads);
+
+  /* Retornando o erro MSE. */
+  return erroGlobal / qtdPadroesTreinamento;
+}
+
+HistoricoTreinamento *
+PerceptronMulticamadas_backpropagationHogwild(PerceptronMulticamadas * pm,
+                                              PadraoTreinamento * padroes,
+                                              int qtdPadroesTreinamento,
+                                              float taxaAprendizagem,
+                                              float erroDesejado,
+                                              int qtdThreads,
+                                              bool gerarHistorico)
+{
+  /* Inicializando a estrutura. */
+  HistoricoTreinamento * historicoTreinamento = NULL;
+  if (gerarHistorico)
+  {
+    historicoTreinamento = HistoricoTreinamento_inicializar(pm,
+                                                            taxaAprendizagem,
+                                                            erroDesejado);
+  }
+
+  /* Criando um contexto de execução para cada thread (os pesos e os bias
+     são compartilhados entre as mesmas). */
+  ContextoExecucao ** contextos = malloc(sizeof(ContextoExecucao *) *
+                                         qtdThreads);
+  for (int t = 0; t < qtdThreads; t++)
+  {
+    contextos[t] = ContextoExecucao_inicializar(pm);
+  }
+
+  /* Ordem em que os padrões são apresentados à rede (gerada a cada época
+     com a configuração de embaralhamento da rede e dividida entre as
+     threads). */
+  int * ordemPadroes = malloc(sizeof(int) * qtdPadroesTreinamento);
+
+  float h_erroGlobal;
+  int epocas = 0;
+
+  do
+  {
+    /* Coletando a hora antes e depois do treinamento da época. */
+    struct timeval horaAntesTreinamento;
+    struct timeval horaDepoisTreinamento;
+
+    gettimeofday(&horaAntesTreinamento, NULL);
+    ConfigEmbaralhamento_ordenarEpoca(&pm->embaralhamento, ordemPadroes,
+                                      qtdPadroesTreinamento, epocas);
+    h_erroGlobal = PerceptronMulticamadas_treinarEpocaHogwild(pm, contextos,
+                                                              padroes,
+                                                              ordemPadroes,
+                                                              qtdPadroesTreinamento,
+                                                              taxaAprendizagem,
+                                                              qtdThreads);
+    gettimeofday(&horaDepoisTreinamento, NULL);
+
+    /* Atualizando a quantidade de épocas. */
+    epocas++;
+
+    /* Calculando o tempo de treinamento. */
+    float segs =  (horaDepoisTreinamento.tv_sec +
+                   horaDepoisTreinamento.tv_usec / 1000000.0) -
+                  (horaAntesTreinamento.tv_sec +
+                   horaAntesTreinamento.tv_usec / 1000000.0);
+
+    /* Adicionando as informações desta época no histórico de
+    treinamento. */
+    if (gerarHistorico)
+    {
+      HistoricoTreinamento_adicionarInfoEpoca(historicoTreinamento,
+                                              segs,
+                                              h_erroGlobal);
+    }
+
+    /* Mostrando a época, o erro MSE e a vazão de amostras para a mesma
+       (caso tenha que ser feito). */
+    if (INFO_ESTATISTICAS)
+    {
+      printf("Época: %d\nErro MSE: %.4f\n", epocas, h_erroGlobal);
+      printf("Tempo total de execução da época: %.2f segundo(s)\n", segs);
+      printf("Amostras por segundo (%d thread(s)): %.0f\n\n", qtdThreads,
+             qtdPadroesTreinamento / segs);
+    }
+
+  } while (h_erroGlobal > erroDesejado && epocas < QTD_MAX_EPOCAS);
+
+  /* Desalocando os contextos das threads. */
+  for (int t = 0; t < qtdThreads; t++)
+  {
+    ContextoExecucao_desalocar(contextos[t]);
+  }
+  free(contextos);
+  free(ordemPadroes);
+
+  return historicoTreinamento;
+}
+
+void embaralhamentoFisherYates(int * v, int n, GeradorAleatorio * gerador)
+{
+  /* Percorrendo o vetor do fim para o
+  início. */
+  for (int i = n - 1; i > 0; i--)
+  {
+    /* Gerando o índice para permutação
+    entre o número "i-ésimo" e algum
+    número entre 0 e i (inclusive). */
+    int indicePerm = GeradorAleatorio_inteiro(gerador, i + 1);
+
+    /* Realizando a troca. */
+    int auxTroca = v[i];
+    v[i] = v[indicePerm];
+    v[indicePerm] = auxTroca;
+  }
+}
+
+void embaralhamentoBlocos(int * v, int n, int tamBloco,
+                          GeradorAleatorio * gerador)
+{
+  /* Embaralhando a ordem dos blocos. */
+  int qtdBlocos = (n + tamBloco - 1) / tamBloco;
+  int * ordemBlocos = malloc(sizeof(int) * qtdBlocos);
+
+  for (int b = 0; b < qtdBlocos; b++)
+  {
+    ordemBlocos[b] = b;
+  }
+  embaralhamentoFisherYates(ordemBlocos, qtdBlocos, gerador);
+
+  /* Copiando os blocos na nova ordem e embaralhando os itens de cada um
+     deles. */
+  int * auxiliar = malloc(sizeof(int) * n);
+  int k = 0;
+
+  for (int b = 0; b < qtdBlocos; b++)
+  {
+    int inicio = ordemBlocos[b] * tamBloco;
+    int tam = (inicio + tamBloco <= n) ? tamBloco : n - inicio;
+
+    memcpy(auxiliar + k, v + inicio, sizeof(int) * tam);
+    embaralhamentoFisherYates(auxiliar + k, tam, gerador);
+    k += tam;
+  }
+
+  memcpy(v, auxiliar, sizeof(int) * n);
+
+  free(auxiliar);
+  free(ordemBlocos);
+}
+
+void ConfigEmbaralhamento_ordenarEpoca(const ConfigEmbaralhamento * config,
+                                       int * ordem,
+                                       int qtdPadroes,
+                                       int epoca)
+{
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    ordem[i] = i;
+  }
+
+  /* O gerador de cada época é inicializado com a semente e o número da
+     época (a ordem não depende das épocas anteriores). */
+  GeradorAleatorio gerador;
+  GeradorAleatorio_inicializar(&gerador,
+                               GeradorAleatorio_contador(config->semente,
+                                                         epoca));
+
+  switch (config->modo)
+  {
+  case EmbaralhamentoCompleto:
+    embaralhamentoFisherYates(ordem, qtdPadroes, &gerador);
+    break;
+  case EmbaralhamentoBlocos:
+    embaralhamentoBlocos(ordem, qtdPadroes, config->tamBloco, &gerador);
+    break;
+  }
+}
+
+void normalizacaoMinMax(float * v, int n, float min, float max)
+{
+  /* Percorrendo todos os itens do vetor e realizando a normalização
+  dos mesmos. */
+  for (int i = 0; i < n; i++)
+  {
+    v[i] = (v[i] - min) / (max - min);
+  }
+}
+
+int hashAtributo(const char * atributo, size_t tamanho, int qtdItensAmostra,
+                 float * sinal)
+{
+  /* Hash FNV-1a de 64 bits. */
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < tamanho; i++)
+  {
+    hash ^= (unsigned char) atributo[i];
+    hash *= 1099511628211ULL;
+  }
+
+  /* Misturando os bits (finalizador do MurmurHash3), pois os bits mais
+     significativos do FNV-1a variam pouco entre atributos parecidos. */
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ULL;
+  hash ^= hash >> 33;
+
+  /* O bit mais significativo define o sinal e os demais o índice. */
+  *sinal = (hash >> 63) ? -1 : 1;
+  return (int) ((hash & 0x7FFFFFFFFFFFFFFFULL) % (uint64_t) qtdItensAmostra);
+}
+
+#pragma acc routine seq
+float aplicarFuncaoAtivacao(float z, int funcaoAtivacao)
+{
+  switch (funcaoAtivacao)
+  {
+  case Degrau:
+    return funcaoDegrau(z);
+  case Sigmoide:
+    return funcaoSigmoide(z);
+  case TangHiperbolica:
+    return funcaoTangHiperbolica(z);
+  default:
+    return z;
+  }
+}
+
+#pragma acc routine seq
+inline float funcaoDegrau(float z)
+{
+  return (z >= 0) ? 1 : 0;
+}
+
+#pragma acc routine seq
+float derivadaFuncaoDegrau(float valDegrau)
+{
+  return 1.0;
+}
+
+#pragma acc routine seq
+inline float funcaoSigmoide(float z)
+{
+  return 1.0 / ((1.0) + expf(-z));
+}
+
+#pragma acc routine seq
+inline float derivadaFuncaoSigmoide(float valSigmoide)
+{
+  return valSigmoide * (1.0 - valSigmoide);
+}
+
+#pragma acc routine seq
+inline float funcaoTangHiperbolica(float z)
+{
+  return tanhf(z);
+}
+
+#pragma acc routine seq
+inline float derivadaFuncaoTangHiperbolica(float valTangHiperbolica)
+{
+  return 1 - (valTangHiperbolica * valTangHiperbolica);
+}
+
+/**
+ * União utilizada para acessar os bits de um float.
+ */
+typedef union
+{
+  float valor;
+  uint32_t bits;
+} BitsFloat;
+
+#pragma acc routine seq
+uint16_t converterFloatBF16(float valor)
+{
+  BitsFloat f;
+  f.valor = valor;
+
+  /* NaN: mantendo o sinal e forçando um bit da mantissa (o truncamento
+     poderia zerar a mesma e gerar infinito). */
+  if ((f.bits & 0x7FFFFFFF) > 0x7F800000)
+  {
+    return (uint16_t) ((f.bits >> 16) | 0x0040);
+  }
+
+  /* Arredondando para o mais próximo (empates para o par) os 16 bits
+     descartados. */
+  uint32_t arredondamento = 0x7FFF + ((f.bits >> 16) & 1);
+  return (uint16_t) ((f.bits + arredondamento) >> 16);
+}
+
+#pragma acc routine seq
+float converterBF16Float(uint16_t valor)
+{
+  BitsFloat f;
+  f.bits = (uint32_t) valor << 16;
+  return f.valor;
+}
+
+#pragma acc routine seq
+uint16_t converterFloatFP16(float valor)
+{
+  BitsFloat f;
+  f.valor = valor;
+
+  uint16_t sinal = (uint16_t) ((f.bits >> 16) & 0x8000);
+  uint32_t x = f.bits & 0x7FFFFFFF;
+
+  /* Infinito e NaN. */
+  if (x >= 0x7F800000)
+  {
+    return sinal | ((x > 0x7F800000) ? 0x7E00 : 0x7C00);
+  }
+
+  /* Valores que arredondam para além do maior fp16 (65504). */
+  if (x >= 0x477FF000)
+  {
+    return sinal | 0x7C00;
+  }
+
+  /* Valores menores que a metade do menor subnormal (2^-25). */
+  if (x <= 0x33000000)
+  {
+    return sinal;
+  }
+
+  /* Subnormais do fp16 (menores que 2^-14): deslocando a mantissa (com o
+     bit implícito) e arredondando os bits descartados. */
+  if (x < 0x38800000)
+  {
+    uint32_t mantissa = (x & 0x007FFFFF) | 0x00800000;
+    int deslocamento = 126 - (int) (x >> 23);
+    uint32_t h = mantissa >> deslocamento;
+    uint32_t resto = mantissa & ((1u << deslocamento) - 1);
+    uint32_t metade = 1u << (deslocamento - 1);
+
+    if (resto > metade || (resto == metade && (h & 1)))
+    {
+      h++;
+    }
+
+    return sinal | (uint16_t) h;
+  }
+
+  /* Normais: ajustando o expoente (127 -> 15) e arredondando os 13 bits
+     descartados da mantissa (o transbordo da mantissa incrementa o
+     expoente corretamente). */
+  uint32_t h = (x - 0x38000000) >> 13;
+  uint32_t resto = x & 0x1FFF;
+
+  if (resto > 0x1000 || (resto == 0x1000 && (h & 1)))
+  {
+    h++;
+  }
+
+  return sinal | (uint16_t) h;
+}
+
+#pragma acc routine seq
+float converterFP16Float(uint16_t valor)
+{
+  uint32_t sinal = (uint32_t) (valor & 0x8000) << 16;
+  uint32_t expoente = (valor >> 10) & 0x1F;
+  uint32_t mantissa = valor & 0x03FF;
+  BitsFloat f;
+
+  if (expoente == 0x1F)
+  {
+    /* Infinito e NaN. */
+    f.bits = sinal | 0x7F800000 | (mantissa << 13);
+  }
+  else if (expoente != 0)
+  {
+    /* Normais. */
+    f.bits = sinal | ((expoente + 112) << 23) | (mantissa << 13);
+  }
+  else if (mantissa == 0)
+  {
+    /* Zero. */
+    f.bits = sinal;
+  }
+  else
+  {
+    /* Subnormais do fp16 são normais no fp32: normalizando a mantissa. */
+    expoente = 113;
+    while ((mantissa & 0x0400) == 0)
+    {
+      mantissa <<= 1;
+      expoente--;
+    }
+
+    f.bits = sinal | (expoente << 23) | ((mantissa & 0x03FF) << 13);
+  }
+
+  return f.valor;
+}
+
+#pragma acc routine seq
+float lerValorFormato(const float * vFP32, const uint16_t * vReduzido,
+                      int formato, long i)
+{
+  switch (formato)
+  {
+  case FormatoBF16:
+    return converterBF16Float(vReduzido[i]);
+  case FormatoFP16:
+    return converterFP16Float(vReduzido[i]);
+  default:
+    return vFP32[i];
+  }
+}
+
+#pragma acc routine seq
+float lerItemAmostraBruta(const void * d_amostraBruta, int tipoAmostra,
+                          long i)
+{
+  switch (tipoAmostra)
+  {
+  case AmostraUint16:
+    return ((const uint16_t *) d_amostraBruta)[i];
+  case AmostraFP16:
+    return converterFP16Float(((const uint16_t *) d_amostraBruta)[i]);
+  default:
+    return ((const uint8_t *) d_amostraBruta)[i];
+  }
+}
+
+#pragma acc routine seq
+void escreverValorFormato(float * vFP32, uint16_t * vReduzido, int formato,
+                          long i, float valor)
+{
+  switch (formato)
+  {
+  case FormatoBF16:
+    vReduzido[i] = converterFloatBF16(valor);
+    break;
+  case FormatoFP16:
+    vReduzido[i] = converterFloatFP16(valor);
+    break;
+  default:
+    vFP32[i] = valor;
+  }
+}
+
+/**
+ * Método que lê os vetores de objetivo (um por linha, com os valores
+ * separados por ponto e vírgula) e insere os mesmos nos padrões.
+ */
+static void __carregarAlvosArquivo(FILE * arqAlvos,
+                                   PadraoTreinamento * padroes,
+                                   int qtdItensAlvo,
+                                   int qtdPadroes)
+{
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    /* Coletando a linha com o alvo do arquivo. */
+    char linhaAlvo[4096]; // 4 Kbytes
+    fscanf(arqAlvos, "%s", linhaAlvo);
+
+    /* Alocando o vetor para armazenar o vetor de objetivo "i-ésimo"
+       do hospedeiro. */
+    float * h_alvo = (float *) malloc(sizeof(float) * qtdItensAlvo);
+
+    /* Extraindo o primeiro item do vetor de objetivo. */
+    h_alvo[0] = atof(strtok(linhaAlvo, ";\n\0"));
+
+    /* Extraindo os demais itens do vetor de objetivo. */
+    for (int j = 1; j < qtdItensAlvo; j++)
+    {
+      /* Extraindo o item "j-ésimo" do vetor de objetivo. */
+      h_alvo[j] = atof(strtok(NULL, ";\n\0"));
+    }
+
+    /* Copiando o vetor objetivo para a memória do dispositivo 
+       acelerador. */
+    float * d_alvo;
+    cudaMalloc((void **) &d_alvo, sizeof(float) * qtdItensAlvo);
+    cudaMemcpy(d_alvo, h_alvo, sizeof(float) * qtdItensAlvo,
+	       cudaMemcpyHostToDevice);
+    
+    /* Por fim, colocando no padrão o vetor de objetivo extraido do
+       arquivo. */
+    padroes[i].d_alvo = d_alvo;
+
+    /* Desalocando os vetores do hospedeiro que já foram copiados
+       para o dispositivo acelerador. */
+    free(h_alvo);
+  }
+}
+
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesArquivo(char * nomeArquivoAmostras,
+                                         char * nomeArquivoAlvos,
+                                         float menorValAmostra,
+                                         float maiorValAmostra,
+                                         int qtdItensAmostra,
+                                         int qtdItensAlvo,
+                                         int qtdPadroes)
+{
+  /* Tentando abrir os arquivos para leitura. */
+  FILE * arqAmostras;
+  FILE * arqAlvos;
+
+  arqAmostras = fopen(nomeArquivoAmostras, "r");
+  arqAlvos = fopen(nomeArquivoAlvos, "r");
+
+  /* Verificando se os arquivos foram abertos com sucesso. */
+  if (arqAmostras == NULL || arqAlvos == NULL)
+  {
+    /* Retornando NULL. */
+    return NULL;
+  }
+
+  /* Alocando o vetor que irá armazenar os padrões. */
+  PadraoTreinamento * padroes;
+  padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+
+  /* Primeiramente lendo as amostras e inserindo as mesmas nos respectivos
+     padrões. */
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    /* Coletando a linha com a amostra do arquivo. */
+    char linhaAmostra[4096]; // 4 Kbytes
+    fscanf(arqAmostras, "%s", linhaAmostra);
+
+    /* Alocando o vetor para armazenar a amostra "i-ésima"
+       no hospedeiro. */
+    float * h_amostra = (float *) malloc(sizeof(float) * qtdItensAmostra);
+    
+    /* Extraindo o primeiro item da amostra. */
+    h_amostra[0] = atof(strtok(linhaAmostra, ";\n\0"));
+
+    /* Extraindo os demais itens da amostra. */
+    for (int j = 1; j < qtdItensAmostra; j++)
+    {
+      /* Extraindo o item "j-ésimo" da amostra. */
+      h_amostra[j] = atof(strtok(NULL, ";\n\0"));
+    }
+
+    /* Normalizando a amostra coletada... */
+    normalizacaoMinMax(h_amostra, qtdItensAmostra, menorValAmostra,
+                       maiorValAmostra);
+
+    /* Copiando a amostra normalizada para a memória do dispositivo
+       acelerador . */
+    float * d_amostra;
+    cudaMalloc((void **) &d_amostra, sizeof(float) * qtdItensAmostra);
+    cudaMemcpy(d_amostra, h_amostra, sizeof(float) * qtdItensAmostra,
+	       cudaMemcpyHostToDevice);
+    
+    /* Por fim, colocando no padrão a amostra acima extraida
+    do arquivo. */
+    padroes[i].d_amostra = d_amostra;
+    padroes[i].tipoAmostra = AmostraDensa;
+    padroes[i].d_indices = NULL;
+    padroes[i].qtdNaoNulos = 0;
+
+    /* Desalocando os vetores do hospedeiro que já foram copiados
+       para o dispositivo acelerador. */
+    free(h_amostra);
+  }
+
+  /* Lendo os vetores de alvo e inserindo os mesmos nos respectivos
+     padrões. */
+  __carregarAlvosArquivo(arqAlvos, padroes, qtdItensAlvo, qtdPadroes);
+
+  fclose(arqAmostras);
+  fclose(arqAlvos);
+
+  return padroes;
+}
+
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesBrutosArquivo(char * nomeArquivoAmostras,
+                                               char * nomeArquivoAlvos,
+                                               float menorValAmostra,
+                                               float maiorValAmostra,
+                                               int qtdItensAmostra,
+                                               int qtdItensAlvo,
+                                               int qtdPadroes,
+                                               int tipoAmostra)
+{
+  /* Tentando abrir os arquivos para leitura. */
+  FILE * arqAmostras = fopen(nomeArquivoAmostras, "r");
+  FILE * arqAlvos = fopen(nomeArquivoAlvos, "r");
+
+  if (arqAmostras == NULL || arqAlvos == NULL)
+  {
+    if (arqAmostras != NULL) fclose(arqAmostras);
+    if (arqAlvos != NULL) fclose(arqAlvos);
+    return NULL;
+  }
+
+  PadraoTreinamento * padroes;
+  padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+
+  /* Todas as amostras ficam em um único bloco (no hospedeiro durante a
+     leitura e depois no dispositivo acelerador), evitando o custo de uma
+     alocação por amostra. */
+  size_t tamItem = (tipoAmostra == AmostraUint16) ? sizeof(uint16_t) :
+                                                    sizeof(uint8_t);
+  size_t tamAmostra = tamItem * qtdItensAmostra;
+  float maiorValTipo = (tipoAmostra == AmostraUint16) ? UINT16_MAX :
+                                                        UINT8_MAX;
+  uint8_t * h_amostras = malloc(tamAmostra * qtdPadroes);
+
+  char * linhaAmostra = NULL;
+  size_t tamLinhaAmostra = 0;
+
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    /* Itens ausentes na linha são considerados nulos. */
+    memset(h_amostras + tamAmostra * i, 0, tamAmostra);
+
+    if (getline(&linhaAmostra, &tamLinhaAmostra, arqAmostras) == -1)
+    {
+      continue;
+    }
+
+    char * item = strtok(linhaAmostra, ";\r\n");
+    for (int j = 0; j < qtdItensAmostra && item != NULL; j++)
+    {
+      /* Saturando e arredondando o item para o tipo da amostra. */
+      float valor = fminf(fmaxf(atof(item), 0), maiorValTipo);
+
+      if (tipoAmostra == AmostraUint16)
+      {
+        ((uint16_t *) (h_amostras + tamAmostra * i))[j] = lrintf(valor);
+      }
+      else
+      {
+        h_amostras[tamAmostra * i + j] = lrintf(valor);
+      }
+
+      item = strtok(NULL, ";\r\n");
+    }
+  }
+
+  free(linhaAmostra);
+
+  uint8_t * d_amostras;
+  cudaMalloc((void **) &d_amostras, tamAmostra * qtdPadroes);
+  cudaMemcpy(d_amostras, h_amostras, tamAmostra * qtdPadroes,
+             cudaMemcpyHostToDevice);
+  free(h_amostras);
+
+  /* A normalização "min-max" como "x * escala + deslocamento". */
+  float escala = 1.0 / (maiorValAmostra - menorValAmostra);
+  float deslocamento = -menorValAmostra * escala;
+
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    padroes[i].d_amostra = NULL;
+    padroes[i].tipoAmostra = tipoAmostra;
+    padroes[i].d_indices = NULL;
+    padroes[i].qtdNaoNulos = 0;
+    padroes[i].d_amostraBruta = d_amostras + tamAmostra * i;
+    padroes[i].escalaAmostra = escala;
+    padroes[i].deslocamentoAmostra = deslocamento;
+    padroes[i].d_escalasAmostra = NULL;
+    padroes[i].d_deslocamentosAmostra = NULL;
+  }
+
+  /* Lendo os vetores de alvo e inserindo os mesmos nos respectivos
+     padrões. */
+  __carregarAlvosArquivo(arqAlvos, padroes, qtdItensAlvo, qtdPadroes);
+
+  fclose(arqAmostras);
+  fclose(arqAlvos);
+
+  return padroes;
+}
+
+/**
+ * Método que lê a próxima linha do arquivo de amostras para um vetor de
+ * floats (itens ausentes na linha são considerados nulos).
+ */
+static void __lerLinhaAmostra(FILE * arqAmostras, char ** linha,
+                              size_t * tamLinha, float * h_amostra,
+                              int qtdItensAmostra)
+{
+  memset(h_amostra, 0, sizeof(float) * qtdItensAmostra);
+
+  if (getline(linha, tamLinha, arqAmostras) == -1)
+  {
+    return;
+  }
+
+  char * item = strtok(*linha, ";\r\n");
+  for (int j = 0; j < qtdItensAmostra && item != NULL; j++)
+  {
+    h_amostra[j] = atof(item);
+    item = strtok(NULL, ";\r\n");
+  }
+}
+
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesQuantizadosArquivo(char * nomeArquivoAmostras,
+                                                    char * nomeArquivoAlvos,
+                                                    float menorValAmostra,
+                                                    float maiorValAmostra,
+                                                    int qtdItensAmostra,
+                                                    int qtdItensAlvo,
+                                                    int qtdPadroes,
+                                                    int tipoAmostra)
+{
+  /* Tentando abrir os arquivos para leitura. */
+  FILE * arqAmostras = fopen(nomeArquivoAmostras, "r");
+  FILE * arqAlvos = fopen(nomeArquivoAlvos, "r");
+
+  if (arqAmostras == NULL || arqAlvos == NULL)
+  {
+    if (arqAmostras != NULL) fclose(arqAmostras);
+    if (arqAlvos != NULL) fclose(arqAlvos);
+    return NULL;
+  }
+
+  float * h_amostra = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_menores = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_maiores = malloc(sizeof(float) * qtdItensAmostra);
+  char * linhaAmostra = NULL;
+  size_t tamLinhaAmostra = 0;
+
+  for (int j = 0; j < qtdItensAmostra; j++)
+  {
+    h_menores[j] = INFINITY;
+    h_maiores[j] = -INFINITY;
+  }
+
+  /* Primeira leitura: encontrando a faixa de cada item. */
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    __lerLinhaAmostra(arqAmostras, &linhaAmostra, &tamLinhaAmostra,
+                      h_amostra, qtdItensAmostra);
+
+    for (int j = 0; j < qtdItensAmostra; j++)
+    {
+      h_menores[j] = fminf(h_menores[j], h_amostra[j]);
+      h_maiores[j] = fmaxf(h_maiores[j], h_amostra[j]);
     }
-    
-  } while (h_erroGlobal > erroDesejado && epocas < QTD_MAX_EPOCAS);
+  }
 
-  /* Desalocando as variáveis que estão no dispositivo acelerador 
-     que não serão mais necessárias. */
-  cudaFree(d_erroPadrao);
-  
-  return historicoTreinamento;
-}
+  /* Escala de quantização de cada item ("x = q * escala + menor" em uint8
+     e "x = q * escala" em fp16) e a normalização "min-max" da entrada da
+     rede, combinadas em "q * escalas[j] + deslocamentos[j]". */
+  float * h_escalasQuantizacao = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_escalas = malloc(sizeof(float) * qtdItensAmostra);
+  float * h_deslocamentos = malloc(sizeof(float) * qtdItensAmostra);
+  float escalaNormalizacao = 1.0 / (maiorValAmostra - menorValAmostra);
 
-void embaralhamentoFisherYates(int * v, int n)
-{
-  /* Gerando a semente para gerar
-  os números randômicos. */
-  srand(time(NULL));
+  for (int j = 0; j < qtdItensAmostra; j++)
+  {
+    float escalaQuantizacao;
+    float menorQuantizacao;
 
-  /* Percorrendo o vetor do fim para o
-  início. */
-  for (int i = n - 1; i > 0; i--)
+    if (tipoAmostra == AmostraFP16)
+    {
+      escalaQuantizacao = fmaxf(fabsf(h_menores[j]), fabsf(h_maiores[j]));
+      menorQuantizacao = 0.0;
+    }
+    else
+    {
+      escalaQuantizacao = (h_maiores[j] - h_menores[j]) / UINT8_MAX;
+      menorQuantizacao = h_menores[j];
+    }
+
+    /* Itens constantes (ou sempre nulos, em fp16) com escala unitária. */
+    if (escalaQuantizacao == 0.0)
+    {
+      escalaQuantizacao = 1.0;
+    }
+
+    h_escalas[j] = escalaQuantizacao * escalaNormalizacao;
+    h_deslocamentos[j] = (menorQuantizacao - menorValAmostra) *
+                         escalaNormalizacao;
+    h_escalasQuantizacao[j] = escalaQuantizacao;
+  }
+
+  /* Segunda leitura: quantizando as amostras em um único bloco. */
+  size_t tamItem = (tipoAmostra == AmostraFP16) ? sizeof(uint16_t) :
+                                                  sizeof(uint8_t);
+  size_t tamAmostra = tamItem * qtdItensAmostra;
+  uint8_t * h_amostras = malloc(tamAmostra * qtdPadroes);
+
+  rewind(arqAmostras);
+
+  for (int i = 0; i < qtdPadroes; i++)
   {
-    /* Gerando o índice para permutação
-    entre o número "i-ésimo" e algum
-    número entre 0 e i-1. */
-    int indicePerm = rand() % i;
+    __lerLinhaAmostra(arqAmostras, &linhaAmostra, &tamLinhaAmostra,
+                      h_amostra, qtdItensAmostra);
 
-    /* Realizando a troca. */
-    int auxTroca = v[i];
-    v[i] = v[indicePerm];
-    v[indicePerm] = auxTroca;
+    for (int j = 0; j < qtdItensAmostra; j++)
+    {
+      if (tipoAmostra == AmostraFP16)
+      {
+        ((uint16_t *) (h_amostras + tamAmostra * i))[j] =
+          converterFloatFP16(h_amostra[j] / h_escalasQuantizacao[j]);
+      }
+      else
+      {
+        float nivel = (h_amostra[j] - h_menores[j]) /
+                      h_escalasQuantizacao[j];
+        h_amostras[tamAmostra * i + j] = lrintf(fminf(fmaxf(nivel, 0),
+                                                      UINT8_MAX));
+      }
+    }
   }
-}
 
-void normalizacaoMinMax(float * v, int n, float min, float max)
-{
-  /* Percorrendo todos os itens do vetor e realizando a normalização
-  dos mesmos. */
-  for (int i = 0; i < n; i++)
+  free(linhaAmostra);
+  free(h_amostra);
+  free(h_menores);
+  free(h_maiores);
+  free(h_escalasQuantizacao);
+
+  /* Copiando as amostras e as escalas para o dispositivo acelerador. */
+  uint8_t * d_amostras;
+  cudaMalloc((void **) &d_amostras, tamAmostra * qtdPadroes);
+  cudaMemcpy(d_amostras, h_amostras, tamAmostra * qtdPadroes,
+             cudaMemcpyHostToDevice);
+  free(h_amostras);
+
+  float * d_escalas;
+  float * d_deslocamentos;
+  cudaMalloc((void **) &d_escalas, sizeof(float) * qtdItensAmostra);
+  cudaMalloc((void **) &d_deslocamentos, sizeof(float) * qtdItensAmostra);
+  cudaMemcpy(d_escalas, h_escalas, sizeof(float) * qtdItensAmostra,
+             cudaMemcpyHostToDevice);
+  cudaMemcpy(d_deslocamentos, h_deslocamentos,
+             sizeof(float) * qtdItensAmostra, cudaMemcpyHostToDevice);
+  free(h_escalas);
+  free(h_deslocamentos);
+
+  PadraoTreinamento * padroes;
+  padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+
+  for (int i = 0; i < qtdPadroes; i++)
   {
-    v[i] = (v[i] - min) / (max - min);
+    padroes[i].d_amostra = NULL;
+    padroes[i].tipoAmostra = tipoAmostra;
+    padroes[i].d_indices = NULL;
+    padroes[i].qtdNaoNulos = 0;
+    padroes[i].d_amostraBruta = d_amostras + tamAmostra * i;
+    padroes[i].escalaAmostra = 1.0;
+    padroes[i].deslocamentoAmostra = 0.0;
+    padroes[i].d_escalasAmostra = d_escalas;
+    padroes[i].d_deslocamentosAmostra = d_deslocamentos;
   }
-}
 
-#pragma acc routine seq
-inline float funcaoDegrau(float z)
-{
-  return (z >= 0) ? 1 : 0;
+  /* Lendo os vetores de alvo e inserindo os mesmos nos respectivos
+     padrões. */
+  __carregarAlvosArquivo(arqAlvos, padroes, qtdItensAlvo, qtdPadroes);
+
+  fclose(arqAmostras);
+  fclose(arqAlvos);
+
+  return padroes;
 }
 
-#pragma acc routine seq
-float derivadaFuncaoDegrau(float valDegrau)
+PadraoTreinamento * PadraoTreinamento_criarJanelasSerie(const float * h_serie,
+                                                        long tamSerie,
+                                                        int tamJanela,
+                                                        int horizonte,
+                                                        int passo,
+                                                        int * qtdPadroes)
 {
-  return 1.0;
+  *qtdPadroes = 0;
+
+  if (tamSerie < (long) tamJanela + horizonte || passo <= 0)
+  {
+    return NULL;
+  }
+
+  *qtdPadroes = (int) ((tamSerie - tamJanela - horizonte) / passo + 1);
+
+  /* A série é a única cópia dos valores no dispositivo acelerador. */
+  float * d_serie;
+  cudaMalloc((void **) &d_serie, sizeof(float) * tamSerie);
+  cudaMemcpy(d_serie, h_serie, sizeof(float) * tamSerie,
+             cudaMemcpyHostToDevice);
+
+  PadraoTreinamento * padroes;
+  padroes = malloc(sizeof(PadraoTreinamento) * *qtdPadroes);
+
+  /* Cada padrão aponta para a sua janela e para os valores seguintes
+     (objetivo), que também são o início das janelas posteriores. */
+  for (int i = 0; i < *qtdPadroes; i++)
+  {
+    long inicio = (long) passo * i;
+
+    padroes[i].d_amostra = d_serie + inicio;
+    padroes[i].d_alvo = d_serie + inicio + tamJanela;
+    padroes[i].tipoAmostra = AmostraDensa;
+    padroes[i].d_indices = NULL;
+    padroes[i].qtdNaoNulos = 0;
+  }
+
+  return padroes;
 }
 
-#pragma acc routine seq
-inline float funcaoSigmoide(float z)
+PadraoTreinamento *
+PadraoTreinamento_carregarJanelasSerieArquivo(char * nomeArquivoSerie,
+                                              float menorValSerie,
+                                              float maiorValSerie,
+                                              int tamJanela,
+                                              int horizonte,
+                                              int passo,
+                                              int * qtdPadroes)
 {
-  return 1.0 / ((1.0) + expf(-z));
+  *qtdPadroes = 0;
+
+  FILE * arqSerie = fopen(nomeArquivoSerie, "r");
+  if (arqSerie == NULL)
+  {
+    return NULL;
+  }
+
+  /* Lendo os valores da série (em um vetor que cresce conforme a
+     leitura). */
+  long tamSerie = 0;
+  long capacidadeSerie = 1024;
+  float * h_serie = malloc(sizeof(float) * capacidadeSerie);
+
+  char * linha = NULL;
+  size_t tamLinha = 0;
+
+  while (getline(&linha, &tamLinha, arqSerie) != -1)
+  {
+    for (char * item = strtok(linha, ";\r\n"); item != NULL;
+         item = strtok(NULL, ";\r\n"))
+    {
+      if (tamSerie == capacidadeSerie)
+      {
+        capacidadeSerie *= 2;
+        h_serie = realloc(h_serie, sizeof(float) * capacidadeSerie);
+      }
+
+      h_serie[tamSerie++] = atof(item);
+    }
+  }
+
+  free(linha);
+  fclose(arqSerie);
+
+  /* Normalizando a série uma única vez (amostras e objetivos). */
+  for (long i = 0; i < tamSerie; i++)
+  {
+    h_serie[i] = (h_serie[i] - menorValSerie) /
+                 (maiorValSerie - menorValSerie);
+  }
+
+  PadraoTreinamento * padroes;
+  padroes = PadraoTreinamento_criarJanelasSerie(h_serie, tamSerie, tamJanela,
+                                                horizonte, passo, qtdPadroes);
+
+  free(h_serie);
+
+  return padroes;
 }
 
-#pragma acc routine seq
-inline float derivadaFuncaoSigmoide(float valSigmoide)
+void PadraoTreinamento_desalocarJanelasSerie(PadraoTreinamento * padroes)
 {
-  return valSigmoide * (1.0 - valSigmoide);
+  if (padroes == NULL)
+  {
+    return;
+  }
+
+  /* A amostra do primeiro padrão é o início da série (a única alocação no
+     dispositivo acelerador). */
+  cudaFree((void *) padroes[0].d_amostra);
+  free(padroes);
 }
 
-#pragma acc routine seq
-inline float funcaoTangHiperbolica(float z)
+/**
+ * Método que copia os pares índice/valor de uma amostra esparsa para a
+ * memória do dispositivo acelerador (com ao menos um item, mesmo para as
+ * amostras nulas) e os coloca no padrão.
+ */
+static void __definirAmostraEsparsa(PadraoTreinamento * padrao,
+                                    const int * h_indices,
+                                    const float * h_valores,
+                                    int qtdNaoNulos)
 {
-  return tanhf(z);
+  int * d_indices;
+  float * d_valores;
+  int qtdAlocada = (qtdNaoNulos > 0) ? qtdNaoNulos : 1;
+  cudaMalloc((void **) &d_indices, sizeof(int) * qtdAlocada);
+  cudaMalloc((void **) &d_valores, sizeof(float) * qtdAlocada);
+  cudaMemcpy(d_indices, h_indices, sizeof(int) * qtdNaoNulos,
+             cudaMemcpyHostToDevice);
+  cudaMemcpy(d_valores, h_valores, sizeof(float) * qtdNaoNulos,
+             cudaMemcpyHostToDevice);
+
+  padrao->d_amostra = d_valores;
+  padrao->d_alvo = NULL;
+  padrao->tipoAmostra = AmostraEsparsa;
+  padrao->d_indices = d_indices;
+  padrao->qtdNaoNulos = qtdNaoNulos;
 }
 
-#pragma acc routine seq
-inline float derivadaFuncaoTangHiperbolica(float valTangHiperbolica)
+/**
+ * Estrutura com o item da entrada e o valor (com sinal) de um atributo
+ * transformado pelo "hashing trick".
+ */
+typedef struct
 {
-  return 1 - (valTangHiperbolica * valTangHiperbolica);
+  int indice;
+  float valor;
+} ParAtributo;
+
+/**
+ * Método de comparação dos pares de atributos (pelo índice) para o "qsort".
+ */
+static int __compararParIndice(const void * a, const void * b)
+{
+  int x = ((const ParAtributo *) a)->indice;
+  int y = ((const ParAtributo *) b)->indice;
+  return (x > y) - (x < y);
 }
 
 PadraoTreinamento *
-PadraoTreinamento_carregarPadroesArquivo(char * nomeArquivoAmostras,
-                                         char * nomeArquivoAlvos,
-                                         float menorValAmostra,
-                                         float maiorValAmostra,
-                                         int qtdItensAmostra,
-                                         int qtdItensAlvo,
-                                         int qtdPadroes)
+PadraoTreinamento_carregarPadroesEsparsosArquivo(char * nomeArquivoAmostras,
+                                                 char * nomeArquivoAlvos,
+                                                 int qtdItensAmostra,
+                                                 int qtdItensAlvo,
+                                                 int qtdPadroes)
 {
   /* Tentando abrir os arquivos para leitura. */
-  FILE * arqAmostras;
-  FILE * arqAlvos;
-
-  arqAmostras = fopen(nomeArquivoAmostras, "r");
-  arqAlvos = fopen(nomeArquivoAlvos, "r");
+  FILE * arqAmostras = fopen(nomeArquivoAmostras, "r");
+  FILE * arqAlvos = fopen(nomeArquivoAlvos, "r");
 
-  /* Verificando se os arquivos foram abertos com sucesso. */
   if (arqAmostras == NULL || arqAlvos == NULL)
   {
-    /* Retornando NULL. */
+    if (arqAmostras != NULL) fclose(arqAmostras);
+    if (arqAlvos != NULL) fclose(arqAlvos);
     return NULL;
   }
 
-  /* Alocando o vetor que irá armazenar os padrões. */
   PadraoTreinamento * padroes;
   padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
 
-  /* Primeiramente lendo as amostras e inserindo as mesmas nos respectivos
-     padrões. */
-  for (int i = 0; i < qtdPadroes; i++)
-  {
-    /* Coletando a linha com a amostra do arquivo. */
-    char linhaAmostra[4096]; // 4 Kbytes
-    fscanf(arqAmostras, "%s", linhaAmostra);
+  /* Vetores (no hospedeiro) com os pares índice/valor de uma amostra, que
+     crescem conforme a necessidade. */
+  int capacidade = 256;
+  int * h_indices = malloc(sizeof(int) * capacidade);
+  float * h_valores = malloc(sizeof(float) * capacidade);
 
-    /* Alocando o vetor para armazenar a amostra "i-ésima"
-       no hospedeiro. */
-    float * h_amostra = (float *) malloc(sizeof(float) * qtdItensAmostra);
-    
-    /* Extraindo o primeiro item da amostra. */
-    h_amostra[0] = atof(strtok(linhaAmostra, ";\n\0"));
+  char * linhaAmostra = NULL;
+  size_t tamLinhaAmostra = 0;
+  bool indiceInvalido = false;
+  int i;
 
-    /* Extraindo os demais itens da amostra. */
-    for (int j = 1; j < qtdItensAmostra; j++)
+  for (i = 0; i < qtdPadroes && !indiceInvalido; i++)
+  {
+    /* Coletando a linha com a amostra (uma linha ausente é uma amostra
+       nula). */
+    int qtdNaoNulos = 0;
+
+    if (getline(&linhaAmostra, &tamLinhaAmostra, arqAmostras) != -1)
     {
-      /* Extraindo o item "j-ésimo" da amostra. */
-      h_amostra[j] = atof(strtok(NULL, ";\n\0"));
+      /* Extraindo os pares "indice:valor" da linha. */
+      for (char * par = strtok(linhaAmostra, "; \t\r\n"); par != NULL;
+           par = strtok(NULL, "; \t\r\n"))
+      {
+        int indice;
+        float valor;
+
+        if (sscanf(par, "%d:%f", &indice, &valor) != 2 ||
+            indice < 0 || indice >= qtdItensAmostra)
+        {
+          indiceInvalido = true;
+          break;
+        }
+
+        if (qtdNaoNulos == capacidade)
+        {
+          capacidade *= 2;
+          h_indices = realloc(h_indices, sizeof(int) * capacidade);
+          h_valores = realloc(h_valores, sizeof(float) * capacidade);
+        }
+
+        h_indices[qtdNaoNulos] = indice;
+        h_valores[qtdNaoNulos] = valor;
+        qtdNaoNulos++;
+      }
     }
 
-    /* Normalizando a amostra coletada... */
-    normalizacaoMinMax(h_amostra, qtdItensAmostra, menorValAmostra,
-                       maiorValAmostra);
+    __definirAmostraEsparsa(&padroes[i], h_indices, h_valores, qtdNaoNulos);
+  }
 
-    /* Copiando a amostra normalizada para a memória do dispositivo
-       acelerador . */
-    float * d_amostra;
-    cudaMalloc((void **) &d_amostra, sizeof(float) * qtdItensAmostra);
-    cudaMemcpy(d_amostra, h_amostra, sizeof(float) * qtdItensAmostra,
-	       cudaMemcpyHostToDevice);
-    
-    /* Por fim, colocando no padrão a amostra acima extraida
-    do arquivo. */
-    padroes[i].d_amostra = d_amostra;
+  free(linhaAmostra);
+  free(h_indices);
+  free(h_valores);
 
-    /* Desalocando os vetores do hospedeiro que já foram copiados
-       para o dispositivo acelerador. */
-    free(h_amostra);
+  /* Descartando os padrões já carregados caso algum par seja inválido. */
+  if (indiceInvalido)
+  {
+    for (int j = 0; j < i; j++)
+    {
+      cudaFree((void *) padroes[j].d_amostra);
+      cudaFree((void *) padroes[j].d_indices);
+    }
+
+    free(padroes);
+    fclose(arqAmostras);
+    fclose(arqAlvos);
+    return NULL;
   }
 
   /* Lendo os vetores de alvo e inserindo os mesmos nos respectivos
      padrões. */
+  __carregarAlvosArquivo(arqAlvos, padroes, qtdItensAlvo, qtdPadroes);
+
+  fclose(arqAmostras);
+  fclose(arqAlvos);
+
+  return padroes;
+}
+
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesHashArquivo(char * nomeArquivoAmostras,
+                                             char * nomeArquivoAlvos,
+                                             int qtdItensAmostra,
+                                             int qtdItensAlvo,
+                                             int qtdPadroes)
+{
+  /* Tentando abrir os arquivos para leitura. */
+  FILE * arqAmostras = fopen(nomeArquivoAmostras, "r");
+  FILE * arqAlvos = fopen(nomeArquivoAlvos, "r");
+
+  if (arqAmostras == NULL || arqAlvos == NULL)
+  {
+    if (arqAmostras != NULL) fclose(arqAmostras);
+    if (arqAlvos != NULL) fclose(arqAlvos);
+    return NULL;
+  }
+
+  PadraoTreinamento * padroes;
+  padroes = malloc(sizeof(PadraoTreinamento) * qtdPadroes);
+
+  /* Pares dos atributos de uma amostra e os itens não nulos resultantes,
+     que crescem conforme a necessidade. */
+  int capacidade = 256;
+  ParAtributo * h_pares = malloc(sizeof(ParAtributo) * capacidade);
+  int * h_indices = malloc(sizeof(int) * capacidade);
+  float * h_valores = malloc(sizeof(float) * capacidade);
+
+  char * linhaAmostra = NULL;
+  size_t tamLinhaAmostra = 0;
+
   for (int i = 0; i < qtdPadroes; i++)
   {
-    /* Coletando a linha com o alvo do arquivo. */
-    char linhaAlvo[4096]; // 4 Kbytes
-    fscanf(arqAlvos, "%s", linhaAlvo);
+    int qtdAtributos = 0;
 
-    /* Alocando o vetor para armazenar o vetor de objetivo "i-ésimo"
-       do hospedeiro. */
-    float * h_alvo = (float *) malloc(sizeof(float) * qtdItensAlvo);
+    if (getline(&linhaAmostra, &tamLinhaAmostra, arqAmostras) != -1)
+    {
+      for (char * atributo = strtok(linhaAmostra, "; \t\r\n");
+           atributo != NULL; atributo = strtok(NULL, "; \t\r\n"))
+      {
+        /* Atributos "chave=número" utilizam o hash da chave com o número
+           como valor; os demais utilizam o hash do atributo inteiro com
+           valor 1. */
+        size_t tamHash = strlen(atributo);
+        float valor = 1;
+
+        char * separador = strchr(atributo, '=');
+        if (separador != NULL && separador[1] != '\0')
+        {
+          char * fim;
+          float numero = strtof(separador + 1, &fim);
+          if (*fim == '\0')
+          {
+            tamHash = separador - atributo;
+            valor = numero;
+          }
+        }
+
+        float sinal;
+        int indice = hashAtributo(atributo, tamHash, qtdItensAmostra, &sinal);
+
+        if (qtdAtributos == capacidade)
+        {
+          capacidade *= 2;
+          h_pares = realloc(h_pares, sizeof(ParAtributo) * capacidade);
+          h_indices = realloc(h_indices, sizeof(int) * capacidade);
+          h_valores = realloc(h_valores, sizeof(float) * capacidade);
+        }
+
+        h_pares[qtdAtributos].indice = indice;
+        h_pares[qtdAtributos].valor = valor * sinal;
+        qtdAtributos++;
+      }
+    }
 
-    /* Extraindo o primeiro item do vetor de objetivo. */
-    h_alvo[0] = atof(strtok(linhaAlvo, ";\n\0"));
+    /* Ordenando os pares pelo índice e somando os atributos que colidiram
+       no mesmo item (os itens que se anularam são descartados). */
+    qsort(h_pares, qtdAtributos, sizeof(ParAtributo), __compararParIndice);
 
-    /* Extraindo os demais itens do vetor de objetivo. */
-    for (int j = 1; j < qtdItensAlvo; j++)
+    int qtdNaoNulos = 0;
+    for (int a = 0; a < qtdAtributos; a++)
     {
-      /* Extraindo o item "j-ésimo" do vetor de objetivo. */
-      h_alvo[j] = atof(strtok(NULL, ";\n\0"));
+      if (qtdNaoNulos > 0 && h_indices[qtdNaoNulos - 1] == h_pares[a].indice)
+      {
+        h_valores[qtdNaoNulos - 1] += h_pares[a].valor;
+      }
+      else
+      {
+        if (qtdNaoNulos > 0 && h_valores[qtdNaoNulos - 1] == 0)
+        {
+          qtdNaoNulos--;
+        }
+
+        h_indices[qtdNaoNulos] = h_pares[a].indice;
+        h_valores[qtdNaoNulos] = h_pares[a].valor;
+        qtdNaoNulos++;
+      }
     }
 
-    /* Copiando o vetor objetivo para a memória do dispositivo 
-       acelerador. */
-    float * d_alvo;
-    cudaMalloc((void **) &d_alvo, sizeof(float) * qtdItensAlvo);
-    cudaMemcpy(d_alvo, h_alvo, sizeof(float) * qtdItensAlvo,
-	       cudaMemcpyHostToDevice);
-    
-    /* Por fim, colocando no padrão o vetor de objetivo extraido do
-       arquivo. */
-    padroes[i].d_alvo = d_alvo;
+    if (qtdNaoNulos > 0 && h_valores[qtdNaoNulos - 1] == 0)
+    {
+      qtdNaoNulos--;
+    }
 
-    /* Desalocando os vetores do hospedeiro que já foram copiados
-       para o dispositivo acelerador. */
-    free(h_alvo);
+    __definirAmostraEsparsa(&padroes[i], h_indices, h_valores, qtdNaoNulos);
   }
 
+  free(linhaAmostra);
+  free(h_pares);
+  free(h_indices);
+  free(h_valores);
+
+  /* Lendo os vetores de alvo e inserindo os mesmos nos respectivos
+     padrões. */
+  __carregarAlvosArquivo(arqAlvos, padroes, qtdItensAlvo, qtdPadroes);
+
   fclose(arqAmostras);
   fclose(arqAlvos);
 
   return padroes;
 }
 
+float calcularErroSaida(const float * d_saida, const float * d_alvo,
+                        int qtdNeuroniosSaida)
+{
+  float erro = 0.0;
+
+  #pragma acc parallel loop vector_length(TAM_VECTOR) reduction(+:erro) \
+  deviceptr(d_saida, d_alvo)
+  for (int n = 0; n < qtdNeuroniosSaida; n++)
+  {
+    float erroSaidaNeuronio = d_saida[n] - d_alvo[n];
+    erro += 0.5 * erroSaidaNeuronio * erroSaidaNeuronio;
+  }
+
+  return erro;
+}
+
 float PerceptronMulticamadas_calcularTaxaAcerto(PerceptronMulticamadas * pm,
                                                 PadraoTreinamento * padroesTeste,
                                                 int qtdPadroesTeste)
 {
   
-  /* Alocando na memória do adaptador gráfico a variável que irá armazenar
-     o erro calculado das iterações. */
-  float * d_erroPadrao =  acc_malloc(sizeof(float));
+  /* Alocando o contexto de execução que irá armazenar as ativações
+     e o erro calculado das iterações. */
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+  int ultimaCamada = pm->qtdCamadas - 1;
 
   /* Percorrendo os padrões de teste. */
   float h_erroGlobal = 0;
@@ -770,25 +3761,25 @@ float PerceptronMulticamadas_calcularTaxaAcerto(PerceptronMulticamadas * pm,
   for (int i = 0; i < qtdPadroesTeste; i++)
   {
     /* Alimentando a rede com o padrão de teste "i-ésimo". */
-    PerceptronMulticamadas_feedfoward(pm, padroesTeste[i].d_amostra);
+    PerceptronMulticamadas_feedfowardPadrao(pm, contexto, &padroesTeste[i]);
 
     /* Calculando o erro dos neurônios da última camada. */
      Camada_calcularErroRpropNeuroniosUltimaCamada
-       (*pm->camadas[pm->qtdCamadas - 1], padroesTeste[i].d_alvo,
-	d_erroPadrao);
+       (*pm->camadas[ultimaCamada], contexto->estados[ultimaCamada],
+        padroesTeste[i].d_alvo, contexto->d_erroPadrao);
 
      /* Copiando o erro do padrão armazenado do dispositivo acelerador para
 	o hospedeiro. */
-     acc_memcpy_from_device(&h_erroPadrao, d_erroPadrao, sizeof(float));
+     acc_memcpy_from_device(&h_erroPadrao, contexto->d_erroPadrao,
+                            sizeof(float));
      
      h_erroGlobal += h_erroPadrao;
   }
 
   /* Desalocando as variáveis do dispositivo acelerador que não
      serão mais utilizadas. */
-  acc_free(d_erroPadrao);
+  ContextoExecucao_desalocar(contexto);
   
   /* Retornando o erro MSE calculado. */
   return h_erroGlobal / qtdPadroesTeste;
 }
-
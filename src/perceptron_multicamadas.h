@@ -19,12 +19,15 @@
 #include <time.h>
 #include <sys/time.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <complex.h>
+#include <pthread.h>
 #include <openacc.h>
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include "uniform.h" /* Biblioteca para gerar números aleatórios uniformemente
                         distribuídos. */
+#include "gerador_aleatorio.h"
 
 /* Tamanho do "vector" do OpenACC.
  * Caso estiver utilizando um adaptador da NVIDIA, utilizar
@@ -32,6 +35,14 @@
  */
 #define TAM_VECTOR 32
 
+/* Quantidade máxima de amostras processadas de uma só vez pela
+inferência em lote (o restante é processado em lotes sucessivos). */
+#define TAM_MAX_LOTE_INFERENCIA 1024
+
+/* Tamanho do "vector" do OpenACC utilizado na inferência de baixa
+latência (uma única "gang" calcula todas as camadas da rede). */
+#define TAM_VECTOR_LATENCIA 256
+
 /* Quantidade máxima de épocas de treinamento. */
 #define QTD_MAX_EPOCAS 1000
 
@@ -40,9 +51,29 @@ para os pesos. */
 #define RAND_LIM_MIN -1
 #define RAND_LIM_MAX  1
 
+/* Semente padrão dos pesos iniciais (a inicialização é reproduzível). */
+#define SEMENTE_PESOS 2021
+
 /* Valor inicial para o BIAS... */
 #define BIAS 1.0
 
+/* Semente padrão do embaralhamento dos padrões a cada época. */
+#define SEMENTE_EMBARALHAMENTO 12345
+
+/* Quantidade padrão de padrões consecutivos por bloco no embaralhamento
+em blocos. */
+#define TAM_BLOCO_EMBARALHAMENTO 4096
+
+/* Coeficiente padrão do momento. */
+#define MOMENTO_PADRAO 0.9
+
+/* Parâmetros padrão do Adam/AdamW (coeficientes do primeiro e do segundo
+momentos, constante de estabilidade e decaimento dos pesos do AdamW). */
+#define BETA1_PADRAO 0.9
+#define BETA2_PADRAO 0.999
+#define EPSILON_PADRAO 1e-8
+#define DECAIMENTO_PESOS_PADRAO 0.01
+
 /* Para mostra informações estatísticas. */
 #define INFO_ESTATISTICAS true
 
@@ -57,6 +88,124 @@ enum FuncoesAtivacaoEnum
   TangHiperbolica
 };
 
+/**
+ * Enumerações para a ordem em que os padrões são apresentados à rede em
+ * cada época do treinamento.
+ */
+enum ModosEmbaralhamentoEnum
+{
+  /** Ordem dos padrões no vetor (ou no arquivo). */
+  EmbaralhamentoDesativado,
+
+  /** Permutação uniforme de todos os padrões a cada época. */
+  EmbaralhamentoCompleto,
+
+  /** Blocos de padrões consecutivos em ordem aleatória, com os padrões de
+  cada bloco também embaralhados: cada bloco é percorrido de uma só vez,
+  preservando a localidade dos acessos (padrões lidos do disco ou mapeados
+  na memória). */
+  EmbaralhamentoBlocos
+};
+
+/**
+ * Enumerações para a distribuição dos pesos iniciais de uma camada, em que
+ * "fanIn" é a quantidade de pesos de cada neurônio e "fanOut" a quantidade
+ * de neurônios da camada.
+ */
+enum EsquemasInicializacaoEnum
+{
+  /** Uniforme em [-escala, escala] (escala 1 equivale ao intervalo
+  RAND_LIM_MIN..RAND_LIM_MAX). */
+  InicializacaoUniforme,
+
+  /** Normal com média 0 e desvio padrão "escala". */
+  InicializacaoNormal,
+
+  /** Xavier/Glorot uniforme: limite sqrt(6 / (fanIn + fanOut)), para
+  sigmoide e tangente hiperbólica. */
+  InicializacaoXavierUniforme,
+
+  /** Xavier/Glorot normal: desvio padrão sqrt(2 / (fanIn + fanOut)). */
+  InicializacaoXavierNormal,
+
+  /** He uniforme: limite sqrt(6 / fanIn), para funções do tipo ReLU. */
+  InicializacaoHeUniforme,
+
+  /** He normal: desvio padrão sqrt(2 / fanIn). */
+  InicializacaoHeNormal
+};
+
+/**
+ * Enumerações para o otimizador que atualiza os pesos durante o
+ * treinamento.
+ */
+enum OtimizadoresEnum
+{
+  /** Gradiente descendente: w += -taxa * g. */
+  OtimizadorSGD,
+
+  /** Momento: v = momento * v - taxa * g; w += v. */
+  OtimizadorMomento,
+
+  /** Momento de Nesterov: v = momento * v - taxa * g;
+  w += momento * v - taxa * g. */
+  OtimizadorNesterov,
+
+  /** Adam: m = beta1 * m + (1 - beta1) * g; v = beta2 * v + (1 - beta2) *
+  g^2; w += -taxa * (m / (1 - beta1^t)) / (sqrt(v / (1 - beta2^t)) + eps). */
+  OtimizadorAdam,
+
+  /** AdamW: Adam com o decaimento dos pesos desacoplado do gradiente
+  (w += -taxa * decaimento * w, além do passo do Adam). */
+  OtimizadorAdamW
+};
+
+/**
+ * Enumerações para a forma em que a amostra de um padrão é armazenada.
+ */
+enum TiposAmostraEnum
+{
+  /** Vetor com todos os itens da amostra. */
+  AmostraDensa,
+
+  /** Apenas os itens não nulos da amostra (pares índice/valor), para
+  entradas de alta dimensão com poucos valores não nulos. */
+  AmostraEsparsa,
+
+  /** Identificadores dos atributos categóricos (linhas da tabela da camada
+  de "embedding") seguidos dos atributos densos. */
+  AmostraCategorica,
+
+  /** Amostra bruta (sem normalização) em inteiros de 8 bits, normalizada
+  pela primeira camada durante o cálculo (veja "d_amostraBruta"). */
+  AmostraUint8,
+
+  /** O mesmo que "AmostraUint8", com inteiros de 16 bits. */
+  AmostraUint16,
+
+  /** O mesmo que "AmostraUint8", com os itens em fp16 ("half"). */
+  AmostraFP16
+};
+
+/**
+ * Enumerações para o formato numérico em que os pesos de uma camada (e as
+ * ativações da inferência em lote) são armazenados. Em todos os formatos as
+ * somas são acumuladas em float (fp32).
+ */
+enum FormatosNumericosEnum
+{
+  /** Float de 32 bits (padrão). */
+  FormatoFP32,
+
+  /** "bfloat16": 8 bits de expoente e 7 de mantissa (mesma faixa do
+  fp32 com menos precisão). */
+  FormatoBF16,
+
+  /** "half" do IEEE 754: 5 bits de expoente e 10 de mantissa (mais precisão
+  que o bf16, porém com valores limitados a +-65504). */
+  FormatoFP16
+};
+
 /***********************************************
  * Estruturas do Perceptron Multicamadas e etc *
  ***********************************************/
@@ -65,6 +214,10 @@ enum FuncoesAtivacaoEnum
  * Estrutura que irá representar uma camada da rede neural, os dados da
  * mesma serão organizados em vetores e tipos primitivos para facilitar
  * o envio dos mesmos para o dispositivo acelerador através do OpenACC.
+ *
+ * A camada armazena apenas os parâmetros (pesos e bias), o estado de uma
+ * avaliação da rede (ativações, derivadas e erros) fica na estrutura
+ * "EstadoCamada" do contexto de execução.
  * 
  * Lembrando que as variáveis com o prefixo "d_" terão seu conteúdo
  * alocado no dispositivo acelerador (não serão copiadas automáticamente
@@ -74,9 +227,48 @@ enum FuncoesAtivacaoEnum
 typedef struct
 {
   /** Vetor que irá armazenar os pesos desta camada na conveção
-  "row-major". */
+  "row-major". Quando a camada utiliza um formato reduzido (bf16 ou fp16),
+  é a cópia mestre (fp32) dos pesos, onde as atualizações do treinamento são
+  acumuladas, ou NULO caso a mesma não seja mantida. */
   float * d_W;
 
+  /** Vetor com os pesos no formato reduzido ("row-major"), lidos pelo
+  cálculo das ativações e do erro retropropagado (NULO no formato fp32). */
+  uint16_t * d_Wreduzido;
+
+  /** Vetor que irá armazenar os bias para cada neurônio da camada. */
+  float * d_bias;
+
+  /** Variável que irá armazenar a quantidade de neurônios desta camada. */
+  int qtdNeuronios;
+
+  /** Variável que irá armazenar a função de ativação para esta camada
+  (usar a enumeração "FuncoesAtivacaoEnum"). */
+  int funcaoAtivacao;
+
+  /** Formato em que os pesos são armazenados (usar a enumeração
+  "FormatosNumericosEnum"). Os bias são sempre armazenados em fp32. */
+  int formatoPesos;
+
+  /** Velocidades (momento) ou primeiros momentos (Adam) dos pesos
+  ("row-major", como "d_W") e dos bias, atualizados na mesma passagem que
+  os pesos, ou NULO caso o otimizador da rede não os utilize. */
+  float * d_velocidadeW;
+  float * d_velocidadeBias;
+
+  /** Segundos momentos (Adam) dos pesos e dos bias, ou NULO. */
+  float * d_segundoMomentoW;
+  float * d_segundoMomentoBias;
+
+} Camada;
+
+/**
+ * Estrutura que irá armazenar o estado dos neurônios de uma camada durante
+ * uma avaliação da rede (os vetores também estão no dispositivo
+ * acelerador).
+ */
+typedef struct
+{
   /** Vetor que irá armazenar o grau de ativação dos neurônios
   desta camada. */
   float * d_neuronioAtivacao;
@@ -89,17 +281,107 @@ typedef struct
   neurônio desta camada. */
   float * d_neuronioErroRprop;
 
-  /** Vetor que irá armazenar os bias para cada neurônio da camada. */
-  float * d_bias;
+} EstadoCamada;
 
-  /** Variável que irá armazenar a quantidade de neurônios desta camada. */
-  int qtdNeuronios;
+/**
+ * Estrutura que representa a camada de "embedding" colocada à frente da
+ * primeira camada: cada atributo categórico da amostra (um identificador
+ * inteiro) seleciona uma linha da tabela, e as linhas selecionadas são
+ * concatenadas com os atributos densos para formar a entrada da primeira
+ * camada (no lugar de uma codificação "one-hot").
+ */
+typedef struct
+{
+  /** Tabela (categoria x dimensão, "row-major") com o vetor de cada
+  categoria. */
+  float * d_tabela;
 
-  /** Variável que irá armazenar a função de ativação para esta camada
-  (usar a enumeração "FuncoesAtivacaoEnum"). */
-  int funcaoAtivacao;
+  /** Quantidade de categorias (linhas da tabela). Atributos categóricos
+  diferentes compartilham a tabela, utilizando faixas distintas de
+  identificadores caso não devam compartilhar os vetores. */
+  int qtdCategorias;
 
-} Camada;
+  /** Dimensão dos vetores (colunas da tabela). */
+  int dimensao;
+
+  /** Quantidade de atributos categóricos de cada amostra. */
+  int qtdAtributos;
+
+  /** Velocidades ou primeiros momentos e segundos momentos (Adam) da
+  tabela, ou NULO caso o otimizador da rede não os utilize. */
+  float * d_velocidadeTabela;
+  float * d_segundoMomentoTabela;
+
+} CamadaEmbedding;
+
+/**
+ * Estrutura com a configuração do embaralhamento dos padrões a cada época.
+ * A ordem de cada época depende apenas da semente e do número da época,
+ * de modo que um treinamento retomado de um "checkpoint" repete as mesmas
+ * ordens.
+ */
+typedef struct
+{
+  /** Modo do embaralhamento (enumeração "ModosEmbaralhamentoEnum"). */
+  int modo;
+
+  /** Quantidade de padrões por bloco (modo "EmbaralhamentoBlocos"). */
+  int tamBloco;
+
+  /** Semente do gerador. */
+  uint64_t semente;
+
+} ConfigEmbaralhamento;
+
+/**
+ * Estrutura com a configuração da inicialização dos pesos e do bias de uma
+ * camada.
+ */
+typedef struct
+{
+  /** Distribuição dos pesos (enumeração "EsquemasInicializacaoEnum"). */
+  int esquema;
+
+  /** Limite/desvio padrão dos esquemas "InicializacaoUniforme" e
+  "InicializacaoNormal", ou fator multiplicado pelo limite/desvio padrão
+  dos esquemas Xavier e He (normalmente 1). */
+  float escala;
+
+  /** Valor inicial do bias de todos os neurônios. */
+  float bias;
+
+} ConfigInicializacao;
+
+/**
+ * Estrutura com os parâmetros do otimizador do treinamento.
+ */
+typedef struct
+{
+  /** Otimizador (enumeração "OtimizadoresEnum"). */
+  int tipo;
+
+  /** Coeficiente do momento (otimizadores "OtimizadorMomento" e
+  "OtimizadorNesterov"). */
+  float momento;
+
+  /** Coeficientes do primeiro e do segundo momentos e constante de
+  estabilidade (otimizadores "OtimizadorAdam" e "OtimizadorAdamW"). */
+  float beta1;
+  float beta2;
+  float epsilon;
+
+  /** Decaimento dos pesos (não se aplica aos bias): somado ao gradiente
+  (regularização L2) ou, no AdamW, aplicado diretamente aos pesos. */
+  float decaimentoPesos;
+
+  /** Quantidade de atualizações realizadas e correções dos momentos do
+  Adam para a atualização atual (1 - beta1^t e 1 - beta2^t), mantidas pelo
+  treinamento. */
+  long passo;
+  float correcaoPrimeiroMomento;
+  float correcaoSegundoMomento;
+
+} ParametrosOtimizador;
 
 /**
  * Estrutura que irá armazenar as camadas do Perceptron.
@@ -112,23 +394,142 @@ typedef struct
   /** Quantidade de camadas. */
   int qtdCamadas;
 
-  /** Tamanho da entrada (quantidade de "neurônios"). */
+  /** Tamanho da entrada (quantidade de "neurônios"). Com a camada de
+  "embedding", é o tamanho da entrada montada (vetores concatenados
+  seguidos dos atributos densos). */
   int qtdNeuroniosEntrada;
 
+  /** Camada de "embedding" à frente da primeira camada, ou NULO caso a
+  rede não possua atributos categóricos. */
+  CamadaEmbedding * embedding;
+
+  /** Ordem dos padrões em cada época do treinamento (por padrão,
+  "EmbaralhamentoCompleto" com SEMENTE_EMBARALHAMENTO). */
+  ConfigEmbaralhamento embaralhamento;
+
+  /** Semente dos pesos iniciais (também utilizada pela tabela da camada de
+  "embedding"). */
+  uint64_t sementePesos;
+
+  /** Otimizador do treinamento (por padrão, "OtimizadorSGD"). */
+  ParametrosOtimizador otimizador;
+
 } PerceptronMulticamadas;
 
+/**
+ * Estrutura que irá armazenar o contexto de execução de uma rede, ou seja,
+ * tudo que é necessário para avaliar/treinar a rede salvo os parâmetros
+ * (pesos e bias) da mesma.
+ *
+ * Como os parâmetros ficam apenas no Perceptron, várias threads podem
+ * utilizar a mesma rede ao mesmo tempo, cada uma com o seu contexto.
+ */
+typedef struct
+{
+  /** Vetor com o estado de cada camada da rede. */
+  EstadoCamada * estados;
+
+  /** Quantidade de camadas (estados). */
+  int qtdCamadas;
+
+  /** Variável do dispositivo acelerador onde será armazenado o erro
+  do padrão apresentado à rede. */
+  float * d_erroPadrao;
+
+  /** Matrizes (amostra x neurônio) utilizadas alternadamente para armazenar
+  as ativações das camadas na inferência em lote (no formato dos pesos da
+  camada que as produziu). São alocadas apenas na primeira inferência em
+  lote realizada com o contexto. */
+  float * d_loteAtivacaoA;
+  float * d_loteAtivacaoB;
+
+  /** Matrizes utilizadas para transferir as entradas e as saídas da
+  inferência em lote entre o hospedeiro e o dispositivo acelerador. */
+  float * d_loteEntrada;
+  float * d_loteSaida;
+
+  /** Entrada da primeira camada montada pela camada de "embedding" (NULO
+  caso a rede não possua a mesma). */
+  float * d_entradaEmbedding;
+
+  /** Soma dos pesos de cada neurônio da primeira camada (no dispositivo
+  acelerador), utilizada pela ativação com amostras brutas para aplicar o
+  deslocamento da normalização sem percorrer os pesos novamente. É mantida
+  pela atualização dos pesos com amostras brutas e recalculada na próxima
+  ativação quando "somaPesosValida" for falso. */
+  float * d_somaPesosPrimeiraCamada;
+  bool somaPesosValida;
+
+  /** Espaço de trabalho da inferência de baixa latência (uma amostra),
+  alocado uma única vez por "PerceptronMulticamadas_prepararLatencia":
+  tabelas (no dispositivo acelerador) com os pesos, bias, quantidade de
+  neurônios e função de ativação de cada camada, vetores de ativação
+  utilizados alternadamente (o segundo, com pelo menos o tamanho da entrada,
+  recebe a cópia da amostra) e as regiões mapeadas do hospedeiro (lidas e
+  escritas diretamente pelo dispositivo) para a amostra e a saída. */
+  float ** d_latenciaTabelaW;
+  uint16_t ** d_latenciaTabelaWreduzido;
+  int * d_latenciaTabelaFormatoPesos;
+  float ** d_latenciaTabelaBias;
+  int * d_latenciaTabelaQtdNeuronios;
+  int * d_latenciaTabelaFuncaoAtivacao;
+  float * d_latenciaAtivacaoA;
+  float * d_latenciaAtivacaoB;
+  float * h_latenciaEntrada;
+  float * h_latenciaSaida;
+
+  /** Cópias (no hospedeiro) das tabelas de pesos, formatos e bias enviadas
+  ao dispositivo acelerador, comparadas com as camadas a cada inferência
+  para que as tabelas sejam reenviadas caso os vetores tenham sido
+  realocados (por exemplo, por "PerceptronMulticamadas_definirFormatoPesos"). */
+  float ** h_latenciaTabelaW;
+  uint16_t ** h_latenciaTabelaWreduzido;
+  int * h_latenciaTabelaFormatoPesos;
+  float ** h_latenciaTabelaBias;
+
+} ContextoExecucao;
+
 /**
  * Estrutura que irá representar um padrão de treinamento
  * para ser apresentado à rede.
  */
 typedef struct
 {
-  /** A vetor com a amostra (entrada da rede). */
+  /** A vetor com a amostra (entrada da rede). Nas amostras esparsas possui
+  apenas os valores não nulos e nas categóricas apenas os atributos
+  densos. */
   const float * d_amostra;
 
   /** Vetor com os valores desejados para saída da rede (objetivo). */
   const float * d_alvo;
 
+  /** Forma da amostra (usar a enumeração "TiposAmostraEnum"). */
+  int tipoAmostra;
+
+  /** Índice (item da entrada) de cada valor não nulo da amostra esparsa,
+  ou os identificadores dos atributos da amostra categórica (não utilizado
+  nas amostras densas). */
+  const int * d_indices;
+
+  /** Quantidade de valores não nulos da amostra esparsa (ou de atributos
+  da amostra categórica). */
+  int qtdNaoNulos;
+
+  /** Amostra bruta (sem normalização) das amostras "AmostraUint8",
+  "AmostraUint16" e "AmostraFP16". */
+  const void * d_amostraBruta;
+
+  /** Normalização das amostras brutas ("x * escala + deslocamento"),
+  aplicada pela primeira camada no lugar de "normalizacaoMinMax". */
+  float escalaAmostra;
+  float deslocamentoAmostra;
+
+  /** Escala e deslocamento de cada item (atributo) das amostras brutas,
+  compartilhados por todos os padrões do conjunto, ou NULOS para utilizar
+  "escalaAmostra" e "deslocamentoAmostra" em todos os itens. */
+  const float * d_escalasAmostra;
+  const float * d_deslocamentosAmostra;
+
 } PadraoTreinamento;
 
 /***********************************************************
@@ -190,6 +591,27 @@ typedef struct
   
 } HistoricoTreinamento;
 
+/**
+ * Estrutura com a configuração dos "checkpoints" periódicos do
+ * treinamento (veja "checkpoint_treinamento.h").
+ */
+typedef struct
+{
+  /** Nome do arquivo de "checkpoint" (substituído a cada "checkpoint"). */
+  const char * nomeArquivo;
+
+  /** Quantidade de épocas entre dois "checkpoints" (0 para desativar). */
+  int intervaloEpocas;
+
+  /** Tempo (em segundos) entre dois "checkpoints" (0 para desativar). */
+  float intervaloSegs;
+
+  /** Se o treinamento deve ser retomado do "checkpoint" (pesos, bias,
+  contador de épocas e histórico), caso o arquivo exista. */
+  bool retomar;
+
+} ConfigCheckpoint;
+
 /*********************************************************************
  * Funções da rede neural (inicialização do Perceptron Multicamadas, *
  * backpropagation, feedfoward e etc)...                             *
@@ -224,6 +646,88 @@ PerceptronMulticamadas_inicializar(int qtdNeuroniosEntrada,
                                    int * qtdNeuroniosCamada,
                                    int funcaoAtivacaoRede);
 
+/**
+ * Método idêntico a "PerceptronMulticamadas_inicializar" (que utiliza a
+ * semente SEMENTE_PESOS), porém com a semente dos pesos iniciais explícita.
+ * Os pesos são gerados diretamente no dispositivo acelerador por um gerador
+ * baseado em contador, de modo que a mesma semente sempre resulta nos
+ * mesmos pesos, independente da quantidade de threads.
+ *
+ * @param qtdNeuroniosEntrada Quantidade de neurônios da camada de
+ *                              entrada.
+ *
+ * @param qtdCamadas Quantidade de camadas (em que há processamento).
+ *
+ * @param qtdNeuroniosCamada Vetor com a quantidade de neurônios para cada
+ *                           camada.
+ *
+ * @param funcaoAtivacaoRede Função de ativação da rede (usar a enumeração
+ *                           "FuncoesAtivacaoEnum").
+ *
+ * @param semente Semente dos pesos iniciais.
+ *
+ * @return Referência para a estrutura alocada.
+ */
+PerceptronMulticamadas *
+PerceptronMulticamadas_inicializarSemente(int qtdNeuroniosEntrada,
+                                          int qtdCamadas,
+                                          int * qtdNeuroniosCamada,
+                                          int funcaoAtivacaoRede,
+                                          uint64_t semente);
+
+/**
+ * Método idêntico a "PerceptronMulticamadas_inicializarSemente", porém com
+ * a inicialização dos pesos e do bias de cada camada explícita.
+ *
+ * @param qtdNeuroniosEntrada Quantidade de neurônios da camada de
+ *                              entrada.
+ *
+ * @param qtdCamadas Quantidade de camadas (em que há processamento).
+ *
+ * @param qtdNeuroniosCamada Vetor com a quantidade de neurônios para cada
+ *                           camada.
+ *
+ * @param funcaoAtivacaoRede Função de ativação da rede (usar a enumeração
+ *                           "FuncoesAtivacaoEnum").
+ *
+ * @param configCamadas Vetor com a configuração da inicialização de cada
+ *                      camada, ou NULO para a inicialização padrão
+ *                      (uniforme em RAND_LIM_MIN..RAND_LIM_MAX e bias
+ *                      igual a BIAS).
+ *
+ * @param semente Semente dos pesos iniciais.
+ *
+ * @return Referência para a estrutura alocada.
+ */
+PerceptronMulticamadas *
+PerceptronMulticamadas_inicializarConfig(int qtdNeuroniosEntrada,
+                                         int qtdCamadas,
+                                         int * qtdNeuroniosCamada,
+                                         int funcaoAtivacaoRede,
+                                         const ConfigInicializacao *
+                                         configCamadas,
+                                         uint64_t semente);
+
+/**
+ * Método que retorna a configuração de inicialização padrão da rede
+ * (uniforme em RAND_LIM_MIN..RAND_LIM_MAX e bias igual a BIAS).
+ *
+ * @return Configuração padrão.
+ */
+ConfigInicializacao ConfigInicializacao_padrao();
+
+/**
+ * Método que retorna a configuração de inicialização recomendada para uma
+ * função de ativação (Xavier uniforme para as funções sigmoidais e a
+ * identidade, He uniforme para as demais), com bias 0.
+ *
+ * @param funcaoAtivacao Função de ativação da camada (usar a enumeração
+ *                       "FuncoesAtivacaoEnum").
+ *
+ * @return Configuração recomendada.
+ */
+ConfigInicializacao ConfigInicializacao_recomendada(int funcaoAtivacao);
+
 /**
  * Método que aloca uma camada na memória do hospedeiro (salvo os 
  * atributos da camada, que serão alocados na memória do dispostivo
@@ -237,110 +741,573 @@ PerceptronMulticamadas_inicializar(int qtdNeuroniosEntrada,
  * @param funcaoAtivacao Função de ativação desta camada
  *                       (usar a enumeração "FuncoesAtivacaoEnum").
  *
+ * @param config Configuração da inicialização dos pesos e do bias.
+ *
+ * @param semente Semente dos pesos da camada.
+ *
  * @return Referência para a camada alocada.
  */
 Camada * __alocarCamada(int qtdNeuronios,
 			int qtdPesosNeuronio,
-                        int funcaoAtivacao);
+                        int funcaoAtivacao,
+                        const ConfigInicializacao * config,
+                        uint64_t semente);
 
 /**
- * Método que aloca um vetor de pesos, gera os números aleatórios
- * (intervalo de RAND_LIM_MIN, RAND_LIM_MAX) e retorna a referência para o mesmo.
+ * Método que aloca uma camada cujos pesos e bias já estão na memória do
+ * hospedeiro (ex: carregados de um arquivo), copiando os mesmos para o
+ * dispositivo acelerador.
  *
- * @param qtdPesos Quantidade de pesos do a serem alocados.
+ * @param qtdNeuronios Quantidade de neurônios que a camada irá possuir.
+ *
+ * @param qtdPesosNeuronio Quantidade de pesos que cada
+ * neurônio irá possuir.
+ *
+ * @param funcaoAtivacao Função de ativação desta camada
+ *                       (usar a enumeração "FuncoesAtivacaoEnum").
+ *
+ * @param h_W Pesos da camada ("row-major", um neurônio por linha).
  *
- * @return Referência para o vetor de pesos alocado na memória.
+ * @param h_bias Bias de cada neurônio.
+ *
+ * @return Referência para a camada alocada.
  */
-float * __alocarVetorPesosRandomicos(int qtdPesos);
+Camada * __alocarCamadaPesos(int qtdNeuronios,
+                             int qtdPesosNeuronio,
+                             int funcaoAtivacao,
+                             const float * h_W,
+                             const float * h_bias);
 
 /**
- * Método que tem o objetivo de calcular a ativação dos neurônios da primeira
- * camada.
+ * Método que preenche um vetor do dispositivo acelerador com números
+ * aleatórios uniformemente distribuídos em um intervalo. O item "i" recebe o
+ * número de posição "i" da sequência da semente, calculado em paralelo.
  *
- * A função será deslocada para o dispositivo acelerador utilizando o "paralelismo
- * de neurônio", onde as iterações serão dividas nas "vector lanes".   
+ * @param d_vetor Vetor a ser preenchido (no dispositivo acelerador).
  *
- * @param camada Primeira camada.
+ * @param qtdItens Quantidade de itens do vetor.
  *
- * @param d_amostra Amostra sendo apresentada à rede (deve estar no dispositivo
- *                  acelerador).
+ * @param limiteMin Limite inferior do intervalo.
  *
- * @param qtdNeuroniosEntrada Tamanho da entrada (quantidade de itens da
- *                            amostra).
+ * @param limiteMax Limite superior do intervalo.
+ *
+ * @param semente Semente da sequência.
  */
-void Camada_calcularAtivacaoNeuroniosPrimeiraCamada(const Camada camada,
-                                                    const float * d_amostra,
-                                                    int qtdNeuroniosEntrada);
+void gerarVetorUniformeAleatorio(float * d_vetor,
+                                 long qtdItens,
+                                 float limiteMin,
+                                 float limiteMax,
+                                 uint64_t semente);
 
 /**
- * Método que tem o objetivo de calcular a ativação dos neurônios de qualquer
- * camada salvo a primeira.
+ * Método que preenche um vetor do dispositivo acelerador com números
+ * aleatórios com distribuição normal de média 0, da mesma forma que
+ * "gerarVetorUniformeAleatorio".
  *
- * A função será deslocada para o dispositivo acelerador utilizando o "paralelismo
- * de neurônio", onde as iterações serão dividas nas "vector lanes".   
+ * @param d_vetor Vetor a ser preenchido (no dispositivo acelerador).
  *
- * @param camadaAnterior Camada anterior à camada que se deseja calcular ao
- *                       ativação dos neurônios.
+ * @param qtdItens Quantidade de itens do vetor.
  *
- * @param camada Camada da qual se deseja calcular a ativação dos neurônios.
+ * @param desvioPadrao Desvio padrão da distribuição.
+ *
+ * @param semente Semente da sequência.
  */
-void Camada_calcularAtivacaoNeuroniosCamada(const Camada camadaAnterior,
-                                            const Camada camada);
+void gerarVetorNormalAleatorio(float * d_vetor,
+                               long qtdItens,
+                               float desvioPadrao,
+                               uint64_t semente);
 
 /**
- * Método que realizar o cálculo do erro retropropagado dos neurônios de uma
- * camada da rede salvo a última.
+ * Método que altera o formato em que os pesos de todas as camadas da rede
+ * são armazenados (veja "FormatosNumericosEnum"), convertendo os pesos
+ * atuais para o novo formato.
+ *
+ * Nos formatos reduzidos (bf16 e fp16) o cálculo das ativações, do erro
+ * retropropagado e da inferência lê apenas a metade dos bytes dos pesos,
+ * mas todas as somas continuam sendo acumuladas em fp32. Caso a cópia mestre
+ * em fp32 seja mantida, as atualizações do treinamento são acumuladas na
+ * mesma e os pesos reduzidos são arredondados a partir dela a cada
+ * atualização; caso contrário as atualizações são aplicadas diretamente aos
+ * pesos reduzidos e atualizações menores que a precisão do formato são
+ * perdidas (adequado apenas para inferência ou ajuste fino).
+ *
+ * Não deve ser chamado durante uma inferência. Os contextos que já
+ * prepararam a inferência de baixa latência reenviam as tabelas das camadas
+ * (pesos e formato) na inferência seguinte.
  *
- * @param camada Camada da qual se deseja calcular o erro retropropagado dos
- *               neurônios.
+ * @param pm Referência para o Perceptron Multicamadas.
  *
- * @param camadaPosterior Camada posterior à camada que se deseja calcular o
- *                        o erro retropropagado dos neurônios.
+ * @param formato Novo formato dos pesos (usar a enumeração
+ *                "FormatosNumericosEnum").
+ *
+ * @param manterCopiaFP32 Se a cópia mestre dos pesos em fp32 deve ser
+ *                        mantida (ignorado no formato fp32).
  */
-void Camada_calcularErroRpropNeuroniosCamada(const Camada camada,
-                                             const Camada camadaPosterior);
+void PerceptronMulticamadas_definirFormatoPesos(PerceptronMulticamadas * pm,
+                                                int formato,
+                                                bool manterCopiaFP32);
 
 /**
- * Método que realiza o cálculo do erro retropropagado dos neurônios da última
- * camada.
+ * Método que define a ordem em que os padrões são apresentados à rede em
+ * cada época do treinamento ("PerceptronMulticamadas_backpropagation").
  *
- * Apesar da função ser executada no dispositivo acelerador, sua execução será
- * sequencial, apenas sendo executada no dispositivo acelerador para que não
- * seja necessária a transferência de dados entre o dispostivo acelerador e
- * e o hospedeiro.  
+ * @param pm Referência para o Perceptron Multicamadas.
  *
- * @param camada Última camada da rede.
+ * @param modo Modo do embaralhamento (usar a enumeração
+ *             "ModosEmbaralhamentoEnum").
  *
- * @param d_alvo Vetor com os valores desejados para os neurônios desta camada
- *               (vetor de objetivo), onde a mesma deve estar alocada no 
- *               dispositivo acelerador.
+ * @param tamBloco Quantidade de padrões por bloco (apenas no modo
+ *                 "EmbaralhamentoBlocos").
  *
- * @param d_erroPadrao Variável do dispositivo acelerador onde será armazenado
- *                     o erro para o padrão apresentado à rede. 
+ * @param semente Semente do gerador.
  */
-void Camada_calcularErroRpropNeuroniosUltimaCamada(const Camada camada,
-						   const float * d_alvo,
-						   float * d_erroPadrao);
+void PerceptronMulticamadas_definirEmbaralhamento(PerceptronMulticamadas * pm,
+                                                  int modo,
+                                                  int tamBloco,
+                                                  uint64_t semente);
 
 /**
- * Método que atualiza os pesos dos neurônios da primeira camada.
- * 
- * A função será deslocada para o dispositivo acelerador utilizando o "paralelismo
- * de neurônio", onde as iterações serão dividas nas "vector lanes".   
- *
- * @param camada Primeira camada.
+ * Método que retorna os parâmetros padrão de um otimizador.
  *
- * @param d_amostra Amostra (deve estar alocada no dispositivo acelerador).
+ * @param tipo Otimizador (usar a enumeração "OtimizadoresEnum").
+ *
+ * @return Parâmetros do otimizador.
+ */
+ParametrosOtimizador ParametrosOtimizador_padrao(int tipo);
+
+/**
+ * Método que define o otimizador utilizado pelo treinamento da rede,
+ * alocando (zerados) ou desalocando as velocidades/momentos das camadas
+ * (e da tabela de "embedding") conforme o otimizador e reiniciando a
+ * contagem de atualizações.
+ *
+ * As velocidades/momentos e o peso são atualizados na mesma passagem sobre
+ * cada neurônio, de modo que o otimizador não acrescenta passagens sobre os
+ * pesos. Nas amostras esparsas apenas os estados dos pesos das entradas não
+ * nulas são atualizados (atualização "preguiçosa"), assim como apenas os
+ * das linhas da tabela de "embedding" selecionadas pela amostra.
+ *
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param parametros Parâmetros do otimizador.
+ */
+void PerceptronMulticamadas_definirOtimizador(PerceptronMulticamadas * pm,
+                                              const ParametrosOtimizador *
+                                              parametros);
+
+/**
+ * Método que copia os pesos de uma camada para um vetor (fp32) do
+ * hospedeiro, a partir da cópia mestre em fp32 caso exista ou convertendo
+ * os pesos reduzidos caso contrário.
+ *
+ * @param camada Camada.
+ *
+ * @param qtdPesosNeuronio Quantidade de pesos de cada neurônio.
+ *
+ * @param h_W Vetor ("row-major") onde serão armazenados os pesos.
+ */
+void Camada_copiarPesosHospedeiro(const Camada * camada,
+                                  int qtdPesosNeuronio,
+                                  float * h_W);
+
+/**
+ * Método que substitui os pesos de uma camada pelos pesos (fp32) de um
+ * vetor do hospedeiro, atualizando a cópia mestre (caso exista) e os pesos
+ * reduzidos (caso a camada utilize um formato reduzido).
+ *
+ * @param camada Camada.
+ *
+ * @param qtdPesosNeuronio Quantidade de pesos de cada neurônio.
+ *
+ * @param h_W Vetor ("row-major") com os novos pesos.
+ */
+void Camada_definirPesosHospedeiro(const Camada * camada,
+                                   int qtdPesosNeuronio,
+                                   const float * h_W);
+
+/**
+ * Método que aloca um contexto de execução para a rede, com os vetores de
+ * ativação, derivada e erro retropropagado de cada camada alocados no
+ * dispositivo acelerador e o espaço de trabalho da inferência de baixa
+ * latência.
+ *
+ * @param pm Perceptron do qual o contexto será utilizado.
+ *
+ * @return Referência para o contexto alocado.
+ */
+ContextoExecucao *
+ContextoExecucao_inicializar(const PerceptronMulticamadas * pm);
+
+/**
+ * Método que desaloca um contexto de execução.
+ *
+ * @param contexto Contexto a ser desalocado.
+ */
+void ContextoExecucao_desalocar(ContextoExecucao * contexto);
+
+/**
+ * Método que descarta a soma dos pesos da primeira camada mantida pelo
+ * contexto, fazendo com que a mesma seja recalculada na próxima ativação com
+ * amostras brutas. Deve ser chamado sempre que os pesos da primeira camada
+ * forem modificados sem o contexto (por exemplo, ao aplicar uma máscara de
+ * poda ou copiar os parâmetros de um arquivo) enquanto o mesmo for utilizado.
+ *
+ * @param contexto Contexto de execução.
+ */
+void ContextoExecucao_invalidarSomaPesos(ContextoExecucao * contexto);
+
+/**
+ * Método que adiciona a camada de "embedding" à frente da primeira camada
+ * da rede, com a tabela inicializada aleatoriamente. A entrada da primeira
+ * camada passa a ser os "qtdAtributos" vetores concatenados seguidos dos
+ * "qtdNeuroniosEntrada - qtdAtributos * dimensao" atributos densos. Os
+ * contextos devem ser inicializados após a adição da camada.
+ *
+ * @param pm Referência para Perceptron Multicamadas.
+ *
+ * @param qtdCategorias Quantidade de categorias (linhas da tabela).
+ *
+ * @param dimensao Dimensão dos vetores.
+ *
+ * @param qtdAtributos Quantidade de atributos categóricos por amostra.
+ *
+ * @return Verdadeiro caso a camada tenha sido adicionada, ou falso caso os
+ *         vetores não caibam na entrada da rede ou a rede já possua a
+ *         camada.
+ */
+bool PerceptronMulticamadas_adicionarEmbedding(PerceptronMulticamadas * pm,
+                                               int qtdCategorias,
+                                               int dimensao,
+                                               int qtdAtributos);
+
+/**
+ * Método que monta a entrada da primeira camada a partir de uma amostra
+ * categórica, copiando a linha da tabela de cada atributo e, em seguida,
+ * os atributos densos.
+ *
+ * @param camada Camada de "embedding".
+ *
+ * @param d_ids Identificadores dos atributos categóricos (no dispositivo
+ *              acelerador, entre 0 e "qtdCategorias - 1").
+ *
+ * @param d_densos Atributos densos (no dispositivo acelerador).
+ *
+ * @param qtdNeuroniosEntrada Tamanho da entrada da primeira camada.
+ *
+ * @param d_entrada Vetor (no dispositivo acelerador) onde será montada a
+ *                  entrada.
+ */
+void CamadaEmbedding_montarEntrada(const CamadaEmbedding camada,
+                                   const int * d_ids,
+                                   const float * d_densos,
+                                   int qtdNeuroniosEntrada,
+                                   float * d_entrada);
+
+/**
+ * Método que atualiza apenas as linhas da tabela selecionadas pela amostra,
+ * com o gradiente da entrada da primeira camada (pesos da primeira camada
+ * multiplicados pelo erro retropropagado dos seus neurônios) e o mesmo
+ * otimizador das camadas. Deve ser chamado antes da atualização dos pesos
+ * da primeira camada. Os gradientes dos atributos que selecionam a mesma
+ * linha são somados antes do passo do otimizador. As velocidades e os
+ * momentos das linhas não selecionadas não decaem (atualização
+ * "preguiçosa", como nos otimizadores esparsos).
+ *
+ * @param camada Camada de "embedding".
+ *
+ * @param primeiraCamada Primeira camada da rede.
+ *
+ * @param estado Estado da primeira camada.
+ *
+ * @param d_ids Identificadores dos atributos categóricos da amostra.
+ *
+ * @param qtdNeuroniosEntrada Tamanho da entrada da primeira camada.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param otimizador Parâmetros do otimizador (com as correções dos
+ *                   momentos da atualização atual).
+ */
+void CamadaEmbedding_atualizarLinhas(const CamadaEmbedding camada,
+                                     const Camada primeiraCamada,
+                                     const EstadoCamada estado,
+                                     const int * d_ids,
+                                     int qtdNeuroniosEntrada,
+                                     float taxaAprendizagem,
+                                     const ParametrosOtimizador otimizador);
+
+/**
+ * Método que tem o objetivo de calcular a ativação dos neurônios da primeira
+ * camada.
+ *
+ * A função será deslocada para o dispositivo acelerador utilizando o "paralelismo
+ * de neurônio", onde as iterações serão dividas nas "vector lanes".   
+ *
+ * @param camada Primeira camada.
+ *
+ * @param estado Estado da primeira camada.
+ *
+ * @param d_amostra Amostra sendo apresentada à rede (deve estar no dispositivo
+ *                  acelerador).
+ *
+ * @param qtdNeuroniosEntrada Tamanho da entrada (quantidade de itens da
+ *                            amostra).
+ */
+void Camada_calcularAtivacaoNeuroniosPrimeiraCamada(const Camada camada,
+                                                    const EstadoCamada estado,
+                                                    const float * d_amostra,
+                                                    int qtdNeuroniosEntrada);
+
+/**
+ * Método que tem o objetivo de calcular a ativação dos neurônios de qualquer
+ * camada salvo a primeira.
+ *
+ * A função será deslocada para o dispositivo acelerador utilizando o "paralelismo
+ * de neurônio", onde as iterações serão dividas nas "vector lanes".   
+ *
+ * @param camadaAnterior Camada anterior à camada que se deseja calcular ao
+ *                       ativação dos neurônios.
+ *
+ * @param estadoAnterior Estado da camada anterior.
+ *
+ * @param camada Camada da qual se deseja calcular a ativação dos neurônios.
+ *
+ * @param estado Estado da camada.
+ */
+void Camada_calcularAtivacaoNeuroniosCamada(const Camada camadaAnterior,
+                                            const EstadoCamada estadoAnterior,
+                                            const Camada camada,
+                                            const EstadoCamada estado);
+
+/**
+ * Método que realizar o cálculo do erro retropropagado dos neurônios de uma
+ * camada da rede salvo a última.
+ *
+ * @param camada Camada da qual se deseja calcular o erro retropropagado dos
+ *               neurônios.
+ *
+ * @param estado Estado da camada.
+ *
+ * @param camadaPosterior Camada posterior à camada que se deseja calcular o
+ *                        o erro retropropagado dos neurônios.
+ *
+ * @param estadoPosterior Estado da camada posterior.
+ */
+void Camada_calcularErroRpropNeuroniosCamada(const Camada camada,
+                                             const EstadoCamada estado,
+                                             const Camada camadaPosterior,
+                                             const EstadoCamada estadoPosterior);
+
+/**
+ * Método que realiza o cálculo do erro retropropagado dos neurônios da última
+ * camada.
+ *
+ * Apesar da função ser executada no dispositivo acelerador, sua execução será
+ * sequencial, apenas sendo executada no dispositivo acelerador para que não
+ * seja necessária a transferência de dados entre o dispostivo acelerador e
+ * e o hospedeiro.  
+ *
+ * @param camada Última camada da rede.
+ *
+ * @param estado Estado da última camada.
+ *
+ * @param d_alvo Vetor com os valores desejados para os neurônios desta camada
+ *               (vetor de objetivo), onde a mesma deve estar alocada no 
+ *               dispositivo acelerador.
+ *
+ * @param d_erroPadrao Variável do dispositivo acelerador onde será armazenado
+ *                     o erro para o padrão apresentado à rede. 
+ */
+void Camada_calcularErroRpropNeuroniosUltimaCamada(const Camada camada,
+                                                   const EstadoCamada estado,
+						   const float * d_alvo,
+						   float * d_erroPadrao);
+
+/**
+ * Método que calcula a ativação dos neurônios da primeira camada para uma
+ * amostra esparsa, percorrendo apenas os pesos das entradas não nulas
+ * (O(qtdNaoNulos) por neurônio em vez de O(qtdNeuroniosEntrada)).
+ *
+ * @param camada Primeira camada.
+ *
+ * @param estado Estado da primeira camada.
+ *
+ * @param d_indices Índices dos valores não nulos da amostra (devem estar
+ *                  no dispositivo acelerador).
+ *
+ * @param d_valores Valores não nulos da amostra (devem estar no
+ *                  dispositivo acelerador).
+ *
+ * @param qtdNaoNulos Quantidade de valores não nulos da amostra.
+ *
+ * @param qtdNeuroniosEntrada Tamanho da entrada (quantidade de itens da
+ *                            amostra densa).
+ */
+void Camada_calcularAtivacaoPrimeiraCamadaEsparsa(const Camada camada,
+                                                  const EstadoCamada estado,
+                                                  const int * d_indices,
+                                                  const float * d_valores,
+                                                  int qtdNaoNulos,
+                                                  int qtdNeuroniosEntrada);
+
+/**
+ * Método que calcula a ativação dos neurônios da primeira camada para uma
+ * amostra bruta (inteiros ou fp16), com a normalização incorporada ao
+ * cálculo: com a mesma escala para todos os itens, "soma(W * (x * escala +
+ * deslocamento)) = escala * soma(W * x) + deslocamento * soma(W)"; com a
+ * escala de cada item, cada item é convertido durante o produto escalar.
+ * Em ambos os casos a amostra normalizada não é armazenada.
+ *
+ * @param camada Primeira camada.
+ *
+ * @param estado Estado da primeira camada.
+ *
+ * @param d_amostraBruta Amostra bruta (no dispositivo acelerador).
+ *
+ * @param tipoAmostra Tipo da amostra ("AmostraUint8", "AmostraUint16" ou
+ *                    "AmostraFP16").
+ *
+ * @param escala Escala da normalização.
+ *
+ * @param deslocamento Deslocamento da normalização.
+ *
+ * @param d_escalas Escala de cada item (no dispositivo acelerador), ou NULO
+ *                  para utilizar "escala" em todos os itens.
+ *
+ * @param d_deslocamentos Deslocamento de cada item, ou NULO (deve ser NULO
+ *                        se, e somente se, "d_escalas" for NULO).
+ *
+ * @param d_somaPesos Soma dos pesos de cada neurônio já calculada (no
+ *                    dispositivo acelerador), ou NULO para somar os pesos
+ *                    junto com o produto escalar. Ignorada quando
+ *                    "d_escalas" não for NULO.
+ *
+ * @param qtdNeuroniosEntrada Tamanho da entrada (quantidade de itens da
+ *                            amostra).
+ */
+void Camada_calcularAtivacaoPrimeiraCamadaBruta(const Camada camada,
+                                                const EstadoCamada estado,
+                                                const void * d_amostraBruta,
+                                                int tipoAmostra,
+                                                float escala,
+                                                float deslocamento,
+                                                const float * d_escalas,
+                                                const float * d_deslocamentos,
+                                                const float * d_somaPesos,
+                                                int qtdNeuroniosEntrada);
+
+/**
+ * Método que atualiza os pesos dos neurônios da primeira camada.
+ * 
+ * A função será deslocada para o dispositivo acelerador utilizando o "paralelismo
+ * de neurônio", onde as iterações serão dividas nas "vector lanes".   
+ *
+ * @param camada Primeira camada.
+ *
+ * @param estado Estado da primeira camada.
+ *
+ * @param d_amostra Amostra (deve estar alocada no dispositivo acelerador).
  *
  * @param qtdNeuroniosEntrada Tamanho da entrada (quantidade de itens da
  *                            amostra).
  *
  * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param otimizador Parâmetros do otimizador (as velocidades são as da
+ *                   camada).
  */
 void Camada_atualizarPesosNeuroniosPrimeiraCamada(const Camada camada,
+                                                  const EstadoCamada estado,
                                                   const float * d_amostra,
                                                   int qtdNeuroniosEntrada,
-                                                  float taxaAprendizagem);
+                                                  float taxaAprendizagem,
+                                                  const ParametrosOtimizador
+                                                  otimizador);
+
+/**
+ * Método que atualiza os pesos dos neurônios da primeira camada para uma
+ * amostra esparsa. Como o gradiente dos pesos das entradas nulas é nulo,
+ * apenas os pesos das entradas não nulas são atualizados.
+ *
+ * @param camada Primeira camada.
+ *
+ * @param estado Estado da primeira camada.
+ *
+ * @param d_indices Índices dos valores não nulos da amostra (devem estar
+ *                  no dispositivo acelerador).
+ *
+ * @param d_valores Valores não nulos da amostra (devem estar no
+ *                  dispositivo acelerador).
+ *
+ * @param qtdNaoNulos Quantidade de valores não nulos da amostra.
+ *
+ * @param qtdNeuroniosEntrada Tamanho da entrada (quantidade de itens da
+ *                            amostra densa).
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param otimizador Parâmetros do otimizador (as velocidades são as da
+ *                   camada).
+ */
+void Camada_atualizarPesosPrimeiraCamadaEsparsa(const Camada camada,
+                                                const EstadoCamada estado,
+                                                const int * d_indices,
+                                                const float * d_valores,
+                                                int qtdNaoNulos,
+                                                int qtdNeuroniosEntrada,
+                                                float taxaAprendizagem,
+                                                const ParametrosOtimizador
+                                                otimizador);
+
+/**
+ * Método que atualiza os pesos dos neurônios da primeira camada para uma
+ * amostra bruta (inteiros ou fp16), normalizando cada item durante a
+ * atualização.
+ *
+ * @param camada Primeira camada.
+ *
+ * @param estado Estado da primeira camada.
+ *
+ * @param d_amostraBruta Amostra bruta (no dispositivo acelerador).
+ *
+ * @param tipoAmostra Tipo da amostra ("AmostraUint8", "AmostraUint16" ou
+ *                    "AmostraFP16").
+ *
+ * @param escala Escala da normalização.
+ *
+ * @param deslocamento Deslocamento da normalização.
+ *
+ * @param d_escalas Escala de cada item (no dispositivo acelerador), ou NULO
+ *                  para utilizar "escala" em todos os itens.
+ *
+ * @param d_deslocamentos Deslocamento de cada item, ou NULO (deve ser NULO
+ *                        se, e somente se, "d_escalas" for NULO).
+ *
+ * @param qtdNeuroniosEntrada Tamanho da entrada (quantidade de itens da
+ *                            amostra).
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param otimizador Parâmetros do otimizador (as velocidades são as da
+ *                   camada).
+ *
+ * @param d_somaPesos Vetor (no dispositivo acelerador) onde será armazenada
+ *                    a soma dos pesos atualizados de cada neurônio, somados
+ *                    durante a própria atualização, ou NULO.
+ */
+void Camada_atualizarPesosPrimeiraCamadaBruta(const Camada camada,
+                                              const EstadoCamada estado,
+                                              const void * d_amostraBruta,
+                                              int tipoAmostra,
+                                              float escala,
+                                              float deslocamento,
+                                              const float * d_escalas,
+                                              const float * d_deslocamentos,
+                                              int qtdNeuroniosEntrada,
+                                              float taxaAprendizagem,
+                                              const ParametrosOtimizador
+                                              otimizador,
+                                              float * d_somaPesos);
 
 /**
  * Método que atualiza os pesos dos neurônios de uma camada da rede salvo a
@@ -349,27 +1316,326 @@ void Camada_atualizarPesosNeuroniosPrimeiraCamada(const Camada camada,
  * A função será deslocada para o dispositivo acelerador utilizando o "paralelismo
  * de neurônio", onde as iterações serão dividas nas "vector lanes".   
  *
- * @param camadaAnterior Camada anterior à camada da qual se deseja atualizar
- *                       os pesos dos neurônios.
+ * @param camadaAnterior Camada anterior à camada da qual se deseja atualizar
+ *                       os pesos dos neurônios.
+ *
+ * @param estadoAnterior Estado da camada anterior.
+ *
+ * @param camada Camada da qual se deseja atualizar os pesos dos neurônios.
+ *
+ * @param estado Estado da camada.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param otimizador Parâmetros do otimizador (as velocidades são as da
+ *                   camada).
+ */
+void Camada_atualizarPesosNeuroniosCamada(const Camada camadaAnterior,
+                                          const EstadoCamada estadoAnterior,
+                                          const Camada camada,
+                                          const EstadoCamada estado,
+                                          float taxaAprendizagem,
+                                          const ParametrosOtimizador
+                                          otimizador);
+
+/**
+ * Método que realiza alimentação da rede (feedfoward) com amostra de
+ * forma paralela no dispositivo acelerador.
+ *
+ * A saída da rede ficará no vetor de ativação do estado da última camada
+ * do contexto. Várias threads podem alimentar a mesma rede ao mesmo tempo,
+ * desde que cada uma utilize o seu próprio contexto.
+ *
+ * @param pm Referência para Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução onde serão armazenadas as ativações.
+ *
+ * @param d_amostra Vetor da amostra alocado no dispositivo acelerador.
+ */
+void PerceptronMulticamadas_feedfoward(PerceptronMulticamadas * pm,
+                                       ContextoExecucao * contexto,
+                                       const float * d_amostra);
+
+/**
+ * Método que realiza alimentação da rede (feedfoward) com a amostra de um
+ * padrão, utilizando a primeira camada densa ou esparsa, ou montando a
+ * entrada com a camada de "embedding", de acordo com o tipo da amostra.
+ *
+ * @param pm Referência para Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução onde serão armazenadas as ativações.
+ *
+ * @param padrao Padrão com a amostra (densa ou esparsa).
+ */
+void PerceptronMulticamadas_feedfowardPadrao(PerceptronMulticamadas * pm,
+                                             ContextoExecucao * contexto,
+                                             const PadraoTreinamento * padrao);
+
+/**
+ * Método que calcula a ativação dos neurônios de uma camada para um lote
+ * de amostras (produto matriz-matriz entre as entradas e os pesos),
+ * onde cada "gang" processa uma amostra e as "vector lanes" os neurônios.
+ *
+ * @param camada Camada da qual se deseja calcular a ativação dos neurônios.
+ *
+ * @param d_entradaLote Matriz (amostra x entrada) "row-major" com as
+ *                      entradas da camada (deve ser acessível pelo
+ *                      dispositivo acelerador).
+ *
+ * @param qtdNeuroniosEntrada Quantidade de entradas da camada.
+ *
+ * @param passoEntrada Distância (em quantidade de floats) entre o início
+ *                     de duas amostras consecutivas em "d_entradaLote"
+ *                     (no mínimo "qtdNeuroniosEntrada").
+ *
+ * @param d_saidaLote Matriz (amostra x neurônio) "row-major" onde será
+ *                    armazenada a ativação dos neurônios (deve ser
+ *                    acessível pelo dispositivo acelerador).
+ *
+ * @param passoSaida Distância (em quantidade de floats) entre o início
+ *                   de duas saídas consecutivas em "d_saidaLote" (no
+ *                   mínimo a quantidade de neurônios da camada).
+ *
+ * @param qtdAmostras Quantidade de amostras do lote.
+ */
+void Camada_calcularAtivacaoNeuroniosLote(const Camada camada,
+                                          const float * d_entradaLote,
+                                          int qtdNeuroniosEntrada,
+                                          int passoEntrada,
+                                          float * d_saidaLote,
+                                          int passoSaida,
+                                          int qtdAmostras);
+
+/**
+ * Método que calcula a ativação dos neurônios de uma camada para um lote
+ * de amostras (veja "Camada_calcularAtivacaoNeuroniosLote"), onde as
+ * entradas e as saídas podem estar armazenadas em formatos reduzidos (as
+ * somas são sempre acumuladas em fp32).
+ *
+ * @param camada Camada da qual se deseja calcular a ativação dos neurônios.
+ *
+ * @param d_entradaLote Matriz (amostra x entrada) "row-major" com as
+ *                      entradas da camada.
+ *
+ * @param formatoEntrada Formato das entradas (usar a enumeração
+ *                       "FormatosNumericosEnum").
+ *
+ * @param qtdNeuroniosEntrada Quantidade de entradas da camada.
+ *
+ * @param passoEntrada Distância (em quantidade de itens) entre o início de
+ *                     duas amostras consecutivas em "d_entradaLote".
+ *
+ * @param d_saidaLote Matriz (amostra x neurônio) "row-major" onde será
+ *                    armazenada a ativação dos neurônios.
+ *
+ * @param formatoSaida Formato das saídas (usar a enumeração
+ *                     "FormatosNumericosEnum").
+ *
+ * @param passoSaida Distância (em quantidade de itens) entre o início de
+ *                   duas saídas consecutivas em "d_saidaLote".
+ *
+ * @param qtdAmostras Quantidade de amostras do lote.
+ */
+void Camada_calcularAtivacaoNeuroniosLoteFormato(const Camada camada,
+                                                 const void * d_entradaLote,
+                                                 int formatoEntrada,
+                                                 int qtdNeuroniosEntrada,
+                                                 int passoEntrada,
+                                                 void * d_saidaLote,
+                                                 int formatoSaida,
+                                                 int passoSaida,
+                                                 int qtdAmostras);
+
+/**
+ * Método que realiza a inferência de um lote de amostras que já estão
+ * na memória do dispositivo acelerador, sem nenhuma sincronização com o
+ * hospedeiro entre as amostras (as camadas são calculadas para todo o
+ * lote de uma só vez).
+ *
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução.
+ *
+ * @param d_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) "row-major"
+ *                   com as amostras (no dispositivo acelerador).
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param d_saidas Matriz (qtdAmostras x neurônios da última camada)
+ *                 "row-major" onde serão armazenadas as saídas da rede
+ *                 (no dispositivo acelerador).
+ */
+void PerceptronMulticamadas_predizerLote(PerceptronMulticamadas * pm,
+                                         ContextoExecucao * contexto,
+                                         const float * d_entradas,
+                                         int qtdAmostras,
+                                         float * d_saidas);
+
+/**
+ * Método que realiza a inferência de um lote de amostras acessíveis pelo
+ * dispositivo acelerador, onde as amostras e as saídas podem estar
+ * espaçadas (por exemplo, colunas de registros maiores), sem a
+ * necessidade de reempacotar as mesmas.
+ *
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução.
+ *
+ * @param d_entradas Primeiro item da primeira amostra.
+ *
+ * @param passoEntrada Distância (em quantidade de floats) entre o início
+ *                     de duas amostras consecutivas.
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param d_saidas Primeiro item da saída da primeira amostra.
+ *
+ * @param passoSaida Distância (em quantidade de floats) entre o início
+ *                   de duas saídas consecutivas.
+ */
+void PerceptronMulticamadas_predizerLoteEspacado(PerceptronMulticamadas * pm,
+                                                 ContextoExecucao * contexto,
+                                                 const float * d_entradas,
+                                                 int passoEntrada,
+                                                 int qtdAmostras,
+                                                 float * d_saidas,
+                                                 int passoSaida);
+
+/**
+ * Método que registra (fixa e mapeia no espaço de endereçamento do
+ * dispositivo acelerador) uma região de memória do hospedeiro que já
+ * pertence ao chamador (ex: um "buffer" de recepção da rede ou um arquivo
+ * mapeado com "mmap"), permitindo que a mesma seja lida/escrita
+ * diretamente pelas funções de inferência sem cópia.
+ *
+ * O registro é custoso, portanto deve ser feito uma única vez para a
+ * região, e não a cada inferência. Regiões mapeadas apenas para leitura
+ * devem ser mapeadas com escrita permitida (ex: MAP_PRIVATE com
+ * PROT_WRITE), pois o registro exige acesso de escrita às páginas.
+ *
+ * @param h_memoria Início da região.
+ *
+ * @param qtdBytes Tamanho da região em bytes.
+ *
+ * @return Verdadeiro caso a região tenha sido registrada com sucesso.
+ */
+bool PerceptronMulticamadas_registrarMemoria(void * h_memoria,
+                                             size_t qtdBytes);
+
+/**
+ * Método que desfaz o registro de uma região de memória registrada por
+ * "PerceptronMulticamadas_registrarMemoria".
+ *
+ * @param h_memoria Início da região.
+ */
+void PerceptronMulticamadas_desregistrarMemoria(void * h_memoria);
+
+/**
+ * Método que realiza a inferência de um lote de amostras lendo as mesmas
+ * diretamente da memória do hospedeiro do chamador e escrevendo as saídas
+ * diretamente na memória do chamador, sem nenhuma cópia intermediária (o
+ * dispositivo acelerador acessa a memória do hospedeiro pelo barramento).
+ *
+ * As regiões de entrada e saída devem estar registradas através de
+ * "PerceptronMulticamadas_registrarMemoria" (ou alocadas com
+ * "cudaHostAlloc" com a opção "cudaHostAllocMapped"). Requisitos de
+ * alinhamento:
+ *   - "h_entradas" e "h_saidas" devem estar alinhados a 4 bytes (float);
+ *   - para o melhor desempenho, o início de cada amostra (ou seja,
+ *     "h_entradas" e "passoEntrada * sizeof(float)") deve ser múltiplo de
+ *     128 bytes, para que os acessos pelo barramento sejam agrupados.
+ *
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução.
+ *
+ * @param h_entradas Primeiro item da primeira amostra.
+ *
+ * @param passoEntrada Distância (em quantidade de floats) entre o início
+ *                     de duas amostras consecutivas (permite ler colunas
+ *                     de registros maiores sem reempacotar os mesmos).
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param h_saidas Primeiro item da saída da primeira amostra.
+ *
+ * @param passoSaida Distância (em quantidade de floats) entre o início
+ *                   de duas saídas consecutivas.
+ *
+ * @return Verdadeiro caso a inferência tenha sido realizada, ou falso caso
+ *         as regiões não estejam registradas.
+ */
+bool PerceptronMulticamadas_predizerSemCopia(PerceptronMulticamadas * pm,
+                                             ContextoExecucao * contexto,
+                                             const float * h_entradas,
+                                             int passoEntrada,
+                                             int qtdAmostras,
+                                             float * h_saidas,
+                                             int passoSaida);
+
+/**
+ * Método que realiza a inferência de um lote de amostras que estão na
+ * memória do hospedeiro, copiando as amostras para o dispositivo
+ * acelerador e as saídas de volta a cada TAM_MAX_LOTE_INFERENCIA amostras.
+ * Quando o lote possui uma única amostra, é utilizada a inferência de baixa
+ * latência ("PerceptronMulticamadas_predizerAmostra").
+ *
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução.
+ *
+ * @param h_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) "row-major"
+ *                   com as amostras.
+ *
+ * @param qtdAmostras Quantidade de amostras.
  *
- * @param camada Camada da qual se deseja atualizar os pesos dos neurônios.
+ * @param h_saidas Matriz (qtdAmostras x neurônios da última camada)
+ *                 "row-major" onde serão armazenadas as saídas da rede.
+ */
+void PerceptronMulticamadas_predizer(PerceptronMulticamadas * pm,
+                                     ContextoExecucao * contexto,
+                                     const float * h_entradas,
+                                     int qtdAmostras,
+                                     float * h_saidas);
+
+/**
+ * Método que aloca o espaço de trabalho da inferência de baixa latência no
+ * contexto (caso ainda não tenha sido alocado), para que as chamadas de
+ * "PerceptronMulticamadas_predizerAmostra" não realizem nenhuma alocação
+ * (chamado por "ContextoExecucao_inicializar"). Caso já tenha sido alocado,
+ * apenas reenvia as tabelas das camadas cujos pesos foram realocados ou
+ * convertidos desde a última inferência.
  *
- * @param taxaAprendizagem Taxa de aprendizagem.
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução.
  */
-void Camada_atualizarPesosNeuroniosCamada(const Camada camadaAnterior,
-                                          const Camada camada,
-                                          float taxaAprendizagem);
+void PerceptronMulticamadas_prepararLatencia(const PerceptronMulticamadas * pm,
+                                             ContextoExecucao * contexto);
 
 /**
- * Método que realiza alimentação da rede (feedfoward) com amostra de
- * forma paralela no dispositivo acelerador.
+ * Método que realiza a inferência de uma única amostra com a menor latência
+ * possível: todas as camadas são calculadas em um único "kernel" com uma
+ * única "gang" (as "vector lanes" dividem os neurônios de cada camada), e a
+ * amostra e a saída são trocadas através de memória mapeada do hospedeiro,
+ * sem cópias explícitas. Nenhuma alocação é realizada (o espaço de trabalho
+ * é alocado por "ContextoExecucao_inicializar").
  *
- * @param pm Referência para Perceptron Multicamadas.
+ * Utilizada automaticamente por "PerceptronMulticamadas_predizer" quando o
+ * lote possui uma única amostra.
  *
- * @param d_amostra Vetor da amostra alocado no dispositivo acelerador.
+ * @param pm Referência para o Perceptron Multicamadas.
+ *
+ * @param contexto Contexto de execução (um por thread).
+ *
+ * @param h_amostra Amostra (qtdNeuroniosEntrada itens).
+ *
+ * @param h_saida Vetor onde será armazenada a saída da rede.
  */
-void PerceptronMulticamadas_feedfoward(PerceptronMulticamadas * pm,
-                                       const float * d_amostra);
+void PerceptronMulticamadas_predizerAmostra(PerceptronMulticamadas * pm,
+                                            ContextoExecucao * contexto,
+                                            const float * h_amostra,
+                                            float * h_saida);
 
 /**
  * Método que realiza o "backpropagation" da rede de forma paralela no
@@ -400,15 +1666,184 @@ PerceptronMulticamadas_backpropagation(PerceptronMulticamadas * pm,
 				       float erroDesejado,
 				       bool gerarHistorico);
 
+/**
+ * Método que realiza o "backpropagation" da rede (veja
+ * "PerceptronMulticamadas_backpropagation") salvando "checkpoints"
+ * periódicos do treinamento.
+ *
+ * A cada "checkpoint" os pesos, os bias e o estado do otimizador são
+ * copiados para um de dois "buffers" do hospedeiro e escritos no disco por
+ * uma thread em segundo plano, portanto o treinamento nunca aguarda a
+ * escrita do arquivo. Ao final do treinamento é realizado um último
+ * "checkpoint". O otimizador deve ser definido antes da chamada (o
+ * "checkpoint" só é retomado com o mesmo tipo de otimizador). Um
+ * treinamento retomado sempre realiza ao menos uma época.
+ *
+ * @param pm Perceptron.
+ *
+ * @param padroes Padrões para treinamento.
+ *
+ * @param qtdPadroesTreinamento Quantidade de padrões de treinamento.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param erroDesejado Condição de parada para o treinamento
+ *                     da rede.
+ *
+ * @param gerarHistorico Se será necessário gerar o histórico ou não.
+ *
+ * @param config Configuração dos "checkpoints" (NULO para desativar).
+ *
+ * @return Histórico do treinamento (incluindo as épocas retomadas).
+ */
+HistoricoTreinamento *
+PerceptronMulticamadas_backpropagationCheckpoint(PerceptronMulticamadas * pm,
+                                                 PadraoTreinamento * padroes,
+                                                 int qtdPadroesTreinamento,
+                                                 float taxaAprendizagem,
+                                                 float erroDesejado,
+                                                 bool gerarHistorico,
+                                                 const ConfigCheckpoint *
+                                                 config);
+
+/**
+ * Método que apresenta um padrão de treinamento à rede (feedfoward, cálculo
+ * do erro e atualização dos pesos), ou seja, um passo do gradiente
+ * descendente estocástico.
+ *
+ * @param pm Perceptron.
+ *
+ * @param contexto Contexto de execução.
+ *
+ * @param padrao Padrão de treinamento a ser apresentado à rede.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @return Erro do padrão apresentado à rede.
+ */
+float __treinarPadrao(PerceptronMulticamadas * pm,
+                      ContextoExecucao * contexto,
+                      const PadraoTreinamento * padrao,
+                      float taxaAprendizagem);
+
+/**
+ * Método que realiza uma época de treinamento no modo "Hogwild", onde
+ * "qtdThreads" threads apresentam à rede, ao mesmo tempo, faixas disjuntas
+ * dos padrões de treinamento, atualizando os pesos e os bias compartilhados
+ * sem nenhum tipo de trava (as atualizações concorrentes podem se sobrepor,
+ * o que é aceitável para o gradiente descendente estocástico). Cada thread
+ * utiliza o seu próprio contexto de execução.
+ *
+ * Os "kernels" de todas as threads são disparados de forma síncrona na
+ * fila padrão do dispositivo acelerador (e o erro de cada padrão é copiado
+ * de forma bloqueante), portanto são serializados no dispositivo: apenas o
+ * trabalho do hospedeiro é realizado em paralelo.
+ *
+ * @param pm Perceptron.
+ *
+ * @param contextos Vetor com os contextos de execução (um por thread).
+ *
+ * @param padroes Padrões para treinamento.
+ *
+ * @param ordemPadroes Ordem em que os padrões são apresentados (dividida em
+ *                     faixas entre as threads), ou NULO para a ordem do
+ *                     vetor.
+ *
+ * @param qtdPadroesTreinamento Quantidade de padrões de treinamento.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param qtdThreads Quantidade de threads.
+ *
+ * @return Erro MSE da época.
+ */
+float PerceptronMulticamadas_treinarEpocaHogwild(PerceptronMulticamadas * pm,
+                                                 ContextoExecucao ** contextos,
+                                                 PadraoTreinamento * padroes,
+                                                 const int * ordemPadroes,
+                                                 int qtdPadroesTreinamento,
+                                                 float taxaAprendizagem,
+                                                 int qtdThreads);
+
+/**
+ * Método que realiza o "backpropagation" da rede no modo "Hogwild" (veja
+ * "PerceptronMulticamadas_treinarEpocaHogwild") até que o erro da rede seja
+ * menor ou igual ao erro desejado OU o treinamento atinga a quantidade
+ * máxima de epocas (QTD_MAX_EPOCAS). A ordem dos padrões de cada época é
+ * gerada com a configuração de embaralhamento da rede (veja
+ * "ConfigEmbaralhamento_ordenarEpoca").
+ *
+ * @param pm Perceptron.
+ *
+ * @param padroes Padrões para treinamento.
+ *
+ * @param qtdPadroesTreinamento Quantidade de padrões de treinamento.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param erroDesejado Condição de parada para o treinamento
+ *                     da rede.
+ *
+ * @param qtdThreads Quantidade de threads que irão treinar a rede.
+ *
+ * @param gerarHistorico Se será necessário gerar o histórico ou não.
+ *
+ * @return Histórico do treinamento.
+ */
+HistoricoTreinamento *
+PerceptronMulticamadas_backpropagationHogwild(PerceptronMulticamadas * pm,
+                                              PadraoTreinamento * padroes,
+                                              int qtdPadroesTreinamento,
+                                              float taxaAprendizagem,
+                                              float erroDesejado,
+                                              int qtdThreads,
+                                              bool gerarHistorico);
+
 /**
  * Método que realiza o embaralhamento de um vetor de inteiros através
- * do método de Fisher-Yates (moderno).
+ * do método de Fisher-Yates (moderno), onde todas as permutações são
+ * igualmente prováveis.
+ *
+ * @param v Vetor a ser embaralhado.
+ *
+ * @param n Quantidade de itens do vetor.
+ *
+ * @param gerador Gerador de números pseudoaleatórios.
+ */
+void embaralhamentoFisherYates(int * v, int n, GeradorAleatorio * gerador);
+
+/**
+ * Método que embaralha um vetor de inteiros em blocos: os blocos de
+ * "tamBloco" itens consecutivos são colocados em ordem aleatória e os
+ * itens de cada bloco são embaralhados (Fisher-Yates).
  *
  * @param v Vetor a ser embaralhado.
  *
  * @param n Quantidade de itens do vetor.
+ *
+ * @param tamBloco Quantidade de itens por bloco (o último pode ser menor).
+ *
+ * @param gerador Gerador de números pseudoaleatórios.
+ */
+void embaralhamentoBlocos(int * v, int n, int tamBloco,
+                          GeradorAleatorio * gerador);
+
+/**
+ * Método que gera a ordem em que os padrões são apresentados à rede em uma
+ * época do treinamento.
+ *
+ * @param config Configuração do embaralhamento.
+ *
+ * @param ordem Vetor onde será armazenada a ordem (índices dos padrões).
+ *
+ * @param qtdPadroes Quantidade de padrões.
+ *
+ * @param epoca Número da época (a partir de 0).
  */
-void embaralhamentoFisherYates(int * v, int n);
+void ConfigEmbaralhamento_ordenarEpoca(const ConfigEmbaralhamento * config,
+                                       int * ordem,
+                                       int qtdPadroes,
+                                       int epoca);
 
 /**
  * Método que realiza a normalização de um vetor através do método "min-max".
@@ -423,10 +1858,44 @@ void embaralhamentoFisherYates(int * v, int n);
  */
 void normalizacaoMinMax(float * v, int n, float min, float max);
 
+/**
+ * Método que mapeia um atributo (token de texto ou campo "chave=valor") para
+ * um item de uma entrada de tamanho fixo através do "hashing trick" com
+ * sinal: um hash de 64 bits (FNV-1a com o finalizador do MurmurHash3) do
+ * atributo define o índice (resto da divisão pelo tamanho da entrada) e o
+ * sinal (bit mais significativo), que faz as colisões se cancelarem em
+ * média.
+ *
+ * @param atributo Texto do atributo.
+ *
+ * @param tamanho Quantidade de caracteres do atributo.
+ *
+ * @param qtdItensAmostra Tamanho da entrada.
+ *
+ * @param sinal Onde será armazenado o sinal (1 ou -1) do atributo.
+ *
+ * @return Índice do atributo (entre 0 e "qtdItensAmostra - 1").
+ */
+int hashAtributo(const char * atributo, size_t tamanho, int qtdItensAmostra,
+                 float * sinal);
+
 /***********************
  * Funções de ativação *
  ***********************/
 
+/**
+ * Método que aplica uma das funções de ativação da rede.
+ *
+ * @param z Parâmetro para o cálculo da função de ativação.
+ *
+ * @param funcaoAtivacao Função de ativação (usar a enumeração
+ *                       "FuncoesAtivacaoEnum").
+ *
+ * @return Valor do cálculo da função de ativação.
+ */
+#pragma acc routine seq
+float aplicarFuncaoAtivacao(float z, int funcaoAtivacao);
+
 /**
  * Método que realiza o cálculo da função degrau.
  *
@@ -434,6 +1903,7 @@ void normalizacaoMinMax(float * v, int n, float min, float max);
  *
  * @return Valor do cálculo da função degrau.
  */
+#pragma acc routine seq
 float funcaoDegrau(float z);
 
 /**
@@ -444,6 +1914,7 @@ float funcaoDegrau(float z);
  *
  * @return Valor do cálculo da derivada da função degrau.
  */
+#pragma acc routine seq
 float derivadaFuncaoDegrau(float valDegrau);
 
 /**
@@ -453,6 +1924,7 @@ float derivadaFuncaoDegrau(float valDegrau);
  *
  * @return Valor do cálculo da função sigmóide.
  */
+#pragma acc routine seq
 float funcaoSigmoide(float z);
 
 /**
@@ -463,6 +1935,7 @@ float funcaoSigmoide(float z);
  *
  * @return Valor do cálculo da derivada da função sigmóide.
  */
+#pragma acc routine seq
 float derivadaFuncaoSigmoide(float valSigmoide);
 
 /**
@@ -472,6 +1945,7 @@ float derivadaFuncaoSigmoide(float valSigmoide);
  *
  * @return Valor do cálculo da função tangente hiperbólica.
  */
+#pragma acc routine seq
 float funcaoTangHiperbolica(float z);
 
 /**
@@ -482,8 +1956,111 @@ float funcaoTangHiperbolica(float z);
  *
  * @return Valor do cálculo da derivada da função tangente hiperbólica.
  */
+#pragma acc routine seq
 float derivadaFuncaoTangHiperbolica(float valTangHiperbolica);
 
+/***************************************
+ * Conversões entre formatos numéricos *
+ ***************************************/
+
+/**
+ * Método que converte um float para bf16 (arredondamento para o mais
+ * próximo, empates para o par).
+ *
+ * @param valor Valor a ser convertido.
+ *
+ * @return Bits do valor em bf16.
+ */
+#pragma acc routine seq
+uint16_t converterFloatBF16(float valor);
+
+/**
+ * Método que converte um valor bf16 para float (conversão exata).
+ *
+ * @param valor Bits do valor em bf16.
+ *
+ * @return Valor convertido.
+ */
+#pragma acc routine seq
+float converterBF16Float(uint16_t valor);
+
+/**
+ * Método que converte um float para fp16 (arredondamento para o mais
+ * próximo, empates para o par), incluindo os valores subnormais. Valores
+ * maiores que o maior fp16 são convertidos para infinito.
+ *
+ * @param valor Valor a ser convertido.
+ *
+ * @return Bits do valor em fp16.
+ */
+#pragma acc routine seq
+uint16_t converterFloatFP16(float valor);
+
+/**
+ * Método que converte um valor fp16 para float (conversão exata).
+ *
+ * @param valor Bits do valor em fp16.
+ *
+ * @return Valor convertido.
+ */
+#pragma acc routine seq
+float converterFP16Float(uint16_t valor);
+
+/**
+ * Método que lê o item "i-ésimo" de um vetor armazenado em um dos formatos
+ * numéricos, como float.
+ *
+ * @param vFP32 Vetor, caso o formato seja fp32.
+ *
+ * @param vReduzido Vetor, caso o formato seja bf16 ou fp16.
+ *
+ * @param formato Formato do vetor (usar a enumeração
+ *                "FormatosNumericosEnum").
+ *
+ * @param i Índice do item.
+ *
+ * @return Valor do item.
+ */
+#pragma acc routine seq
+float lerValorFormato(const float * vFP32, const uint16_t * vReduzido,
+                      int formato, long i);
+
+/**
+ * Método que escreve um float no item "i-ésimo" de um vetor armazenado em
+ * um dos formatos numéricos (arredondando o mesmo caso necessário).
+ *
+ * @param vFP32 Vetor, caso o formato seja fp32.
+ *
+ * @param vReduzido Vetor, caso o formato seja bf16 ou fp16.
+ *
+ * @param formato Formato do vetor (usar a enumeração
+ *                "FormatosNumericosEnum").
+ *
+ * @param i Índice do item.
+ *
+ * @param valor Valor a ser escrito.
+ */
+#pragma acc routine seq
+void escreverValorFormato(float * vFP32, uint16_t * vReduzido, int formato,
+                          long i, float valor);
+
+/**
+ * Método que lê o item "i-ésimo" de uma amostra bruta (inteiros ou fp16)
+ * como float (sem normalização).
+ *
+ * @param d_amostraBruta Amostra bruta.
+ *
+ * @param tipoAmostra Tipo da amostra ("AmostraUint8", "AmostraUint16" ou
+ *                    "AmostraFP16").
+ *
+ * @param i Índice do item.
+ *
+ * @return Valor do item.
+ */
+#pragma acc routine seq
+float lerItemAmostraBruta(const void * d_amostraBruta, int tipoAmostra,
+                          long i);
+
 /****************************************************************************
  * Funções para carregar os padrões de treinamento de arquivos, calcular    *
  * a corretude de um treinamento anteriormente realizado utilizando padrões *
@@ -526,6 +2103,253 @@ PadraoTreinamento_carregarPadroesArquivo(char * nomeArquivoAmostras,
                                          int qtdItensAlvo,
                                          int qtdPadroes);
 
+/**
+ * Método que carrega os padrões de dois arquivos (no mesmo formato de
+ * "PadraoTreinamento_carregarPadroesArquivo") mantendo as amostras brutas
+ * em inteiros de 8 ou 16 bits, sem normalizá-las: a normalização "min-max"
+ * é realizada pela primeira camada durante o treinamento e a avaliação. As
+ * amostras de todos os padrões são armazenadas em um único bloco do
+ * dispositivo acelerador (1/4 ou 1/2 da memória das amostras em float).
+ *
+ * @param nomeArquivoAmostras Nome do arquivo (com extensão) com as amostras.
+ *
+ * @param nomeArquivoAlvos Nome do arquivo (com extensão) com os objetivos.
+ *
+ * @param menorValAmostra Menor valor presente nas amostras (para normalização).
+ *
+ * @param maiorValAmostra Maior valor presente nas amostras (para normalização).
+ *
+ * @param qtdItensAmostra Quantidade de itens por amostra.
+ *
+ * @param qtdItensAlvo Quantidade de itens por vetor de objetivo.
+ *
+ * @param qtdPadroes Quantidade de padrões nos arquivos.
+ *
+ * @param tipoAmostra Tipo das amostras ("AmostraUint8" ou "AmostraUint16").
+ *                    Valores fora da faixa do tipo são saturados.
+ *
+ * @return Vetor com os padrões carregados ou NULO caso não seja possível
+ *         abrir os arquivos para leitura.
+ */
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesBrutosArquivo(char * nomeArquivoAmostras,
+                                               char * nomeArquivoAlvos,
+                                               float menorValAmostra,
+                                               float maiorValAmostra,
+                                               int qtdItensAmostra,
+                                               int qtdItensAlvo,
+                                               int qtdPadroes,
+                                               int tipoAmostra);
+
+/**
+ * Método que carrega os padrões de dois arquivos (no mesmo formato de
+ * "PadraoTreinamento_carregarPadroesArquivo") quantizando as amostras com
+ * a escala de cada item (atributo), de modo que o conjunto ocupe 1/4
+ * (uint8) ou 1/2 (fp16) da memória das amostras em float.
+ *
+ * Em uint8, cada item é armazenado como "(x - min) / (max - min) * 255",
+ * com o menor e o maior valor do item no arquivo (utilizando os 256 níveis
+ * na faixa de cada item), e em fp16 como "x / max(|x|)". A escala e o
+ * deslocamento de cada item (que também incorporam a normalização
+ * "min-max" com "menorValAmostra" e "maiorValAmostra", como em
+ * "PadraoTreinamento_carregarPadroesArquivo") são aplicados pela primeira
+ * camada durante o produto escalar. O arquivo de amostras é lido duas
+ * vezes (a primeira para encontrar a faixa de cada item), sem manter as
+ * amostras em float na memória.
+ *
+ * @param nomeArquivoAmostras Nome do arquivo (com extensão) com as amostras.
+ *
+ * @param nomeArquivoAlvos Nome do arquivo (com extensão) com os objetivos.
+ *
+ * @param menorValAmostra Menor valor presente nas amostras (para normalização).
+ *
+ * @param maiorValAmostra Maior valor presente nas amostras (para normalização).
+ *
+ * @param qtdItensAmostra Quantidade de itens por amostra.
+ *
+ * @param qtdItensAlvo Quantidade de itens por vetor de objetivo.
+ *
+ * @param qtdPadroes Quantidade de padrões nos arquivos.
+ *
+ * @param tipoAmostra Tipo das amostras ("AmostraUint8" ou "AmostraFP16").
+ *
+ * @return Vetor com os padrões carregados ou NULO caso não seja possível
+ *         abrir os arquivos para leitura.
+ */
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesQuantizadosArquivo(char * nomeArquivoAmostras,
+                                                    char * nomeArquivoAlvos,
+                                                    float menorValAmostra,
+                                                    float maiorValAmostra,
+                                                    int qtdItensAmostra,
+                                                    int qtdItensAlvo,
+                                                    int qtdPadroes,
+                                                    int tipoAmostra);
+
+/**
+ * Método que cria os padrões de previsão de uma série temporal como
+ * janelas deslizantes: o padrão "i-ésimo" tem como amostra os
+ * "tamJanela" valores a partir da posição "i * passo" e como objetivo os
+ * "horizonte" valores seguintes. A série é copiada uma única vez para o
+ * dispositivo acelerador e os padrões apontam para trechos da mesma (as
+ * janelas sobrepostas não são duplicadas), portanto os padrões devem ser
+ * desalocados com "PadraoTreinamento_desalocarJanelasSerie".
+ *
+ * @param h_serie Série temporal (no hospedeiro), já normalizada.
+ *
+ * @param tamSerie Quantidade de valores da série.
+ *
+ * @param tamJanela Quantidade de valores de cada amostra (deve ser igual
+ *                  à quantidade de neurônios de entrada da rede).
+ *
+ * @param horizonte Quantidade de valores de cada objetivo (deve ser igual
+ *                  à quantidade de neurônios da última camada).
+ *
+ * @param passo Distância entre o início de duas janelas consecutivas.
+ *
+ * @param qtdPadroes Variável onde será armazenada a quantidade de padrões
+ *                   criados ("(tamSerie - tamJanela - horizonte) / passo
+ *                   + 1").
+ *
+ * @return Vetor com os padrões criados ou NULO caso a série seja menor que
+ *         uma janela seguida do horizonte.
+ */
+PadraoTreinamento * PadraoTreinamento_criarJanelasSerie(const float * h_serie,
+                                                        long tamSerie,
+                                                        int tamJanela,
+                                                        int horizonte,
+                                                        int passo,
+                                                        int * qtdPadroes);
+
+/**
+ * Método que carrega uma série temporal de um arquivo (um valor por linha
+ * ou valores separados por ';'), normaliza a mesma ("min-max") e cria os
+ * padrões como janelas deslizantes sobre a série (ver
+ * "PadraoTreinamento_criarJanelasSerie").
+ *
+ * @param nomeArquivoSerie Nome do arquivo (com extensão) com a série.
+ *
+ * @param menorValSerie Menor valor presente na série (para normalização).
+ *
+ * @param maiorValSerie Maior valor presente na série (para normalização).
+ *
+ * @param tamJanela Quantidade de valores de cada amostra.
+ *
+ * @param horizonte Quantidade de valores de cada objetivo.
+ *
+ * @param passo Distância entre o início de duas janelas consecutivas.
+ *
+ * @param qtdPadroes Variável onde será armazenada a quantidade de padrões
+ *                   criados.
+ *
+ * @return Vetor com os padrões criados ou NULO caso não seja possível abrir
+ *         o arquivo para leitura ou a série seja menor que uma janela
+ *         seguida do horizonte.
+ */
+PadraoTreinamento *
+PadraoTreinamento_carregarJanelasSerieArquivo(char * nomeArquivoSerie,
+                                              float menorValSerie,
+                                              float maiorValSerie,
+                                              int tamJanela,
+                                              int horizonte,
+                                              int passo,
+                                              int * qtdPadroes);
+
+/**
+ * Método que desaloca os padrões criados como janelas deslizantes sobre uma
+ * série ("PadraoTreinamento_criarJanelasSerie" ou
+ * "PadraoTreinamento_carregarJanelasSerieArquivo"): a série no dispositivo
+ * acelerador, compartilhada por todos os padrões, e o vetor de padrões.
+ *
+ * @param padroes Vetor com os padrões (pode ser NULO).
+ */
+void PadraoTreinamento_desalocarJanelasSerie(PadraoTreinamento * padroes);
+
+/**
+ * Método que carrega padrões com amostras esparsas de dois arquivos para a
+ * memória do dispositivo acelerador. Cada linha do arquivo de amostras
+ * representa uma amostra com apenas os seus itens não nulos, no formato
+ * "indice:valor" separados por ponto e vírgula (ex.: "3:0.5;1047:1"), onde
+ * uma linha vazia é uma amostra nula. Os valores não são normalizados (a
+ * normalização "min-max" tornaria os itens nulos não nulos). O arquivo de
+ * objetivos segue o mesmo formato de "PadraoTreinamento_carregarPadroesArquivo".
+ *
+ * @param nomeArquivoAmostras Nome do arquivo (com extensão) com as amostras
+ *                            esparsas.
+ *
+ * @param nomeArquivoAlvos Nome do arquivo (com extensão) com os objetivos.
+ *
+ * @param qtdItensAmostra Tamanho da entrada (os índices devem estar entre 0
+ *                        e "qtdItensAmostra - 1").
+ *
+ * @param qtdItensAlvo Quantidade de itens por vetor de objetivo.
+ *
+ * @param qtdPadroes Quantidade de padrões nos arquivos.
+ *
+ * @return Vetor com os padrões carregados ou NULO caso não seja possível
+ *         abrir os arquivos para leitura ou algum índice seja inválido.
+ */
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesEsparsosArquivo(char * nomeArquivoAmostras,
+                                                 char * nomeArquivoAlvos,
+                                                 int qtdItensAmostra,
+                                                 int qtdItensAlvo,
+                                                 int qtdPadroes);
+
+/**
+ * Método que carrega padrões a partir de atributos categóricos ou de texto,
+ * transformando cada amostra diretamente em uma amostra esparsa de tamanho
+ * fixo através de "hashAtributo" (sem gerar o "one-hot" denso). Cada linha
+ * do arquivo de amostras possui os atributos separados por ponto e vírgula
+ * ou espaços, onde:
+ *
+ * - "chave=número" soma o número ao item da chave (atributo numérico);
+ * - "chave=texto" soma 1 ao item de "chave=texto" (atributo categórico);
+ * - demais tokens somam 1 ao item do token (ex.: palavras de um texto).
+ *
+ * Os valores de atributos que colidem no mesmo item são somados (com os
+ * seus sinais). O arquivo de objetivos segue o mesmo formato de
+ * "PadraoTreinamento_carregarPadroesArquivo".
+ *
+ * @param nomeArquivoAmostras Nome do arquivo (com extensão) com os
+ *                            atributos das amostras.
+ *
+ * @param nomeArquivoAlvos Nome do arquivo (com extensão) com os objetivos.
+ *
+ * @param qtdItensAmostra Tamanho da entrada (quantidade de itens do
+ *                        "hashing").
+ *
+ * @param qtdItensAlvo Quantidade de itens por vetor de objetivo.
+ *
+ * @param qtdPadroes Quantidade de padrões nos arquivos.
+ *
+ * @return Vetor com os padrões (esparsos) carregados ou NULO caso não seja
+ *         possível abrir os arquivos para leitura.
+ */
+PadraoTreinamento *
+PadraoTreinamento_carregarPadroesHashArquivo(char * nomeArquivoAmostras,
+                                             char * nomeArquivoAlvos,
+                                             int qtdItensAmostra,
+                                             int qtdItensAlvo,
+                                             int qtdPadroes);
+
+/**
+ * Método que calcula o erro de uma saída da rede (metade da soma dos
+ * quadrados das diferenças, o mesmo erro utilizado pelo treinamento) no
+ * dispositivo acelerador. Utilizado pelas formas alternativas da rede
+ * (quantizada, esparsa e etc) para calcular a taxa de acerto.
+ *
+ * @param d_saida Saída da rede (no dispositivo acelerador).
+ *
+ * @param d_alvo Vetor com os valores desejados (no dispositivo acelerador).
+ *
+ * @param qtdNeuroniosSaida Quantidade de neurônios da última camada.
+ *
+ * @return Erro da saída.
+ */
+float calcularErroSaida(const float * d_saida, const float * d_alvo,
+                        int qtdNeuroniosSaida);
+
 /**
  * Método que calcula a taxa de acerto de uma rede Perceptron Multicamdas já
  * treinada utilizando os padrões de teste.
@@ -0,0 +1,511 @@
+#include "poda.h"
+
+/**
+ * Método de comparação de floats para o "qsort".
+ */
+static int __compararFloat(const void * a, const void * b)
+{
+  float x = *(const float *) a;
+  float y = *(const float *) b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Método que retorna a quantidade de pesos de cada neurônio da camada "c".
+ */
+static int __qtdPesosNeuronio(const PerceptronMulticamadas * pm, int c)
+{
+  return (c == 0) ? pm->qtdNeuroniosEntrada : pm->camadas[c - 1]->qtdNeuronios;
+}
+
+MascaraPoda * PerceptronMulticamadas_podar(PerceptronMulticamadas * pm,
+                                           float esparsidade)
+{
+  /* Limitando a esparsidade ao intervalo 0..1. */
+  esparsidade = fminf(fmaxf(esparsidade, 0), 1);
+
+  MascaraPoda * mascara = malloc(sizeof(MascaraPoda));
+  mascara->d_mascaras = malloc(sizeof(uint8_t *) * pm->qtdCamadas);
+  mascara->qtdPesos = malloc(sizeof(size_t) * pm->qtdCamadas);
+  mascara->qtdCamadas = pm->qtdCamadas;
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    int qtdPesosNeuronio = __qtdPesosNeuronio(pm, c);
+    size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+    size_t qtdPodados = (size_t) (esparsidade * qtdPesos);
+
+    float * h_W = malloc(sizeof(float) * qtdPesos);
+    uint8_t * h_mascara = malloc(sizeof(uint8_t) * qtdPesos);
+    Camada_copiarPesosHospedeiro(camada, qtdPesosNeuronio, h_W);
+
+    /* Localizando o limiar: o "qtdPodados-ésimo" menor valor absoluto. */
+    float limiar = -1;
+    if (qtdPodados > 0)
+    {
+      float * h_magnitudes = malloc(sizeof(float) * qtdPesos);
+      for (size_t i = 0; i < qtdPesos; i++)
+      {
+        h_magnitudes[i] = fabsf(h_W[i]);
+      }
+
+      qsort(h_magnitudes, qtdPesos, sizeof(float), __compararFloat);
+      limiar = h_magnitudes[qtdPodados - 1];
+      free(h_magnitudes);
+    }
+
+    /* Podando os pesos abaixo do limiar e, em caso de empate no limiar,
+       apenas os primeiros até atingir exatamente a esparsidade. */
+    size_t qtdAbaixoLimiar = 0;
+    for (size_t i = 0; i < qtdPesos; i++)
+    {
+      if (fabsf(h_W[i]) < limiar)
+      {
+        qtdAbaixoLimiar++;
+      }
+    }
+
+    size_t qtdEmpatesPodar = qtdPodados - qtdAbaixoLimiar;
+    for (size_t i = 0; i < qtdPesos; i++)
+    {
+      float magnitude = fabsf(h_W[i]);
+      bool podar = magnitude < limiar;
+
+      if (!podar && magnitude == limiar && qtdEmpatesPodar > 0)
+      {
+        podar = true;
+        qtdEmpatesPodar--;
+      }
+
+      h_mascara[i] = podar ? 0 : 1;
+      if (podar)
+      {
+        h_W[i] = 0;
+      }
+    }
+
+    /* Atualizando os pesos da camada e copiando a máscara para o
+       dispositivo acelerador. */
+    Camada_definirPesosHospedeiro(camada, qtdPesosNeuronio, h_W);
+
+    cudaMalloc((void **) &mascara->d_mascaras[c], sizeof(uint8_t) * qtdPesos);
+    cudaMemcpy(mascara->d_mascaras[c], h_mascara, sizeof(uint8_t) * qtdPesos,
+               cudaMemcpyHostToDevice);
+    mascara->qtdPesos[c] = qtdPesos;
+
+    free(h_W);
+    free(h_mascara);
+  }
+
+  return mascara;
+}
+
+void MascaraPoda_aplicar(const MascaraPoda * mascara,
+                         PerceptronMulticamadas * pm)
+{
+  for (int c = 0; c < mascara->qtdCamadas; c++)
+  {
+    /* Convertendo as estruturas para variáveis de tipos primitivos para que
+       o OpenACC não tente copiar os vetores. */
+    float * camada_d_W = pm->camadas[c]->d_W;
+    uint16_t * camada_d_Wreduzido = pm->camadas[c]->d_Wreduzido;
+    float * camada_d_velocidadeW = pm->camadas[c]->d_velocidadeW;
+    float * camada_d_segundoMomentoW = pm->camadas[c]->d_segundoMomentoW;
+    bool possuiFP32 = (camada_d_W != NULL);
+    bool possuiReduzido = (camada_d_Wreduzido != NULL);
+    bool possuiVelocidade = (camada_d_velocidadeW != NULL);
+    bool possuiSegundoMomento = (camada_d_segundoMomentoW != NULL);
+    uint8_t * d_mascara = mascara->d_mascaras[c];
+    long qtdPesos = (long) mascara->qtdPesos[c];
+
+    /* Zerando tanto a cópia em fp32 quanto a reduzida (o zero possui a
+       mesma representação em bf16 e fp16) e o estado do otimizador dos
+       pesos podados (para que o momento não os afaste novamente do
+       zero). */
+    #pragma acc parallel loop gang vector vector_length(TAM_VECTOR) \
+    deviceptr(camada_d_W, camada_d_Wreduzido, camada_d_velocidadeW, \
+              camada_d_segundoMomentoW, d_mascara)
+    for (long i = 0; i < qtdPesos; i++)
+    {
+      if (d_mascara[i] == 0)
+      {
+        if (possuiFP32)
+        {
+          camada_d_W[i] = 0;
+        }
+        if (possuiReduzido)
+        {
+          camada_d_Wreduzido[i] = 0;
+        }
+        if (possuiVelocidade)
+        {
+          camada_d_velocidadeW[i] = 0;
+        }
+        if (possuiSegundoMomento)
+        {
+          camada_d_segundoMomentoW[i] = 0;
+        }
+      }
+    }
+  }
+}
+
+void MascaraPoda_desalocar(MascaraPoda * mascara)
+{
+  for (int c = 0; c < mascara->qtdCamadas; c++)
+  {
+    cudaFree(mascara->d_mascaras[c]);
+  }
+
+  free(mascara->d_mascaras);
+  free(mascara->qtdPesos);
+  free(mascara);
+}
+
+float PerceptronMulticamadas_ajustarPoda(PerceptronMulticamadas * pm,
+                                         const MascaraPoda * mascara,
+                                         PadraoTreinamento * padroes,
+                                         int qtdPadroesTreinamento,
+                                         float taxaAprendizagem,
+                                         int qtdEpocas)
+{
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+  float erroGlobal = 0;
+
+  /* Descartando o estado do otimizador acumulado antes da poda. */
+  MascaraPoda_aplicar(mascara, pm);
+
+  for (int e = 0; e < qtdEpocas; e++)
+  {
+    erroGlobal = 0;
+
+    for (int p = 0; p < qtdPadroesTreinamento; p++)
+    {
+      erroGlobal += __treinarPadrao(pm, contexto, &padroes[p],
+                                    taxaAprendizagem);
+
+      /* A atualização pode ter tornado os pesos podados não nulos, que
+         são zerados antes do próximo padrão (o padrão seguinte é
+         apresentado apenas à rede podada). */
+      MascaraPoda_aplicar(mascara, pm);
+      ContextoExecucao_invalidarSomaPesos(contexto);
+    }
+
+    erroGlobal /= qtdPadroesTreinamento;
+  }
+
+  ContextoExecucao_desalocar(contexto);
+
+  return erroGlobal;
+}
+
+PerceptronEsparso * PerceptronEsparso_converter(PerceptronMulticamadas * pm)
+{
+  /* A rede esparsa não possui a camada de "embedding" (a primeira camada
+     espera a entrada montada pela mesma). */
+  if (pm->embedding != NULL)
+  {
+    return NULL;
+  }
+
+  PerceptronEsparso * pe = malloc(sizeof(PerceptronEsparso));
+  pe->camadas = malloc(sizeof(CamadaEsparsa) * pm->qtdCamadas);
+  pe->qtdCamadas = pm->qtdCamadas;
+  pe->qtdNeuroniosEntrada = pm->qtdNeuroniosEntrada;
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    CamadaEsparsa * camadaEsparsa = &pe->camadas[c];
+    int qtdPesosNeuronio = __qtdPesosNeuronio(pm, c);
+    size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+    float * h_W = malloc(sizeof(float) * qtdPesos);
+    Camada_copiarPesosHospedeiro(camada, qtdPesosNeuronio, h_W);
+
+    /* Contando os pesos não nulos para alocar os vetores do CSR. */
+    int qtdNaoNulos = 0;
+    for (size_t i = 0; i < qtdPesos; i++)
+    {
+      if (h_W[i] != 0)
+      {
+        qtdNaoNulos++;
+      }
+    }
+
+    float * h_valores = malloc(sizeof(float) * (qtdNaoNulos + 1));
+    int * h_colunas = malloc(sizeof(int) * (qtdNaoNulos + 1));
+    int * h_inicioLinhas = malloc(sizeof(int) * (camada->qtdNeuronios + 1));
+
+    /* Montando as linhas (neurônios) do CSR. */
+    int k = 0;
+    for (int n = 0; n < camada->qtdNeuronios; n++)
+    {
+      h_inicioLinhas[n] = k;
+
+      for (int i = 0; i < qtdPesosNeuronio; i++)
+      {
+        float peso = h_W[(size_t) n * qtdPesosNeuronio + i];
+        if (peso != 0)
+        {
+          h_valores[k] = peso;
+          h_colunas[k] = i;
+          k++;
+        }
+      }
+    }
+    h_inicioLinhas[camada->qtdNeuronios] = k;
+
+    /* Copiando o CSR para o dispositivo acelerador (ao menos um item, para
+       camadas totalmente podadas) e os bias de uma camada para a outra. */
+    cudaMalloc((void **) &camadaEsparsa->d_valores,
+               sizeof(float) * (qtdNaoNulos + 1));
+    cudaMalloc((void **) &camadaEsparsa->d_colunas,
+               sizeof(int) * (qtdNaoNulos + 1));
+    cudaMalloc((void **) &camadaEsparsa->d_inicioLinhas,
+               sizeof(int) * (camada->qtdNeuronios + 1));
+    cudaMalloc((void **) &camadaEsparsa->d_bias,
+               sizeof(float) * camada->qtdNeuronios);
+
+    cudaMemcpy(camadaEsparsa->d_valores, h_valores,
+               sizeof(float) * qtdNaoNulos, cudaMemcpyHostToDevice);
+    cudaMemcpy(camadaEsparsa->d_colunas, h_colunas,
+               sizeof(int) * qtdNaoNulos, cudaMemcpyHostToDevice);
+    cudaMemcpy(camadaEsparsa->d_inicioLinhas, h_inicioLinhas,
+               sizeof(int) * (camada->qtdNeuronios + 1),
+               cudaMemcpyHostToDevice);
+    cudaMemcpy(camadaEsparsa->d_bias, camada->d_bias,
+               sizeof(float) * camada->qtdNeuronios,
+               cudaMemcpyDeviceToDevice);
+
+    camadaEsparsa->qtdNeuronios = camada->qtdNeuronios;
+    camadaEsparsa->qtdPesosNeuronio = qtdPesosNeuronio;
+    camadaEsparsa->qtdNaoNulos = qtdNaoNulos;
+    camadaEsparsa->funcaoAtivacao = camada->funcaoAtivacao;
+
+    free(h_W);
+    free(h_valores);
+    free(h_colunas);
+    free(h_inicioLinhas);
+  }
+
+  return pe;
+}
+
+void PerceptronEsparso_desalocar(PerceptronEsparso * pe)
+{
+  for (int c = 0; c < pe->qtdCamadas; c++)
+  {
+    cudaFree(pe->camadas[c].d_valores);
+    cudaFree(pe->camadas[c].d_colunas);
+    cudaFree(pe->camadas[c].d_inicioLinhas);
+    cudaFree(pe->camadas[c].d_bias);
+  }
+
+  free(pe->camadas);
+  free(pe);
+}
+
+size_t PerceptronEsparso_bytesPesos(const PerceptronEsparso * pe)
+{
+  size_t qtdBytes = 0;
+
+  for (int c = 0; c < pe->qtdCamadas; c++)
+  {
+    qtdBytes += (sizeof(float) + sizeof(int)) * pe->camadas[c].qtdNaoNulos +
+                sizeof(int) * (pe->camadas[c].qtdNeuronios + 1);
+  }
+
+  return qtdBytes;
+}
+
+ContextoEsparso * ContextoEsparso_inicializar(const PerceptronEsparso * pe)
+{
+  ContextoEsparso * contexto = malloc(sizeof(ContextoEsparso));
+
+  int maiorCamada = 0;
+  for (int c = 0; c < pe->qtdCamadas; c++)
+  {
+    if (pe->camadas[c].qtdNeuronios > maiorCamada)
+    {
+      maiorCamada = pe->camadas[c].qtdNeuronios;
+    }
+  }
+
+  int qtdNeuroniosSaida = pe->camadas[pe->qtdCamadas - 1].qtdNeuronios;
+
+  cudaMalloc((void **) &contexto->d_ativacaoA, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_ativacaoB, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_loteEntrada, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * pe->qtdNeuroniosEntrada);
+  cudaMalloc((void **) &contexto->d_loteSaida, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * qtdNeuroniosSaida);
+
+  return contexto;
+}
+
+void ContextoEsparso_desalocar(ContextoEsparso * contexto)
+{
+  cudaFree(contexto->d_ativacaoA);
+  cudaFree(contexto->d_ativacaoB);
+  cudaFree(contexto->d_loteEntrada);
+  cudaFree(contexto->d_loteSaida);
+  free(contexto);
+}
+
+void CamadaEsparsa_calcularAtivacaoNeuroniosLote(const CamadaEsparsa camada,
+                                                 const float * d_entradaLote,
+                                                 int qtdAmostras,
+                                                 float * d_saidaLote)
+{
+  /* Convertendo a estrutura da camada para variáveis de tipos
+   * primitivos para que o OpenACC não tente copiar os vetores
+   * para a memória do dispositivo. */
+  float * camada_d_valores = camada.d_valores;
+  int * camada_d_colunas = camada.d_colunas;
+  int * camada_d_inicioLinhas = camada.d_inicioLinhas;
+  float * camada_d_bias = camada.d_bias;
+  int qtdNeuronios = camada.qtdNeuronios;
+  int qtdPesosNeuronio = camada.qtdPesosNeuronio;
+  int funcaoAtivacao = camada.funcaoAtivacao;
+
+  #pragma acc parallel loop gang vector_length(TAM_VECTOR) \
+  deviceptr(camada_d_valores, camada_d_colunas, camada_d_inicioLinhas, \
+            camada_d_bias, d_entradaLote, d_saidaLote)
+  for (int s = 0; s < qtdAmostras; s++)
+  {
+    const float * entrada = &d_entradaLote[(long) qtdPesosNeuronio * s];
+
+    #pragma acc loop vector
+    for (int n = 0; n < qtdNeuronios; n++)
+    {
+      /* Percorrendo apenas os pesos não nulos do neurônio. */
+      float valFuncIntegracao = 0.0;
+
+      #pragma acc loop seq reduction(+:valFuncIntegracao)
+      for (int k = camada_d_inicioLinhas[n]; k < camada_d_inicioLinhas[n + 1];
+           k++)
+      {
+        valFuncIntegracao += camada_d_valores[k] *
+                             entrada[camada_d_colunas[k]];
+      }
+
+      d_saidaLote[(long) qtdNeuronios * s + n] =
+        aplicarFuncaoAtivacao(valFuncIntegracao + camada_d_bias[n],
+                              funcaoAtivacao);
+    }
+  }
+}
+
+void PerceptronEsparso_predizerLote(PerceptronEsparso * pe,
+                                    ContextoEsparso * contexto,
+                                    const float * d_entradas,
+                                    int qtdAmostras,
+                                    float * d_saidas)
+{
+  int qtdNeuroniosSaida = pe->camadas[pe->qtdCamadas - 1].qtdNeuronios;
+
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
+    {
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    /* A primeira camada lê as amostras e a última escreve na saída, as
+       demais alternam entre as matrizes de ativação do contexto. */
+    const float * d_entradaCamada = &d_entradas[(long) inicio *
+                                                pe->qtdNeuroniosEntrada];
+
+    for (int c = 0; c < pe->qtdCamadas; c++)
+    {
+      float * d_saidaCamada;
+      if (c == pe->qtdCamadas - 1)
+      {
+        d_saidaCamada = &d_saidas[(long) inicio * qtdNeuroniosSaida];
+      }
+      else
+      {
+        d_saidaCamada = (c % 2 == 0) ? contexto->d_ativacaoA :
+                                       contexto->d_ativacaoB;
+      }
+
+      CamadaEsparsa_calcularAtivacaoNeuroniosLote(pe->camadas[c],
+                                                  d_entradaCamada,
+                                                  qtdAmostrasLote,
+                                                  d_saidaCamada);
+
+      d_entradaCamada = d_saidaCamada;
+    }
+  }
+}
+
+void PerceptronEsparso_predizer(PerceptronEsparso * pe,
+                                ContextoEsparso * contexto,
+                                const float * h_entradas,
+                                int qtdAmostras,
+                                float * h_saidas)
+{
+  int qtdNeuroniosSaida = pe->camadas[pe->qtdCamadas - 1].qtdNeuronios;
+
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
+    {
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    cudaMemcpy(contexto->d_loteEntrada,
+               &h_entradas[(long) inicio * pe->qtdNeuroniosEntrada],
+               sizeof(float) * qtdAmostrasLote * pe->qtdNeuroniosEntrada,
+               cudaMemcpyHostToDevice);
+
+    PerceptronEsparso_predizerLote(pe, contexto, contexto->d_loteEntrada,
+                                   qtdAmostrasLote, contexto->d_loteSaida);
+
+    cudaMemcpy(&h_saidas[(long) inicio * qtdNeuroniosSaida],
+               contexto->d_loteSaida,
+               sizeof(float) * qtdAmostrasLote * qtdNeuroniosSaida,
+               cudaMemcpyDeviceToHost);
+  }
+}
+
+float PerceptronEsparso_calcularTaxaAcerto(PerceptronEsparso * pe,
+                                           PadraoTreinamento * padroesTeste,
+                                           int qtdPadroesTeste)
+{
+  /* A rede esparsa recebe apenas amostras densas (float). */
+  for (int i = 0; i < qtdPadroesTeste; i++)
+  {
+    if (padroesTeste[i].tipoAmostra != AmostraDensa)
+    {
+      fprintf(stderr, "PerceptronEsparso_calcularTaxaAcerto: o padrão %d "
+              "não possui uma amostra densa.\n", i);
+      return NAN;
+    }
+  }
+
+  ContextoEsparso * contexto = ContextoEsparso_inicializar(pe);
+  int qtdNeuroniosSaida = pe->camadas[pe->qtdCamadas - 1].qtdNeuronios;
+
+  float h_erroGlobal = 0;
+
+  for (int i = 0; i < qtdPadroesTeste; i++)
+  {
+    PerceptronEsparso_predizerLote(pe, contexto, padroesTeste[i].d_amostra,
+                                   1, contexto->d_loteSaida);
+
+    h_erroGlobal += calcularErroSaida(contexto->d_loteSaida,
+                                      padroesTeste[i].d_alvo,
+                                      qtdNeuroniosSaida);
+  }
+
+  ContextoEsparso_desalocar(contexto);
+
+  return h_erroGlobal / qtdPadroesTeste;
+}
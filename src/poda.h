@@ -0,0 +1,285 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Poda por magnitude dos pesos da rede, com ajuste fino opcional, e        *
+ * inferência da rede podada com as camadas no formato esparso CSR.         *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef PODA_H
+#define PODA_H
+
+#include <stdint.h>
+#include "perceptron_multicamadas.h"
+
+/**
+ * Estrutura com as máscaras da poda (quais pesos de cada camada foram
+ * mantidos), utilizada para manter os pesos podados nulos durante o ajuste
+ * fino da rede.
+ */
+typedef struct
+{
+  /** Máscara ("row-major", no dispositivo acelerador) de cada camada, com
+  1 para os pesos mantidos e 0 para os pesos podados. */
+  uint8_t ** d_mascaras;
+
+  /** Quantidade de pesos de cada camada. */
+  size_t * qtdPesos;
+
+  /** Quantidade de camadas. */
+  int qtdCamadas;
+
+} MascaraPoda;
+
+/**
+ * Estrutura que representa uma camada no formato esparso CSR ("compressed
+ * sparse row"), onde cada linha é um neurônio e apenas os pesos não nulos
+ * são armazenados.
+ */
+typedef struct
+{
+  /** Pesos não nulos, linha após linha. */
+  float * d_valores;
+
+  /** Índice da entrada (coluna) de cada peso não nulo. */
+  int * d_colunas;
+
+  /** Posição do primeiro peso não nulo de cada neurônio em "d_valores"
+  ("qtdNeuronios + 1" itens, o último é a quantidade de pesos não nulos). */
+  int * d_inicioLinhas;
+
+  /** Bias de cada neurônio. */
+  float * d_bias;
+
+  /** Quantidade de neurônios e de entradas da camada. */
+  int qtdNeuronios;
+  int qtdPesosNeuronio;
+
+  /** Quantidade de pesos não nulos da camada. */
+  int qtdNaoNulos;
+
+  /** Função de ativação (enumeração "FuncoesAtivacaoEnum"). */
+  int funcaoAtivacao;
+
+} CamadaEsparsa;
+
+/**
+ * Estrutura que irá armazenar as camadas da rede esparsa.
+ */
+typedef struct
+{
+  /** Vetor de camadas. */
+  CamadaEsparsa * camadas;
+
+  /** Quantidade de camadas. */
+  int qtdCamadas;
+
+  /** Tamanho da entrada (quantidade de "neurônios"). */
+  int qtdNeuroniosEntrada;
+
+} PerceptronEsparso;
+
+/**
+ * Estrutura com as matrizes (no dispositivo acelerador) utilizadas pela
+ * inferência em lote da rede esparsa (uma por thread).
+ */
+typedef struct
+{
+  /** Matrizes (amostra x neurônio) utilizadas alternadamente para as
+  ativações das camadas. */
+  float * d_ativacaoA;
+  float * d_ativacaoB;
+
+  /** Matrizes utilizadas para transferir as entradas e as saídas entre
+  o hospedeiro e o dispositivo acelerador. */
+  float * d_loteEntrada;
+  float * d_loteSaida;
+
+} ContextoEsparso;
+
+/**
+ * Método que poda a rede por magnitude: em cada camada, a fração
+ * "esparsidade" dos pesos com os menores valores absolutos é zerada.
+ *
+ * @param pm Rede a ser podada (os pesos são alterados).
+ *
+ * @param esparsidade Fração (0..1) dos pesos de cada camada a serem
+ *                    zerados.
+ *
+ * @return Máscaras da poda (para o ajuste fino).
+ */
+MascaraPoda * PerceptronMulticamadas_podar(PerceptronMulticamadas * pm,
+                                           float esparsidade);
+
+/**
+ * Método que zera novamente os pesos podados da rede, junto com o estado do
+ * otimizador (velocidades e segundos momentos) dos mesmos.
+ *
+ * @param mascara Máscaras da poda.
+ *
+ * @param pm Rede podada.
+ */
+void MascaraPoda_aplicar(const MascaraPoda * mascara,
+                         PerceptronMulticamadas * pm);
+
+/**
+ * Método que desaloca as máscaras da poda.
+ *
+ * @param mascara Máscaras da poda.
+ */
+void MascaraPoda_desalocar(MascaraPoda * mascara);
+
+/**
+ * Método que realiza o ajuste fino da rede podada com o otimizador da
+ * rede, zerando novamente os pesos podados (e o estado do otimizador dos
+ * mesmos) após cada padrão, para que apenas a rede podada seja treinada.
+ *
+ * @param pm Rede podada.
+ *
+ * @param mascara Máscaras da poda.
+ *
+ * @param padroes Padrões para treinamento.
+ *
+ * @param qtdPadroesTreinamento Quantidade de padrões de treinamento.
+ *
+ * @param taxaAprendizagem Taxa de aprendizagem.
+ *
+ * @param qtdEpocas Quantidade de épocas do ajuste fino.
+ *
+ * @return Erro MSE da última época.
+ */
+float PerceptronMulticamadas_ajustarPoda(PerceptronMulticamadas * pm,
+                                         const MascaraPoda * mascara,
+                                         PadraoTreinamento * padroes,
+                                         int qtdPadroesTreinamento,
+                                         float taxaAprendizagem,
+                                         int qtdEpocas);
+
+/**
+ * Método que converte as camadas de uma rede (normalmente podada) para o
+ * formato esparso CSR, descartando os pesos nulos.
+ *
+ * @param pm Rede (não é alterada).
+ *
+ * @return Referência para a rede esparsa, ou NULO caso a rede possua a
+ *         camada de "embedding" (que não é convertida).
+ */
+PerceptronEsparso * PerceptronEsparso_converter(PerceptronMulticamadas * pm);
+
+/**
+ * Método que desaloca uma rede esparsa.
+ *
+ * @param pe Rede esparsa.
+ */
+void PerceptronEsparso_desalocar(PerceptronEsparso * pe);
+
+/**
+ * Método que retorna a quantidade de bytes ocupados pelos pesos da rede
+ * esparsa (valores, colunas e início das linhas).
+ *
+ * @param pe Rede esparsa.
+ *
+ * @return Quantidade de bytes.
+ */
+size_t PerceptronEsparso_bytesPesos(const PerceptronEsparso * pe);
+
+/**
+ * Método que aloca as matrizes da inferência em lote da rede esparsa.
+ *
+ * @param pe Rede esparsa.
+ *
+ * @return Referência para o contexto alocado.
+ */
+ContextoEsparso * ContextoEsparso_inicializar(const PerceptronEsparso * pe);
+
+/**
+ * Método que desaloca um contexto da rede esparsa.
+ *
+ * @param contexto Contexto a ser desalocado.
+ */
+void ContextoEsparso_desalocar(ContextoEsparso * contexto);
+
+/**
+ * Método que calcula a ativação dos neurônios de uma camada esparsa para um
+ * lote de amostras ("gangs" nas amostras e "vector lanes" nos neurônios),
+ * onde cada neurônio percorre apenas os seus pesos não nulos.
+ *
+ * @param camada Camada esparsa.
+ *
+ * @param d_entradaLote Entradas (amostra x qtdPesosNeuronio).
+ *
+ * @param qtdAmostras Quantidade de amostras do lote.
+ *
+ * @param d_saidaLote Matriz (amostra x neurônio) onde serão armazenadas as
+ *                    ativações.
+ */
+void CamadaEsparsa_calcularAtivacaoNeuroniosLote(const CamadaEsparsa camada,
+                                                 const float * d_entradaLote,
+                                                 int qtdAmostras,
+                                                 float * d_saidaLote);
+
+/**
+ * Método que realiza a inferência da rede esparsa para um lote de amostras
+ * que já estão no dispositivo acelerador.
+ *
+ * @param pe Rede esparsa.
+ *
+ * @param contexto Contexto da rede esparsa.
+ *
+ * @param d_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) com as
+ *                   amostras.
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param d_saidas Matriz (qtdAmostras x neurônios da última camada) onde
+ *                 serão armazenadas as saídas da rede.
+ */
+void PerceptronEsparso_predizerLote(PerceptronEsparso * pe,
+                                    ContextoEsparso * contexto,
+                                    const float * d_entradas,
+                                    int qtdAmostras,
+                                    float * d_saidas);
+
+/**
+ * Método que realiza a inferência da rede esparsa para um lote de amostras
+ * que estão na memória do hospedeiro.
+ *
+ * @param pe Rede esparsa.
+ *
+ * @param contexto Contexto da rede esparsa.
+ *
+ * @param h_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) com as
+ *                   amostras.
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param h_saidas Matriz (qtdAmostras x neurônios da última camada) onde
+ *                 serão armazenadas as saídas da rede.
+ */
+void PerceptronEsparso_predizer(PerceptronEsparso * pe,
+                                ContextoEsparso * contexto,
+                                const float * h_entradas,
+                                int qtdAmostras,
+                                float * h_saidas);
+
+/**
+ * Método que calcula a taxa de acerto (erro MSE, da mesma forma que
+ * "PerceptronMulticamadas_calcularTaxaAcerto") da rede esparsa.
+ *
+ * @param pe Rede esparsa.
+ *
+ * @param padroesTeste Padrões de teste (apenas com amostras densas,
+ *                     "AmostraDensa").
+ *
+ * @param qtdPadroesTeste Quantidade de padrões de teste.
+ *
+ * @return Taxa de acerto da rede (erro MSE), ou NAN caso algum padrão não
+ *         possua uma amostra densa.
+ */
+float PerceptronEsparso_calcularTaxaAcerto(PerceptronEsparso * pe,
+                                           PadraoTreinamento * padroesTeste,
+                                           int qtdPadroesTeste);
+
+#endif
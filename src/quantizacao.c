@@ -0,0 +1,475 @@
+#include "quantizacao.h"
+
+/**
+ * Método que quantiza um valor (já dividido pela escala) para int8,
+ * arredondando e saturando no intervalo -VALOR_MAX_INT8..VALOR_MAX_INT8.
+ */
+#pragma acc routine seq
+static inline int8_t __quantizarInt8(float valor)
+{
+  float arredondado = roundf(valor);
+
+  if (arredondado > VALOR_MAX_INT8)
+  {
+    arredondado = VALOR_MAX_INT8;
+  }
+  else if (arredondado < -VALOR_MAX_INT8)
+  {
+    arredondado = -VALOR_MAX_INT8;
+  }
+
+  return (int8_t) arredondado;
+}
+
+/**
+ * Método que retorna a escala que leva o maior valor absoluto para
+ * VALOR_MAX_INT8 (1 caso todos os valores sejam nulos).
+ */
+static float __calcularEscala(float maiorValorAbsoluto)
+{
+  return (maiorValorAbsoluto > 0) ? maiorValorAbsoluto / VALOR_MAX_INT8 : 1;
+}
+
+/**
+ * Método que verifica se todos os padrões possuem amostras densas (as
+ * únicas aceitas pela rede quantizada), informando o primeiro que não
+ * possuir.
+ */
+static bool __padroesDensos(const PadraoTreinamento * padroes,
+                            int qtdPadroes, const char * nomeMetodo)
+{
+  for (int i = 0; i < qtdPadroes; i++)
+  {
+    if (padroes[i].tipoAmostra != AmostraDensa)
+    {
+      fprintf(stderr, "%s: o padrão %d não possui uma amostra densa.\n",
+              nomeMetodo, i);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Método que calcula o maior valor absoluto das entradas de cada camada
+ * ao apresentar os padrões de calibração à rede original.
+ */
+static void __calibrarEntradas(PerceptronMulticamadas * pm,
+                               PadraoTreinamento * padroesCalibracao,
+                               int qtdPadroesCalibracao,
+                               float * maiorValorEntrada)
+{
+  ContextoExecucao * contexto = ContextoExecucao_inicializar(pm);
+
+  int maiorCamada = pm->qtdNeuroniosEntrada;
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    if (pm->camadas[c]->qtdNeuronios > maiorCamada)
+    {
+      maiorCamada = pm->camadas[c]->qtdNeuronios;
+    }
+  }
+
+  float * h_valores = malloc(sizeof(float) * maiorCamada);
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    maiorValorEntrada[c] = 0;
+  }
+
+  for (int p = 0; p < qtdPadroesCalibracao; p++)
+  {
+    PerceptronMulticamadas_feedfoward(pm, contexto,
+                                      padroesCalibracao[p].d_amostra);
+
+    /* A entrada da primeira camada é a amostra, e a entrada das demais é a
+       ativação da camada anterior. */
+    for (int c = 0; c < pm->qtdCamadas; c++)
+    {
+      const float * d_entradaCamada;
+      int qtdEntradas;
+      if (c == 0)
+      {
+        d_entradaCamada = padroesCalibracao[p].d_amostra;
+        qtdEntradas = pm->qtdNeuroniosEntrada;
+      }
+      else
+      {
+        d_entradaCamada = contexto->estados[c - 1].d_neuronioAtivacao;
+        qtdEntradas = pm->camadas[c - 1]->qtdNeuronios;
+      }
+
+      cudaMemcpy(h_valores, d_entradaCamada, sizeof(float) * qtdEntradas,
+                 cudaMemcpyDeviceToHost);
+
+      for (int i = 0; i < qtdEntradas; i++)
+      {
+        if (fabsf(h_valores[i]) > maiorValorEntrada[c])
+        {
+          maiorValorEntrada[c] = fabsf(h_valores[i]);
+        }
+      }
+    }
+  }
+
+  free(h_valores);
+  ContextoExecucao_desalocar(contexto);
+}
+
+PerceptronQuantizado *
+PerceptronQuantizado_quantizar(PerceptronMulticamadas * pm,
+                               PadraoTreinamento * padroesCalibracao,
+                               int qtdPadroesCalibracao,
+                               int granularidade)
+{
+  /* A rede quantizada não possui a camada de "embedding" (a primeira
+     camada espera a entrada montada pela mesma). */
+  if (pm->embedding != NULL)
+  {
+    return NULL;
+  }
+
+  if (!__padroesDensos(padroesCalibracao, qtdPadroesCalibracao,
+                       "PerceptronQuantizado_quantizar"))
+  {
+    return NULL;
+  }
+
+  PerceptronQuantizado * pq = malloc(sizeof(PerceptronQuantizado));
+  pq->camadas = malloc(sizeof(CamadaQuantizada) * pm->qtdCamadas);
+  pq->qtdCamadas = pm->qtdCamadas;
+  pq->qtdNeuroniosEntrada = pm->qtdNeuroniosEntrada;
+
+  /* Calibrando as escalas das entradas de cada camada. */
+  float * maiorValorEntrada = malloc(sizeof(float) * pm->qtdCamadas);
+  __calibrarEntradas(pm, padroesCalibracao, qtdPadroesCalibracao,
+                     maiorValorEntrada);
+
+  for (int c = 0; c < pm->qtdCamadas; c++)
+  {
+    const Camada * camada = pm->camadas[c];
+    CamadaQuantizada * camadaQuantizada = &pq->camadas[c];
+    int qtdPesosNeuronio = (c == 0) ? pm->qtdNeuroniosEntrada :
+                                      pm->camadas[c - 1]->qtdNeuronios;
+    size_t qtdPesos = (size_t) camada->qtdNeuronios * qtdPesosNeuronio;
+
+    camadaQuantizada->qtdNeuronios = camada->qtdNeuronios;
+    camadaQuantizada->qtdPesosNeuronio = qtdPesosNeuronio;
+    camadaQuantizada->funcaoAtivacao = camada->funcaoAtivacao;
+    camadaQuantizada->escalaEntrada = __calcularEscala(maiorValorEntrada[c]);
+
+    /* Copiando os pesos para o hospedeiro e calculando as escalas. */
+    float * h_W = malloc(sizeof(float) * qtdPesos);
+    Camada_copiarPesosHospedeiro(camada, qtdPesosNeuronio, h_W);
+
+    float * h_escalaW = malloc(sizeof(float) * camada->qtdNeuronios);
+    float maiorPesoCamada = 0;
+
+    for (int n = 0; n < camada->qtdNeuronios; n++)
+    {
+      float maiorPesoNeuronio = 0;
+      for (int i = 0; i < qtdPesosNeuronio; i++)
+      {
+        float peso = fabsf(h_W[(size_t) n * qtdPesosNeuronio + i]);
+        if (peso > maiorPesoNeuronio)
+        {
+          maiorPesoNeuronio = peso;
+        }
+      }
+
+      h_escalaW[n] = __calcularEscala(maiorPesoNeuronio);
+      if (maiorPesoNeuronio > maiorPesoCamada)
+      {
+        maiorPesoCamada = maiorPesoNeuronio;
+      }
+    }
+
+    if (granularidade == QuantizacaoPorCamada)
+    {
+      for (int n = 0; n < camada->qtdNeuronios; n++)
+      {
+        h_escalaW[n] = __calcularEscala(maiorPesoCamada);
+      }
+    }
+
+    /* Quantizando os pesos. */
+    int8_t * h_Wq = malloc(sizeof(int8_t) * qtdPesos);
+    for (int n = 0; n < camada->qtdNeuronios; n++)
+    {
+      for (int i = 0; i < qtdPesosNeuronio; i++)
+      {
+        size_t p = (size_t) n * qtdPesosNeuronio + i;
+        h_Wq[p] = __quantizarInt8(h_W[p] / h_escalaW[n]);
+      }
+    }
+
+    /* Copiando os pesos quantizados e as escalas para o dispositivo
+       acelerador, e os bias de uma camada para a outra. */
+    cudaMalloc((void **) &camadaQuantizada->d_W, sizeof(int8_t) * qtdPesos);
+    cudaMemcpy(camadaQuantizada->d_W, h_Wq, sizeof(int8_t) * qtdPesos,
+               cudaMemcpyHostToDevice);
+
+    cudaMalloc((void **) &camadaQuantizada->d_escalaW,
+               sizeof(float) * camada->qtdNeuronios);
+    cudaMemcpy(camadaQuantizada->d_escalaW, h_escalaW,
+               sizeof(float) * camada->qtdNeuronios, cudaMemcpyHostToDevice);
+
+    cudaMalloc((void **) &camadaQuantizada->d_bias,
+               sizeof(float) * camada->qtdNeuronios);
+    cudaMemcpy(camadaQuantizada->d_bias, camada->d_bias,
+               sizeof(float) * camada->qtdNeuronios,
+               cudaMemcpyDeviceToDevice);
+
+    free(h_W);
+    free(h_Wq);
+    free(h_escalaW);
+  }
+
+  free(maiorValorEntrada);
+
+  return pq;
+}
+
+void PerceptronQuantizado_desalocar(PerceptronQuantizado * pq)
+{
+  for (int c = 0; c < pq->qtdCamadas; c++)
+  {
+    cudaFree(pq->camadas[c].d_W);
+    cudaFree(pq->camadas[c].d_escalaW);
+    cudaFree(pq->camadas[c].d_bias);
+  }
+
+  free(pq->camadas);
+  free(pq);
+}
+
+ContextoQuantizado *
+ContextoQuantizado_inicializar(const PerceptronQuantizado * pq)
+{
+  ContextoQuantizado * contexto = malloc(sizeof(ContextoQuantizado));
+
+  int maiorCamada = 0;
+  for (int c = 0; c < pq->qtdCamadas; c++)
+  {
+    if (pq->camadas[c].qtdNeuronios > maiorCamada)
+    {
+      maiorCamada = pq->camadas[c].qtdNeuronios;
+    }
+  }
+
+  int qtdNeuroniosSaida = pq->camadas[pq->qtdCamadas - 1].qtdNeuronios;
+
+  cudaMalloc((void **) &contexto->d_entradaQuantizada, sizeof(int8_t) *
+             TAM_MAX_LOTE_INFERENCIA * pq->qtdNeuroniosEntrada);
+  cudaMalloc((void **) &contexto->d_ativacaoA, sizeof(int8_t) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_ativacaoB, sizeof(int8_t) *
+             TAM_MAX_LOTE_INFERENCIA * maiorCamada);
+  cudaMalloc((void **) &contexto->d_loteEntrada, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * pq->qtdNeuroniosEntrada);
+  cudaMalloc((void **) &contexto->d_loteSaida, sizeof(float) *
+             TAM_MAX_LOTE_INFERENCIA * qtdNeuroniosSaida);
+
+  return contexto;
+}
+
+void ContextoQuantizado_desalocar(ContextoQuantizado * contexto)
+{
+  cudaFree(contexto->d_entradaQuantizada);
+  cudaFree(contexto->d_ativacaoA);
+  cudaFree(contexto->d_ativacaoB);
+  cudaFree(contexto->d_loteEntrada);
+  cudaFree(contexto->d_loteSaida);
+  free(contexto);
+}
+
+/**
+ * Método que quantiza as entradas (reais) de um lote para a escala da
+ * entrada da primeira camada.
+ */
+static void __quantizarEntradasLote(const float * d_entradas,
+                                    int8_t * d_entradaQuantizada,
+                                    long qtdItens,
+                                    float escala)
+{
+  float inversoEscala = 1 / escala;
+
+  #pragma acc parallel loop gang vector vector_length(TAM_VECTOR) \
+  deviceptr(d_entradas, d_entradaQuantizada)
+  for (long i = 0; i < qtdItens; i++)
+  {
+    d_entradaQuantizada[i] = __quantizarInt8(d_entradas[i] * inversoEscala);
+  }
+}
+
+void CamadaQuantizada_calcularAtivacaoNeuroniosLote(const CamadaQuantizada
+                                                    camada,
+                                                    const int8_t *
+                                                    d_entradaLote,
+                                                    int qtdAmostras,
+                                                    int8_t * d_saidaQuantizada,
+                                                    float escalaSaida,
+                                                    float * d_saidaLote)
+{
+  /* Convertendo a estrutura da camada para variáveis de tipos
+   * primitivos para que o OpenACC não tente copiar os vetores
+   * para a memória do dispositivo. */
+  int8_t * camada_d_W = camada.d_W;
+  float * camada_d_escalaW = camada.d_escalaW;
+  float * camada_d_bias = camada.d_bias;
+  int qtdNeuronios = camada.qtdNeuronios;
+  int qtdPesosNeuronio = camada.qtdPesosNeuronio;
+  int funcaoAtivacao = camada.funcaoAtivacao;
+  float escalaEntrada = camada.escalaEntrada;
+  float inversoEscalaSaida = 1 / escalaSaida;
+  bool saidaReal = (d_saidaLote != NULL);
+
+  #pragma acc parallel loop gang vector_length(TAM_VECTOR) \
+  deviceptr(camada_d_W, camada_d_escalaW, camada_d_bias, d_entradaLote, \
+            d_saidaQuantizada, d_saidaLote)
+  for (int s = 0; s < qtdAmostras; s++)
+  {
+    const int8_t * entrada = &d_entradaLote[(long) qtdPesosNeuronio * s];
+
+    #pragma acc loop vector
+    for (int n = 0; n < qtdNeuronios; n++)
+    {
+      const int8_t * w = &camada_d_W[(long) qtdPesosNeuronio * n];
+
+      /* Produto interno int8 x int8 acumulado em int32. */
+      int acumulador = 0;
+
+      #pragma acc loop seq reduction(+:acumulador)
+      for (int i = 0; i < qtdPesosNeuronio; i++)
+      {
+        acumulador += (int) w[i] * (int) entrada[i];
+      }
+
+      /* Dequantizando, somando o bias e aplicando a função de ativação. */
+      float ativacao = aplicarFuncaoAtivacao(acumulador * camada_d_escalaW[n] *
+                                             escalaEntrada + camada_d_bias[n],
+                                             funcaoAtivacao);
+
+      /* A última camada escreve a ativação real, as demais já escrevem a
+         ativação quantizada para a próxima camada. */
+      if (saidaReal)
+      {
+        d_saidaLote[(long) qtdNeuronios * s + n] = ativacao;
+      }
+      else
+      {
+        d_saidaQuantizada[(long) qtdNeuronios * s + n] =
+          __quantizarInt8(ativacao * inversoEscalaSaida);
+      }
+    }
+  }
+}
+
+void PerceptronQuantizado_predizerLote(PerceptronQuantizado * pq,
+                                       ContextoQuantizado * contexto,
+                                       const float * d_entradas,
+                                       int qtdAmostras,
+                                       float * d_saidas)
+{
+  int qtdNeuroniosSaida = pq->camadas[pq->qtdCamadas - 1].qtdNeuronios;
+
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
+    {
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    __quantizarEntradasLote(&d_entradas[(long) inicio *
+                                        pq->qtdNeuroniosEntrada],
+                            contexto->d_entradaQuantizada,
+                            (long) qtdAmostrasLote * pq->qtdNeuroniosEntrada,
+                            pq->camadas[0].escalaEntrada);
+
+    const int8_t * d_entradaCamada = contexto->d_entradaQuantizada;
+
+    for (int c = 0; c < pq->qtdCamadas; c++)
+    {
+      if (c == pq->qtdCamadas - 1)
+      {
+        CamadaQuantizada_calcularAtivacaoNeuroniosLote
+          (pq->camadas[c], d_entradaCamada, qtdAmostrasLote, NULL, 1,
+           &d_saidas[(long) inicio * qtdNeuroniosSaida]);
+      }
+      else
+      {
+        int8_t * d_saidaCamada = (c % 2 == 0) ? contexto->d_ativacaoA :
+                                                contexto->d_ativacaoB;
+
+        CamadaQuantizada_calcularAtivacaoNeuroniosLote
+          (pq->camadas[c], d_entradaCamada, qtdAmostrasLote, d_saidaCamada,
+           pq->camadas[c + 1].escalaEntrada, NULL);
+
+        d_entradaCamada = d_saidaCamada;
+      }
+    }
+  }
+}
+
+void PerceptronQuantizado_predizer(PerceptronQuantizado * pq,
+                                   ContextoQuantizado * contexto,
+                                   const float * h_entradas,
+                                   int qtdAmostras,
+                                   float * h_saidas)
+{
+  int qtdNeuroniosSaida = pq->camadas[pq->qtdCamadas - 1].qtdNeuronios;
+
+  for (int inicio = 0; inicio < qtdAmostras; inicio += TAM_MAX_LOTE_INFERENCIA)
+  {
+    int qtdAmostrasLote = qtdAmostras - inicio;
+    if (qtdAmostrasLote > TAM_MAX_LOTE_INFERENCIA)
+    {
+      qtdAmostrasLote = TAM_MAX_LOTE_INFERENCIA;
+    }
+
+    cudaMemcpy(contexto->d_loteEntrada,
+               &h_entradas[(long) inicio * pq->qtdNeuroniosEntrada],
+               sizeof(float) * qtdAmostrasLote * pq->qtdNeuroniosEntrada,
+               cudaMemcpyHostToDevice);
+
+    PerceptronQuantizado_predizerLote(pq, contexto, contexto->d_loteEntrada,
+                                      qtdAmostrasLote, contexto->d_loteSaida);
+
+    cudaMemcpy(&h_saidas[(long) inicio * qtdNeuroniosSaida],
+               contexto->d_loteSaida,
+               sizeof(float) * qtdAmostrasLote * qtdNeuroniosSaida,
+               cudaMemcpyDeviceToHost);
+  }
+}
+
+float PerceptronQuantizado_calcularTaxaAcerto(PerceptronQuantizado * pq,
+                                              PadraoTreinamento * padroesTeste,
+                                              int qtdPadroesTeste)
+{
+  if (!__padroesDensos(padroesTeste, qtdPadroesTeste,
+                       "PerceptronQuantizado_calcularTaxaAcerto"))
+  {
+    return NAN;
+  }
+
+  ContextoQuantizado * contexto = ContextoQuantizado_inicializar(pq);
+  int qtdNeuroniosSaida = pq->camadas[pq->qtdCamadas - 1].qtdNeuronios;
+
+  float h_erroGlobal = 0;
+
+  for (int i = 0; i < qtdPadroesTeste; i++)
+  {
+    PerceptronQuantizado_predizerLote(pq, contexto, padroesTeste[i].d_amostra,
+                                      1, contexto->d_loteSaida);
+
+    h_erroGlobal += calcularErroSaida(contexto->d_loteSaida,
+                                      padroesTeste[i].d_alvo,
+                                      qtdNeuroniosSaida);
+  }
+
+  ContextoQuantizado_desalocar(contexto);
+
+  return h_erroGlobal / qtdPadroesTeste;
+}
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Quantização pós-treinamento (int8) da rede para inferência, com          *
+ * acumulação em int32 e dequantização fundida com a função de ativação.    *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef QUANTIZACAO_H
+#define QUANTIZACAO_H
+
+#include <stdint.h>
+#include "perceptron_multicamadas.h"
+
+/* Maior valor absoluto representado na quantização (simétrica). */
+#define VALOR_MAX_INT8 127
+
+/**
+ * Enumerações para a granularidade das escalas dos pesos.
+ */
+enum GranularidadeQuantizacaoEnum
+{
+  /** Uma única escala para todos os pesos da camada. */
+  QuantizacaoPorCamada,
+
+  /** Uma escala para os pesos de cada neurônio (linha de "W"). */
+  QuantizacaoPorNeuronio
+};
+
+/**
+ * Estrutura que representa uma camada quantizada, onde o valor real de um
+ * peso é "d_W[n][i] * d_escalaW[n]" e o valor real de uma entrada é
+ * "entrada[i] * escalaEntrada".
+ */
+typedef struct
+{
+  /** Pesos quantizados ("row-major"). */
+  int8_t * d_W;
+
+  /** Escala dos pesos de cada neurônio (iguais quando a granularidade é
+  por camada). */
+  float * d_escalaW;
+
+  /** Bias (não quantizados) de cada neurônio. */
+  float * d_bias;
+
+  /** Quantidade de neurônios e de pesos por neurônio. */
+  int qtdNeuronios;
+  int qtdPesosNeuronio;
+
+  /** Função de ativação (enumeração "FuncoesAtivacaoEnum"). */
+  int funcaoAtivacao;
+
+  /** Escala das entradas da camada, calibrada com os padrões. */
+  float escalaEntrada;
+
+} CamadaQuantizada;
+
+/**
+ * Estrutura que irá armazenar as camadas da rede quantizada.
+ */
+typedef struct
+{
+  /** Vetor de camadas. */
+  CamadaQuantizada * camadas;
+
+  /** Quantidade de camadas. */
+  int qtdCamadas;
+
+  /** Tamanho da entrada (quantidade de "neurônios"). */
+  int qtdNeuroniosEntrada;
+
+} PerceptronQuantizado;
+
+/**
+ * Estrutura com as matrizes (no dispositivo acelerador) utilizadas pela
+ * inferência em lote da rede quantizada (uma por thread).
+ */
+typedef struct
+{
+  /** Entradas do lote quantizadas (amostra x entrada). */
+  int8_t * d_entradaQuantizada;
+
+  /** Matrizes (amostra x neurônio) utilizadas alternadamente para as
+  ativações quantizadas das camadas. */
+  int8_t * d_ativacaoA;
+  int8_t * d_ativacaoB;
+
+  /** Matrizes utilizadas para transferir as entradas e as saídas entre
+  o hospedeiro e o dispositivo acelerador. */
+  float * d_loteEntrada;
+  float * d_loteSaida;
+
+} ContextoQuantizado;
+
+/**
+ * Método que quantiza uma rede treinada: os pesos de cada camada são
+ * quantizados com escalas por camada ou por neurônio e a escala da entrada
+ * de cada camada é calibrada com o maior valor absoluto observado ao
+ * apresentar os padrões de calibração à rede original.
+ *
+ * @param pm Rede treinada (não é alterada).
+ *
+ * @param padroesCalibracao Padrões utilizados na calibração (por exemplo,
+ *                          uma amostra dos padrões de treinamento), apenas
+ *                          com amostras densas ("AmostraDensa").
+ *
+ * @param qtdPadroesCalibracao Quantidade de padrões de calibração.
+ *
+ * @param granularidade Granularidade das escalas dos pesos (usar a
+ *                      enumeração "GranularidadeQuantizacaoEnum").
+ *
+ * @return Referência para a rede quantizada, ou NULO caso a rede possua a
+ *         camada de "embedding" (que não é quantizada) ou algum padrão de
+ *         calibração não possua uma amostra densa.
+ */
+PerceptronQuantizado *
+PerceptronQuantizado_quantizar(PerceptronMulticamadas * pm,
+                               PadraoTreinamento * padroesCalibracao,
+                               int qtdPadroesCalibracao,
+                               int granularidade);
+
+/**
+ * Método que desaloca uma rede quantizada.
+ *
+ * @param pq Rede quantizada.
+ */
+void PerceptronQuantizado_desalocar(PerceptronQuantizado * pq);
+
+/**
+ * Método que aloca as matrizes da inferência em lote da rede quantizada.
+ *
+ * @param pq Rede quantizada.
+ *
+ * @return Referência para o contexto alocado.
+ */
+ContextoQuantizado *
+ContextoQuantizado_inicializar(const PerceptronQuantizado * pq);
+
+/**
+ * Método que desaloca um contexto da rede quantizada.
+ *
+ * @param contexto Contexto a ser desalocado.
+ */
+void ContextoQuantizado_desalocar(ContextoQuantizado * contexto);
+
+/**
+ * Método que calcula a ativação dos neurônios de uma camada quantizada para
+ * um lote de amostras ("gangs" nas amostras e "vector lanes" nos
+ * neurônios): o produto interno int8 x int8 é acumulado em int32 e a
+ * dequantização, o bias e a função de ativação são aplicados de uma só vez.
+ *
+ * @param camada Camada quantizada.
+ *
+ * @param d_entradaLote Entradas quantizadas (amostra x qtdPesosNeuronio).
+ *
+ * @param qtdAmostras Quantidade de amostras do lote.
+ *
+ * @param d_saidaQuantizada Matriz onde serão armazenadas as ativações
+ *                          quantizadas com "escalaSaida" (entrada da
+ *                          próxima camada), utilizada caso "d_saidaLote"
+ *                          seja NULO.
+ *
+ * @param escalaSaida Escala das ativações quantizadas.
+ *
+ * @param d_saidaLote Matriz onde serão armazenadas as ativações reais
+ *                    (última camada) ou NULO.
+ */
+void CamadaQuantizada_calcularAtivacaoNeuroniosLote(const CamadaQuantizada
+                                                    camada,
+                                                    const int8_t *
+                                                    d_entradaLote,
+                                                    int qtdAmostras,
+                                                    int8_t * d_saidaQuantizada,
+                                                    float escalaSaida,
+                                                    float * d_saidaLote);
+
+/**
+ * Método que realiza a inferência da rede quantizada para um lote de
+ * amostras (reais) que já estão no dispositivo acelerador.
+ *
+ * @param pq Rede quantizada.
+ *
+ * @param contexto Contexto da rede quantizada.
+ *
+ * @param d_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) com as
+ *                   amostras.
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param d_saidas Matriz (qtdAmostras x neurônios da última camada) onde
+ *                 serão armazenadas as saídas da rede.
+ */
+void PerceptronQuantizado_predizerLote(PerceptronQuantizado * pq,
+                                       ContextoQuantizado * contexto,
+                                       const float * d_entradas,
+                                       int qtdAmostras,
+                                       float * d_saidas);
+
+/**
+ * Método que realiza a inferência da rede quantizada para um lote de
+ * amostras que estão na memória do hospedeiro.
+ *
+ * @param pq Rede quantizada.
+ *
+ * @param contexto Contexto da rede quantizada.
+ *
+ * @param h_entradas Matriz (qtdAmostras x qtdNeuroniosEntrada) com as
+ *                   amostras.
+ *
+ * @param qtdAmostras Quantidade de amostras.
+ *
+ * @param h_saidas Matriz (qtdAmostras x neurônios da última camada) onde
+ *                 serão armazenadas as saídas da rede.
+ */
+void PerceptronQuantizado_predizer(PerceptronQuantizado * pq,
+                                   ContextoQuantizado * contexto,
+                                   const float * h_entradas,
+                                   int qtdAmostras,
+                                   float * h_saidas);
+
+/**
+ * Método que calcula a taxa de acerto (erro MSE, da mesma forma que
+ * "PerceptronMulticamadas_calcularTaxaAcerto") da rede quantizada.
+ *
+ * @param pq Rede quantizada.
+ *
+ * @param padroesTeste Padrões de teste (apenas com amostras densas,
+ *                     "AmostraDensa").
+ *
+ * @param qtdPadroesTeste Quantidade de padrões de teste.
+ *
+ * @return Taxa de acerto da rede (erro MSE), ou NAN caso algum padrão não
+ *         possua uma amostra densa.
+ */
+float PerceptronQuantizado_calcularTaxaAcerto(PerceptronQuantizado * pq,
+                                              PadraoTreinamento * padroesTeste,
+                                              int qtdPadroesTeste);
+
+#endif
@@ -0,0 +1,454 @@
+#include "servidor_inferencia.h"
+
+/**
+ * Estrutura com os argumentos da thread que atende uma conexão.
+ */
+typedef struct
+{
+  ServidorInferencia * servidor;
+  int socketConexao;
+  int posicaoConexao;
+} ArgsThreadConexao;
+
+/**
+ * Método que lê exatamente "qtdBytes" do socket.
+ *
+ * @return Verdadeiro caso todos os bytes tenham sido lidos.
+ */
+static bool __lerSocket(int socketConexao, void * buffer, size_t qtdBytes)
+{
+  char * posicao = (char *) buffer;
+  while (qtdBytes > 0)
+  {
+    ssize_t qtdLidos = recv(socketConexao, posicao, qtdBytes, 0);
+    if (qtdLidos <= 0)
+    {
+      return false; // Conexão encerrada ou erro.
+    }
+    posicao += qtdLidos;
+    qtdBytes -= qtdLidos;
+  }
+  return true;
+}
+
+/**
+ * Método que escreve exatamente "qtdBytes" no socket.
+ *
+ * @return Verdadeiro caso todos os bytes tenham sido escritos.
+ */
+static bool __escreverSocket(int socketConexao, const void * buffer,
+                             size_t qtdBytes)
+{
+  const char * posicao = (const char *) buffer;
+  while (qtdBytes > 0)
+  {
+    ssize_t qtdEscritos = send(socketConexao, posicao, qtdBytes, MSG_NOSIGNAL);
+    if (qtdEscritos <= 0)
+    {
+      return false;
+    }
+    posicao += qtdEscritos;
+    qtdBytes -= qtdEscritos;
+  }
+  return true;
+}
+
+/**
+ * Método que descarta "qtdBytes" do socket (requisições inválidas).
+ */
+static bool __descartarSocket(int socketConexao, size_t qtdBytes)
+{
+  char buffer[4096];
+  while (qtdBytes > 0)
+  {
+    size_t qtd = (qtdBytes < sizeof(buffer)) ? qtdBytes : sizeof(buffer);
+    if (!__lerSocket(socketConexao, buffer, qtd))
+    {
+      return false;
+    }
+    qtdBytes -= qtd;
+  }
+  return true;
+}
+
+/**
+ * Thread que atende uma conexão: lê as requisições, coloca as mesmas na
+ * fila do servidor, aguarda o cálculo da saída e envia a resposta.
+ */
+static void * __atenderConexao(void * args)
+{
+  ArgsThreadConexao * argsConexao = (ArgsThreadConexao *) args;
+  ServidorInferencia * servidor = argsConexao->servidor;
+  int socketConexao = argsConexao->socketConexao;
+  int posicaoConexao = argsConexao->posicaoConexao;
+  free(argsConexao);
+
+  int qtdNeuroniosSaida =
+    servidor->pm->camadas[servidor->pm->qtdCamadas - 1]->qtdNeuronios;
+  uint32_t qtdBytesAmostra = sizeof(float) * servidor->pm->qtdNeuroniosEntrada;
+  uint32_t qtdBytesSaida = sizeof(float) * qtdNeuroniosSaida;
+
+  /* A requisição (e seus vetores) é reutilizada durante toda a conexão. */
+  Requisicao requisicao;
+  requisicao.amostra = malloc(qtdBytesAmostra);
+  requisicao.saida = malloc(qtdBytesSaida);
+  pthread_cond_init(&requisicao.condConcluida, NULL);
+
+  uint32_t qtdBytes;
+  while (!servidor->encerrar &&
+         __lerSocket(socketConexao, &qtdBytes, sizeof(uint32_t)))
+  {
+    /* Verificando se a requisição corresponde à entrada da rede. */
+    if (qtdBytes != qtdBytesAmostra)
+    {
+      uint32_t qtdBytesResposta = 0;
+      if (!__descartarSocket(socketConexao, qtdBytes) ||
+          !__escreverSocket(socketConexao, &qtdBytesResposta,
+                            sizeof(uint32_t)))
+      {
+        break;
+      }
+      continue;
+    }
+
+    if (!__lerSocket(socketConexao, requisicao.amostra, qtdBytesAmostra))
+    {
+      break;
+    }
+
+    /* Colocando a requisição no fim da fila e aguardando o cálculo da
+       saída. */
+    clock_gettime(CLOCK_MONOTONIC, &requisicao.horaChegada);
+    requisicao.concluida = false;
+    requisicao.falhou = false;
+    requisicao.proxRequisicao = NULL;
+
+    pthread_mutex_lock(&servidor->mutexFila);
+    if (servidor->encerrar)
+    {
+      pthread_mutex_unlock(&servidor->mutexFila);
+      break;
+    }
+
+    if (servidor->fimFila == NULL)
+    {
+      servidor->inicioFila = &requisicao;
+    }
+    else
+    {
+      servidor->fimFila->proxRequisicao = &requisicao;
+    }
+    servidor->fimFila = &requisicao;
+    servidor->qtdRequisicoesFila++;
+    pthread_cond_signal(&servidor->condFila);
+
+    while (!requisicao.concluida)
+    {
+      pthread_cond_wait(&requisicao.condConcluida, &servidor->mutexFila);
+    }
+    pthread_mutex_unlock(&servidor->mutexFila);
+
+    /* Sem a saída calculada, respondendo com o erro (tamanho 0) e
+       encerrando a conexão. */
+    if (requisicao.falhou)
+    {
+      uint32_t qtdBytesResposta = 0;
+      __escreverSocket(socketConexao, &qtdBytesResposta, sizeof(uint32_t));
+      break;
+    }
+
+    /* Enviando a resposta. */
+    if (!__escreverSocket(socketConexao, &qtdBytesSaida, sizeof(uint32_t)) ||
+        !__escreverSocket(socketConexao, requisicao.saida, qtdBytesSaida))
+    {
+      break;
+    }
+  }
+
+  /* Encerrando a conexão. */
+  close(socketConexao);
+  pthread_cond_destroy(&requisicao.condConcluida);
+  free(requisicao.amostra);
+  free(requisicao.saida);
+
+  pthread_mutex_lock(&servidor->mutexFila);
+  servidor->socketsConexoes[posicaoConexao] = -1;
+  servidor->qtdConexoesAtivas--;
+  pthread_cond_broadcast(&servidor->condConexoes);
+  pthread_mutex_unlock(&servidor->mutexFila);
+
+  return NULL;
+}
+
+/**
+ * Thread que aceita as conexões e dispara uma thread para cada uma.
+ */
+static void * __aceitarConexoes(void * args)
+{
+  ServidorInferencia * servidor = (ServidorInferencia *) args;
+
+  while (!servidor->encerrar)
+  {
+    int socketConexao = accept(servidor->socketServidor, NULL, NULL);
+    if (socketConexao < 0)
+    {
+      if (servidor->encerrar)
+      {
+        break;
+      }
+      continue;
+    }
+
+    /* Localizando uma posição livre para a conexão. */
+    pthread_mutex_lock(&servidor->mutexFila);
+    int posicaoConexao = -1;
+    for (int i = 0; i < QTD_MAX_CONEXOES; i++)
+    {
+      if (servidor->socketsConexoes[i] == -1)
+      {
+        posicaoConexao = i;
+        servidor->socketsConexoes[i] = socketConexao;
+        servidor->qtdConexoesAtivas++;
+        break;
+      }
+    }
+    pthread_mutex_unlock(&servidor->mutexFila);
+
+    if (posicaoConexao == -1)
+    {
+      close(socketConexao); // Limite de conexões atingido.
+      continue;
+    }
+
+    ArgsThreadConexao * argsConexao = malloc(sizeof(ArgsThreadConexao));
+    argsConexao->servidor = servidor;
+    argsConexao->socketConexao = socketConexao;
+    argsConexao->posicaoConexao = posicaoConexao;
+
+    pthread_t threadConexao;
+    pthread_create(&threadConexao, NULL, __atenderConexao, argsConexao);
+    pthread_detach(threadConexao);
+  }
+
+  return NULL;
+}
+
+/**
+ * Thread que forma os micro-lotes: aguarda até que o lote atinja o tamanho
+ * máximo ou até que a requisição mais antiga tenha aguardado o tempo
+ * máximo, e então apresenta o lote à rede através da inferência em lote.
+ */
+static void * __processarLotes(void * args)
+{
+  ServidorInferencia * servidor = (ServidorInferencia *) args;
+  PerceptronMulticamadas * pm = servidor->pm;
+  int qtdNeuroniosEntrada = pm->qtdNeuroniosEntrada;
+  int qtdNeuroniosSaida = pm->camadas[pm->qtdCamadas - 1]->qtdNeuronios;
+  Requisicao ** lote = malloc(sizeof(Requisicao *) *
+                              servidor->config.tamMaxLote);
+
+  pthread_mutex_lock(&servidor->mutexFila);
+
+  while (true)
+  {
+    /* Aguardando a primeira requisição do lote. */
+    while (servidor->qtdRequisicoesFila == 0 && !servidor->encerrar)
+    {
+      pthread_cond_wait(&servidor->condFila, &servidor->mutexFila);
+    }
+
+    if (servidor->encerrar)
+    {
+      break;
+    }
+
+    /* Calculando o prazo do lote a partir da chegada da requisição mais
+       antiga e aguardando mais requisições até o prazo. */
+    struct timespec prazo = servidor->inicioFila->horaChegada;
+    prazo.tv_nsec += (long) servidor->config.esperaMaxMicrossegs * 1000;
+    prazo.tv_sec += prazo.tv_nsec / 1000000000;
+    prazo.tv_nsec %= 1000000000;
+
+    while (servidor->qtdRequisicoesFila < servidor->config.tamMaxLote &&
+           !servidor->encerrar)
+    {
+      if (pthread_cond_timedwait(&servidor->condFila, &servidor->mutexFila,
+                                 &prazo) != 0)
+      {
+        break; // Prazo esgotado.
+      }
+    }
+
+    /* Retirando as requisições do lote da fila. */
+    int qtdRequisicoesLote = 0;
+    while (servidor->inicioFila != NULL &&
+           qtdRequisicoesLote < servidor->config.tamMaxLote)
+    {
+      lote[qtdRequisicoesLote++] = servidor->inicioFila;
+      servidor->inicioFila = servidor->inicioFila->proxRequisicao;
+    }
+    if (servidor->inicioFila == NULL)
+    {
+      servidor->fimFila = NULL;
+    }
+    servidor->qtdRequisicoesFila -= qtdRequisicoesLote;
+
+    pthread_mutex_unlock(&servidor->mutexFila);
+
+    /* Montando a matriz de amostras, apresentando o lote à rede e
+       distribuindo as saídas. */
+    for (int r = 0; r < qtdRequisicoesLote; r++)
+    {
+      memcpy(&servidor->h_entradasLote[(long) r * qtdNeuroniosEntrada],
+             lote[r]->amostra, sizeof(float) * qtdNeuroniosEntrada);
+    }
+
+    PerceptronMulticamadas_predizer(pm, servidor->contexto,
+                                    servidor->h_entradasLote,
+                                    qtdRequisicoesLote,
+                                    servidor->h_saidasLote);
+
+    pthread_mutex_lock(&servidor->mutexFila);
+    for (int r = 0; r < qtdRequisicoesLote; r++)
+    {
+      memcpy(lote[r]->saida,
+             &servidor->h_saidasLote[(long) r * qtdNeuroniosSaida],
+             sizeof(float) * qtdNeuroniosSaida);
+      lote[r]->concluida = true;
+      pthread_cond_signal(&lote[r]->condConcluida);
+    }
+  }
+
+  /* Liberando as requisições que ficaram na fila (sem as saídas). */
+  while (servidor->inicioFila != NULL)
+  {
+    servidor->inicioFila->falhou = true;
+    servidor->inicioFila->concluida = true;
+    pthread_cond_signal(&servidor->inicioFila->condConcluida);
+    servidor->inicioFila = servidor->inicioFila->proxRequisicao;
+  }
+  servidor->fimFila = NULL;
+  servidor->qtdRequisicoesFila = 0;
+
+  pthread_mutex_unlock(&servidor->mutexFila);
+  free(lote);
+
+  return NULL;
+}
+
+ServidorInferencia * ServidorInferencia_iniciar(PerceptronMulticamadas * pm,
+                                                const char * caminhoSocket,
+                                                ConfigServidorInferencia config)
+{
+  /* Com lotes vazios a fila nunca seria consumida. */
+  if (config.tamMaxLote < 1 || config.esperaMaxMicrossegs < 0)
+  {
+    return NULL;
+  }
+
+  /* Criando o socket de domínio Unix. */
+  struct sockaddr_un endereco;
+  memset(&endereco, 0, sizeof(endereco));
+  endereco.sun_family = AF_UNIX;
+
+  if (strlen(caminhoSocket) >= sizeof(endereco.sun_path))
+  {
+    return NULL; // Caminho muito longo.
+  }
+  strcpy(endereco.sun_path, caminhoSocket);
+
+  int socketServidor = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socketServidor < 0)
+  {
+    return NULL;
+  }
+
+  unlink(caminhoSocket);
+  if (bind(socketServidor, (struct sockaddr *) &endereco,
+           sizeof(endereco)) != 0 ||
+      listen(socketServidor, QTD_MAX_CONEXOES_PENDENTES) != 0)
+  {
+    close(socketServidor);
+    return NULL;
+  }
+
+  /* Alocando e preenchendo a estrutura do servidor. */
+  ServidorInferencia * servidor = malloc(sizeof(ServidorInferencia));
+  servidor->pm = pm;
+  servidor->contexto = ContextoExecucao_inicializar(pm);
+  servidor->config = config;
+  servidor->socketServidor = socketServidor;
+  strcpy(servidor->caminhoSocket, caminhoSocket);
+  servidor->inicioFila = NULL;
+  servidor->fimFila = NULL;
+  servidor->qtdRequisicoesFila = 0;
+  servidor->qtdConexoesAtivas = 0;
+  servidor->encerrar = false;
+
+  for (int i = 0; i < QTD_MAX_CONEXOES; i++)
+  {
+    servidor->socketsConexoes[i] = -1;
+  }
+
+  /* O prazo dos lotes é calculado com o relógio CLOCK_MONOTONIC. */
+  pthread_condattr_t atributosCond;
+  pthread_condattr_init(&atributosCond);
+  pthread_condattr_setclock(&atributosCond, CLOCK_MONOTONIC);
+  pthread_mutex_init(&servidor->mutexFila, NULL);
+  pthread_cond_init(&servidor->condFila, &atributosCond);
+  pthread_cond_init(&servidor->condConexoes, NULL);
+  pthread_condattr_destroy(&atributosCond);
+
+  /* Alocando as matrizes do micro-lote (fixadas na memória, para que as
+     transferências para o dispositivo acelerador sejam mais rápidas). */
+  int qtdNeuroniosSaida = pm->camadas[pm->qtdCamadas - 1]->qtdNeuronios;
+  cudaMallocHost((void **) &servidor->h_entradasLote, sizeof(float) *
+                 config.tamMaxLote * pm->qtdNeuroniosEntrada);
+  cudaMallocHost((void **) &servidor->h_saidasLote, sizeof(float) *
+                 config.tamMaxLote * qtdNeuroniosSaida);
+
+  /* Iniciando as threads. */
+  pthread_create(&servidor->threadLotes, NULL, __processarLotes, servidor);
+  pthread_create(&servidor->threadConexoes, NULL, __aceitarConexoes, servidor);
+
+  return servidor;
+}
+
+void ServidorInferencia_encerrar(ServidorInferencia * servidor)
+{
+  /* Sinalizando o encerramento e desbloqueando as threads. */
+  pthread_mutex_lock(&servidor->mutexFila);
+  servidor->encerrar = true;
+  pthread_cond_broadcast(&servidor->condFila);
+  pthread_mutex_unlock(&servidor->mutexFila);
+
+  shutdown(servidor->socketServidor, SHUT_RDWR);
+  close(servidor->socketServidor);
+  pthread_join(servidor->threadConexoes, NULL);
+  pthread_join(servidor->threadLotes, NULL);
+
+  /* Encerrando as conexões ativas e aguardando as suas threads. */
+  pthread_mutex_lock(&servidor->mutexFila);
+  for (int i = 0; i < QTD_MAX_CONEXOES; i++)
+  {
+    if (servidor->socketsConexoes[i] != -1)
+    {
+      shutdown(servidor->socketsConexoes[i], SHUT_RDWR);
+    }
+  }
+  while (servidor->qtdConexoesAtivas > 0)
+  {
+    pthread_cond_wait(&servidor->condConexoes, &servidor->mutexFila);
+  }
+  pthread_mutex_unlock(&servidor->mutexFila);
+
+  /* Desalocando a estrutura. */
+  unlink(servidor->caminhoSocket);
+  pthread_mutex_destroy(&servidor->mutexFila);
+  pthread_cond_destroy(&servidor->condFila);
+  pthread_cond_destroy(&servidor->condConexoes);
+  cudaFreeHost(servidor->h_entradasLote);
+  cudaFreeHost(servidor->h_saidasLote);
+  ContextoExecucao_desalocar(servidor->contexto);
+  free(servidor);
+}
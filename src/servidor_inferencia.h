@@ -0,0 +1,150 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Servidor de inferência local (socket de domínio Unix) que agrupa as      *
+ * requisições concorrentes em micro-lotes antes de apresentá-las à rede.   *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#ifndef SERVIDOR_INFERENCIA_H
+#define SERVIDOR_INFERENCIA_H
+
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "perceptron_multicamadas.h"
+
+/***************************************************************************
+ * Protocolo (binário, com prefixo de tamanho, na ordem de bytes do        *
+ * hospedeiro, já que o socket é local):                                   *
+ *                                                                         *
+ *   Requisição: uint32 qtdBytes | float amostra[qtdNeuroniosEntrada]      *
+ *   Resposta:   uint32 qtdBytes | float saida[neurônios da última camada] *
+ *                                                                         *
+ * Várias requisições podem ser enviadas (uma após a outra) na mesma       *
+ * conexão. Caso o tamanho da requisição não corresponda à entrada da      *
+ * rede, a resposta terá "qtdBytes" igual a 0. Requisições ainda na fila   *
+ * quando o servidor é encerrado também recebem "qtdBytes" igual a 0,      *
+ * seguido do fechamento da conexão.                                       *
+ ***************************************************************************/
+
+/* Quantidade máxima de conexões aguardando na fila do "listen". */
+#define QTD_MAX_CONEXOES_PENDENTES 128
+
+/* Quantidade máxima de conexões atendidas ao mesmo tempo. */
+#define QTD_MAX_CONEXOES 1024
+
+/**
+ * Estrutura com a política de formação dos micro-lotes.
+ */
+typedef struct
+{
+  /** Quantidade máxima de requisições em um micro-lote. */
+  int tamMaxLote;
+
+  /** Tempo máximo (em microssegundos) que a requisição mais antiga
+  aguarda por outras requisições antes do micro-lote ser processado. */
+  int esperaMaxMicrossegs;
+
+} ConfigServidorInferencia;
+
+/**
+ * Estrutura que representa uma requisição aguardando na fila do servidor.
+ */
+typedef struct Requisicao
+{
+  /** Amostra recebida e saída calculada para a mesma. */
+  float * amostra;
+  float * saida;
+
+  /** Hora (CLOCK_MONOTONIC) da chegada da requisição. */
+  struct timespec horaChegada;
+
+  /** Se a saída já foi calculada. */
+  bool concluida;
+
+  /** Se a requisição foi concluída sem que a saída tenha sido calculada
+  (servidor encerrado com a requisição na fila). */
+  bool falhou;
+
+  /** Condição sinalizada quando a saída for calculada. */
+  pthread_cond_t condConcluida;
+
+  /** Próxima requisição da fila. */
+  struct Requisicao * proxRequisicao;
+
+} Requisicao;
+
+/**
+ * Estrutura do servidor de inferência.
+ */
+typedef struct
+{
+  /** Rede e contexto de execução utilizados pelos micro-lotes. */
+  PerceptronMulticamadas * pm;
+  ContextoExecucao * contexto;
+
+  /** Política de formação dos micro-lotes. */
+  ConfigServidorInferencia config;
+
+  /** Socket que aguarda as conexões e o caminho do mesmo. */
+  int socketServidor;
+  char caminhoSocket[108];
+
+  /** Fila de requisições (protegida por "mutexFila"). */
+  Requisicao * inicioFila;
+  Requisicao * fimFila;
+  int qtdRequisicoesFila;
+  pthread_mutex_t mutexFila;
+  pthread_cond_t condFila;
+
+  /** Matrizes (hospedeiro) com as amostras e saídas do micro-lote. */
+  float * h_entradasLote;
+  float * h_saidasLote;
+
+  /** Sockets das conexões ativas (-1 para posições livres) e a
+  quantidade das mesmas (protegidos por "mutexFila"). */
+  int socketsConexoes[QTD_MAX_CONEXOES];
+  int qtdConexoesAtivas;
+  pthread_cond_t condConexoes;
+
+  /** Threads que aceitam as conexões e que processam os micro-lotes. */
+  pthread_t threadConexoes;
+  pthread_t threadLotes;
+
+  /** Se o servidor deve ser encerrado. */
+  volatile bool encerrar;
+
+} ServidorInferencia;
+
+/**
+ * Método que cria o socket de domínio Unix e inicia as threads do
+ * servidor de inferência (a função retorna logo após o início das
+ * mesmas).
+ *
+ * @param pm Rede que irá atender as requisições.
+ *
+ * @param caminhoSocket Caminho do socket de domínio Unix.
+ *
+ * @param config Política de formação dos micro-lotes ("tamMaxLote" deve ser
+ *               maior que 0 e "esperaMaxMicrossegs" não pode ser
+ *               negativo).
+ *
+ * @return Referência para o servidor ou NULO caso a política seja inválida
+ *         ou não seja possível criar o socket.
+ */
+ServidorInferencia * ServidorInferencia_iniciar(PerceptronMulticamadas * pm,
+                                                const char * caminhoSocket,
+                                                ConfigServidorInferencia config);
+
+/**
+ * Método que encerra o servidor (aguardando o micro-lote em andamento),
+ * remove o socket e desaloca a estrutura.
+ *
+ * @param servidor Servidor a ser encerrado.
+ */
+void ServidorInferencia_encerrar(ServidorInferencia * servidor);
+
+#endif
@@ -0,0 +1,126 @@
+/****************************************************************************
+ * Projeto Perceptron Multicamadas paralelo (OpenACC - NVIDIA).             *
+ *                                                                          *
+ * Processo ("daemon") do servidor de inferência local.                     *
+ *                                                                          *
+ * Uso: ./servidor_inferencia <socket> <arquivo de modelo ou topologia     *
+ *                            (ex: 128-256-10)> [tamanho máximo do lote]    *
+ *                            [espera máxima em microssegundos]             *
+ *                                                                          *
+ * @author Gilberto Augusto de Oliveira Bastos.                             *
+ * @copyright BSD-2-Clause                                                  *
+ ****************************************************************************/
+
+#include <signal.h>
+#include "servidor_inferencia.h"
+#include "modelo_arquivo.h"
+
+/* Valores padrão da política dos micro-lotes. */
+#define TAM_MAX_LOTE_PADRAO 64
+#define ESPERA_MAX_MICROSSEGS_PADRAO 200
+
+/* Quantidade máxima de camadas aceitas na topologia. */
+#define QTD_MAX_CAMADAS_TOPOLOGIA 64
+
+/**
+ * Método que cria a rede a partir da topologia no formato
+ * "entrada-camada1-...-camadaN" (pesos aleatórios).
+ */
+static PerceptronMulticamadas * criarRedeTopologia(char * topologia)
+{
+  int qtdNeuronios[QTD_MAX_CAMADAS_TOPOLOGIA + 1];
+  int qtdItens = 0;
+
+  char * item = strtok(topologia, "-");
+  while (item != NULL && qtdItens <= QTD_MAX_CAMADAS_TOPOLOGIA)
+  {
+    qtdNeuronios[qtdItens] = atoi(item);
+    if (qtdNeuronios[qtdItens] < 1)
+    {
+      return NULL; // Camada (ou entrada) sem neurônios.
+    }
+
+    qtdItens++;
+    item = strtok(NULL, "-");
+  }
+
+  if (qtdItens < 2)
+  {
+    return NULL;
+  }
+
+  return PerceptronMulticamadas_inicializar(qtdNeuronios[0], qtdItens - 1,
+                                            &qtdNeuronios[1], Sigmoide);
+}
+
+int main(int argc, char ** argv)
+{
+  if (argc < 3)
+  {
+    printf("Uso: %s <socket> <modelo|topologia> [tamMaxLote] "
+           "[esperaMaxMicrossegs]\n", argv[0]);
+    return 1;
+  }
+
+  /* Caso o argumento seja um arquivo existente, o mesmo é carregado como
+     modelo; caso contrário, é interpretado como uma topologia. */
+  PerceptronMulticamadas * pm;
+  if (access(argv[2], R_OK) == 0)
+  {
+    pm = PerceptronMulticamadas_carregar(argv[2]);
+    if (pm == NULL)
+    {
+      printf("Arquivo de modelo inválido: %s\n", argv[2]);
+      return 1;
+    }
+  }
+  else
+  {
+    pm = criarRedeTopologia(argv[2]);
+    if (pm == NULL)
+    {
+      printf("Topologia inválida.\n");
+      return 1;
+    }
+  }
+
+  ConfigServidorInferencia config;
+  config.tamMaxLote = (argc > 3) ? atoi(argv[3]) : TAM_MAX_LOTE_PADRAO;
+  config.esperaMaxMicrossegs = (argc > 4) ? atoi(argv[4]) :
+                                            ESPERA_MAX_MICROSSEGS_PADRAO;
+
+  if (config.tamMaxLote < 1 || config.esperaMaxMicrossegs < 0)
+  {
+    printf("O tamanho máximo do lote deve ser maior que 0 e a espera "
+           "máxima não pode ser negativa.\n");
+    return 1;
+  }
+
+  /* Bloqueando os sinais de encerramento antes de iniciar as threads, para
+     que os mesmos sejam tratados apenas pelo "sigwait" abaixo. */
+  sigset_t sinais;
+  sigemptyset(&sinais);
+  sigaddset(&sinais, SIGINT);
+  sigaddset(&sinais, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &sinais, NULL);
+
+  ServidorInferencia * servidor = ServidorInferencia_iniciar(pm, argv[1],
+                                                             config);
+  if (servidor == NULL)
+  {
+    printf("Não foi possível criar o socket %s.\n", argv[1]);
+    return 1;
+  }
+
+  printf("Servidor aguardando requisições em %s (lote máximo: %d, "
+         "espera máxima: %d us).\n", argv[1], config.tamMaxLote,
+         config.esperaMaxMicrossegs);
+
+  /* Aguardando o sinal de encerramento. */
+  int sinal;
+  sigwait(&sinais, &sinal);
+
+  ServidorInferencia_encerrar(servidor);
+
+  return 0;
+}